@@ -4,12 +4,50 @@
       "target_name": "graph",
       "cflags!": [ "-fno-exceptions" ],
       "cflags_cc!": [ "-fno-exceptions" ],
+      "cflags_c": [ "-std=c11" ],
       "sources": [
         "src/graph/native/graph.cc",
-        "src/graph/native/binding.cc"
+        "src/graph/native/bloom_filter.cc",
+        "src/graph/native/name_table.cc",
+        "src/graph/native/source_buffer.cc",
+        "src/graph/native/syntax_tree.cc",
+        "src/graph/native/tree_cache.cc",
+        "src/graph/native/extractor.cc",
+        "src/graph/native/usage_scanner.cc",
+        "src/graph/native/identifier_index.cc",
+        "src/graph/native/config_scanner.cc",
+        "src/graph/native/symbol_classifier.cc",
+        "src/graph/native/import_resolver.cc",
+        "src/graph/native/control_flow.cc",
+        "src/graph/native/dataflow.cc",
+        "src/graph/native/function_summary.cc",
+        "src/graph/native/export_table.cc",
+        "src/graph/native/skeleton.cc",
+        "src/graph/native/block_codec.cc",
+        "src/graph/native/disk_cache.cc",
+        "src/graph/native/analysis_cache.cc",
+        "src/graph/native/access_log.cc",
+        "src/graph/native/pattern_query.cc",
+        "src/graph/native/bulk_reader.cc",
+        "src/graph/native/file_watcher.cc",
+        "src/graph/native/reindex_scheduler.cc",
+        "src/graph/native/project_index.cc",
+        "src/graph/native/binding.cc",
+        "src/graph/native/syntax_tree_binding.cc",
+        "src/graph/native/extractor_binding.cc",
+        "src/graph/native/project_index_binding.cc",
+        "node_modules/tree-sitter/vendor/tree-sitter/lib/src/lib.c",
+        "node_modules/tree-sitter-typescript/typescript/src/parser.c",
+        "node_modules/tree-sitter-typescript/typescript/src/scanner.c",
+        "node_modules/tree-sitter-typescript/tsx/src/parser.c",
+        "node_modules/tree-sitter-typescript/tsx/src/scanner.c",
+        "node_modules/tree-sitter-python/src/parser.c",
+        "node_modules/tree-sitter-python/src/scanner.c"
       ],
       "include_dirs": [
-        "<!@(node -p \"require('node-addon-api').include\")"
+        "<!@(node -p \"require('node-addon-api').include\")",
+        "node_modules/tree-sitter/vendor/tree-sitter/lib/include",
+        "node_modules/tree-sitter/vendor/tree-sitter/lib/src"
       ],
       "defines": [ "NAPI_DISABLE_CPP_EXCEPTIONS" ]
     }
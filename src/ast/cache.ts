@@ -5,6 +5,10 @@ import * as chokidar from 'chokidar';
 import { stat, access } from 'fs/promises';
 import { constants } from 'fs';
 
+export type FileEventType = 'add' | 'change' | 'unlink';
+
+export type FileEventListener = (event: FileEventType, filePath: string) => void;
+
 interface CacheEntry {
   parseResult: ParseResult;
   filePath: string;
@@ -21,6 +25,7 @@ export class ASTCacheManager {
   private enabled: boolean;
   private fileWatcher: chokidar.FSWatcher | null = null;
   private watchedPaths: Set<string>;
+  private fileEventListeners: Set<FileEventListener> = new Set();
   private stats: {
     hits: number;
     misses: number;
@@ -75,6 +80,9 @@ export class ASTCacheManager {
     }
 
     entry.lastAccessed = now;
+    // Map order is recency order: re-inserting makes this the newest entry.
+    this.cache.delete(filePath);
+    this.cache.set(filePath, entry);
     this.stats.hits++;
 
     logger.debug('Cache hit', {
@@ -114,6 +122,7 @@ export class ASTCacheManager {
       };
 
       if (this.cache.has(filePath)) {
+        this.cache.delete(filePath);
         this.cache.set(filePath, entry);
       } else {
         if (this.cache.size >= this.maxSize) {
@@ -184,17 +193,10 @@ export class ASTCacheManager {
   }
 
   evictLRU(): void {
-    let lruKey: string | null = null;
-    let lruTime = Infinity;
-
-    for (const [key, entry] of this.cache.entries()) {
-      if (entry.lastAccessed < lruTime) {
-        lruTime = entry.lastAccessed;
-        lruKey = key;
-      }
-    }
+    // The first key in insertion order is the least recently used.
+    const lruKey = this.cache.keys().next().value;
 
-    if (lruKey) {
+    if (lruKey !== undefined) {
       this.cache.delete(lruKey);
       this.stats.evictions++;
 
@@ -213,7 +215,7 @@ export class ASTCacheManager {
   }
 
   startFileWatcher(paths: string | string[]): void {
-    if (!this.enabled || this.fileWatcher) {
+    if (this.fileWatcher || (!this.enabled && this.fileEventListeners.size === 0)) {
       return;
     }
 
@@ -221,6 +223,7 @@ export class ASTCacheManager {
 
     this.fileWatcher = chokidar.watch(watchPaths, {
       ignoreInitial: true,
+      ignored: /(^|[/\\])(node_modules|\.git)([/\\]|$)/,
       persistent: true,
       awaitWriteFinish: {
         stabilityThreshold: 100,
@@ -228,12 +231,18 @@ export class ASTCacheManager {
       },
     });
 
+    this.fileWatcher.on('add', (filePath: string) => {
+      this.emitFileEvent('add', filePath);
+    });
+
     this.fileWatcher.on('change', (filePath: string) => {
       this.invalidate(filePath);
+      this.emitFileEvent('change', filePath);
     });
 
     this.fileWatcher.on('unlink', (filePath: string) => {
       this.invalidate(filePath);
+      this.emitFileEvent('unlink', filePath);
     });
 
     watchPaths.forEach((path) => this.watchedPaths.add(path));
@@ -243,6 +252,31 @@ export class ASTCacheManager {
     });
   }
 
+  /**
+   * Subscribes to watcher events so other stores (e.g. the project index) stay
+   * in step with the AST cache. Returns an unsubscribe function.
+   */
+  onFileEvent(listener: FileEventListener): () => void {
+    this.fileEventListeners.add(listener);
+    return () => {
+      this.fileEventListeners.delete(listener);
+    };
+  }
+
+  private emitFileEvent(event: FileEventType, filePath: string): void {
+    for (const listener of this.fileEventListeners) {
+      try {
+        listener(event, filePath);
+      } catch (error) {
+        logger.warn('File event listener failed', {
+          event,
+          filePath,
+          error: (error as Error).message,
+        });
+      }
+    }
+  }
+
   stopFileWatcher(): void {
     if (this.fileWatcher) {
       this.fileWatcher.close().then(() => {
@@ -253,6 +287,10 @@ export class ASTCacheManager {
     }
   }
 
+  isWatching(): boolean {
+    return this.fileWatcher !== null;
+  }
+
   addWatchPath(path: string): void {
     if (!this.fileWatcher) {
       return;
@@ -0,0 +1,227 @@
+import { resolve } from 'path';
+import { getConfig } from '../utils/config.js';
+import { logger } from '../utils/logger.js';
+import { getCacheManager } from '../ast/cache.js';
+import type { ProjectIndex } from './native/index.js';
+
+/**
+ * fromSymbolId of the graph edges from configuration files to the classes they
+ * name (kConfigRootId natively).
+ */
+export const CONFIG_ROOT_ID = 'config';
+
+/**
+ * Per-symbol heuristic flags computed by classifySymbols (SymbolFlag in
+ * symbol_classifier.h).
+ */
+export const SymbolFlags = {
+  MiddlewareClass: 1 << 0,
+  InMiddlewareClass: 1 << 1,
+  FrameworkMethod: 1 << 2,
+  ReactLifecycle: 1 << 3,
+  PythonMagic: 1 << 4,
+  InConfigFile: 1 << 5,
+  /** Called by a framework rather than by project code; never reported as dead. */
+  DeadCodeRoot: 1 << 6,
+} as const;
+
+type NativeGraph = typeof import('./native/index.js');
+
+let nativePromise: Promise<NativeGraph | null> | null = null;
+let indexPromise: Promise<ProjectIndex | null> | null = null;
+let unsubscribeFileEvents: (() => void) | null = null;
+
+/**
+ * Returns the native graph module, or null when the native graph is disabled
+ * or the addon is not available. The addon is loaded lazily so the tools keep
+ * working on their JS paths without it.
+ */
+export function getNativeGraph(): Promise<NativeGraph | null> {
+  if (!getConfig().get('graph').enableCpp) {
+    return Promise.resolve(null);
+  }
+
+  if (nativePromise === null) {
+    nativePromise = import('./native/index.js')
+      .then((native) => {
+        native.setTreeCacheBudget(getConfig().get('cache').maxBytes);
+        return native;
+      })
+      .catch((error) => {
+        logger.warn('Native graph addon unavailable, using JS analysis', {
+          error: (error as Error).message,
+        });
+        return null;
+      });
+  }
+
+  return nativePromise;
+}
+
+/**
+ * Returns the process-wide native project index, or null when the native graph
+ * is disabled or unavailable.
+ */
+export function getProjectIndex(): Promise<ProjectIndex | null> {
+  if (!getConfig().get('graph').enableCpp) {
+    return Promise.resolve(null);
+  }
+
+  if (indexPromise === null) {
+    indexPromise = getNativeGraph().then((native) => (native ? new native.ProjectIndex() : null));
+  }
+
+  return indexPromise;
+}
+
+/**
+ * Warms the index for root in the background and keeps it current from file
+ * watcher events. Changed files are marked dirty here and re-read by the
+ * native background reindexer once they settle, or sooner by a query that
+ * reads them. The native watcher feeds the dirty set itself; chokidar events
+ * are forwarded where it is unavailable.
+ */
+export async function initializeProjectIndex(root: string): Promise<void> {
+  const index = await getProjectIndex();
+  if (!index) {
+    return;
+  }
+
+  const absoluteRoot = resolve(root);
+  const cacheManager = getCacheManager();
+  const graphConfig = getConfig().get('graph');
+  index.setReindexOptions({
+    debounceMs: graphConfig.reindexDebounceMs,
+    cpuBudget: graphConfig.reindexCpuBudget,
+  });
+  const cacheConfig = getConfig().get('cache');
+  index.setCacheBudgets({ hotBytes: cacheConfig.hotBytes, warmBytes: cacheConfig.warmBytes });
+  if (cacheConfig.enabled) {
+    const cacheDir = resolve(getConfig().get('paths').cacheDir, 'parse');
+    if (index.setCacheDir(cacheDir, cacheConfig.coldBytes)) {
+      process.once('exit', () => index.flushAccessLog());
+    } else {
+      logger.warn('Parse cache directory unusable', { cacheDir });
+    }
+  }
+
+  const watchedNatively = index.watch(absoluteRoot, (filePaths) => {
+    for (const filePath of filePaths) {
+      cacheManager.invalidate(filePath);
+    }
+  });
+  if (!watchedNatively) {
+    if (unsubscribeFileEvents === null) {
+      unsubscribeFileEvents = cacheManager.onFileEvent((_event, filePath) => {
+        index.markFileDirty(resolve(filePath));
+      });
+    }
+    if (cacheManager.isWatching()) {
+      cacheManager.addWatchPath(absoluteRoot);
+    } else {
+      cacheManager.startFileWatcher(absoluteRoot);
+    }
+  }
+
+  const startTime = Date.now();
+  try {
+    const fileCount = await index.warm(absoluteRoot);
+    logger.info('Project index warmed', {
+      root: absoluteRoot,
+      fileCount,
+      durationMs: Date.now() - startTime,
+    });
+    const prefetched = await index.prefetch({
+      maxFiles: graphConfig.prefetchFiles,
+      maxSymbols: graphConfig.prefetchSymbols,
+      timeMs: graphConfig.prefetchTimeMs,
+      memoryBytes: graphConfig.prefetchBytes,
+    });
+    logger.info('Working set prefetched', { ...prefetched });
+  } catch (error) {
+    logger.warn('Failed to warm project index', {
+      root: absoluteRoot,
+      error: (error as Error).message,
+    });
+  }
+}
+
+async function getCoveringProjectIndex(dir: string): Promise<ProjectIndex | null> {
+  const index = await getProjectIndex();
+  if (!index || !index.covers(resolve(dir))) {
+    return null;
+  }
+  return index;
+}
+
+/**
+ * Returns the index only if it has been warmed for a directory containing
+ * dir, after folding in any pending file changes. Tools fall back to parsing
+ * when this returns null.
+ */
+export async function getWarmProjectIndex(dir: string): Promise<ProjectIndex | null> {
+  const index = await getCoveringProjectIndex(dir);
+  index?.refreshDirtyFiles();
+  return index;
+}
+
+/**
+ * Like getWarmProjectIndex, but only when every one of files is indexed, so a
+ * tool can answer for exactly the file set it would otherwise parse. Only
+ * those files are brought up to date before returning; their imports jump
+ * the background queue and other pending changes stay in it. Pass
+ * recordAccess when files are what the tool was asked about and its lookups
+ * do not already count them; whole-project sweeps must not, or every file
+ * ranks the same for prefetch.
+ */
+export async function getProjectIndexForFiles(
+  files: string[],
+  options: { recordAccess?: boolean } = {}
+): Promise<ProjectIndex | null> {
+  if (files.length === 0) {
+    return null;
+  }
+
+  const index = await getCoveringProjectIndex(files[0]!);
+  if (!index) {
+    return null;
+  }
+  const absolute = files.map((file) => resolve(file));
+  index.refreshFiles(absolute);
+  if (options.recordAccess) {
+    index.recordFileAccess(absolute);
+  }
+  if (!absolute.every((file) => index.hasFile(file))) {
+    return null;
+  }
+  return index;
+}
+
+/**
+ * Narrows files to those that may mention any of names before a tool parses
+ * them. Files the index has not seen, or that changed since it read them, are
+ * kept, and without an index the list is returned unchanged.
+ */
+export async function filterCandidateFiles(files: string[], names: string[]): Promise<string[]> {
+  if (files.length === 0 || names.length === 0) {
+    return files;
+  }
+
+  const index = await getProjectIndex();
+  if (!index) {
+    return files;
+  }
+
+  const absolute = files.map((file) => resolve(file));
+  index.refreshFiles(absolute);
+  const candidates = new Set(index.findCandidateFiles(names, absolute));
+  return files.filter((_, i) => candidates.has(absolute[i]!));
+}
+
+export function resetProjectIndex(): void {
+  if (unsubscribeFileEvents) {
+    unsubscribeFileEvents();
+    unsubscribeFileEvents = null;
+  }
+  indexPromise = null;
+}
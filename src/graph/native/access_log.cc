@@ -0,0 +1,196 @@
+#include "access_log.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace prism {
+
+namespace {
+
+constexpr const char* kHeader = "prism-access 1";
+constexpr size_t kMaxTracked = 16384;  // Per table
+constexpr auto kSaveInterval = std::chrono::seconds(30);
+
+void age(std::unordered_map<std::string, uint32_t>& counts) {
+  for (auto it = counts.begin(); it != counts.end();) {
+    it->second /= 2;
+    it = it->second == 0 ? counts.erase(it) : std::next(it);
+  }
+}
+
+std::vector<std::string> top(const std::unordered_map<std::string, uint32_t>& counts,
+                             size_t limit) {
+  std::vector<std::pair<uint32_t, const std::string*>> ranked;
+  ranked.reserve(counts.size());
+  for (const auto& entry : counts) ranked.push_back({entry.second, &entry.first});
+  auto byCount = [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : *a.second < *b.second;
+  };
+  if (ranked.size() > limit) {
+    std::partial_sort(ranked.begin(), ranked.begin() + limit, ranked.end(), byCount);
+    ranked.resize(limit);
+  } else {
+    std::sort(ranked.begin(), ranked.end(), byCount);
+  }
+  std::vector<std::string> keys;
+  keys.reserve(ranked.size());
+  for (const auto& entry : ranked) keys.push_back(*entry.second);
+  return keys;
+}
+
+bool writeWhole(int fd, const std::string& bytes) {
+  size_t done = 0;
+  while (done < bytes.size()) {
+    ssize_t n = write(fd, bytes.data() + done, bytes.size() - done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Another server process may save the same file; each writes its own
+// temporary and renames it over, so the file is always one whole save.
+bool replaceFile(const std::string& path, const std::string& bytes) {
+  static std::atomic<uint64_t> nextTemporary{0};
+  std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." +
+                          std::to_string(nextTemporary.fetch_add(1));
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+  bool written = writeWhole(fd, bytes);
+  if (close(fd) != 0) written = false;
+  if (!written || rename(temporary.c_str(), path.c_str()) != 0) {
+    unlink(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void AccessLog::attach(const std::string& path) {
+  Counts files;
+  Counts symbols;
+  if (!path.empty()) {
+    std::ifstream in(path);
+    std::string line;
+    if (std::getline(in, line) && line == kHeader) {
+      // "<f|s>\t<count>\t<key>" per line
+      while (std::getline(in, line)) {
+        size_t tab = line.find('\t', 2);
+        if (line.size() < 5 || line[1] != '\t' || tab == std::string::npos) continue;
+        uint32_t count = static_cast<uint32_t>(std::strtoul(line.c_str() + 2, nullptr, 10));
+        if (count / 2 == 0) continue;
+        Counts& counts = line[0] == 'f' ? files : symbols;
+        counts[line.substr(tab + 1)] += count / 2;
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (path == path_) return;
+  path_ = path;
+  stats_.loaded += files.size() + symbols.size();
+  for (auto& entry : files) files_[entry.first] += entry.second;
+  for (auto& entry : symbols) symbols_[entry.first] += entry.second;
+  lastSave_ = std::chrono::steady_clock::now();
+}
+
+void AccessLog::recordFile(const std::string& filePath) {
+  bool save;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    record(files_, filePath);
+    save = saveDue();
+  }
+  if (save) flush();
+}
+
+void AccessLog::recordFiles(const std::vector<std::string>& filePaths) {
+  bool save;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& filePath : filePaths) record(files_, filePath);
+    save = saveDue();
+  }
+  if (save) flush();
+}
+
+void AccessLog::recordSymbol(const std::string& symbolId) {
+  bool save;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    record(symbols_, symbolId);
+    save = saveDue();
+  }
+  if (save) flush();
+}
+
+std::vector<std::string> AccessLog::topFiles(size_t limit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return top(files_, limit);
+}
+
+std::vector<std::string> AccessLog::topSymbols(size_t limit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return top(symbols_, limit);
+}
+
+bool AccessLog::flush() {
+  std::string path;
+  std::string bytes = std::string(kHeader) + "\n";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty() || !dirty_ || saving_) return false;
+    path = path_;
+    for (const auto& entry : files_) {
+      bytes += "f\t" + std::to_string(entry.second) + "\t" + entry.first + "\n";
+    }
+    for (const auto& entry : symbols_) {
+      bytes += "s\t" + std::to_string(entry.second) + "\t" + entry.first + "\n";
+    }
+    dirty_ = false;
+    saving_ = true;
+    lastSave_ = std::chrono::steady_clock::now();
+  }
+  bool saved = replaceFile(path, bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  saving_ = false;
+  if (saved) {
+    stats_.saves++;
+  } else {
+    stats_.saveFailures++;
+    dirty_ = true;
+  }
+  return saved;
+}
+
+AccessLogStats AccessLog::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AccessLogStats stats = stats_;
+  stats.files = files_.size();
+  stats.symbols = symbols_.size();
+  return stats;
+}
+
+void AccessLog::record(Counts& counts, const std::string& key) {
+  if (key.empty() || key.find('\n') != std::string::npos) return;
+  uint32_t& count = counts[key];
+  if (count < UINT32_MAX) count++;
+  stats_.records++;
+  dirty_ = true;
+  if (counts.size() > kMaxTracked) age(counts);
+}
+
+bool AccessLog::saveDue() const {
+  return !path_.empty() && dirty_ && !saving_ &&
+         std::chrono::steady_clock::now() - lastSave_ >= kSaveInterval;
+}
+
+}  // namespace prism
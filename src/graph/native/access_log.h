@@ -0,0 +1,69 @@
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace prism {
+
+struct AccessLogStats {
+  size_t files = 0;    // Distinct files counted
+  size_t symbols = 0;  // Distinct symbols counted
+  size_t records = 0;  // Accesses recorded by this process
+  size_t loaded = 0;   // Entries restored from disk
+  size_t saves = 0;
+  size_t saveFailures = 0;
+};
+
+// How often queries touch each file and symbol, so the next server process can
+// load the working set before it is asked for it. Counts are saved to a file
+// (usually beside the disk parse cache) at most every 30 seconds while
+// queries come in, and on flush(). Counts halve when loaded, and whenever
+// either table outgrows its cap, so an old working set fades.
+// Internally synchronized.
+class AccessLog {
+ public:
+  AccessLog() = default;
+
+  AccessLog(const AccessLog&) = delete;
+  AccessLog& operator=(const AccessLog&) = delete;
+
+  // Adds the counts saved at path, halved, and saves there from now on.
+  // Empty stops saving; attaching the current path again does nothing.
+  void attach(const std::string& path);
+  void recordFile(const std::string& filePath);
+  void recordFiles(const std::vector<std::string>& filePaths);
+  void recordSymbol(const std::string& symbolId);
+  // Most accessed first.
+  std::vector<std::string> topFiles(size_t limit) const;
+  std::vector<std::string> topSymbols(size_t limit) const;
+  // Saves now if anything changed since the last save.
+  bool flush();
+  AccessLogStats stats() const;
+
+ private:
+  using Counts = std::unordered_map<std::string, uint32_t>;
+
+  mutable std::mutex mutex_;
+  std::string path_;
+  Counts files_;
+  Counts symbols_;
+  AccessLogStats stats_;
+  bool dirty_ = false;
+  bool saving_ = false;
+  std::chrono::steady_clock::time_point lastSave_;
+
+  // Caller holds mutex_.
+  void record(Counts& counts, const std::string& key);
+  // True when a save is due; the caller then calls flush() without the lock.
+  bool saveDue() const;
+};
+
+}  // namespace prism
+
+#endif  // ACCESS_LOG_H
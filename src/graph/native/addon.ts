@@ -0,0 +1,43 @@
+import { createRequire } from 'module';
+import path from 'path';
+import fs from 'fs';
+
+const require = createRequire(import.meta.url);
+
+function findAddon() {
+  const possiblePaths = [
+    // When running from build/graph/native/index.js
+    '../../Release/graph.node',
+    // When running from src/graph/native/index.ts (dev/test)
+    '../../../build/Release/graph.node'
+  ];
+
+  for (const p of possiblePaths) {
+    try {
+      // Resolve relative to this file
+      const resolved = require.resolve(p);
+      return require(resolved);
+    } catch (e) {
+      // Continue
+    }
+  }
+  
+  // Fallback: try via absolute path from cwd (for vitest execution)
+  try {
+    const cwdPath = path.join(process.cwd(), 'build', 'Release', 'graph.node');
+    if (fs.existsSync(cwdPath)) {
+      return require(cwdPath);
+    }
+  } catch (e) {
+    // Continue
+  }
+  
+  // Last resort
+  try {
+     return require('../../../build/Release/graph.node');
+  } catch (e) {
+     throw new Error(`Could not find graph.node addon. Searched in: ${possiblePaths.join(', ')}`);
+  }
+}
+
+export const addon = findAddon();
@@ -0,0 +1,334 @@
+#include "analysis_cache.h"
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include "block_codec.h"
+#include "tree_cache.h"
+
+namespace prism {
+
+namespace {
+
+// Uses while warm that bring an entry back to hot.
+constexpr uint32_t kPromoteUses = 2;
+
+size_t bitVectorBytes(const BitVector& bits) {
+  return sizeof(BitVector) + (bits.size() + 63) / 64 * sizeof(uint64_t);
+}
+
+size_t analysisBytes(const FileAnalysis& analysis) {
+  size_t bytes = sizeof(FileAnalysis);
+  if (analysis.extraction) bytes += extractionResultBytes(*analysis.extraction);
+  for (const auto& site : analysis.configCallSites) bytes += referenceBytes(site);
+  for (const auto& facts : analysis.functionFacts) {
+    bytes += sizeof(LocalFunctionFacts) + heapBytes(facts.symbolId) + heapBytes(facts.name) +
+             bitVectorBytes(facts.returns) - sizeof(BitVector);
+    for (const auto& parameter : facts.parameters) {
+      bytes += sizeof(std::string) + heapBytes(parameter);
+    }
+    for (const auto& call : facts.calls) {
+      bytes += sizeof(SummaryCall) + heapBytes(call.callee);
+      for (const auto& argument : call.arguments) bytes += bitVectorBytes(argument);
+    }
+    for (const auto& write : facts.globalWrites) {
+      bytes += sizeof(write) + heapBytes(write.first) + bitVectorBytes(write.second) -
+               sizeof(BitVector);
+    }
+  }
+  bytes += analysis.usedNames.size() * sizeof(std::string_view);
+  bytes += analysis.occurrences.size() * sizeof(Occurrence);
+  for (const auto& name : analysis.names) bytes += sizeof(std::string) + heapBytes(name);
+  if (analysis.skeleton) bytes += skeletonBytes(*analysis.skeleton);
+  return bytes;
+}
+
+size_t warmEntryBytes(const std::string& filePath, const std::string& block) {
+  return sizeof(std::string) * 2 + filePath.size() + block.size() + 64;
+}
+
+// A copy of analysis whose name views point into its own storage rather than
+// the source it was scanned from.
+std::shared_ptr<const FileAnalysis> ownedCopy(const FileAnalysis& analysis) {
+  auto owned = std::make_shared<FileAnalysis>();
+  owned->extraction = analysis.extraction;
+  owned->configCallSites = analysis.configCallSites;
+  owned->functionFacts = analysis.functionFacts;
+  owned->skeleton = analysis.skeleton;
+
+  std::unordered_map<std::string_view, size_t> slot;
+  auto add = [&](std::string_view name) {
+    if (slot.emplace(name, slot.size()).second) owned->names.emplace_back(name);
+  };
+  for (std::string_view name : analysis.usedNames) add(name);
+  for (const auto& occurrence : analysis.occurrences) add(occurrence.name);
+
+  owned->usedNames.reserve(analysis.usedNames.size());
+  for (std::string_view name : analysis.usedNames) {
+    owned->usedNames.push_back(owned->names[slot.at(name)]);
+  }
+  owned->occurrences = analysis.occurrences;
+  for (auto& occurrence : owned->occurrences) {
+    occurrence.name = owned->names[slot.at(occurrence.name)];
+  }
+  return owned;
+}
+
+bool sameContent(LanguageId language, uint64_t contentHash, size_t contentSize,
+                 const SourceBuffer& source, LanguageId sourceLanguage) {
+  return language == sourceLanguage && contentHash == source.contentHash() &&
+         contentSize == source.size();
+}
+
+}  // namespace
+
+AnalysisCache::AnalysisCache(AnalysisCacheOptions options) : options_(options) {}
+
+void AnalysisCache::setOptions(const AnalysisCacheOptions& options) {
+  std::vector<Entry> demoted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    shrinkHot(demoted);
+    shrinkWarm();
+  }
+  demote(std::move(demoted));
+}
+
+AnalysisCacheOptions AnalysisCache::options() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return options_;
+}
+
+void AnalysisCache::setCold(DiskParseCachePtr cold) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cold_ = std::move(cold);
+}
+
+DiskParseCachePtr AnalysisCache::cold() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cold_;
+}
+
+std::shared_ptr<const FileAnalysis> AnalysisCache::get(const std::string& filePath,
+                                                       LanguageId language,
+                                                       const SourceBuffer& source) {
+  bool warm = false;
+  std::string block;
+  size_t rawSize = 0;
+  bool promote = false;
+  DiskParseCachePtr cold;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.lookups++;
+    auto it = entries_.find(filePath);
+    if (it != entries_.end()) {
+      EntryList::iterator entry = it->second;
+      if (!sameContent(entry->language, entry->contentHash, entry->contentSize, source,
+                       language)) {
+        unlink(entry);
+        entries_.erase(it);
+      } else if (entry->tier == Tier::Hot) {
+        entry->uses++;
+        hot_.splice(hot_.begin(), hot_, entry);
+        stats_.hot.hits++;
+        return entry->analysis;
+      } else {
+        entry->uses++;
+        warm_.splice(warm_.begin(), warm_, entry);
+        warm = true;
+        block = entry->block;
+        rawSize = entry->rawSize;
+        promote = entry->uses >= kPromoteUses;
+      }
+    }
+    cold = cold_;
+  }
+
+  if (warm) {
+    std::string payload;
+    auto analysis = std::make_shared<FileAnalysis>();
+    bool decoded = decompressBlock(block, rawSize, payload) &&
+                   decodeFileAnalysis(payload, filePath, *analysis);
+    std::vector<Entry> demoted;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(filePath);
+      bool current = it != entries_.end() && it->second->tier == Tier::Warm &&
+                     sameContent(it->second->language, it->second->contentHash,
+                                 it->second->contentSize, source, language);
+      if (!decoded) {
+        if (current) {
+          unlink(it->second);
+          entries_.erase(it);
+        }
+        stats_.misses++;
+        return nullptr;
+      }
+      stats_.warm.hits++;
+      if (promote && current) {
+        Entry& entry = *it->second;
+        size_t bytes = analysisBytes(*analysis);
+        if (bytes <= options_.hotBytes) {
+          warmBytes_ -= entry.bytes;
+          warmRawBytes_ -= entry.rawSize;
+          entry.tier = Tier::Hot;
+          entry.analysis = analysis;
+          entry.block = std::string();
+          entry.rawSize = 0;
+          entry.bytes = bytes;
+          hotBytes_ += bytes;
+          hot_.splice(hot_.begin(), warm_, it->second);
+          stats_.promotions++;
+          shrinkHot(demoted);
+        }
+      }
+    }
+    demote(std::move(demoted));
+    return analysis;
+  }
+
+  if (cold) {
+    FileAnalysis analysis;
+    std::string payload;
+    if (cold->load(filePath, language, source, analysis, &payload)) {
+      Entry entry{filePath, language, source.contentHash(), source.size(), 1, Tier::Warm};
+      entry.block = compressBlock(payload);
+      entry.rawSize = payload.size();
+      entry.bytes = warmEntryBytes(filePath, entry.block);
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.coldHits++;
+      if (entries_.find(filePath) == entries_.end()) insertWarm(std::move(entry));
+      return std::make_shared<const FileAnalysis>(std::move(analysis));
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.misses++;
+  return nullptr;
+}
+
+void AnalysisCache::put(const std::string& filePath, LanguageId language,
+                        const SourceBuffer& source, const FileAnalysis& analysis) {
+  if (!analysis.extraction) return;
+  std::shared_ptr<const FileAnalysis> owned = ownedCopy(analysis);
+  size_t bytes = analysisBytes(*owned);
+  std::vector<Entry> demoted;
+  DiskParseCachePtr cold;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t uses = 1;
+    auto it = entries_.find(filePath);
+    if (it != entries_.end()) {
+      // A new version of a file in use, such as an edit, inherits its count.
+      uses = std::max(uses, it->second->uses);
+      unlink(it->second);
+      entries_.erase(it);
+    }
+    Entry entry{filePath, language, source.contentHash(), source.size(), uses, Tier::Hot};
+    entry.analysis = std::move(owned);
+    entry.bytes = bytes;
+    if (bytes <= options_.hotBytes) {
+      hot_.push_front(std::move(entry));
+      hotBytes_ += bytes;
+      entries_.emplace(filePath, hot_.begin());
+      shrinkHot(demoted);
+    } else {
+      demoted.push_back(std::move(entry));
+    }
+    cold = cold_;
+  }
+  demote(std::move(demoted));
+  if (cold) cold->store(filePath, language, source, analysis);
+}
+
+void AnalysisCache::erase(const std::string& filePath) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(filePath);
+  if (it == entries_.end()) return;
+  unlink(it->second);
+  entries_.erase(it);
+}
+
+AnalysisCacheStats AnalysisCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AnalysisCacheStats stats = stats_;
+  stats.hot.entries = hot_.size();
+  stats.hot.bytes = hotBytes_;
+  stats.hot.budgetBytes = options_.hotBytes;
+  stats.warm.entries = warm_.size();
+  stats.warm.bytes = warmBytes_;
+  stats.warm.budgetBytes = options_.warmBytes;
+  stats.warmRawBytes = warmRawBytes_;
+  return stats;
+}
+
+void AnalysisCache::unlink(EntryList::iterator entry) {
+  if (entry->tier == Tier::Hot) {
+    hotBytes_ -= entry->bytes;
+    hot_.erase(entry);
+  } else {
+    warmBytes_ -= entry->bytes;
+    warmRawBytes_ -= entry->rawSize;
+    warm_.erase(entry);
+  }
+}
+
+void AnalysisCache::shrinkHot(std::vector<Entry>& demoted) {
+  while (hotBytes_ > options_.hotBytes && !hot_.empty()) {
+    EntryList::iterator coldest = std::prev(hot_.end());
+    if (coldest->uses > 1 && hot_.size() > 1) {
+      coldest->uses /= 2;
+      hot_.splice(hot_.begin(), hot_, coldest);
+      continue;
+    }
+    hotBytes_ -= coldest->bytes;
+    entries_.erase(coldest->filePath);
+    demoted.push_back(std::move(*coldest));
+    hot_.erase(coldest);
+  }
+}
+
+void AnalysisCache::shrinkWarm() {
+  while (warmBytes_ > options_.warmBytes && !warm_.empty()) {
+    EntryList::iterator coldest = std::prev(warm_.end());
+    if (coldest->uses > 1 && warm_.size() > 1) {
+      coldest->uses /= 2;
+      warm_.splice(warm_.begin(), warm_, coldest);
+      continue;
+    }
+    entries_.erase(coldest->filePath);
+    unlink(coldest);
+    stats_.evictions++;
+  }
+}
+
+void AnalysisCache::insertWarm(Entry entry) {
+  if (entry.bytes > options_.warmBytes) {
+    stats_.evictions++;
+    return;
+  }
+  std::string filePath = entry.filePath;
+  warmBytes_ += entry.bytes;
+  warmRawBytes_ += entry.rawSize;
+  warm_.push_front(std::move(entry));
+  entries_.emplace(std::move(filePath), warm_.begin());
+  shrinkWarm();
+}
+
+void AnalysisCache::demote(std::vector<Entry> demoted) {
+  for (auto& entry : demoted) {
+    std::string payload = encodeFileAnalysis(entry.filePath, *entry.analysis);
+    entry.analysis.reset();
+    entry.tier = Tier::Warm;
+    entry.uses = 0;
+    entry.block = compressBlock(payload);
+    entry.rawSize = payload.size();
+    entry.bytes = warmEntryBytes(entry.filePath, entry.block);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.demotions++;
+    // Indexed again, or brought back from disk, while being compressed
+    if (entries_.find(entry.filePath) != entries_.end()) continue;
+    insertWarm(std::move(entry));
+  }
+}
+
+}  // namespace prism
@@ -0,0 +1,116 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "disk_cache.h"
+
+namespace prism {
+
+struct AnalysisCacheOptions {
+  size_t hotBytes = 32u << 20;
+  size_t warmBytes = 64u << 20;
+};
+
+struct AnalysisTierStats {
+  size_t entries = 0;
+  size_t bytes = 0;
+  size_t budgetBytes = 0;
+  size_t hits = 0;
+};
+
+struct AnalysisCacheStats {
+  size_t lookups = 0;
+  AnalysisTierStats hot;
+  AnalysisTierStats warm;
+  size_t warmRawBytes = 0;  // What the warm tier's blocks expand to
+  size_t coldHits = 0;
+  size_t misses = 0;
+  size_t promotions = 0;  // Warm to hot
+  size_t demotions = 0;   // Hot to warm
+  size_t evictions = 0;   // Dropped from warm, left to the cold tier
+};
+
+// Per-file analyses in three tiers, so a file dropped from memory costs a
+// decompression or a disk read rather than a parse:
+//   hot:  decoded FileAnalysis objects, ready to use;
+//   warm: the same, serialized and compressed with compressBlock;
+//   cold: the DiskParseCache, when one is set.
+// Entries are keyed by path and valid for the bytes they were computed from.
+// Analyses enter hot when computed and go down a tier when their tier is
+// over budget, least recently used first, except that an entry used more
+// than once since it was last passed over gets another round with its count
+// halved. A warm entry moves back to hot on its second use there, and a cold
+// hit enters warm as its first. Internally synchronized; encoding and
+// compression happen outside the lock.
+class AnalysisCache {
+ public:
+  explicit AnalysisCache(AnalysisCacheOptions options = {});
+
+  AnalysisCache(const AnalysisCache&) = delete;
+  AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+  void setOptions(const AnalysisCacheOptions& options);
+  AnalysisCacheOptions options() const;
+  void setCold(DiskParseCachePtr cold);
+  DiskParseCachePtr cold() const;
+
+  // The analysis of source as filePath, from the first tier that has it;
+  // null when none does.
+  std::shared_ptr<const FileAnalysis> get(const std::string& filePath, LanguageId language,
+                                          const SourceBuffer& source);
+  // Keeps analysis, just computed from source, hot and writes it to the cold
+  // tier. Views in analysis may point into source; the cache keeps copies.
+  void put(const std::string& filePath, LanguageId language, const SourceBuffer& source,
+           const FileAnalysis& analysis);
+  void erase(const std::string& filePath);
+  AnalysisCacheStats stats() const;
+
+ private:
+  enum class Tier : uint8_t { Hot, Warm };
+
+  struct Entry {
+    std::string filePath;
+    LanguageId language;
+    uint64_t contentHash;
+    size_t contentSize;
+    uint32_t uses;
+    Tier tier;
+    std::shared_ptr<const FileAnalysis> analysis{};  // Hot
+    std::string block{};                              // Warm, compressed
+    size_t rawSize = 0;                               // Warm, expanded
+    size_t bytes = 0;
+  };
+  using EntryList = std::list<Entry>;  // Most recently used at the front
+
+  mutable std::mutex mutex_;
+  AnalysisCacheOptions options_;
+  DiskParseCachePtr cold_;
+  EntryList hot_;
+  EntryList warm_;
+  size_t hotBytes_ = 0;
+  size_t warmBytes_ = 0;
+  size_t warmRawBytes_ = 0;
+  std::unordered_map<std::string, EntryList::iterator> entries_;
+  AnalysisCacheStats stats_;
+
+  // Caller holds mutex_.
+  void unlink(EntryList::iterator entry);
+  // Moves hot entries past the budget into demoted, to be compressed by demote().
+  void shrinkHot(std::vector<Entry>& demoted);
+  void shrinkWarm();
+  void insertWarm(Entry entry);
+
+  // Caller does not hold mutex_.
+  void demote(std::vector<Entry> demoted);
+};
+
+}  // namespace prism
+
+#endif  // ANALYSIS_CACHE_H
@@ -1,5 +1,6 @@
 #include <napi.h>
 #include "graph.h"
+#include "bindings.h"
 
 class ReferenceGraphWrapper : public Napi::ObjectWrap<ReferenceGraphWrapper> {
  public:
@@ -37,14 +38,6 @@ class ReferenceGraphWrapper : public Napi::ObjectWrap<ReferenceGraphWrapper> {
   Napi::Value GetStats(const Napi::CallbackInfo& info);
   Napi::Value Size(const Napi::CallbackInfo& info);
   void Clear(const Napi::CallbackInfo& info);
-
-  // Helpers
-  prism::Symbol JsToSymbol(Napi::Object obj);
-  Napi::Object SymbolToJs(Napi::Env env, const prism::Symbol& symbol);
-  prism::Reference JsToReference(Napi::Object obj);
-  Napi::Object ReferenceToJs(Napi::Env env, const prism::Reference& ref);
-  prism::FileData JsToFileData(Napi::Object obj);
-  prism::ImportEntry JsToImportEntry(Napi::Object obj);
 };
 
 Napi::Object ReferenceGraphWrapper::Init(Napi::Env env, Napi::Object exports) {
@@ -90,7 +83,7 @@ ReferenceGraphWrapper::~ReferenceGraphWrapper() {
 }
 
 // Helpers
-prism::Symbol ReferenceGraphWrapper::JsToSymbol(Napi::Object obj) {
+prism::Symbol JsToSymbol(Napi::Object obj) {
   prism::Symbol s;
   if (obj.Has("id")) s.id = obj.Get("id").As<Napi::String>().Utf8Value();
   if (obj.Has("name")) s.name = obj.Get("name").As<Napi::String>().Utf8Value();
@@ -98,13 +91,14 @@ prism::Symbol ReferenceGraphWrapper::JsToSymbol(Napi::Object obj) {
   if (obj.Has("filePath")) s.filePath = obj.Get("filePath").As<Napi::String>().Utf8Value();
   if (obj.Has("line")) s.line = obj.Get("line").As<Napi::Number>().Int32Value();
   if (obj.Has("column")) s.column = obj.Get("column").As<Napi::Number>().Int32Value();
+  if (obj.Has("endLine")) s.endLine = obj.Get("endLine").As<Napi::Number>().Int32Value();
   if (obj.Has("className")) s.className = obj.Get("className").As<Napi::String>().Utf8Value();
   if (obj.Has("isExported")) s.isExported = obj.Get("isExported").As<Napi::Boolean>().Value();
   if (obj.Has("isStatic")) s.isStatic = obj.Get("isStatic").As<Napi::Boolean>().Value();
   return s;
 }
 
-Napi::Object ReferenceGraphWrapper::SymbolToJs(Napi::Env env, const prism::Symbol& s) {
+Napi::Object SymbolToJs(Napi::Env env, const prism::Symbol& s) {
   Napi::Object obj = Napi::Object::New(env);
   obj.Set("id", s.id);
   obj.Set("name", s.name);
@@ -112,13 +106,15 @@ Napi::Object ReferenceGraphWrapper::SymbolToJs(Napi::Env env, const prism::Symbo
   obj.Set("filePath", s.filePath);
   obj.Set("line", s.line);
   obj.Set("column", s.column);
+  obj.Set("endLine", s.endLine);
   obj.Set("className", s.className);
   obj.Set("isExported", s.isExported);
   obj.Set("isStatic", s.isStatic);
+  obj.Set("flags", s.flags);
   return obj;
 }
 
-prism::Reference ReferenceGraphWrapper::JsToReference(Napi::Object obj) {
+prism::Reference JsToReference(Napi::Object obj) {
   prism::Reference r;
   if (obj.Has("id")) r.id = obj.Get("id").As<Napi::String>().Utf8Value();
   if (obj.Has("fromSymbolId")) r.fromSymbolId = obj.Get("fromSymbolId").As<Napi::String>().Utf8Value();
@@ -127,10 +123,13 @@ prism::Reference ReferenceGraphWrapper::JsToReference(Napi::Object obj) {
   if (obj.Has("filePath")) r.filePath = obj.Get("filePath").As<Napi::String>().Utf8Value();
   if (obj.Has("line")) r.line = obj.Get("line").As<Napi::Number>().Int32Value();
   if (obj.Has("column")) r.column = obj.Get("column").As<Napi::Number>().Int32Value();
+  if (obj.Has("name")) r.name = obj.Get("name").As<Napi::String>().Utf8Value();
+  if (obj.Get("receiverClass").IsString()) r.receiverClass = obj.Get("receiverClass").As<Napi::String>().Utf8Value();
+  if (obj.Get("superCall").IsBoolean()) r.superCall = obj.Get("superCall").As<Napi::Boolean>().Value();
   return r;
 }
 
-Napi::Object ReferenceGraphWrapper::ReferenceToJs(Napi::Env env, const prism::Reference& r) {
+Napi::Object ReferenceToJs(Napi::Env env, const prism::Reference& r) {
   Napi::Object obj = Napi::Object::New(env);
   obj.Set("id", r.id);
   obj.Set("fromSymbolId", r.fromSymbolId);
@@ -139,13 +138,33 @@ Napi::Object ReferenceGraphWrapper::ReferenceToJs(Napi::Env env, const prism::Re
   obj.Set("filePath", r.filePath);
   obj.Set("line", r.line);
   obj.Set("column", r.column);
+  if (!r.name.empty()) obj.Set("name", r.name);
+  if (!r.receiverClass.empty()) obj.Set("receiverClass", r.receiverClass);
+  if (r.superCall) obj.Set("superCall", true);
   return obj;
 }
 
-prism::ImportEntry ReferenceGraphWrapper::JsToImportEntry(Napi::Object obj) {
+prism::ClassBase JsToClassBase(Napi::Object obj) {
+  prism::ClassBase b;
+  if (obj.Has("classId")) b.classId = obj.Get("classId").As<Napi::String>().Utf8Value();
+  if (obj.Has("name")) b.name = obj.Get("name").As<Napi::String>().Utf8Value();
+  if (obj.Get("isImplements").IsBoolean()) b.isImplements = obj.Get("isImplements").As<Napi::Boolean>().Value();
+  return b;
+}
+
+Napi::Object ClassBaseToJs(Napi::Env env, const prism::ClassBase& b) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("classId", b.classId);
+  obj.Set("name", b.name);
+  obj.Set("isImplements", b.isImplements);
+  return obj;
+}
+
+prism::ImportEntry JsToImportEntry(Napi::Object obj) {
   prism::ImportEntry i;
   if (obj.Has("source")) i.source = obj.Get("source").As<Napi::String>().Utf8Value();
   if (obj.Has("isTypeOnly")) i.isTypeOnly = obj.Get("isTypeOnly").As<Napi::Boolean>().Value();
+  if (obj.Get("resolvedPath").IsString()) i.resolvedPath = obj.Get("resolvedPath").As<Napi::String>().Utf8Value();
   if (obj.Has("imported")) {
       Napi::Array arr = obj.Get("imported").As<Napi::Array>();
       for (uint32_t j = 0; j < arr.Length(); j++) {
@@ -155,7 +174,75 @@ prism::ImportEntry ReferenceGraphWrapper::JsToImportEntry(Napi::Object obj) {
   return i;
 }
 
-prism::FileData ReferenceGraphWrapper::JsToFileData(Napi::Object obj) {
+Napi::Object ImportEntryToJs(Napi::Env env, const prism::ImportEntry& i) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("source", i.source);
+  Napi::Array imported = Napi::Array::New(env, i.imported.size());
+  for (size_t j = 0; j < i.imported.size(); j++) {
+    imported.Set(j, i.imported[j]);
+  }
+  obj.Set("imported", imported);
+  obj.Set("isTypeOnly", i.isTypeOnly);
+  if (!i.resolvedPath.empty()) obj.Set("resolvedPath", i.resolvedPath);
+  return obj;
+}
+
+std::vector<std::string> JsToStrings(Napi::Array arr) {
+  std::vector<std::string> result;
+  result.reserve(arr.Length());
+  for (uint32_t j = 0; j < arr.Length(); j++) {
+    result.push_back(arr.Get(j).As<Napi::String>().Utf8Value());
+  }
+  return result;
+}
+
+Napi::Array StringsToJs(Napi::Env env, const std::vector<std::string>& strings) {
+  Napi::Array arr = Napi::Array::New(env, strings.size());
+  for (size_t j = 0; j < strings.size(); j++) {
+    arr.Set(j, strings[j]);
+  }
+  return arr;
+}
+
+// Accepts either a string (UTF-8 encoded here) or a Buffer of UTF-8 bytes.
+bool JsToSourceBytes(const Napi::Value& value, std::string& out) {
+  if (value.IsString()) {
+    out = value.As<Napi::String>().Utf8Value();
+    return true;
+  }
+  if (value.IsBuffer()) {
+    Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+    out.assign(buffer.Data(), buffer.Length());
+    return true;
+  }
+  return false;
+}
+
+// Like JsToSourceBytes, but a Buffer the addon handed out (readSource) is
+// used in place instead of copied.
+bool JsToSourceBuffer(const Napi::Value& value, prism::SourceBufferPtr& out) {
+  if (value.IsBuffer()) {
+    Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+    out = prism::findLoadedSource(buffer.Data(), buffer.Length());
+    if (out) return true;
+  }
+  std::string bytes;
+  if (!JsToSourceBytes(value, bytes)) return false;
+  out = prism::SourceBuffer::fromString(std::move(bytes));
+  return true;
+}
+
+// A Buffer viewing slice, which must lie within source. The view keeps source
+// alive; JS must treat it as read-only, since trees share the bytes.
+Napi::Value SourceSliceToJs(Napi::Env env, const prism::SourceBufferPtr& source, std::string_view slice) {
+  if (slice.empty()) return Napi::Buffer<char>::New(env, 0);
+  return Napi::Buffer<char>::New(
+      env, const_cast<char*>(slice.data()), slice.size(),
+      [](Napi::Env, char*, prism::SourceBufferPtr* hint) { delete hint; },
+      new prism::SourceBufferPtr(source));
+}
+
+prism::FileData JsToFileData(Napi::Object obj) {
   prism::FileData f;
   if (obj.Has("path")) f.path = obj.Get("path").As<Napi::String>().Utf8Value();
   if (obj.Has("symbols")) {
@@ -170,6 +257,18 @@ prism::FileData ReferenceGraphWrapper::JsToFileData(Napi::Object obj) {
           f.imports.push_back(JsToImportEntry(arr.Get(j).As<Napi::Object>()));
       }
   }
+  if (obj.Has("callSites")) {
+      Napi::Array arr = obj.Get("callSites").As<Napi::Array>();
+      for (uint32_t j = 0; j < arr.Length(); j++) {
+          f.callSites.push_back(JsToReference(arr.Get(j).As<Napi::Object>()));
+      }
+  }
+  if (obj.Get("bases").IsArray()) {
+      Napi::Array arr = obj.Get("bases").As<Napi::Array>();
+      for (uint32_t j = 0; j < arr.Length(); j++) {
+          f.bases.push_back(JsToClassBase(arr.Get(j).As<Napi::Object>()));
+      }
+  }
   return f;
 }
 
@@ -401,7 +500,11 @@ void ReferenceGraphWrapper::Clear(const Napi::CallbackInfo& info) {
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-  return ReferenceGraphWrapper::Init(env, exports);
+  ReferenceGraphWrapper::Init(env, exports);
+  InitSyntaxTree(env, exports);
+  InitExtractor(env, exports);
+  InitProjectIndex(env, exports);
+  return exports;
 }
 
 NODE_API_MODULE(graph, Init)
@@ -0,0 +1,31 @@
+#ifndef BINDINGS_H
+#define BINDINGS_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "source_buffer.h"
+
+// Conversions shared by every wrapper, defined in binding.cc.
+prism::Symbol JsToSymbol(Napi::Object obj);
+Napi::Object SymbolToJs(Napi::Env env, const prism::Symbol& symbol);
+prism::Reference JsToReference(Napi::Object obj);
+Napi::Object ReferenceToJs(Napi::Env env, const prism::Reference& ref);
+prism::ImportEntry JsToImportEntry(Napi::Object obj);
+Napi::Object ImportEntryToJs(Napi::Env env, const prism::ImportEntry& entry);
+prism::ClassBase JsToClassBase(Napi::Object obj);
+Napi::Object ClassBaseToJs(Napi::Env env, const prism::ClassBase& base);
+prism::FileData JsToFileData(Napi::Object obj);
+std::vector<std::string> JsToStrings(Napi::Array arr);
+Napi::Array StringsToJs(Napi::Env env, const std::vector<std::string>& strings);
+bool JsToSourceBytes(const Napi::Value& value, std::string& out);
+bool JsToSourceBuffer(const Napi::Value& value, prism::SourceBufferPtr& out);
+Napi::Value SourceSliceToJs(Napi::Env env, const prism::SourceBufferPtr& source, std::string_view slice);
+
+// Registration hooks for the wrapper classes that live outside binding.cc.
+Napi::Object InitSyntaxTree(Napi::Env env, Napi::Object exports);
+Napi::Object InitExtractor(Napi::Env env, Napi::Object exports);
+Napi::Object InitProjectIndex(Napi::Env env, Napi::Object exports);
+
+#endif  // BINDINGS_H
@@ -0,0 +1,109 @@
+#include "block_codec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace prism {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 0xffff;
+constexpr int kHashBits = 13;
+
+uint32_t load32(const char* at) {
+  uint32_t value;
+  std::memcpy(&value, at, sizeof(value));
+  return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Lengths of 15 or more spill into following bytes of 255 and a remainder.
+void putLength(std::string& out, size_t length) {
+  for (; length >= 255; length -= 255) out.push_back(static_cast<char>(255));
+  out.push_back(static_cast<char>(length));
+}
+
+void putSequence(std::string& out, std::string_view literals, size_t offset, size_t matchLength) {
+  size_t match = matchLength ? matchLength - kMinMatch : 0;
+  uint8_t token = static_cast<uint8_t>((std::min<size_t>(literals.size(), 15) << 4) |
+                                       std::min<size_t>(match, 15));
+  out.push_back(static_cast<char>(token));
+  if (literals.size() >= 15) putLength(out, literals.size() - 15);
+  out.append(literals);
+  if (!matchLength) return;
+  out.push_back(static_cast<char>(offset & 0xff));
+  out.push_back(static_cast<char>(offset >> 8));
+  if (match >= 15) putLength(out, match - 15);
+}
+
+bool getLength(std::string_view in, size_t& at, size_t& length) {
+  for (;;) {
+    if (at >= in.size()) return false;
+    uint8_t byte = static_cast<uint8_t>(in[at++]);
+    length += byte;
+    if (byte != 255) return true;
+  }
+}
+
+}  // namespace
+
+std::string compressBlock(std::string_view raw) {
+  std::string out;
+  out.reserve(raw.size() / 2 + 16);
+  std::vector<uint32_t> table(size_t(1) << kHashBits, 0);  // Position + 1, 0 for none
+  size_t anchor = 0;
+  size_t at = 0;
+  while (at + kMinMatch <= raw.size()) {
+    uint32_t sequence = load32(raw.data() + at);
+    uint32_t& slot = table[hashSequence(sequence)];
+    size_t candidate = slot;
+    slot = static_cast<uint32_t>(at + 1);
+    if (candidate == 0 || at - (candidate - 1) > kMaxOffset ||
+        load32(raw.data() + candidate - 1) != sequence) {
+      at++;
+      continue;
+    }
+    size_t from = candidate - 1;
+    size_t length = kMinMatch;
+    while (at + length < raw.size() && raw[from + length] == raw[at + length]) length++;
+    putSequence(out, raw.substr(anchor, at - anchor), at - from, length);
+    at += length;
+    anchor = at;
+  }
+  putSequence(out, raw.substr(anchor), 0, 0);
+  return out;
+}
+
+bool decompressBlock(std::string_view block, size_t rawSize, std::string& out) {
+  out.clear();
+  out.reserve(rawSize);
+  size_t at = 0;
+  while (at < block.size()) {
+    uint8_t token = static_cast<uint8_t>(block[at++]);
+    size_t literals = token >> 4;
+    if (literals == 15 && !getLength(block, at, literals)) return false;
+    if (literals > block.size() - at || literals > rawSize - out.size()) return false;
+    out.append(block.data() + at, literals);
+    at += literals;
+    if (at == block.size()) break;  // The last sequence has no match
+
+    if (block.size() - at < 2) return false;
+    size_t offset = static_cast<uint8_t>(block[at]) | (static_cast<uint8_t>(block[at + 1]) << 8);
+    at += 2;
+    size_t length = token & 15;
+    if (length == 15 && !getLength(block, at, length)) return false;
+    length += kMinMatch;
+    if (offset == 0 || offset > out.size() || length > rawSize - out.size()) return false;
+    // Matches may overlap what they copy, so go byte by byte.
+    size_t from = out.size() - offset;
+    for (size_t i = 0; i < length; i++) out.push_back(out[from + i]);
+  }
+  return out.size() == rawSize;
+}
+
+}  // namespace prism
@@ -0,0 +1,18 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <string>
+#include <string_view>
+
+namespace prism {
+
+// LZ77 block compression in the LZ4 block layout: fast enough to run on every
+// cache demotion, and effective on serialized analyses, which repeat ids,
+// kinds and names. Blocks carry no header; the caller keeps the raw size.
+std::string compressBlock(std::string_view raw);
+// False when block is corrupt or does not expand to exactly rawSize bytes.
+bool decompressBlock(std::string_view block, size_t rawSize, std::string& out);
+
+}  // namespace prism
+
+#endif  // BLOCK_CODEC_H
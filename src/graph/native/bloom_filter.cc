@@ -0,0 +1,41 @@
+#include "bloom_filter.h"
+#include "source_buffer.h"
+
+namespace prism {
+
+BloomFilter::Probe BloomFilter::probeFor(std::string_view key) {
+  // FNV-1a mixes poorly in the high bits; finish with splitmix64 before
+  // splitting into the two hashes used for double hashing.
+  uint64_t h = hashBytes(key.data(), key.size());
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return {static_cast<uint32_t>(h), static_cast<uint32_t>(h >> 32) | 1};
+}
+
+void BloomFilter::build(const std::vector<std::string_view>& keys) {
+  size_t wanted = keys.size() * kBitsPerKey;
+  size_t words = wanted < 64 ? 1 : (wanted + 63) / 64;
+  bits_.assign(words, 0);
+  bitCount_ = static_cast<uint32_t>(words * 64);
+  for (const auto& key : keys) {
+    Probe probe = probeFor(key);
+    for (uint32_t i = 0; i < kHashCount; i++) {
+      uint32_t bit = (probe.h1 + i * probe.h2) % bitCount_;
+      bits_[bit >> 6] |= 1ULL << (bit & 63);
+    }
+  }
+}
+
+bool BloomFilter::mayContain(const Probe& probe) const {
+  if (bits_.empty()) return true;
+  for (uint32_t i = 0; i < kHashCount; i++) {
+    uint32_t bit = (probe.h1 + i * probe.h2) % bitCount_;
+    if (!(bits_[bit >> 6] & (1ULL << (bit & 63)))) return false;
+  }
+  return true;
+}
+
+}  // namespace prism
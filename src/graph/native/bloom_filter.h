@@ -0,0 +1,37 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace prism {
+
+// Fixed-size Bloom filter over strings, sized at build time for ~1% false
+// positives. An empty (never built) filter answers "maybe" for everything.
+class BloomFilter {
+ public:
+  struct Probe {
+    uint32_t h1;
+    uint32_t h2;
+  };
+
+  static Probe probeFor(std::string_view key);
+
+  void build(const std::vector<std::string_view>& keys);
+  bool mayContain(const Probe& probe) const;
+  bool mayContain(std::string_view key) const { return mayContain(probeFor(key)); }
+  bool empty() const { return bits_.empty(); }
+  size_t sizeBytes() const { return bits_.size() * sizeof(uint64_t); }
+
+ private:
+  static constexpr uint32_t kHashCount = 7;
+  static constexpr uint32_t kBitsPerKey = 10;
+
+  std::vector<uint64_t> bits_;
+  uint32_t bitCount_ = 0;
+};
+
+}  // namespace prism
+
+#endif  // BLOOM_FILTER_H
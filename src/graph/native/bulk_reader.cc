@@ -0,0 +1,487 @@
+#include "bulk_reader.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define PRISM_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace prism {
+
+namespace {
+
+constexpr size_t kMaxReadThreads = 8;
+constexpr size_t kReadAhead = 256;  // Buffers a pool may hold ahead of the consumer
+
+// Always reads from disk: indexing wants current contents even when an older
+// buffer for the path is still alive.
+SourceBufferPtr readOne(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  SourceBufferPtr buffer;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    buffer = SourceBuffer::fromDescriptor(fd, static_cast<size_t>(st.st_size));
+    if (buffer) registerSource(path, buffer, st);
+  }
+  close(fd);
+  return buffer;
+}
+
+#ifdef PRISM_HAVE_IO_URING
+
+constexpr unsigned kRingEntries = 256;
+constexpr size_t kFilesInFlight = 64;  // Two SQEs each for open and statx, then one read
+
+// Minimal io_uring over the raw syscalls, so the addon needs no liburing.
+// Single-threaded: one instance per readFiles call.
+class IoUring {
+ public:
+  explicit IoUring(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) return;
+    if (!map(params) || !supports({IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ})) {
+      unmap();
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  ~IoUring() {
+    if (fd_ < 0) return;
+    unmap();
+    close(fd_);
+  }
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  bool ok() const { return fd_ >= 0; }
+
+  unsigned space() const {
+    return sqEntries_ - (localTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE));
+  }
+
+  // A zeroed SQE to fill, or null when the submission queue is full.
+  io_uring_sqe* next() {
+    if (space() == 0) return nullptr;
+    unsigned index = localTail_ & sqMask_;
+    sqArray_[index] = index;
+    localTail_++;
+    unsubmitted_++;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  // Submits queued SQEs and, when waitFor > 0, blocks for that many completions.
+  bool submit(unsigned waitFor) {
+    __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+    for (;;) {
+      long submitted = syscall(__NR_io_uring_enter, fd_, unsubmitted_, waitFor,
+                               waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+      if (submitted >= 0) {
+        unsubmitted_ -= static_cast<unsigned>(submitted);
+        inFlight_ += static_cast<unsigned>(submitted);
+        return true;
+      }
+      if (errno != EINTR) return false;
+    }
+  }
+
+  template <typename F>
+  void drain(F&& handle) {
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = cqes_[head & cqMask_];
+      inFlight_--;
+      handle(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+  }
+
+  // Waits out every submitted operation, so none still writes into memory the
+  // caller is about to free. SQEs that were never submitted are dropped.
+  template <typename F>
+  void settle(F&& handle) {
+    for (;;) {
+      drain(handle);
+      if (inFlight_ == 0) return;
+      // Waits without submitting; if the ring refuses even that, poll it
+      long waited = syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (waited < 0 && errno != EINTR) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+ private:
+  int fd_ = -1;
+  void* sqRing_ = MAP_FAILED;
+  void* cqRing_ = MAP_FAILED;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqRingSize_ = 0;
+  size_t cqRingSize_ = 0;
+  size_t sqesSize_ = 0;
+  unsigned* sqHead_ = nullptr;
+  unsigned* sqTail_ = nullptr;
+  unsigned* sqArray_ = nullptr;
+  unsigned sqMask_ = 0;
+  unsigned sqEntries_ = 0;
+  unsigned* cqHead_ = nullptr;
+  unsigned* cqTail_ = nullptr;
+  unsigned cqMask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned localTail_ = 0;
+  unsigned unsubmitted_ = 0;
+  unsigned inFlight_ = 0;  // Submitted, completion not yet drained
+
+  bool map(const io_uring_params& params) {
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                   IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) return false;
+    cqRing_ = single ? sqRing_
+                     : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    if (cqRing_ == MAP_FAILED) return false;
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) return false;
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqEntries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    localTail_ = *sqTail_;
+    return true;
+  }
+
+  void unmap() {
+    if (sqes_ != MAP_FAILED) munmap(sqes_, sqesSize_);
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+    if (sqRing_ != MAP_FAILED) munmap(sqRing_, sqRingSize_);
+    sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    cqRing_ = sqRing_ = MAP_FAILED;
+  }
+
+  // Operations need kernel support beyond io_uring itself (5.6 for open and statx).
+  bool supports(std::initializer_list<unsigned> ops) {
+    std::vector<char> storage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+    for (unsigned op : ops) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+    return true;
+  }
+};
+
+enum RingOp : uint64_t { kOpen = 0, kStat = 1, kRead = 2 };
+
+struct RingFile {
+  size_t index = 0;
+  int fd = -1;
+  int error = 0;
+  unsigned waiting = 0;  // Completions outstanding
+  bool reading = false;
+  struct statx stx;
+  std::string bytes;
+};
+
+struct stat statFromStatx(const struct statx& stx) {
+  struct stat st;
+  std::memset(&st, 0, sizeof(st));
+  st.st_dev = makedev(stx.stx_dev_major, stx.stx_dev_minor);
+  st.st_ino = stx.stx_ino;
+  st.st_mode = stx.stx_mode;
+  st.st_size = static_cast<off_t>(stx.stx_size);
+  st.st_mtim.tv_sec = stx.stx_mtime.tv_sec;
+  st.st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
+  return st;
+}
+
+void readWithIoUring(IoUring& ring, const std::vector<std::string>& paths,
+                     const ReadCallback& onRead, BulkReadStats& stats) {
+  std::vector<RingFile> files(std::min(kFilesInFlight, paths.size()));
+  std::vector<size_t> idle;
+  for (size_t slot = files.size(); slot-- > 0;) idle.push_back(slot);
+  std::vector<std::pair<size_t, SourceBufferPtr>> completed;
+  size_t next = 0;
+
+  auto userData = [](size_t slot, RingOp op) { return (static_cast<uint64_t>(slot) << 2) | op; };
+
+  auto finish = [&](size_t slot, SourceBufferPtr buffer) {
+    RingFile& file = files[slot];
+    if (file.fd >= 0) close(file.fd);
+    if (buffer) {
+      registerSource(paths[file.index], buffer, statFromStatx(file.stx));
+      stats.bytes += buffer->size();
+    } else {
+      stats.failed++;
+    }
+    completed.emplace_back(file.index, std::move(buffer));
+    file = RingFile();
+    idle.push_back(slot);
+  };
+
+  // Both the open and the statx are back: read the file.
+  auto opened = [&](size_t slot) {
+    RingFile& file = files[slot];
+    if (file.error || !S_ISREG(file.stx.stx_mode)) return finish(slot, nullptr);
+    size_t size = static_cast<size_t>(file.stx.stx_size);
+    io_uring_sqe* sqe = size >= UINT32_MAX ? nullptr : ring.next();
+    if (!sqe) return finish(slot, SourceBuffer::fromDescriptor(file.fd, size));
+    // One spare byte shows whether the file grew after the statx
+    file.bytes.resize(size + 1);
+    file.reading = true;
+    file.waiting = 1;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = file.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(file.bytes.data());
+    sqe->len = static_cast<uint32_t>(file.bytes.size());
+    sqe->off = 0;
+    sqe->user_data = userData(slot, kRead);
+  };
+
+  auto complete = [&](uint64_t data, int32_t result) {
+    size_t slot = static_cast<size_t>(data >> 2);
+    RingFile& file = files[slot];
+    file.waiting--;
+    switch (static_cast<RingOp>(data & 3)) {
+      case kOpen:
+        if (result < 0) file.error = -result;
+        else file.fd = result;
+        break;
+      case kStat:
+        if (result < 0) file.error = -result;
+        break;
+      case kRead:
+        if (result < 0) return finish(slot, nullptr);
+        if (static_cast<size_t>(result) == file.bytes.size()) {
+          // Grew after the statx; read it again from the start to EOF
+          return finish(slot, SourceBuffer::fromDescriptor(file.fd, file.bytes.size()));
+        }
+        file.bytes.resize(static_cast<size_t>(result));
+        return finish(slot, SourceBuffer::fromString(std::move(file.bytes)));
+    }
+    if (file.waiting == 0) opened(slot);
+  };
+
+  size_t active = 0;
+  while (next < paths.size() || active > 0) {
+    while (next < paths.size() && !idle.empty() && ring.space() >= 2) {
+      size_t slot = idle.back();
+      idle.pop_back();
+      RingFile& file = files[slot];
+      file.index = next;
+      file.waiting = 2;
+      const char* path = paths[next].c_str();
+
+      io_uring_sqe* openSqe = ring.next();
+      openSqe->opcode = IORING_OP_OPENAT;
+      openSqe->fd = AT_FDCWD;
+      openSqe->addr = reinterpret_cast<uint64_t>(path);
+      openSqe->open_flags = O_RDONLY | O_CLOEXEC;
+      openSqe->user_data = userData(slot, kOpen);
+
+      io_uring_sqe* statSqe = ring.next();
+      statSqe->opcode = IORING_OP_STATX;
+      statSqe->fd = AT_FDCWD;
+      statSqe->addr = reinterpret_cast<uint64_t>(path);
+      statSqe->len = STATX_BASIC_STATS;
+      statSqe->off = reinterpret_cast<uint64_t>(&file.stx);
+      statSqe->user_data = userData(slot, kStat);
+
+      next++;
+      active++;
+    }
+
+    if (!ring.submit(1)) {
+      // The ring failed mid-batch. Its reads target files, so wait for them
+      // before finishing everything still in flight directly; opens that
+      // complete meanwhile still hand over a descriptor to close.
+      ring.settle([&](uint64_t data, int32_t result) {
+        if ((data & 3) == kOpen && result >= 0) files[data >> 2].fd = result;
+      });
+      for (size_t slot = 0; slot < files.size(); slot++) {
+        if (std::find(idle.begin(), idle.end(), slot) != idle.end()) continue;
+        if (files[slot].fd >= 0) close(files[slot].fd);
+        files[slot].fd = -1;
+        SourceBufferPtr buffer = readOne(paths[files[slot].index]);
+        if (buffer) stats.bytes += buffer->size();
+        else stats.failed++;
+        completed.emplace_back(files[slot].index, std::move(buffer));
+      }
+      for (; next < paths.size(); next++) {
+        SourceBufferPtr buffer = readOne(paths[next]);
+        if (buffer) stats.bytes += buffer->size();
+        else stats.failed++;
+        completed.emplace_back(next, std::move(buffer));
+      }
+      active = 0;
+    } else {
+      size_t before = completed.size();
+      ring.drain(complete);
+      active -= completed.size() - before;
+      // Queue the reads just prepared before handing buffers to the parser.
+      if (!completed.empty()) ring.submit(0);
+    }
+
+    for (auto& [index, buffer] : completed) onRead(index, std::move(buffer));
+    completed.clear();
+  }
+}
+
+#endif  // PRISM_HAVE_IO_URING
+
+void readWithThreads(const std::vector<std::string>& paths, const ReadCallback& onRead,
+                     BulkReadStats& stats) {
+  std::mutex mutex;
+  std::condition_variable readyChanged;
+  std::condition_variable consumed;
+  std::deque<std::pair<size_t, SourceBufferPtr>> ready;
+  std::atomic<size_t> next{0};
+
+  size_t threadCount = std::min<size_t>(
+      paths.size(), std::clamp<size_t>(std::thread::hardware_concurrency(), 2, kMaxReadThreads));
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threadCount; t++) {
+    workers.emplace_back([&] {
+      for (size_t index; (index = next.fetch_add(1)) < paths.size();) {
+        SourceBufferPtr buffer = readOne(paths[index]);
+        std::unique_lock<std::mutex> lock(mutex);
+        consumed.wait(lock, [&] { return ready.size() < kReadAhead; });
+        ready.emplace_back(index, std::move(buffer));
+        readyChanged.notify_one();
+      }
+    });
+  }
+
+  std::deque<std::pair<size_t, SourceBufferPtr>> batch;
+  for (size_t delivered = 0; delivered < paths.size();) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      readyChanged.wait(lock, [&] { return !ready.empty(); });
+      batch.swap(ready);
+    }
+    consumed.notify_all();
+    for (auto& [index, buffer] : batch) {
+      if (buffer) stats.bytes += buffer->size();
+      else stats.failed++;
+      onRead(index, std::move(buffer));
+      delivered++;
+    }
+    batch.clear();
+  }
+  for (auto& worker : workers) worker.join();
+}
+
+void readSequentially(const std::vector<std::string>& paths, const ReadCallback& onRead,
+                      BulkReadStats& stats) {
+  for (size_t index = 0; index < paths.size(); index++) {
+    SourceBufferPtr buffer = readOne(paths[index]);
+    if (buffer) stats.bytes += buffer->size();
+    else stats.failed++;
+    onRead(index, std::move(buffer));
+  }
+}
+
+}  // namespace
+
+const char* readBackendName(ReadBackend backend) {
+  switch (backend) {
+    case ReadBackend::IoUring:
+      return "io_uring";
+    case ReadBackend::Threads:
+      return "threads";
+    case ReadBackend::Sequential:
+      return "sequential";
+    default:
+      return "auto";
+  }
+}
+
+ReadBackend readBackendFromName(const std::string& name) {
+  if (name == "io_uring") return ReadBackend::IoUring;
+  if (name == "threads") return ReadBackend::Threads;
+  if (name == "sequential") return ReadBackend::Sequential;
+  return ReadBackend::Auto;
+}
+
+bool ioUringAvailable() {
+#ifdef PRISM_HAVE_IO_URING
+  // Containers and hardened kernels often refuse io_uring_setup outright.
+  static const bool available = IoUring(4).ok();
+  return available;
+#else
+  return false;
+#endif
+}
+
+BulkReadStats readFiles(const std::vector<std::string>& paths, const ReadCallback& onRead,
+                        ReadBackend backend) {
+  auto start = std::chrono::steady_clock::now();
+  BulkReadStats stats;
+  stats.files = paths.size();
+  if (backend == ReadBackend::Auto) {
+    backend = ioUringAvailable() ? ReadBackend::IoUring
+              : paths.size() > 1 ? ReadBackend::Threads
+                                 : ReadBackend::Sequential;
+  }
+
+#ifdef PRISM_HAVE_IO_URING
+  if (backend == ReadBackend::IoUring) {
+    IoUring ring(kRingEntries);
+    if (ring.ok()) {
+      stats.backend = ReadBackend::IoUring;
+      readWithIoUring(ring, paths, onRead, stats);
+    } else {
+      backend = ReadBackend::Threads;
+    }
+  }
+#else
+  if (backend == ReadBackend::IoUring) backend = ReadBackend::Threads;
+#endif
+  if (backend == ReadBackend::Threads && !paths.empty()) {
+    stats.backend = ReadBackend::Threads;
+    readWithThreads(paths, onRead, stats);
+  } else if (backend != ReadBackend::IoUring) {
+    stats.backend = ReadBackend::Sequential;
+    readSequentially(paths, onRead, stats);
+  }
+
+  stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+}  // namespace prism
@@ -0,0 +1,43 @@
+#ifndef BULK_READER_H
+#define BULK_READER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "source_buffer.h"
+
+namespace prism {
+
+enum class ReadBackend { Auto, IoUring, Threads, Sequential };
+
+const char* readBackendName(ReadBackend backend);
+// Auto for unrecognized names.
+ReadBackend readBackendFromName(const std::string& name);
+// Whether this kernel lets the process set up an io_uring with the open,
+// statx and read operations. Checked once.
+bool ioUringAvailable();
+
+struct BulkReadStats {
+  ReadBackend backend = ReadBackend::Sequential;
+  size_t files = 0;
+  size_t failed = 0;
+  size_t bytes = 0;
+  double ms = 0;
+};
+
+// Called on the reading thread for each file, in completion order; source is
+// null when the file could not be read.
+using ReadCallback = std::function<void(size_t index, SourceBufferPtr source)>;
+
+// Loads every path with many reads in flight, handing each buffer to onRead
+// as soon as it completes, so the caller parses while later files are still
+// being read. IoUring submits open, statx and read for a window of files at
+// once; Threads reads on a small pool with bounded read-ahead; Auto picks
+// IoUring when available. Buffers are registered for loadSource to share.
+BulkReadStats readFiles(const std::vector<std::string>& paths, const ReadCallback& onRead,
+                        ReadBackend backend = ReadBackend::Auto);
+
+}  // namespace prism
+
+#endif  // BULK_READER_H
@@ -0,0 +1,396 @@
+#include "config_scanner.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "source_buffer.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace prism {
+
+namespace {
+
+constexpr size_t kMaxCachedScans = 4096;
+
+inline bool isWordByte(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool isDottedWordByte(unsigned char c) { return isWordByte(c) || c == '.'; }
+
+// Regex \s over ASCII
+inline bool isSpaceByte(unsigned char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+#if defined(__SSE2__)
+inline __m128i inRange(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+inline unsigned lowestBit(unsigned mask) { return static_cast<unsigned>(__builtin_ctz(mask)); }
+#endif
+
+// Offset of the first byte at or after pos equal to a or b, or size.
+size_t findEither(std::string_view s, size_t pos, char a, char b) {
+  const char* data = s.data();
+  size_t n = s.size();
+#if defined(__SSE2__)
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+  while (pos + 16 <= n) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    unsigned mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb))));
+    if (mask != 0) return pos + lowestBit(mask);
+    pos += 16;
+  }
+#endif
+  for (; pos < n; pos++) {
+    if (data[pos] == a || data[pos] == b) return pos;
+  }
+  return n;
+}
+
+// Length of the run of [A-Za-z0-9_.] starting at pos.
+size_t spanDottedWord(std::string_view s, size_t pos) {
+  const char* data = s.data();
+  size_t n = s.size();
+  size_t i = pos;
+#if defined(__SSE2__)
+  const __m128i caseBit = _mm_set1_epi8(0x20);
+  const __m128i underscore = _mm_set1_epi8('_');
+  const __m128i dot = _mm_set1_epi8('.');
+  while (i + 16 <= n) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Setting 0x20 folds A-Z onto a-z and maps nothing else into that range
+    __m128i letters = inRange(_mm_or_si128(v, caseBit), 'a', 'z');
+    __m128i digits = inRange(v, '0', '9');
+    __m128i marks = _mm_or_si128(_mm_cmpeq_epi8(v, underscore), _mm_cmpeq_epi8(v, dot));
+    unsigned mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), marks)));
+    if (mask != 0xFFFF) return i + lowestBit(~mask & 0xFFFF) - pos;
+    i += 16;
+  }
+#endif
+  while (i < n && isDottedWordByte(static_cast<unsigned char>(data[i]))) i++;
+  return i - pos;
+}
+
+size_t skipSpaces(std::string_view s, size_t pos) {
+  while (pos < s.size() && isSpaceByte(static_cast<unsigned char>(s[pos]))) pos++;
+  return pos;
+}
+
+// Text after the last '.', or empty when there is no dot.
+std::string_view lastSegment(std::string_view path) {
+  size_t dot = path.rfind('.');
+  if (dot == std::string_view::npos) return std::string_view();
+  return path.substr(dot + 1);
+}
+
+// Offsets only move forward, so line and column are counted incrementally.
+class LineCounter {
+ public:
+  explicit LineCounter(std::string_view source) : source_(source) {}
+
+  void locate(size_t offset, uint32_t& line, uint32_t& column) {
+    for (; scanned_ < offset; scanned_++) {
+      if (source_[scanned_] == '\n') {
+        line_++;
+        lineStart_ = scanned_ + 1;
+      }
+    }
+    line = line_;
+    column = static_cast<uint32_t>(offset - lineStart_);
+  }
+
+ private:
+  std::string_view source_;
+  size_t scanned_ = 0;
+  size_t lineStart_ = 0;
+  uint32_t line_ = 1;
+};
+
+class ReferenceCollector {
+ public:
+  explicit ReferenceCollector(std::string_view source) : lines_(source) {}
+
+  void add(std::string_view name, size_t offset) {
+    if (name.empty() || !seen_.insert(std::string(name)).second) return;
+    ConfigReference ref;
+    ref.name = std::string(name);
+    lines_.locate(offset, ref.line, ref.column);
+    refs_.push_back(std::move(ref));
+  }
+
+  std::vector<ConfigReference> take() { return std::move(refs_); }
+
+ private:
+  LineCounter lines_;
+  std::unordered_set<std::string> seen_;
+  std::vector<ConfigReference> refs_;
+};
+
+// Calls visit(offset, text) for every match of /['"]([\w.]+)['"]/g, with the
+// offset of the opening quote. Quotes need not match, as in the regex.
+template <typename Visit>
+void forEachQuotedPath(std::string_view s, Visit visit) {
+  size_t pos = 0;
+  while (true) {
+    size_t quote = findEither(s, pos, '"', '\'');
+    if (quote >= s.size()) return;
+    size_t length = spanDottedWord(s, quote + 1);
+    size_t close = quote + 1 + length;
+    if (length > 0 && close < s.size() && (s[close] == '"' || s[close] == '\'')) {
+      visit(quote, s.substr(quote + 1, length));
+      pos = close + 1;
+    } else {
+      pos = quote + 1;
+    }
+  }
+}
+
+bool startsWithAt(std::string_view s, size_t pos, std::string_view word) {
+  return s.compare(pos, word.size(), word) == 0;
+}
+
+// Modules from /from\s+([\w.]+)\s+import|import\s+([\w.]+)/g. Like the regex
+// there are no word boundaries, and a matched from-import resumes after
+// "import".
+std::unordered_set<std::string> scanPythonImports(std::string_view s) {
+  std::unordered_set<std::string> imports;
+  auto addModule = [&](std::string_view module) {
+    if (module.empty() || module[0] == '.' || module.find('.') == std::string_view::npos) return;
+    std::string_view className = lastSegment(module);
+    if (!className.empty()) imports.insert(std::string(className));
+  };
+
+  size_t pos = 0;
+  while (true) {
+    pos = findEither(s, pos, 'f', 'i');
+    if (pos >= s.size()) break;
+
+    if (startsWithAt(s, pos, "from")) {
+      size_t moduleStart = skipSpaces(s, pos + 4);
+      size_t length = moduleStart > pos + 4 ? spanDottedWord(s, moduleStart) : 0;
+      size_t keyword = skipSpaces(s, moduleStart + length);
+      if (length > 0 && keyword > moduleStart + length && startsWithAt(s, keyword, "import")) {
+        addModule(s.substr(moduleStart, length));
+        pos = keyword + 6;
+        continue;
+      }
+    }
+    if (startsWithAt(s, pos, "import")) {
+      size_t moduleStart = skipSpaces(s, pos + 6);
+      size_t length = moduleStart > pos + 6 ? spanDottedWord(s, moduleStart) : 0;
+      if (length > 0) {
+        addModule(s.substr(moduleStart, length));
+        pos = moduleStart + length;
+        continue;
+      }
+    }
+    pos++;
+  }
+  return imports;
+}
+
+void scanPython(std::string_view s, ReferenceCollector& out) {
+  std::unordered_set<std::string> imports = scanPythonImports(s);
+  forEachQuotedPath(s, [&](size_t offset, std::string_view path) {
+    std::string_view className = lastSegment(path);
+    if (className.empty()) return;
+    if (imports.count(std::string(className)) || path.compare(0, 4, "app.") == 0 ||
+        path.find("logging.") != std::string_view::npos ||
+        path.find("middleware.") != std::string_view::npos ||
+        path.find("core.") != std::string_view::npos ||
+        path.find("filters.") != std::string_view::npos) {
+      out.add(className, offset);
+    }
+  });
+}
+
+void scanYaml(std::string_view s, ReferenceCollector& out) {
+  forEachQuotedPath(s, [&](size_t offset, std::string_view path) {
+    out.add(lastSegment(path), offset);
+  });
+}
+
+void appendUtf8(std::string& out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out.push_back(static_cast<char>(codePoint));
+  } else if (codePoint < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else if (codePoint < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+}
+
+bool readHex4(std::string_view s, size_t pos, uint32_t& value) {
+  if (pos + 4 > s.size()) return false;
+  value = 0;
+  for (size_t i = pos; i < pos + 4; i++) {
+    char c = s[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+    else return false;
+  }
+  return true;
+}
+
+// Decodes the JSON string whose opening quote is at quote. Returns the offset
+// past the closing quote, or npos when the string is unterminated.
+size_t readJsonString(std::string_view s, size_t quote, std::string& out) {
+  out.clear();
+  size_t pos = quote + 1;
+  while (true) {
+    size_t stop = findEither(s, pos, '"', '\\');
+    if (stop >= s.size()) return std::string_view::npos;
+    out.append(s.data() + pos, stop - pos);
+    if (s[stop] == '"') return stop + 1;
+
+    if (stop + 1 >= s.size()) return std::string_view::npos;
+    char escape = s[stop + 1];
+    pos = stop + 2;
+    switch (escape) {
+      case 'n': out.push_back('\n'); break;
+      case 't': out.push_back('\t'); break;
+      case 'r': out.push_back('\r'); break;
+      case 'b': out.push_back('\b'); break;
+      case 'f': out.push_back('\f'); break;
+      case 'u': {
+        uint32_t unit;
+        if (!readHex4(s, pos, unit)) return std::string_view::npos;
+        pos += 4;
+        uint32_t low;
+        if (unit >= 0xD800 && unit < 0xDC00 && startsWithAt(s, pos, "\\u") &&
+            readHex4(s, pos + 2, low) && low >= 0xDC00 && low < 0xE000) {
+          unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+          pos += 6;
+        }
+        appendUtf8(out, unit);
+        break;
+      }
+      default: out.push_back(escape); break;
+    }
+  }
+}
+
+// Every string value (object keys excluded) containing a dot. Outside string
+// literals a '"' always opens one, so only string bodies are walked. Unlike
+// JSON.parse, a malformed document is scanned up to the first bad string.
+void scanJson(std::string_view s, ReferenceCollector& out) {
+  std::string value;
+  size_t pos = 0;
+  while (true) {
+    size_t quote = findEither(s, pos, '"', '"');
+    if (quote >= s.size()) return;
+    size_t end = readJsonString(s, quote, value);
+    if (end == std::string_view::npos) return;
+    pos = end;
+
+    size_t next = skipSpaces(s, end);
+    if (next < s.size() && s[next] == ':') continue;
+    out.add(lastSegment(value), quote);
+  }
+}
+
+}  // namespace
+
+ConfigFormat configFormatForPath(const std::string& filePath) {
+  size_t slash = filePath.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? filePath : filePath.substr(slash + 1);
+  std::transform(name.begin(), name.end(), name.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  size_t dot = name.rfind('.');
+  if (dot == std::string::npos) return ConfigFormat::None;
+  std::string ext = name.substr(dot + 1);
+  std::string stem = name.substr(0, dot);
+
+  if (ext == "py") return ConfigFormat::Python;
+  if (ext == "js" || ext == "ts") return ConfigFormat::Script;
+
+  auto endsWith = [&](const std::string& suffix) {
+    return stem.size() >= suffix.size() &&
+           stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  if (!endsWith("config") && !endsWith("settings")) return ConfigFormat::None;
+  if (ext == "json") return ConfigFormat::Json;
+  if (ext == "yaml" || ext == "yml") return ConfigFormat::Yaml;
+  return ConfigFormat::None;
+}
+
+std::vector<ConfigReference> scanConfigReferences(std::string_view source, ConfigFormat format) {
+  ReferenceCollector out(source);
+  switch (format) {
+    case ConfigFormat::Python: scanPython(source, out); break;
+    case ConfigFormat::Json: scanJson(source, out); break;
+    case ConfigFormat::Yaml: scanYaml(source, out); break;
+    // The JS/TS helper only keeps names imported from module paths containing
+    // '/', which its [\w.]+ module pattern can never match.
+    case ConfigFormat::Script:
+    case ConfigFormat::None: break;
+  }
+  return out.take();
+}
+
+namespace {
+
+struct ConfigScanCache {
+  std::mutex mutex;
+  std::unordered_map<uint64_t, std::shared_ptr<const std::vector<ConfigReference>>> entries;
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+ConfigScanCache& configScanCache() {
+  static ConfigScanCache cache;
+  return cache;
+}
+
+}  // namespace
+
+std::shared_ptr<const std::vector<ConfigReference>> scanConfigReferencesCached(
+    std::string_view source, ConfigFormat format) {
+  uint64_t key = hashBytes(source.data(), source.size()) * 31 + static_cast<uint64_t>(format);
+  ConfigScanCache& cache = configScanCache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+      cache.hits++;
+      return it->second;
+    }
+    cache.misses++;
+  }
+
+  auto refs = std::make_shared<const std::vector<ConfigReference>>(scanConfigReferences(source, format));
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.entries.size() >= kMaxCachedScans) cache.entries.clear();
+  cache.entries.emplace(key, refs);
+  return refs;
+}
+
+ConfigScanCacheStats configScanCacheStats() {
+  ConfigScanCache& cache = configScanCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return {cache.entries.size(), cache.hits, cache.misses};
+}
+
+}  // namespace prism
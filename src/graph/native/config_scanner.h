@@ -0,0 +1,48 @@
+#ifndef CONFIG_SCANNER_H
+#define CONFIG_SCANNER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prism {
+
+// Source id of the edges from configuration files to the classes they name.
+constexpr const char* kConfigRootId = "config";
+
+enum class ConfigFormat { None, Python, Json, Script, Yaml };
+
+// Format to scan a file as, or None when find_dead_code would not read it for
+// config references: .py/.js/.ts always, JSON and YAML only when named like a
+// config or settings file.
+ConfigFormat configFormatForPath(const std::string& filePath);
+
+struct ConfigReference {
+  std::string name;  // Last segment of the dotted path
+  uint32_t line;     // 1-based, of the string literal or import
+  uint32_t column;
+};
+
+// Class names referenced by dotted paths in a config file, first occurrence of
+// each name only. Same rules as the regex helpers in find_dead_code.ts, found
+// with a single left-to-right pass over SIMD character-class spans.
+std::vector<ConfigReference> scanConfigReferences(std::string_view source, ConfigFormat format);
+
+// scanConfigReferences memoized by content hash and format. Shared by every
+// thread; entries are immutable once inserted.
+std::shared_ptr<const std::vector<ConfigReference>> scanConfigReferencesCached(
+    std::string_view source, ConfigFormat format);
+
+struct ConfigScanCacheStats {
+  size_t entries;
+  size_t hits;
+  size_t misses;
+};
+
+ConfigScanCacheStats configScanCacheStats();
+
+}  // namespace prism
+
+#endif  // CONFIG_SCANNER_H
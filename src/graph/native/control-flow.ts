@@ -0,0 +1,49 @@
+import { addon } from './addon.js';
+
+export type ControlFlowNodeType = 'entry' | 'exit' | 'normal' | 'condition' | 'loop' | 'exception';
+
+export interface ControlFlowNode {
+  /** `block_<n>`; block_0 is the entry and block_1 the exit. */
+  id: string;
+  type: ControlFlowNodeType;
+  label: string;
+  statements: string[];
+  /** Set when no path from the entry reaches the block. */
+  unreachable?: boolean;
+}
+
+export interface ControlFlowEdge {
+  from: string;
+  to: string;
+  label?: 'true' | 'false' | 'exception' | 'back';
+}
+
+export interface NativeControlFlowGraph {
+  nodes: ControlFlowNode[];
+  edges: ControlFlowEdge[];
+}
+
+export interface ControlFlowCacheStats {
+  entries: number;
+  hits: number;
+  misses: number;
+}
+
+/**
+ * Control-flow graph of the first function, method or function-valued variable
+ * named functionName, built natively from the tree-sitter tree. Graphs are
+ * cached by file, function and content hash, so unchanged files are not
+ * re-parsed. Returns null when the function is not found or the file type is
+ * unsupported.
+ */
+export function buildControlFlow(
+  source: string | Buffer,
+  filePath: string,
+  functionName: string
+): NativeControlFlowGraph | null {
+  return addon.buildControlFlow(source, filePath, functionName);
+}
+
+export function controlFlowCacheStats(): ControlFlowCacheStats {
+  return addon.controlFlowCacheStats();
+}
@@ -0,0 +1,804 @@
+#include "control_flow.h"
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include "tree_cache.h"
+
+namespace prism {
+
+namespace {
+
+constexpr uint32_t kNoBlock = UINT32_MAX;
+constexpr uint32_t kEntryBlock = 0;
+constexpr uint32_t kExitBlock = 1;
+constexpr size_t kMaxCachedGraphs = 4096;
+
+enum class FlowKind : uint8_t {
+  Other,
+  Comment,
+  Block,
+  Function,  // Declarations that can be looked up by name
+  VariableDeclarator,
+  FunctionValue,
+  If,
+  ElseClause,
+  ElifClause,
+  For,    // C-style
+  ForIn,  // for-in/of, Python for
+  While,
+  Do,
+  Try,
+  CatchClause,  // catch_clause, except_clause, except_group_clause
+  FinallyClause,
+  Switch,
+  SwitchDefault,
+  Return,
+  Throw,
+  Break,
+  Continue,
+  Labeled,
+  With,
+  ParenthesizedExpression,
+};
+
+FlowKind kindForType(const char* type, bool python) {
+  if (!strcmp(type, "comment")) return FlowKind::Comment;
+  if (!strcmp(type, "statement_block") || !strcmp(type, "block")) return FlowKind::Block;
+  if (!strcmp(type, "function_declaration") || !strcmp(type, "generator_function_declaration") ||
+      !strcmp(type, "function_definition") || !strcmp(type, "method_definition")) {
+    return FlowKind::Function;
+  }
+  if (!strcmp(type, "variable_declarator")) return FlowKind::VariableDeclarator;
+  if (!strcmp(type, "arrow_function") || !strcmp(type, "function_expression") ||
+      !strcmp(type, "function") || !strcmp(type, "generator_function")) {
+    return FlowKind::FunctionValue;
+  }
+  if (!strcmp(type, "if_statement")) return FlowKind::If;
+  if (!strcmp(type, "else_clause")) return FlowKind::ElseClause;
+  if (!strcmp(type, "elif_clause")) return FlowKind::ElifClause;
+  if (!strcmp(type, "for_statement")) return python ? FlowKind::ForIn : FlowKind::For;
+  if (!strcmp(type, "for_in_statement")) return FlowKind::ForIn;
+  if (!strcmp(type, "while_statement")) return FlowKind::While;
+  if (!strcmp(type, "do_statement")) return FlowKind::Do;
+  if (!strcmp(type, "try_statement")) return FlowKind::Try;
+  if (!strcmp(type, "catch_clause") || !strcmp(type, "except_clause") ||
+      !strcmp(type, "except_group_clause")) {
+    return FlowKind::CatchClause;
+  }
+  if (!strcmp(type, "finally_clause")) return FlowKind::FinallyClause;
+  if (!strcmp(type, "switch_statement")) return FlowKind::Switch;
+  if (!strcmp(type, "switch_default")) return FlowKind::SwitchDefault;
+  if (!strcmp(type, "return_statement")) return FlowKind::Return;
+  if (!strcmp(type, "throw_statement") || !strcmp(type, "raise_statement")) return FlowKind::Throw;
+  if (!strcmp(type, "break_statement")) return FlowKind::Break;
+  if (!strcmp(type, "continue_statement")) return FlowKind::Continue;
+  if (!strcmp(type, "labeled_statement")) return FlowKind::Labeled;
+  if (!strcmp(type, "with_statement")) return FlowKind::With;
+  if (!strcmp(type, "parenthesized_expression")) return FlowKind::ParenthesizedExpression;
+  return FlowKind::Other;
+}
+
+// Node kinds indexed by grammar symbol, so the walk never compares type strings.
+std::vector<FlowKind> kindTables[3];
+std::once_flag kindTableFlags[3];
+
+const std::vector<FlowKind>& kindTableFor(LanguageId language) {
+  auto index = static_cast<size_t>(language);
+  std::call_once(kindTableFlags[index], [language, index]() {
+    const TSLanguage* tsLanguage = tsLanguageFor(language);
+    uint32_t count = ts_language_symbol_count(tsLanguage);
+    std::vector<FlowKind>& table = kindTables[index];
+    table.resize(count, FlowKind::Other);
+    for (uint32_t symbol = 0; symbol < count; symbol++) {
+      const char* name = ts_language_symbol_name(tsLanguage, static_cast<TSSymbol>(symbol));
+      if (name) table[symbol] = kindForType(name, language == LanguageId::Python);
+    }
+  });
+  return kindTables[index];
+}
+
+TSNode field(TSNode node, const char* name) {
+  return ts_node_child_by_field_name(node, name, static_cast<uint32_t>(strlen(name)));
+}
+
+// A block end that still has to be connected to whatever runs next.
+struct Dangling {
+  uint32_t block;
+  CfgEdgeLabel label;
+};
+
+using Ends = std::vector<Dangling>;
+
+struct PendingBlock {
+  CfgBlockKind kind;
+  bool open;  // Straight-line statements may still be appended
+  const char* fixedLabel;
+  uint32_t labelStart = 0;
+  uint32_t labelEnd = 0;
+  std::vector<CfgStatement> statements;
+};
+
+// Target of break and continue statements.
+struct JumpContext {
+  std::string_view label;   // Statement label, empty when unlabeled
+  bool breakable;           // Loops and switches; unlabeled break targets these
+  uint32_t continueTarget;  // kNoBlock for switches and labeled blocks
+  CfgEdgeLabel continueLabel;
+  Ends breaks;
+};
+
+class CfgBuilder {
+ public:
+  explicit CfgBuilder(const SyntaxTree& tree)
+      : tree_(tree), kinds_(kindTableFor(tree.language())) {}
+
+  TSNode findFunction(std::string_view name) const {
+    TSTreeCursor cursor = ts_tree_cursor_new(tree_.root());
+    TSNode found = {};
+    bool done = false;
+    while (!done) {
+      TSNode node = ts_tree_cursor_current_node(&cursor);
+      if (ts_node_is_named(node) && matchesName(node, name, found)) break;
+      if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+      while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+        if (!ts_tree_cursor_goto_parent(&cursor)) {
+          done = true;
+          break;
+        }
+      }
+    }
+    ts_tree_cursor_delete(&cursor);
+    return found;
+  }
+
+  ControlFlowGraphPtr build(TSNode function, std::string_view name) {
+    newBlock(CfgBlockKind::Entry, "Start");
+    newBlock(CfgBlockKind::Exit, "End");
+
+    TSNode body = field(function, "body");
+    if (ts_node_is_null(body)) {
+      addEdge(kEntryBlock, kExitBlock, CfgEdgeLabel::None);
+    } else if (kindOf(body) != FlowKind::Block) {
+      // Expression-bodied arrow function
+      uint32_t block = newBlock(CfgBlockKind::Normal, "Body");
+      addEdge(kEntryBlock, block, CfgEdgeLabel::None);
+      addStatement(block, body);
+      addEdge(block, kExitBlock, CfgEdgeLabel::None);
+    } else {
+      uint32_t start = newBlock(CfgBlockKind::Normal, "Body Start");
+      addEdge(kEntryBlock, start, CfgEdgeLabel::None);
+      connect(statements(body, {{start, CfgEdgeLabel::None}}), kExitBlock);
+    }
+    return finish(function, name);
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  const std::vector<FlowKind>& kinds_;
+  std::vector<PendingBlock> blocks_;
+  std::vector<CfgEdge> edges_;
+  std::vector<JumpContext> jumps_;
+  std::vector<const std::vector<uint32_t>*> handlers_;  // Innermost last
+  std::string_view pendingLabel_;
+
+  FlowKind kindOf(TSNode node) const {
+    TSSymbol symbol = ts_node_symbol(node);
+    return symbol < kinds_.size() ? kinds_[symbol] : FlowKind::Other;
+  }
+
+  bool matchesName(TSNode node, std::string_view name, TSNode& found) const {
+    FlowKind kind = kindOf(node);
+    if (kind == FlowKind::Function) {
+      TSNode nameNode = field(node, "name");
+      if (!ts_node_is_null(nameNode) && tree_.text(nameNode) == name) {
+        found = node;
+        return true;
+      }
+    } else if (kind == FlowKind::VariableDeclarator) {
+      TSNode nameNode = field(node, "name");
+      TSNode value = field(node, "value");
+      if (!ts_node_is_null(nameNode) && !ts_node_is_null(value) &&
+          kindOf(value) == FlowKind::FunctionValue && tree_.text(nameNode) == name) {
+        found = value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint32_t newBlock(CfgBlockKind kind, const char* label) {
+    PendingBlock block;
+    block.kind = kind;
+    block.open = kind == CfgBlockKind::Normal;
+    block.fixedLabel = label;
+    blocks_.push_back(std::move(block));
+    return static_cast<uint32_t>(blocks_.size() - 1);
+  }
+
+  // Label is the node's text, trimmed of whitespace and header punctuation.
+  uint32_t newBlock(CfgBlockKind kind, uint32_t labelStart, uint32_t labelEnd,
+                    const char* fallback) {
+    uint32_t id = newBlock(kind, fallback);
+    std::string_view source = tree_.source()->view();
+    while (labelStart < labelEnd && std::isspace(static_cast<unsigned char>(source[labelStart]))) {
+      labelStart++;
+    }
+    while (labelEnd > labelStart && (std::isspace(static_cast<unsigned char>(source[labelEnd - 1])) ||
+                                     strchr(";:{", source[labelEnd - 1]))) {
+      labelEnd--;
+    }
+    if (labelStart < labelEnd) {
+      blocks_[id].fixedLabel = nullptr;
+      blocks_[id].labelStart = labelStart;
+      blocks_[id].labelEnd = labelEnd;
+    }
+    return id;
+  }
+
+  uint32_t newBlock(CfgBlockKind kind, TSNode labelNode, const char* fallback) {
+    if (ts_node_is_null(labelNode)) return newBlock(kind, fallback);
+    if (kindOf(labelNode) == FlowKind::ParenthesizedExpression &&
+        ts_node_named_child_count(labelNode) > 0) {
+      labelNode = ts_node_named_child(labelNode, 0);
+    }
+    return newBlock(kind, ts_node_start_byte(labelNode), ts_node_end_byte(labelNode), fallback);
+  }
+
+  void addEdge(uint32_t from, uint32_t to, CfgEdgeLabel label) {
+    edges_.push_back({from, to, label});
+  }
+
+  void connect(const Ends& ends, uint32_t to) {
+    for (const Dangling& end : ends) {
+      addEdge(end.block, to, end.label);
+      blocks_[end.block].open = false;
+    }
+  }
+
+  // Ends of a compound statement never take the statements that follow it.
+  Ends seal(Ends ends) {
+    for (const Dangling& end : ends) blocks_[end.block].open = false;
+    return ends;
+  }
+
+  void addStatement(uint32_t block, uint32_t startByte, uint32_t endByte, TSPoint start) {
+    blocks_[block].statements.push_back({startByte, endByte, start.row + 1});
+  }
+
+  void addStatement(uint32_t block, TSNode node) {
+    addStatement(block, ts_node_start_byte(node), ts_node_end_byte(node), ts_node_start_point(node));
+  }
+
+  // Block that straight-line code continues in: the single open predecessor,
+  // or a new join block. Code after a return or throw gets a block with no
+  // predecessors.
+  uint32_t openBlock(Ends& ends) {
+    if (ends.size() == 1 && ends[0].label == CfgEdgeLabel::None && blocks_[ends[0].block].open) {
+      return ends[0].block;
+    }
+    uint32_t block = newBlock(CfgBlockKind::Normal, ends.empty() ? "Unreachable" : "Join");
+    connect(ends, block);
+    ends = {{block, CfgEdgeLabel::None}};
+    return block;
+  }
+
+  Ends statements(TSNode container, Ends ends) {
+    TSTreeCursor cursor = ts_tree_cursor_new(container);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      do {
+        TSNode child = ts_tree_cursor_current_node(&cursor);
+        if (!ts_node_is_named(child) || kindOf(child) == FlowKind::Comment) continue;
+        ends = statement(child, std::move(ends));
+      } while (ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+    return ends;
+  }
+
+  // A block body or a single unbraced statement.
+  Ends body(TSNode node, Ends ends) {
+    if (ts_node_is_null(node)) return ends;
+    return kindOf(node) == FlowKind::Block ? statements(node, std::move(ends))
+                                           : statement(node, std::move(ends));
+  }
+
+  Ends statement(TSNode node, Ends ends) {
+    switch (kindOf(node)) {
+      case FlowKind::Block:
+        return statements(node, std::move(ends));
+      case FlowKind::If:
+        return ifStatement(node, std::move(ends));
+      case FlowKind::For:
+      case FlowKind::ForIn:
+      case FlowKind::While:
+        return loop(node, kindOf(node), std::move(ends));
+      case FlowKind::Do:
+        return doLoop(node, std::move(ends));
+      case FlowKind::Try:
+        return tryStatement(node, std::move(ends));
+      case FlowKind::Switch:
+        return switchStatement(node, std::move(ends));
+      case FlowKind::Labeled:
+        return labeledStatement(node, std::move(ends));
+      case FlowKind::With: {
+        TSNode withBody = field(node, "body");
+        if (ts_node_is_null(withBody)) break;
+        addStatement(openBlock(ends), ts_node_start_byte(node), ts_node_start_byte(withBody),
+                     ts_node_start_point(node));
+        return statements(withBody, std::move(ends));
+      }
+      case FlowKind::Return: {
+        uint32_t block = openBlock(ends);
+        addStatement(block, node);
+        connect(ends, kExitBlock);
+        return {};
+      }
+      case FlowKind::Throw: {
+        uint32_t block = openBlock(ends);
+        addStatement(block, node);
+        uint32_t thrown = newBlock(CfgBlockKind::Exception, "Throw");
+        connect(ends, thrown);
+        throwFrom(thrown);
+        return {};
+      }
+      case FlowKind::Break:
+      case FlowKind::Continue:
+        return jump(node, std::move(ends));
+      default:
+        break;
+    }
+    addStatement(openBlock(ends), node);
+    return ends;
+  }
+
+  void throwFrom(uint32_t block) {
+    if (handlers_.empty()) {
+      addEdge(block, kExitBlock, CfgEdgeLabel::Exception);
+      return;
+    }
+    for (uint32_t handler : *handlers_.back()) addEdge(block, handler, CfgEdgeLabel::Exception);
+  }
+
+  Ends ifStatement(TSNode node, Ends ends) {
+    uint32_t condition = newBlock(CfgBlockKind::Condition, field(node, "condition"), "If Condition");
+    connect(ends, condition);
+
+    uint32_t thenBlock = newBlock(CfgBlockKind::Normal, "Then");
+    addEdge(condition, thenBlock, CfgEdgeLabel::True);
+    Ends out = body(field(node, "consequence"), {{thenBlock, CfgEdgeLabel::None}});
+
+    // TS has one else_clause; Python any number of elif_clauses, then else.
+    uint32_t falseFrom = condition;
+    bool hasElse = false;
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      do {
+        TSNode child = ts_tree_cursor_current_node(&cursor);
+        FlowKind kind = kindOf(child);
+        if (kind == FlowKind::ElifClause) {
+          uint32_t elif = newBlock(CfgBlockKind::Condition, field(child, "condition"), "Elif Condition");
+          addEdge(falseFrom, elif, CfgEdgeLabel::False);
+          uint32_t elifThen = newBlock(CfgBlockKind::Normal, "Then");
+          addEdge(elif, elifThen, CfgEdgeLabel::True);
+          append(out, body(field(child, "consequence"), {{elifThen, CfgEdgeLabel::None}}));
+          falseFrom = elif;
+        } else if (kind == FlowKind::ElseClause) {
+          uint32_t elseBlock = newBlock(CfgBlockKind::Normal, "Else");
+          addEdge(falseFrom, elseBlock, CfgEdgeLabel::False);
+          append(out, body(elseBody(child), {{elseBlock, CfgEdgeLabel::None}}));
+          hasElse = true;
+        }
+      } while (ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+
+    if (!hasElse) out.push_back({falseFrom, CfgEdgeLabel::False});
+    return seal(std::move(out));
+  }
+
+  // Python's else_clause has a body field; the TS one wraps a bare statement.
+  TSNode elseBody(TSNode clause) const {
+    TSNode result = field(clause, "body");
+    if (!ts_node_is_null(result)) return result;
+    uint32_t count = ts_node_named_child_count(clause);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_named_child(clause, i);
+      if (kindOf(child) != FlowKind::Comment) return child;
+    }
+    return TSNode{};
+  }
+
+  Ends loop(TSNode node, FlowKind kind, Ends ends) {
+    TSNode loopBody = field(node, "body");
+    uint32_t head;
+    if (kind == FlowKind::ForIn) {
+      uint32_t headerEnd = ts_node_is_null(loopBody) ? ts_node_end_byte(node) : ts_node_start_byte(loopBody);
+      head = newBlock(CfgBlockKind::Loop, ts_node_start_byte(node), headerEnd, "For Each");
+    } else if (kind == FlowKind::For) {
+      TSNode initializer = field(node, "initializer");
+      if (!ts_node_is_null(initializer)) addStatement(openBlock(ends), initializer);
+      head = newBlock(CfgBlockKind::Loop, field(node, "condition"), "For");
+    } else {
+      head = newBlock(CfgBlockKind::Loop, field(node, "condition"), "While");
+    }
+    connect(ends, head);
+
+    uint32_t continueTarget = head;
+    CfgEdgeLabel continueLabel = CfgEdgeLabel::Back;
+    TSNode increment = kind == FlowKind::For ? field(node, "increment") : TSNode{};
+    if (!ts_node_is_null(increment)) {
+      continueTarget = newBlock(CfgBlockKind::Normal, "Update");
+      addStatement(continueTarget, increment);
+      addEdge(continueTarget, head, CfgEdgeLabel::Back);
+      blocks_[continueTarget].open = false;
+      continueLabel = CfgEdgeLabel::None;
+    }
+
+    uint32_t bodyBlock = newBlock(CfgBlockKind::Normal, "Loop Body");
+    addEdge(head, bodyBlock, CfgEdgeLabel::True);
+    jumps_.push_back({takePendingLabel(), true, continueTarget, continueLabel, {}});
+    Ends bodyEnds = body(loopBody, {{bodyBlock, CfgEdgeLabel::None}});
+    for (const Dangling& end : bodyEnds) {
+      addEdge(end.block, continueTarget, end.label == CfgEdgeLabel::None ? continueLabel : end.label);
+      blocks_[end.block].open = false;
+    }
+    Ends out = std::move(jumps_.back().breaks);
+    jumps_.pop_back();
+
+    // Python runs a loop's else clause when the loop ends without break.
+    TSNode alternative = field(node, "alternative");
+    if (!ts_node_is_null(alternative)) {
+      uint32_t elseBlock = newBlock(CfgBlockKind::Normal, "Loop Else");
+      addEdge(head, elseBlock, CfgEdgeLabel::False);
+      append(out, body(elseBody(alternative), {{elseBlock, CfgEdgeLabel::None}}));
+    } else {
+      out.push_back({head, CfgEdgeLabel::False});
+    }
+    return seal(std::move(out));
+  }
+
+  Ends doLoop(TSNode node, Ends ends) {
+    uint32_t bodyBlock = newBlock(CfgBlockKind::Normal, "Loop Body");
+    connect(ends, bodyBlock);
+    uint32_t condition = newBlock(CfgBlockKind::Loop, field(node, "condition"), "Do While");
+
+    jumps_.push_back({takePendingLabel(), true, condition, CfgEdgeLabel::None, {}});
+    connect(body(field(node, "body"), {{bodyBlock, CfgEdgeLabel::None}}), condition);
+    Ends out = std::move(jumps_.back().breaks);
+    jumps_.pop_back();
+
+    addEdge(condition, bodyBlock, CfgEdgeLabel::Back);
+    out.push_back({condition, CfgEdgeLabel::False});
+    return seal(std::move(out));
+  }
+
+  Ends switchStatement(TSNode node, Ends ends) {
+    uint32_t dispatch = newBlock(CfgBlockKind::Condition, field(node, "value"), "Switch");
+    connect(ends, dispatch);
+
+    jumps_.push_back({takePendingLabel(), true, kNoBlock, CfgEdgeLabel::None, {}});
+    Ends fallthrough;
+    bool hasDefault = false;
+    TSNode cases = field(node, "body");
+    uint32_t caseCount = ts_node_is_null(cases) ? 0 : ts_node_named_child_count(cases);
+    for (uint32_t i = 0; i < caseCount; i++) {
+      TSNode clause = ts_node_named_child(cases, i);
+      FlowKind kind = kindOf(clause);
+      if (kind == FlowKind::Comment) continue;
+      bool isDefault = kind == FlowKind::SwitchDefault;
+      hasDefault = hasDefault || isDefault;
+
+      TSNode value = field(clause, "value");
+      uint32_t caseBlock = isDefault || ts_node_is_null(value)
+                               ? newBlock(CfgBlockKind::Normal, "default")
+                               : newBlock(CfgBlockKind::Normal, ts_node_start_byte(clause),
+                                          ts_node_end_byte(value), "case");
+      addEdge(dispatch, caseBlock, CfgEdgeLabel::None);
+      connect(fallthrough, caseBlock);
+
+      Ends caseEnds = {{caseBlock, CfgEdgeLabel::None}};
+      TSTreeCursor cursor = ts_tree_cursor_new(clause);
+      if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+          TSNode child = ts_tree_cursor_current_node(&cursor);
+          const char* fieldName = ts_tree_cursor_current_field_name(&cursor);
+          if (!ts_node_is_named(child) || kindOf(child) == FlowKind::Comment ||
+              (fieldName && !strcmp(fieldName, "value"))) {
+            continue;
+          }
+          caseEnds = statement(child, std::move(caseEnds));
+        } while (ts_tree_cursor_goto_next_sibling(&cursor));
+      }
+      ts_tree_cursor_delete(&cursor);
+      fallthrough = seal(std::move(caseEnds));
+    }
+
+    Ends out = std::move(jumps_.back().breaks);
+    jumps_.pop_back();
+    append(out, std::move(fallthrough));
+    if (!hasDefault) out.push_back({dispatch, CfgEdgeLabel::False});
+    return seal(std::move(out));
+  }
+
+  Ends tryStatement(TSNode node, Ends ends) {
+    std::vector<TSNode> clauses;
+    TSNode elseClause = {};
+    TSNode finallyClause = {};
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_named_child(node, i);
+      switch (kindOf(child)) {
+        case FlowKind::CatchClause: clauses.push_back(child); break;
+        case FlowKind::ElseClause: elseClause = child; break;
+        case FlowKind::FinallyClause: finallyClause = child; break;
+        default: break;
+      }
+    }
+
+    uint32_t tryBlock = newBlock(CfgBlockKind::Normal, "Try");
+    connect(ends, tryBlock);
+
+    std::vector<uint32_t> handlers;
+    std::vector<TSNode> handlerBodies;
+    for (TSNode clause : clauses) {
+      TSNode clauseBody = clauseBlock(clause);
+      uint32_t headerEnd = ts_node_is_null(clauseBody) ? ts_node_end_byte(clause) : ts_node_start_byte(clauseBody);
+      handlers.push_back(newBlock(CfgBlockKind::Normal, ts_node_start_byte(clause), headerEnd, "Catch"));
+      handlerBodies.push_back(clauseBody);
+    }
+    uint32_t finallyBlock = kNoBlock;
+    if (!ts_node_is_null(finallyClause)) {
+      finallyBlock = newBlock(CfgBlockKind::Normal, "Finally");
+      if (handlers.empty()) handlers.push_back(finallyBlock);
+    }
+    // Any statement in the body may throw
+    for (uint32_t handler : handlers) addEdge(tryBlock, handler, CfgEdgeLabel::Exception);
+
+    handlers_.push_back(&handlers);
+    Ends out = body(field(node, "body"), {{tryBlock, CfgEdgeLabel::None}});
+    handlers_.pop_back();
+
+    if (!ts_node_is_null(elseClause)) {
+      uint32_t elseBlock = newBlock(CfgBlockKind::Normal, "Else");
+      connect(out, elseBlock);
+      out = body(elseBody(elseClause), {{elseBlock, CfgEdgeLabel::None}});
+    }
+    out = seal(std::move(out));
+    for (size_t i = 0; i < handlerBodies.size(); i++) {
+      append(out, seal(body(handlerBodies[i], {{handlers[i], CfgEdgeLabel::None}})));
+    }
+
+    if (finallyBlock != kNoBlock) {
+      connect(out, finallyBlock);
+      out = body(clauseBlock(finallyClause), {{finallyBlock, CfgEdgeLabel::None}});
+    }
+    return seal(std::move(out));
+  }
+
+  // catch_clause and finally_clause use a body field; Python clauses only
+  // have a block child.
+  TSNode clauseBlock(TSNode clause) const {
+    TSNode result = field(clause, "body");
+    if (!ts_node_is_null(result)) return result;
+    uint32_t count = ts_node_named_child_count(clause);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_named_child(clause, i);
+      if (kindOf(child) == FlowKind::Block) return child;
+    }
+    return TSNode{};
+  }
+
+  Ends labeledStatement(TSNode node, Ends ends) {
+    TSNode labelNode = field(node, "label");
+    TSNode labeled = field(node, "body");
+    if (ts_node_is_null(labeled)) return ends;
+    std::string_view label = ts_node_is_null(labelNode) ? std::string_view() : tree_.text(labelNode);
+    FlowKind kind = kindOf(labeled);
+    if (kind == FlowKind::For || kind == FlowKind::ForIn || kind == FlowKind::While ||
+        kind == FlowKind::Do || kind == FlowKind::Switch) {
+      pendingLabel_ = label;
+      return statement(labeled, std::move(ends));
+    }
+    jumps_.push_back({label, false, kNoBlock, CfgEdgeLabel::None, {}});
+    Ends out = statement(labeled, std::move(ends));
+    append(out, std::move(jumps_.back().breaks));
+    jumps_.pop_back();
+    return seal(std::move(out));
+  }
+
+  std::string_view takePendingLabel() {
+    std::string_view label = pendingLabel_;
+    pendingLabel_ = std::string_view();
+    return label;
+  }
+
+  Ends jump(TSNode node, Ends ends) {
+    uint32_t block = openBlock(ends);
+    addStatement(block, node);
+    blocks_[block].open = false;
+
+    bool isBreak = kindOf(node) == FlowKind::Break;
+    TSNode labelNode = field(node, "label");
+    std::string_view label = ts_node_is_null(labelNode) ? std::string_view() : tree_.text(labelNode);
+    for (size_t i = jumps_.size(); i-- > 0;) {
+      JumpContext& context = jumps_[i];
+      bool matches = label.empty() ? (isBreak ? context.breakable : context.continueTarget != kNoBlock)
+                                   : context.label == label;
+      if (!matches) continue;
+      if (isBreak) {
+        context.breaks.push_back({block, CfgEdgeLabel::None});
+      } else if (context.continueTarget != kNoBlock) {
+        addEdge(block, context.continueTarget, context.continueLabel);
+      } else {
+        break;
+      }
+      return {};
+    }
+    // Outside any loop: the statement is a syntax error, treat it as an exit
+    addEdge(block, kExitBlock, CfgEdgeLabel::None);
+    return {};
+  }
+
+  static void append(Ends& to, Ends from) {
+    to.insert(to.end(), from.begin(), from.end());
+  }
+
+  ControlFlowGraphPtr finish(TSNode function, std::string_view name) {
+    auto graph = std::make_shared<ControlFlowGraph>();
+    graph->source = tree_.source();
+    graph->functionName = std::string(name);
+    graph->startByte = ts_node_start_byte(function);
+    graph->endByte = ts_node_end_byte(function);
+    graph->startLine = ts_node_start_point(function).row + 1;
+    graph->endLine = ts_node_end_point(function).row + 1;
+    graph->edges = std::move(edges_);
+
+    size_t statementCount = 0;
+    for (const PendingBlock& block : blocks_) statementCount += block.statements.size();
+    graph->statements.reserve(statementCount);
+    graph->blocks.reserve(blocks_.size());
+    for (PendingBlock& block : blocks_) {
+      graph->blocks.push_back({block.kind, false, block.fixedLabel, block.labelStart, block.labelEnd,
+                               static_cast<uint32_t>(graph->statements.size()),
+                               static_cast<uint32_t>(block.statements.size())});
+      graph->statements.insert(graph->statements.end(), block.statements.begin(), block.statements.end());
+    }
+
+    std::vector<std::vector<uint32_t>> successors(graph->blocks.size());
+    for (const CfgEdge& edge : graph->edges) successors[edge.from].push_back(edge.to);
+    std::vector<uint32_t> stack = {kEntryBlock};
+    graph->blocks[kEntryBlock].reachable = true;
+    while (!stack.empty()) {
+      uint32_t block = stack.back();
+      stack.pop_back();
+      for (uint32_t next : successors[block]) {
+        if (!graph->blocks[next].reachable) {
+          graph->blocks[next].reachable = true;
+          stack.push_back(next);
+        }
+      }
+    }
+    return graph;
+  }
+};
+
+struct CachedGraph {
+  uint64_t contentHash;
+  ControlFlowGraphPtr graph;  // Null when the function was not found
+};
+
+struct ControlFlowCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, CachedGraph> entries;  // filePath + '\0' + functionName
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+ControlFlowCache& controlFlowCache() {
+  static ControlFlowCache cache;
+  return cache;
+}
+
+std::string cacheKey(const std::string& filePath, const std::string& functionName) {
+  std::string key = filePath;
+  key.push_back('\0');
+  key += functionName;
+  return key;
+}
+
+bool findCachedGraph(const std::string& filePath, const std::string& functionName,
+                     uint64_t contentHash, ControlFlowGraphPtr& graph) {
+  ControlFlowCache& cache = controlFlowCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.entries.find(cacheKey(filePath, functionName));
+  if (it != cache.entries.end() && it->second.contentHash == contentHash) {
+    cache.hits++;
+    graph = it->second.graph;
+    return true;
+  }
+  cache.misses++;
+  return false;
+}
+
+void storeCachedGraph(const std::string& filePath, const std::string& functionName,
+                      uint64_t contentHash, ControlFlowGraphPtr graph) {
+  ControlFlowCache& cache = controlFlowCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.entries.size() >= kMaxCachedGraphs) cache.entries.clear();
+  cache.entries[cacheKey(filePath, functionName)] = {contentHash, std::move(graph)};
+}
+
+}  // namespace
+
+const char* cfgBlockKindName(CfgBlockKind kind) {
+  switch (kind) {
+    case CfgBlockKind::Entry: return "entry";
+    case CfgBlockKind::Exit: return "exit";
+    case CfgBlockKind::Normal: return "normal";
+    case CfgBlockKind::Condition: return "condition";
+    case CfgBlockKind::Loop: return "loop";
+    case CfgBlockKind::Exception: return "exception";
+  }
+  return "normal";
+}
+
+const char* cfgEdgeLabelName(CfgEdgeLabel label) {
+  switch (label) {
+    case CfgEdgeLabel::None: return "";
+    case CfgEdgeLabel::True: return "true";
+    case CfgEdgeLabel::False: return "false";
+    case CfgEdgeLabel::Exception: return "exception";
+    case CfgEdgeLabel::Back: return "back";
+  }
+  return "";
+}
+
+std::string_view ControlFlowGraph::label(const CfgBlock& block) const {
+  if (block.fixedLabel) return block.fixedLabel;
+  return source->slice(block.labelStart, block.labelEnd);
+}
+
+std::string_view ControlFlowGraph::text(const CfgStatement& statement) const {
+  return source->slice(statement.startByte, statement.endByte);
+}
+
+ControlFlowGraphPtr buildControlFlowGraph(const SyntaxTree& tree, std::string_view functionName) {
+  if (tree.language() == LanguageId::Unknown) return nullptr;
+  CfgBuilder builder(tree);
+  TSNode function = builder.findFunction(functionName);
+  if (ts_node_is_null(function)) return nullptr;
+  return builder.build(function, functionName);
+}
+
+ControlFlowGraphPtr controlFlowGraphFor(const std::string& filePath,
+                                        const std::string& functionName, SourceBufferPtr source) {
+  ControlFlowGraphPtr graph;
+  if (findCachedGraph(filePath, functionName, source->contentHash(), graph)) return graph;
+
+  LanguageId language = languageForPath(filePath);
+  if (language == LanguageId::Unknown) return nullptr;
+  SyntaxTreePtr tree = parseCached(language, std::move(source));
+  if (!tree) return nullptr;
+  graph = buildControlFlowGraph(*tree, functionName);
+  storeCachedGraph(filePath, functionName, tree->source()->contentHash(), graph);
+  return graph;
+}
+
+ControlFlowGraphPtr controlFlowGraphFor(const SyntaxTree& tree, const std::string& filePath,
+                                        const std::string& functionName) {
+  uint64_t contentHash = tree.source()->contentHash();
+  ControlFlowGraphPtr graph;
+  if (findCachedGraph(filePath, functionName, contentHash, graph)) return graph;
+  graph = buildControlFlowGraph(tree, functionName);
+  storeCachedGraph(filePath, functionName, contentHash, graph);
+  return graph;
+}
+
+ControlFlowCacheStats controlFlowCacheStats() {
+  ControlFlowCache& cache = controlFlowCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return {cache.entries.size(), cache.hits, cache.misses};
+}
+
+}  // namespace prism
@@ -0,0 +1,89 @@
+#ifndef CONTROL_FLOW_H
+#define CONTROL_FLOW_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "syntax_tree.h"
+
+namespace prism {
+
+enum class CfgBlockKind : uint8_t { Entry, Exit, Normal, Condition, Loop, Exception };
+
+enum class CfgEdgeLabel : uint8_t { None, True, False, Exception, Back };
+
+// Names used by get_control_flow: "entry", "normal", ... and "true", "back", ...
+// cfgEdgeLabelName returns an empty string for None.
+const char* cfgBlockKindName(CfgBlockKind kind);
+const char* cfgEdgeLabelName(CfgEdgeLabel label);
+
+struct CfgStatement {
+  uint32_t startByte;
+  uint32_t endByte;
+  uint32_t line;  // 1-based
+};
+
+struct CfgBlock {
+  CfgBlockKind kind;
+  bool reachable;          // From the entry block
+  const char* fixedLabel;  // Null when the label is the source range below
+  uint32_t labelStart;
+  uint32_t labelEnd;
+  uint32_t firstStatement;  // Index into ControlFlowGraph::statements
+  uint32_t statementCount;
+};
+
+struct CfgEdge {
+  uint32_t from;
+  uint32_t to;
+  CfgEdgeLabel label;
+};
+
+// Control-flow graph of one function. Block 0 is the entry and block 1 the
+// exit. Statements and labels are byte ranges into the shared source buffer.
+struct ControlFlowGraph {
+  SourceBufferPtr source;
+  std::string functionName;
+  uint32_t startByte;  // Of the function node
+  uint32_t endByte;
+  uint32_t startLine;
+  uint32_t endLine;
+  std::vector<CfgBlock> blocks;
+  std::vector<CfgStatement> statements;
+  std::vector<CfgEdge> edges;
+
+  std::string_view label(const CfgBlock& block) const;
+  std::string_view text(const CfgStatement& statement) const;
+};
+
+using ControlFlowGraphPtr = std::shared_ptr<const ControlFlowGraph>;
+
+// Builds the graph of the first function, method or function-valued variable
+// named functionName in document order. Models if/elif/else, switch, for,
+// for-in/of, while, do-while, Python loop else clauses, try/catch/finally and
+// except, return, throw/raise, and labeled break/continue. Null when no such
+// function exists.
+ControlFlowGraphPtr buildControlFlowGraph(const SyntaxTree& tree, std::string_view functionName);
+
+// buildControlFlowGraph memoized by (filePath, functionName, content hash);
+// the file is only parsed on a miss. Shared by every thread.
+ControlFlowGraphPtr controlFlowGraphFor(const std::string& filePath,
+                                        const std::string& functionName, SourceBufferPtr source);
+
+// Same cache, for callers that already hold the parsed tree.
+ControlFlowGraphPtr controlFlowGraphFor(const SyntaxTree& tree, const std::string& filePath,
+                                        const std::string& functionName);
+
+struct ControlFlowCacheStats {
+  size_t entries;
+  size_t hits;
+  size_t misses;
+};
+
+ControlFlowCacheStats controlFlowCacheStats();
+
+}  // namespace prism
+
+#endif  // CONTROL_FLOW_H
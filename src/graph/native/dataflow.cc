@@ -0,0 +1,746 @@
+#include "dataflow.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "tree_cache.h"
+
+namespace prism {
+
+namespace {
+
+constexpr uint32_t kNoStatement = UINT32_MAX;
+constexpr uint32_t kEntryBlock = 0;
+constexpr uint32_t kExitBlock = 1;
+constexpr size_t kMaxCachedFunctions = 4096;
+constexpr const char* kNonNullable = "NonNullable<T>";
+
+bool isType(TSNode node, const char* type) {
+  return !ts_node_is_null(node) && strcmp(ts_node_type(node), type) == 0;
+}
+
+TSNode field(TSNode node, const char* name) {
+  return ts_node_child_by_field_name(node, name, static_cast<uint32_t>(strlen(name)));
+}
+
+bool isScope(TSNode node) {
+  const char* type = ts_node_type(node);
+  return !strcmp(type, "arrow_function") || !strcmp(type, "function_expression") ||
+         !strcmp(type, "function") || !strcmp(type, "generator_function") ||
+         !strcmp(type, "function_declaration") || !strcmp(type, "generator_function_declaration") ||
+         !strcmp(type, "method_definition") || !strcmp(type, "class_declaration") ||
+         !strcmp(type, "class") || !strcmp(type, "function_definition") ||
+         !strcmp(type, "class_definition") || !strcmp(type, "lambda");
+}
+
+bool isPatternContainer(TSNode node) {
+  const char* type = ts_node_type(node);
+  return !strcmp(type, "object_pattern") || !strcmp(type, "array_pattern") ||
+         !strcmp(type, "rest_pattern") || !strcmp(type, "pattern_list") ||
+         !strcmp(type, "tuple_pattern") || !strcmp(type, "list_pattern") ||
+         !strcmp(type, "list_splat_pattern") || !strcmp(type, "dictionary_splat_pattern") ||
+         !strcmp(type, "as_pattern_target");
+}
+
+// Reverse postorder of the blocks reachable from start along edges.
+std::vector<uint32_t> reversePostorder(uint32_t start, const std::vector<std::vector<uint32_t>>& next) {
+  std::vector<uint32_t> order;
+  std::vector<uint8_t> visited(next.size(), 0);
+  std::vector<std::pair<uint32_t, size_t>> stack = {{start, 0}};
+  visited[start] = 1;
+  while (!stack.empty()) {
+    auto& [block, child] = stack.back();
+    if (child < next[block].size()) {
+      uint32_t successor = next[block][child++];
+      if (!visited[successor]) {
+        visited[successor] = 1;
+        stack.push_back({successor, 0});
+      }
+    } else {
+      order.push_back(block);
+      stack.pop_back();
+    }
+  }
+  return std::vector<uint32_t>(order.rbegin(), order.rend());
+}
+
+class DataflowBuilder {
+ public:
+  DataflowBuilder(const SyntaxTree& tree, ControlFlowGraphPtr graph)
+      : tree_(tree), python_(tree.language() == LanguageId::Python) {
+    result_ = std::make_shared<FunctionDataflow>();
+    result_->graph = std::move(graph);
+    result_->statementDefinitions.resize(result_->graph->statements.size());
+  }
+
+  FunctionDataflowPtr run() {
+    const ControlFlowGraph& graph = *result_->graph;
+    TSNode root = tree_.root();
+    TSNode function = ts_node_named_descendant_for_byte_range(root, graph.startByte, graph.endByte);
+    collectParameters(function);
+
+    for (uint32_t b = 0; b < graph.blocks.size(); b++) {
+      const CfgBlock& block = graph.blocks[b];
+      if (block.kind == CfgBlockKind::Loop && !block.fixedLabel) {
+        TSNode header = ts_node_named_descendant_for_byte_range(root, block.labelStart, block.labelEnd);
+        if (isType(header, "for_in_statement") || (python_ && isType(header, "for_statement"))) {
+          std::vector<TSNode> names;
+          patternNames(field(header, "left"), names);
+          for (TSNode name : names) addDefinition(name, DefinitionKind::LoopVariable, b, kNoStatement, "");
+        }
+      }
+      for (uint32_t s = block.firstStatement; s < block.firstStatement + block.statementCount; s++) {
+        const CfgStatement& statement = graph.statements[s];
+        TSNode node = ts_node_named_descendant_for_byte_range(root, statement.startByte, statement.endByte);
+        collectDefinitions(node, b, s, statement.endByte, true);
+      }
+    }
+
+    solveReachingDefinitions();
+    solveNarrowing();
+    return result_;
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  bool python_;
+  std::shared_ptr<FunctionDataflow> result_;
+  std::unordered_map<std::string_view, std::vector<uint32_t>> definitionsByName_;
+  std::vector<std::vector<uint32_t>> blockDefinitions_;  // Including parameters and loop variables
+
+  std::string_view text(TSNode node) const { return tree_.text(node); }
+
+  void addDefinition(TSNode name, DefinitionKind kind, uint32_t block, uint32_t statement,
+                     std::string type) {
+    TSPoint start = ts_node_start_point(name);
+    auto index = static_cast<uint32_t>(result_->definitions.size());
+    result_->definitions.push_back({std::string(text(name)), kind, block, statement, start.row + 1,
+                                    start.column, std::move(type)});
+    if (statement != kNoStatement) result_->statementDefinitions[statement].push_back(index);
+    if (blockDefinitions_.size() <= block) blockDefinitions_.resize(block + 1);
+    blockDefinitions_[block].push_back(index);
+  }
+
+  // Identifiers bound by a destructuring pattern; default values and object
+  // keys are not bindings.
+  void patternNames(TSNode node, std::vector<TSNode>& out) const {
+    if (ts_node_is_null(node)) return;
+    if (isType(node, "identifier") || isType(node, "shorthand_property_identifier_pattern")) {
+      out.push_back(node);
+    } else if (isType(node, "pair_pattern")) {
+      patternNames(field(node, "value"), out);
+    } else if (isType(node, "assignment_pattern") || isType(node, "object_assignment_pattern")) {
+      patternNames(field(node, "left"), out);
+    } else if (isPatternContainer(node)) {
+      uint32_t count = ts_node_named_child_count(node);
+      for (uint32_t i = 0; i < count; i++) patternNames(ts_node_named_child(node, i), out);
+    }
+  }
+
+  void collectParameters(TSNode function) {
+    if (ts_node_is_null(function)) return;
+    TSNode single = field(function, "parameter");  // x => ...
+    if (!ts_node_is_null(single)) {
+      addDefinition(single, DefinitionKind::Parameter, kEntryBlock, kNoStatement, "");
+      return;
+    }
+    TSNode parameters = field(function, "parameters");
+    uint32_t count = ts_node_is_null(parameters) ? 0 : ts_node_named_child_count(parameters);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode parameter = ts_node_named_child(parameters, i);
+      TSNode pattern = field(parameter, "pattern");
+      if (ts_node_is_null(pattern)) pattern = field(parameter, "name");
+      if (ts_node_is_null(pattern) && isType(parameter, "assignment_pattern")) pattern = field(parameter, "left");
+      if (ts_node_is_null(pattern) && isType(parameter, "typed_parameter")) {
+        pattern = ts_node_named_child(parameter, 0);
+      }
+      if (ts_node_is_null(pattern)) pattern = parameter;
+
+      std::string type = annotationType(field(parameter, "type"));
+      if (type.empty()) type = literalType(field(parameter, "value"));
+      std::vector<TSNode> names;
+      patternNames(pattern, names);
+      for (TSNode name : names) {
+        addDefinition(name, DefinitionKind::Parameter, kEntryBlock, kNoStatement, names.size() == 1 ? type : "");
+      }
+    }
+  }
+
+  // Walks one statement, stopping at nested functions and classes and at
+  // children past end (a with header's body belongs to later statements).
+  void collectDefinitions(TSNode node, uint32_t block, uint32_t statement, uint32_t end, bool top) {
+    if (ts_node_is_null(node) || ts_node_start_byte(node) >= end) return;
+    if (!top && isScope(node)) return;
+
+    if (isType(node, "variable_declarator")) {
+      TSNode name = field(node, "name");
+      std::string type = annotationType(field(node, "type"));
+      if (type.empty()) type = literalType(field(node, "value"));
+      bindPattern(name, DefinitionKind::Declaration, block, statement, std::move(type));
+    } else if (isType(node, "assignment_expression") || isType(node, "assignment")) {
+      TSNode right = field(node, "right");
+      std::string type = annotationType(field(node, "type"));
+      if (type.empty()) type = literalType(right);
+      DefinitionKind kind = python_ && ts_node_is_null(right) ? DefinitionKind::Declaration
+                                                              : DefinitionKind::Assignment;
+      bindPattern(field(node, "left"), kind, block, statement, std::move(type));
+    } else if (isType(node, "augmented_assignment_expression") || isType(node, "augmented_assignment")) {
+      bindPattern(field(node, "left"), DefinitionKind::Assignment, block, statement, "");
+    } else if (isType(node, "update_expression")) {
+      TSNode argument = field(node, "argument");
+      if (isType(argument, "identifier")) {
+        addDefinition(argument, DefinitionKind::Update, block, statement, "number");
+      }
+    } else if (isType(node, "named_expression")) {
+      bindPattern(field(node, "name"), DefinitionKind::Assignment, block, statement,
+                  literalType(field(node, "value")));
+    } else if (isType(node, "as_pattern")) {
+      bindPattern(field(node, "alias"), DefinitionKind::Declaration, block, statement, "");
+    }
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      collectDefinitions(ts_node_named_child(node, i), block, statement, end, false);
+    }
+  }
+
+  void bindPattern(TSNode target, DefinitionKind kind, uint32_t block, uint32_t statement,
+                   std::string type) {
+    std::vector<TSNode> names;
+    patternNames(target, names);
+    for (TSNode name : names) {
+      addDefinition(name, kind, block, statement, names.size() == 1 ? type : "");
+    }
+  }
+
+  std::string annotationType(TSNode annotation) const {
+    if (ts_node_is_null(annotation)) return "";
+    // TS wraps the type in a type_annotation that includes the colon
+    if (isType(annotation, "type_annotation") && ts_node_named_child_count(annotation) > 0) {
+      annotation = ts_node_named_child(annotation, 0);
+    }
+    return std::string(text(annotation));
+  }
+
+  std::string literalType(TSNode value) const {
+    if (ts_node_is_null(value)) return "";
+    const char* type = ts_node_type(value);
+    if (!strcmp(type, "parenthesized_expression") && ts_node_named_child_count(value) > 0) {
+      return literalType(ts_node_named_child(value, 0));
+    }
+    if (!strcmp(type, "true") || !strcmp(type, "false")) return python_ ? "bool" : "boolean";
+    if (python_) {
+      if (!strcmp(type, "string") || !strcmp(type, "concatenated_string")) return "str";
+      if (!strcmp(type, "integer")) return "int";
+      if (!strcmp(type, "float")) return "float";
+      if (!strcmp(type, "none")) return "None";
+      if (!strcmp(type, "list") || !strcmp(type, "list_comprehension")) return "list";
+      if (!strcmp(type, "dictionary") || !strcmp(type, "dictionary_comprehension")) return "dict";
+      if (!strcmp(type, "set") || !strcmp(type, "set_comprehension")) return "set";
+      if (!strcmp(type, "tuple")) return "tuple";
+      if (!strcmp(type, "lambda")) return "Callable";
+      if (!strcmp(type, "call")) {
+        // Constructor calls by naming convention
+        TSNode callee = field(value, "function");
+        std::string_view name = isType(callee, "identifier") ? text(callee) : std::string_view();
+        if (!name.empty() && name[0] >= 'A' && name[0] <= 'Z') return std::string(name);
+      }
+      return "";
+    }
+    if (!strcmp(type, "string") || !strcmp(type, "template_string")) return "string";
+    if (!strcmp(type, "number")) return "number";
+    if (!strcmp(type, "null")) return "null";
+    if (!strcmp(type, "undefined")) return "undefined";
+    if (!strcmp(type, "object")) return "object";
+    if (!strcmp(type, "arrow_function") || !strcmp(type, "function_expression") ||
+        !strcmp(type, "function")) {
+      return "Function";
+    }
+    if (!strcmp(type, "new_expression")) {
+      TSNode constructor = field(value, "constructor");
+      return ts_node_is_null(constructor) ? "" : std::string(text(constructor));
+    }
+    if (!strcmp(type, "as_expression") && ts_node_named_child_count(value) > 1) {
+      return std::string(text(ts_node_named_child(value, 1)));
+    }
+    if (!strcmp(type, "array")) {
+      // Same rule as inferArrayType in analyze_type_flow
+      std::string element;
+      uint32_t count = ts_node_named_child_count(value);
+      for (uint32_t i = 0; i < count; i++) {
+        std::string item = literalType(ts_node_named_child(value, i));
+        if (item.empty()) continue;
+        if (!element.empty() && element != item) return "unknown[]";
+        element = item;
+      }
+      return element.empty() ? "unknown[]" : element + "[]";
+    }
+    return "";
+  }
+
+  void solveReachingDefinitions() {
+    const ControlFlowGraph& graph = *result_->graph;
+    size_t factCount = result_->definitions.size();
+    blockDefinitions_.resize(graph.blocks.size());
+    for (uint32_t d = 0; d < factCount; d++) {
+      definitionsByName_[result_->definitions[d].name].push_back(d);
+    }
+
+    DataflowProblem problem;
+    problem.factCount = factCount;
+    problem.boundary = BitVector(factCount);
+    problem.gen.assign(graph.blocks.size(), BitVector(factCount));
+    problem.kill.assign(graph.blocks.size(), BitVector(factCount));
+    for (uint32_t b = 0; b < graph.blocks.size(); b++) {
+      // Definitions were added in statement order, so the last one per name wins
+      for (uint32_t d : blockDefinitions_[b]) {
+        for (uint32_t other : definitionsByName_[result_->definitions[d].name]) {
+          problem.gen[b].reset(other);
+          if (other != d) problem.kill[b].set(other);
+        }
+        problem.gen[b].set(d);
+      }
+    }
+    result_->reaching = solveDataflow(graph, problem);
+  }
+
+  void solveNarrowing() {
+    const ControlFlowGraph& graph = *result_->graph;
+    TSNode root = tree_.root();
+    std::vector<std::vector<uint32_t>> edgeFacts(graph.edges.size());
+    for (uint32_t e = 0; e < graph.edges.size(); e++) {
+      const CfgEdge& edge = graph.edges[e];
+      const CfgBlock& from = graph.blocks[edge.from];
+      bool branch = edge.label == CfgEdgeLabel::True || edge.label == CfgEdgeLabel::False;
+      if (!branch || from.fixedLabel ||
+          (from.kind != CfgBlockKind::Condition && from.kind != CfgBlockKind::Loop)) {
+        continue;
+      }
+      TSNode condition = ts_node_named_descendant_for_byte_range(root, from.labelStart, from.labelEnd);
+      if (ts_node_start_byte(condition) != from.labelStart || ts_node_end_byte(condition) != from.labelEnd) {
+        continue;  // A for-each header, not a condition
+      }
+      conditionFacts(condition, edge.label == CfgEdgeLabel::True, edgeFacts[e]);
+    }
+
+    size_t factCount = result_->narrowings.size();
+    DataflowProblem problem;
+    problem.factCount = factCount;
+    problem.meet = DataflowMeet::Intersection;
+    problem.boundary = BitVector(factCount);
+    problem.gen.assign(graph.blocks.size(), BitVector(factCount));
+    problem.kill.assign(graph.blocks.size(), BitVector(factCount));
+    problem.edgeGen.assign(graph.edges.size(), BitVector(factCount));
+    for (uint32_t e = 0; e < graph.edges.size(); e++) {
+      for (uint32_t fact : edgeFacts[e]) problem.edgeGen[e].set(fact);
+    }
+    // Reassigning a variable discards what its earlier tests proved
+    for (uint32_t n = 0; n < factCount; n++) {
+      auto it = definitionsByName_.find(result_->narrowings[n].variable);
+      if (it == definitionsByName_.end()) continue;
+      for (uint32_t d : it->second) problem.kill[result_->definitions[d].block].set(n);
+    }
+    result_->narrowed = solveDataflow(graph, problem);
+  }
+
+  void addNarrowing(TSNode variable, TSNode condition, std::string type, NarrowingReason reason,
+                    std::vector<uint32_t>& out) {
+    TSPoint start = ts_node_start_point(condition);
+    out.push_back(static_cast<uint32_t>(result_->narrowings.size()));
+    result_->narrowings.push_back({std::string(text(variable)), std::move(type), reason,
+                                   ts_node_start_byte(condition), ts_node_end_byte(condition),
+                                   start.row + 1, start.column});
+  }
+
+  std::string stringLiteral(TSNode node) const {
+    std::string_view value = text(node);
+    if (value.size() >= 2) value = value.substr(1, value.size() - 2);
+    return "'" + std::string(value) + "'";
+  }
+
+  static const char* typeofType(std::string_view name) {
+    if (name == "string") return "string";
+    if (name == "number") return "number";
+    if (name == "boolean") return "boolean";
+    if (name == "function") return "Function";
+    if (name == "object") return "object";
+    if (name == "undefined") return "undefined";
+    if (name == "symbol") return "symbol";
+    if (name == "bigint") return "bigint";
+    return "unknown";
+  }
+
+  bool isNullish(TSNode node) const {
+    return isType(node, "null") || isType(node, "undefined") || isType(node, "none");
+  }
+
+  // Narrowings implied by condition evaluating to whenTrue, the same tests
+  // analyzeTypeNarrowing recognizes plus their negations and && / || chains.
+  void conditionFacts(TSNode node, bool whenTrue, std::vector<uint32_t>& out) {
+    if (ts_node_is_null(node)) return;
+    if (isType(node, "parenthesized_expression")) {
+      if (ts_node_named_child_count(node) > 0) conditionFacts(ts_node_named_child(node, 0), whenTrue, out);
+      return;
+    }
+    if (isType(node, "identifier")) {
+      if (whenTrue) addNarrowing(node, node, kNonNullable, NarrowingReason::Truthiness, out);
+      return;
+    }
+    if (isType(node, "not_operator")) {
+      conditionFacts(field(node, "argument"), !whenTrue, out);
+      return;
+    }
+    if (isType(node, "unary_expression")) {
+      if (text(field(node, "operator")) == "!") conditionFacts(field(node, "argument"), !whenTrue, out);
+      return;
+    }
+
+    TSNode left = field(node, "left");
+    TSNode right = field(node, "right");
+    if (isType(node, "binary_expression") || isType(node, "boolean_operator")) {
+      std::string_view op = text(field(node, "operator"));
+      if (op == "&&" || op == "and") {
+        if (whenTrue) {
+          conditionFacts(left, true, out);
+          conditionFacts(right, true, out);
+        }
+        return;
+      }
+      if (op == "||" || op == "or") {
+        if (!whenTrue) {
+          conditionFacts(left, false, out);
+          conditionFacts(right, false, out);
+        }
+        return;
+      }
+      if (op == "instanceof") {
+        if (whenTrue && isType(left, "identifier")) {
+          addNarrowing(left, node, std::string(text(right)), NarrowingReason::Instanceof, out);
+        }
+        return;
+      }
+      if (op == "===" || op == "==" || op == "!==" || op == "!=") {
+        comparisonFacts(node, left, right, (op[0] == '=') == whenTrue, out);
+      }
+      return;
+    }
+    if (isType(node, "comparison_operator") && ts_node_named_child_count(node) == 2) {
+      left = ts_node_named_child(node, 0);
+      right = ts_node_named_child(node, 1);
+      std::string_view op = tree_.source()->slice(ts_node_end_byte(left), ts_node_start_byte(right));
+      while (!op.empty() && op.front() == ' ') op.remove_prefix(1);
+      while (!op.empty() && op.back() == ' ') op.remove_suffix(1);
+      if (op == "is" || op == "==" || op == "is not" || op == "!=") {
+        comparisonFacts(node, left, right, (op == "is" || op == "==") == whenTrue, out);
+      }
+      return;
+    }
+    if (isType(node, "call_expression") || isType(node, "call")) {
+      if (!whenTrue) return;
+      std::string_view callee = text(field(node, "function"));
+      TSNode arguments = field(node, "arguments");
+      uint32_t count = ts_node_is_null(arguments) ? 0 : ts_node_named_child_count(arguments);
+      TSNode first = count > 0 ? ts_node_named_child(arguments, 0) : TSNode{};
+      if (!isType(first, "identifier")) return;
+      if (callee == "Array.isArray" && count == 1) {
+        addNarrowing(first, node, "unknown[]", NarrowingReason::Instanceof, out);
+      } else if (callee == "isinstance" && count == 2) {
+        TSNode classes = ts_node_named_child(arguments, 1);
+        std::string type;
+        if (isType(classes, "tuple")) {
+          uint32_t classCount = ts_node_named_child_count(classes);
+          for (uint32_t i = 0; i < classCount; i++) {
+            if (!type.empty()) type += " | ";
+            type += text(ts_node_named_child(classes, i));
+          }
+        } else {
+          type = std::string(text(classes));
+        }
+        addNarrowing(first, node, std::move(type), NarrowingReason::Instanceof, out);
+      }
+    }
+  }
+
+  // equal is whether the ==/===/is comparison holds on this edge.
+  void comparisonFacts(TSNode node, TSNode left, TSNode right, bool equal, std::vector<uint32_t>& out) {
+    if (isType(right, "identifier") && !isType(left, "identifier")) std::swap(left, right);
+    // typeof x === 'string'
+    if (isType(right, "unary_expression")) std::swap(left, right);
+    if (isType(left, "unary_expression") && text(field(left, "operator")) == "typeof") {
+      TSNode argument = field(left, "argument");
+      if (equal && isType(argument, "identifier") && isType(right, "string")) {
+        std::string_view name = text(right);
+        if (name.size() >= 2) name = name.substr(1, name.size() - 2);
+        addNarrowing(argument, node, typeofType(name), NarrowingReason::Typeof, out);
+      }
+      return;
+    }
+    if (!isType(left, "identifier")) return;
+    if (isNullish(right)) {
+      if (!equal) addNarrowing(left, node, kNonNullable, NarrowingReason::Equality, out);
+    } else if (isType(right, "string") && equal) {
+      addNarrowing(left, node, stringLiteral(right), NarrowingReason::Equality, out);
+    }
+  }
+};
+
+struct CachedDataflow {
+  uint64_t contentHash;
+  FunctionDataflowPtr dataflow;  // Null when the function was not found
+};
+
+struct DataflowCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, CachedDataflow> entries;  // filePath + '\0' + functionName
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+DataflowCache& dataflowCache() {
+  static DataflowCache cache;
+  return cache;
+}
+
+}  // namespace
+
+BitVector::BitVector(size_t size, bool filled)
+    : size_(size), words_((size + 63) / 64, 0) {
+  if (filled) fill();
+}
+
+void BitVector::fill() {
+  for (auto& word : words_) word = ~uint64_t(0);
+  if (size_ & 63) words_.back() = (uint64_t(1) << (size_ & 63)) - 1;
+}
+
+bool BitVector::unionWith(const BitVector& other) {
+  bool changed = false;
+  for (size_t i = 0; i < words_.size(); i++) {
+    uint64_t merged = words_[i] | other.words_[i];
+    changed = changed || merged != words_[i];
+    words_[i] = merged;
+  }
+  return changed;
+}
+
+bool BitVector::intersectWith(const BitVector& other) {
+  bool changed = false;
+  for (size_t i = 0; i < words_.size(); i++) {
+    uint64_t merged = words_[i] & other.words_[i];
+    changed = changed || merged != words_[i];
+    words_[i] = merged;
+  }
+  return changed;
+}
+
+void BitVector::subtract(const BitVector& other) {
+  for (size_t i = 0; i < words_.size(); i++) words_[i] &= ~other.words_[i];
+}
+
+DataflowSolution solveDataflow(const ControlFlowGraph& graph, const DataflowProblem& problem) {
+  size_t blockCount = graph.blocks.size();
+  bool forward = problem.direction == DataflowDirection::Forward;
+  bool intersect = problem.meet == DataflowMeet::Intersection;
+
+  // Edges in the direction of flow
+  std::vector<std::vector<uint32_t>> incoming(blockCount);
+  std::vector<std::vector<uint32_t>> successors(blockCount);
+  for (uint32_t e = 0; e < graph.edges.size(); e++) {
+    const CfgEdge& edge = graph.edges[e];
+    uint32_t from = forward ? edge.from : edge.to;
+    uint32_t to = forward ? edge.to : edge.from;
+    incoming[to].push_back(e);
+    successors[from].push_back(to);
+  }
+
+  // Unreachable blocks keep the meet's identity so they never weaken a join
+  DataflowSolution solution;
+  BitVector top(problem.factCount, intersect);
+  solution.in.assign(blockCount, top);
+  solution.out.assign(blockCount, top);
+
+  uint32_t start = forward ? kEntryBlock : kExitBlock;
+  std::vector<uint32_t> order = reversePostorder(start, successors);
+  std::vector<uint8_t> queued(blockCount, 0);
+  std::deque<uint32_t> worklist(order.begin(), order.end());
+  for (uint32_t block : order) queued[block] = 1;
+
+  BitVector boundary = problem.boundary.size() == problem.factCount ? problem.boundary
+                                                                     : BitVector(problem.factCount);
+  while (!worklist.empty()) {
+    uint32_t block = worklist.front();
+    worklist.pop_front();
+    queued[block] = 0;
+
+    BitVector in = block == start ? boundary : top;
+    if (block != start) {
+      for (uint32_t e : incoming[block]) {
+        const CfgEdge& edge = graph.edges[e];
+        BitVector value = solution.out[forward ? edge.from : edge.to];
+        if (!problem.edgeGen.empty()) value.unionWith(problem.edgeGen[e]);
+        if (intersect) {
+          in.intersectWith(value);
+        } else {
+          in.unionWith(value);
+        }
+      }
+    }
+
+    BitVector out = in;
+    out.subtract(problem.kill[block]);
+    out.unionWith(problem.gen[block]);
+    solution.in[block] = std::move(in);
+    solution.iterations++;
+    if (out == solution.out[block]) continue;
+    solution.out[block] = std::move(out);
+    for (uint32_t next : successors[block]) {
+      if (!queued[next]) {
+        queued[next] = 1;
+        worklist.push_back(next);
+      }
+    }
+  }
+  return solution;
+}
+
+const char* definitionKindName(DefinitionKind kind) {
+  switch (kind) {
+    case DefinitionKind::Parameter: return "parameter";
+    case DefinitionKind::Declaration: return "declaration";
+    case DefinitionKind::Assignment: return "assignment";
+    case DefinitionKind::Update: return "update";
+    case DefinitionKind::LoopVariable: return "loop";
+  }
+  return "assignment";
+}
+
+const char* narrowingReasonName(NarrowingReason reason) {
+  switch (reason) {
+    case NarrowingReason::Typeof: return "typeof";
+    case NarrowingReason::Instanceof: return "instanceof";
+    case NarrowingReason::Equality: return "equality";
+    case NarrowingReason::Truthiness: return "control_flow";
+  }
+  return "control_flow";
+}
+
+std::string_view FunctionDataflow::condition(const Narrowing& narrowing) const {
+  return graph->source->slice(narrowing.conditionStart, narrowing.conditionEnd);
+}
+
+FunctionDataflowPtr analyzeFunctionDataflow(const SyntaxTree& tree, ControlFlowGraphPtr graph) {
+  if (!graph) return nullptr;
+  return DataflowBuilder(tree, std::move(graph)).run();
+}
+
+FunctionDataflowPtr functionDataflowFor(const std::string& filePath,
+                                        const std::string& functionName, SourceBufferPtr source) {
+  std::string key = filePath;
+  key.push_back('\0');
+  key += functionName;
+  uint64_t contentHash = source->contentHash();
+  DataflowCache& cache = dataflowCache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end() && it->second.contentHash == contentHash) {
+      cache.hits++;
+      return it->second.dataflow;
+    }
+    cache.misses++;
+  }
+
+  LanguageId language = languageForPath(filePath);
+  if (language == LanguageId::Unknown) return nullptr;
+  SyntaxTreePtr tree = parseCached(language, std::move(source));
+  if (!tree) return nullptr;
+  FunctionDataflowPtr dataflow =
+      analyzeFunctionDataflow(*tree, controlFlowGraphFor(*tree, filePath, functionName));
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.entries.size() >= kMaxCachedFunctions) cache.entries.clear();
+  cache.entries[key] = {contentHash, dataflow};
+  return dataflow;
+}
+
+bool dataflowAt(const FunctionDataflow& dataflow, uint32_t line, DataflowPoint& point) {
+  const ControlFlowGraph& graph = *dataflow.graph;
+  if (line < graph.startLine || line > graph.endLine) return false;
+
+  // Latest statement or branch header starting at or before line; the first
+  // one on line wins. Headers hold no statements, so their facts are the
+  // block's input.
+  uint32_t best = kNoStatement;
+  uint32_t bestBlock = kEntryBlock;
+  uint32_t bestLine = 0;
+  uint32_t bestByte = 0;
+  bool found = false;
+  auto consider = [&](uint32_t candidateLine, uint32_t startByte, uint32_t block, uint32_t statement) {
+    if (candidateLine > line) return;
+    if (!found || candidateLine > bestLine || (candidateLine == bestLine && startByte < bestByte)) {
+      best = statement;
+      bestBlock = block;
+      bestLine = candidateLine;
+      bestByte = startByte;
+      found = true;
+    }
+  };
+  std::string_view source = graph.source->view();
+  for (uint32_t b = 0; b < graph.blocks.size(); b++) {
+    const CfgBlock& block = graph.blocks[b];
+    if (!block.reachable) continue;
+    if (block.statementCount == 0 && !block.fixedLabel && block.labelStart >= graph.startByte) {
+      auto headerLine = static_cast<uint32_t>(
+          graph.startLine + std::count(source.begin() + graph.startByte,
+                                       source.begin() + block.labelStart, '\n'));
+      consider(headerLine, block.labelStart, b, kNoStatement);
+    }
+    for (uint32_t s = block.firstStatement; s < block.firstStatement + block.statementCount; s++) {
+      const CfgStatement& statement = graph.statements[s];
+      consider(statement.line, statement.startByte, b, s);
+    }
+  }
+
+  BitVector reaching;
+  BitVector narrowed;
+  if (!found) {
+    // On the signature: only parameters are defined
+    reaching = dataflow.reaching.out[kEntryBlock];
+    narrowed = dataflow.narrowed.out[kEntryBlock];
+  } else if (best == kNoStatement) {
+    reaching = dataflow.reaching.in[bestBlock];
+    narrowed = dataflow.narrowed.in[bestBlock];
+  } else {
+    reaching = dataflow.reaching.in[bestBlock];
+    narrowed = dataflow.narrowed.in[bestBlock];
+    uint32_t last = bestLine == line ? best : best + 1;
+    for (uint32_t s = graph.blocks[bestBlock].firstStatement; s < last; s++) {
+      for (uint32_t d : dataflow.statementDefinitions[s]) {
+        const std::string& name = dataflow.definitions[d].name;
+        for (uint32_t other = 0; other < dataflow.definitions.size(); other++) {
+          if (dataflow.definitions[other].name == name) reaching.reset(other);
+        }
+        reaching.set(d);
+        for (uint32_t n = 0; n < dataflow.narrowings.size(); n++) {
+          if (dataflow.narrowings[n].variable == name) narrowed.reset(n);
+        }
+      }
+    }
+  }
+
+  point.block = bestBlock;
+  point.reachingDefinitions.clear();
+  point.narrowings.clear();
+  reaching.forEach([&](uint32_t d) { point.reachingDefinitions.push_back(d); });
+  narrowed.forEach([&](uint32_t n) { point.narrowings.push_back(n); });
+  return true;
+}
+
+DataflowCacheStats dataflowCacheStats() {
+  DataflowCache& cache = dataflowCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return {cache.entries.size(), cache.hits, cache.misses};
+}
+
+}  // namespace prism
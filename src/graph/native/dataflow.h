@@ -0,0 +1,146 @@
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "control_flow.h"
+
+namespace prism {
+
+// Fixed-size set of small integers. Every lattice here is a power set of facts
+// numbered 0..size-1, so meets and transfers are word-wide bit operations.
+class BitVector {
+ public:
+  BitVector() = default;
+  explicit BitVector(size_t size, bool filled = false);
+
+  size_t size() const { return size_; }
+  bool test(size_t bit) const { return (words_[bit >> 6] >> (bit & 63)) & 1; }
+  void set(size_t bit) { words_[bit >> 6] |= uint64_t(1) << (bit & 63); }
+  void reset(size_t bit) { words_[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+  void fill();
+
+  // Return whether this set changed.
+  bool unionWith(const BitVector& other);
+  bool intersectWith(const BitVector& other);
+  void subtract(const BitVector& other);
+
+  bool operator==(const BitVector& other) const { return words_ == other.words_; }
+  bool operator!=(const BitVector& other) const { return words_ != other.words_; }
+
+  template <typename Fn>
+  void forEach(Fn&& fn) const {
+    for (size_t w = 0; w < words_.size(); w++) {
+      for (uint64_t word = words_[w]; word != 0; word &= word - 1) {
+        fn(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+  }
+
+ private:
+  size_t size_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+enum class DataflowDirection : uint8_t { Forward, Backward };
+enum class DataflowMeet : uint8_t { Union, Intersection };
+
+// Gen/kill problem over a CFG: out = gen | (in & ~kill) per block, where in is
+// the meet over incoming edges of the predecessor's out plus the facts that
+// edge generates (branch conditions hold only along their true or false edge).
+struct DataflowProblem {
+  size_t factCount = 0;
+  DataflowDirection direction = DataflowDirection::Forward;
+  DataflowMeet meet = DataflowMeet::Union;
+  BitVector boundary;               // In of the entry, or of the exit when backward
+  std::vector<BitVector> gen;       // By block
+  std::vector<BitVector> kill;      // By block
+  std::vector<BitVector> edgeGen;   // By edge; empty when no edge generates facts
+};
+
+struct DataflowSolution {
+  std::vector<BitVector> in;   // By block, in the direction of flow
+  std::vector<BitVector> out;
+  size_t iterations = 0;       // Block transfers evaluated
+};
+
+// Worklist solver. Blocks are seeded in reverse postorder of the flow
+// direction, so acyclic regions settle in one pass and loops only revisit
+// the blocks whose inputs changed.
+DataflowSolution solveDataflow(const ControlFlowGraph& graph, const DataflowProblem& problem);
+
+enum class DefinitionKind : uint8_t { Parameter, Declaration, Assignment, Update, LoopVariable };
+
+struct Definition {
+  std::string name;
+  DefinitionKind kind;
+  uint32_t block;
+  uint32_t statement;  // Graph statement index; UINT32_MAX for parameters and loop heads
+  uint32_t line;       // 1-based
+  uint32_t column;
+  std::string type;    // Annotation or literal type; empty when unknown
+};
+
+enum class NarrowingReason : uint8_t { Typeof, Instanceof, Equality, Truthiness };
+
+// A type a variable has along one branch of a condition.
+struct Narrowing {
+  std::string variable;
+  std::string type;
+  NarrowingReason reason;
+  uint32_t conditionStart;  // Byte range of the condition that implies it
+  uint32_t conditionEnd;
+  uint32_t line;
+  uint32_t column;
+};
+
+// Reaching definitions (may, union meet) and type narrowing (must,
+// intersection meet) for one function.
+struct FunctionDataflow {
+  ControlFlowGraphPtr graph;
+  std::vector<Definition> definitions;
+  std::vector<Narrowing> narrowings;
+  std::vector<std::vector<uint32_t>> statementDefinitions;  // By graph statement
+  DataflowSolution reaching;  // Facts are definition indices
+  DataflowSolution narrowed;  // Facts are narrowing indices
+
+  std::string_view condition(const Narrowing& narrowing) const;
+};
+
+using FunctionDataflowPtr = std::shared_ptr<const FunctionDataflow>;
+
+const char* definitionKindName(DefinitionKind kind);
+const char* narrowingReasonName(NarrowingReason reason);
+
+FunctionDataflowPtr analyzeFunctionDataflow(const SyntaxTree& tree, ControlFlowGraphPtr graph);
+
+// analyzeFunctionDataflow memoized by (filePath, functionName, content hash).
+// Null when the function is not found.
+FunctionDataflowPtr functionDataflowFor(const std::string& filePath,
+                                        const std::string& functionName, SourceBufferPtr source);
+
+struct DataflowPoint {
+  uint32_t block;
+  std::vector<uint32_t> reachingDefinitions;
+  std::vector<uint32_t> narrowings;
+};
+
+// Facts holding just before the first reachable statement or branch header on
+// line, or after the last one that starts before it. False when line is
+// outside the function.
+bool dataflowAt(const FunctionDataflow& dataflow, uint32_t line, DataflowPoint& point);
+
+struct DataflowCacheStats {
+  size_t entries;
+  size_t hits;
+  size_t misses;
+};
+
+DataflowCacheStats dataflowCacheStats();
+
+}  // namespace prism
+
+#endif  // DATAFLOW_H
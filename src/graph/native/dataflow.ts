@@ -0,0 +1,74 @@
+import { addon } from './addon.js';
+
+export type DefinitionKind = 'parameter' | 'declaration' | 'assignment' | 'update' | 'loop';
+
+export interface DataflowDefinition {
+  name: string;
+  kind: DefinitionKind;
+  line: number;
+  column: number;
+  /** CFG block (`block_<n>`) the definition is in. */
+  block: string;
+  /** Type annotation, or the type of a literal initializer. */
+  type?: string;
+}
+
+export interface DataflowNarrowing {
+  variableName: string;
+  narrowedType: string;
+  reason: 'typeof' | 'instanceof' | 'equality' | 'control_flow';
+  /** Source text of the test that implies the narrowing. */
+  condition: string;
+  line: number;
+  column: number;
+}
+
+export interface DataflowBlock {
+  id: string;
+  /** Indices into `definitions`. */
+  reachingIn: number[];
+  reachingOut: number[];
+  /** Indices into `narrowings` that hold on every path into the block. */
+  narrowedIn: number[];
+}
+
+export interface FunctionDataflow {
+  definitions: DataflowDefinition[];
+  narrowings: DataflowNarrowing[];
+  blocks: DataflowBlock[];
+  /** Block transfers the worklist solver evaluated. */
+  iterations: number;
+}
+
+export interface DataflowPoint {
+  block: string;
+  reachingDefinitions: DataflowDefinition[];
+  narrowings: DataflowNarrowing[];
+}
+
+/**
+ * Reaching definitions and type narrowing for one function, solved natively
+ * over its control-flow graph. Results are cached by file, function and
+ * content hash. Returns null when the function is not found.
+ */
+export function analyzeDataflow(
+  source: string | Buffer,
+  filePath: string,
+  functionName: string
+): FunctionDataflow | null {
+  return addon.analyzeDataflow(source, filePath, functionName);
+}
+
+/**
+ * Definitions that reach, and narrowings that hold at, the first statement or
+ * branch test on a 1-based line of the function. Returns null when the line is
+ * outside it.
+ */
+export function dataflowAt(
+  source: string | Buffer,
+  filePath: string,
+  functionName: string,
+  line: number
+): DataflowPoint | null {
+  return addon.dataflowAt(source, filePath, functionName, line);
+}
@@ -0,0 +1,733 @@
+#include "disk_cache.h"
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+#include "config_scanner.h"
+
+namespace fs = std::filesystem;
+
+namespace prism {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'R', 'I', 'S', 'M', 'P', 'C', '1'};
+// Bump whenever the record layout or what extraction produces changes.
+constexpr uint32_t kFormatVersion = 4;
+constexpr char kPathMark = '\0';  // Stands for the file's own path
+constexpr const char* kRecordSuffix = ".rec";
+// Records read are marked recently used at most this often.
+constexpr auto kTouchInterval = std::chrono::hours(1);
+// Temporary files this old were left by a writer that died.
+constexpr auto kStaleTemporary = std::chrono::hours(1);
+// Bit vectors hold one bit per parameter, so anything larger is corrupt.
+constexpr uint64_t kMaxBits = 1 << 16;
+
+struct RecordHeader {
+  char magic[8];
+  uint32_t format;
+  uint32_t reserved;
+  uint64_t fingerprint;
+  uint64_t contentHash;
+  uint64_t contentSize;
+  uint64_t payloadSize;
+  uint64_t payloadHash;
+};
+
+uint64_t grammarFingerprint(LanguageId language, ConfigFormat configFormat) {
+  const TSLanguage* grammar = tsLanguageFor(language);
+  uint64_t parts[] = {
+      kFormatVersion,
+      static_cast<uint64_t>(language),
+      static_cast<uint64_t>(configFormat),
+      grammar ? ts_language_version(grammar) : 0,
+      grammar ? ts_language_symbol_count(grammar) : 0,
+      grammar ? ts_language_field_count(grammar) : 0,
+  };
+  return hashBytes(reinterpret_cast<const char*>(parts), sizeof(parts));
+}
+
+std::string hex(uint64_t value) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out(16, '0');
+  for (int i = 15; i >= 0; i--, value >>= 4) out[i] = digits[value & 15];
+  return out;
+}
+
+// Varint-encoded record body. Strings have the file's path replaced by
+// kPathMark so a record serves any path with the same contents.
+class RecordWriter {
+ public:
+  explicit RecordWriter(const std::string& filePath) : filePath_(filePath) {}
+
+  void number(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+  void signedNumber(int64_t value) {
+    number((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+  void flag(bool value) { out_.push_back(value ? 1 : 0); }
+  void text(std::string_view value) {
+    std::string stripped;
+    size_t at = filePath_.empty() ? std::string_view::npos : value.find(filePath_);
+    if (at != std::string_view::npos) {
+      for (size_t from = 0; from <= value.size();) {
+        at = value.find(filePath_, from);
+        if (at == std::string_view::npos) {
+          stripped.append(value.substr(from));
+          break;
+        }
+        stripped.append(value.substr(from, at - from)).push_back(kPathMark);
+        from = at + filePath_.size();
+      }
+      value = stripped;
+    }
+    number(value.size());
+    out_.append(value);
+  }
+  void bits(const BitVector& value) {
+    std::vector<uint32_t> set;
+    value.forEach([&](uint32_t bit) { set.push_back(bit); });
+    number(value.size());
+    number(set.size());
+    for (uint32_t bit : set) number(bit);
+  }
+  std::string& bytes() { return out_; }
+
+ private:
+  const std::string& filePath_;
+  std::string out_;
+};
+
+class RecordReader {
+ public:
+  RecordReader(std::string_view in, const std::string& filePath) : in_(in), filePath_(filePath) {}
+
+  bool ok() const { return ok_; }
+  bool done() const { return ok_ && at_ == in_.size(); }
+
+  uint64_t number() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (at_ >= in_.size()) return fail();
+      uint8_t byte = static_cast<uint8_t>(in_[at_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    return fail();
+  }
+  int64_t signedNumber() {
+    uint64_t value = number();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  bool flag() {
+    if (at_ >= in_.size()) return fail();
+    return in_[at_++] != 0;
+  }
+  std::string text() {
+    uint64_t length = number();
+    if (length > in_.size() - at_) return fail(), std::string();
+    std::string_view raw = in_.substr(at_, length);
+    at_ += length;
+    std::string value;
+    value.reserve(raw.size());
+    for (char c : raw) {
+      if (c == kPathMark) {
+        value += filePath_;
+      } else {
+        value.push_back(c);
+      }
+    }
+    return value;
+  }
+  BitVector bits() {
+    uint64_t size = number();
+    uint64_t count = number();
+    if (size > kMaxBits || count > size) return fail(), BitVector();
+    BitVector value(size);
+    for (uint64_t i = 0; i < count && ok_; i++) {
+      uint64_t bit = number();
+      if (bit >= size) return fail(), BitVector();
+      value.set(bit);
+    }
+    return value;
+  }
+  // Element count of a list, which cannot exceed the bytes left since every
+  // element takes at least one.
+  size_t count() {
+    uint64_t value = number();
+    if (value > in_.size() - at_) return fail();
+    return value;
+  }
+
+ private:
+  std::string_view in_;
+  const std::string& filePath_;
+  size_t at_ = 0;
+  bool ok_ = true;
+
+  uint64_t fail() {
+    ok_ = false;
+    at_ = in_.size();
+    return 0;
+  }
+};
+
+void writeSymbol(RecordWriter& out, const Symbol& symbol) {
+  out.text(symbol.id);
+  out.text(symbol.name);
+  out.text(symbol.type);
+  out.text(symbol.filePath);
+  out.signedNumber(symbol.line);
+  out.signedNumber(symbol.column);
+  out.signedNumber(symbol.endLine);
+  out.text(symbol.className);
+  out.flag(symbol.isExported);
+  out.flag(symbol.isStatic);
+}
+
+Symbol readSymbol(RecordReader& in) {
+  Symbol symbol;
+  symbol.id = in.text();
+  symbol.name = in.text();
+  symbol.type = in.text();
+  symbol.filePath = in.text();
+  symbol.line = static_cast<int>(in.signedNumber());
+  symbol.column = static_cast<int>(in.signedNumber());
+  symbol.endLine = static_cast<int>(in.signedNumber());
+  symbol.className = in.text();
+  symbol.isExported = in.flag();
+  symbol.isStatic = in.flag();
+  return symbol;
+}
+
+void writeReference(RecordWriter& out, const Reference& ref) {
+  out.text(ref.id);
+  out.text(ref.fromSymbolId);
+  out.text(ref.toSymbolId);
+  out.text(ref.type);
+  out.text(ref.filePath);
+  out.signedNumber(ref.line);
+  out.signedNumber(ref.column);
+  out.text(ref.name);
+  out.text(ref.receiverClass);
+  out.flag(ref.superCall);
+}
+
+Reference readReference(RecordReader& in) {
+  Reference ref;
+  ref.id = in.text();
+  ref.fromSymbolId = in.text();
+  ref.toSymbolId = in.text();
+  ref.type = in.text();
+  ref.filePath = in.text();
+  ref.line = static_cast<int>(in.signedNumber());
+  ref.column = static_cast<int>(in.signedNumber());
+  ref.name = in.text();
+  ref.receiverClass = in.text();
+  ref.superCall = in.flag();
+  return ref;
+}
+
+template <typename T, typename Write>
+void writeList(RecordWriter& out, const std::vector<T>& items, Write write) {
+  out.number(items.size());
+  for (const auto& item : items) write(out, item);
+}
+
+template <typename T, typename Read>
+void readList(RecordReader& in, std::vector<T>& items, Read read) {
+  size_t count = in.count();
+  items.reserve(count);
+  for (size_t i = 0; i < count && in.ok(); i++) items.push_back(read(in));
+}
+
+void writeText(RecordWriter& out, const std::string& value) {
+  out.text(value);
+}
+
+std::string readText(RecordReader& in) {
+  return in.text();
+}
+
+// Members are written without members of their own, so reading never nests
+// deeper than one level whatever the record says.
+void writeSkeletonItem(RecordWriter& out, const SkeletonItem& item, bool withMembers) {
+  out.number(static_cast<uint64_t>(item.kind));
+  out.number(static_cast<uint64_t>(item.visibility));
+  out.number(item.flags);
+  out.text(item.name);
+  out.text(item.type);
+  out.text(item.extends);
+  writeList(out, item.bases, writeText);
+  out.text(item.alias);
+  writeList(out, item.decorators, writeText);
+  writeList(out, item.parameters, [](RecordWriter& out, const SkeletonParameter& parameter) {
+    out.text(parameter.name);
+    out.text(parameter.type);
+    out.text(parameter.defaultValue);
+  });
+  if (!withMembers) return;
+  writeList(out, item.members, [](RecordWriter& out, const SkeletonItem& member) {
+    writeSkeletonItem(out, member, false);
+  });
+}
+
+// valid is cleared when a kind or visibility is out of range.
+SkeletonItem readSkeletonItem(RecordReader& in, bool withMembers, bool& valid) {
+  SkeletonItem item;
+  uint64_t kind = in.number();
+  uint64_t visibility = in.number();
+  uint64_t flags = in.number();
+  if (kind > static_cast<uint64_t>(SkeletonKind::EnumMember) ||
+      visibility > static_cast<uint64_t>(Visibility::Protected) || flags > 0xff) {
+    valid = false;
+  }
+  item.kind = static_cast<SkeletonKind>(kind);
+  item.visibility = static_cast<Visibility>(visibility);
+  item.flags = static_cast<uint8_t>(flags);
+  item.name = in.text();
+  item.type = in.text();
+  item.extends = in.text();
+  readList(in, item.bases, readText);
+  item.alias = in.text();
+  readList(in, item.decorators, readText);
+  readList(in, item.parameters, [](RecordReader& in) {
+    SkeletonParameter parameter;
+    parameter.name = in.text();
+    parameter.type = in.text();
+    parameter.defaultValue = in.text();
+    return parameter;
+  });
+  if (withMembers) {
+    readList(in, item.members,
+             [&valid](RecordReader& in) { return readSkeletonItem(in, false, valid); });
+  }
+  return item;
+}
+
+void writeSkeleton(RecordWriter& out, const FileSkeleton& skeleton) {
+  writeList(out, skeleton.imports, [](RecordWriter& out, const SkeletonImport& imported) {
+    out.text(imported.source);
+    out.number(imported.imported.size());
+    for (const auto& name : imported.imported) {
+      out.text(name.first);
+      out.text(name.second);
+    }
+    out.flag(imported.isDefault);
+    out.flag(imported.isNamespace);
+  });
+  writeList(out, skeleton.items, [](RecordWriter& out, const SkeletonItem& item) {
+    writeSkeletonItem(out, item, true);
+  });
+  writeList(out, skeleton.surface, [](RecordWriter& out, const SurfaceItem& item) {
+    out.text(item.name);
+    out.text(item.type);
+    out.text(item.signature);
+    writeList(out, item.members, writeText);
+    out.text(item.source);
+    out.flag(item.isDefault);
+  });
+}
+
+bool readSkeleton(RecordReader& in, FileSkeleton& skeleton) {
+  bool valid = true;
+  readList(in, skeleton.imports, [](RecordReader& in) {
+    SkeletonImport imported;
+    imported.source = in.text();
+    readList(in, imported.imported, [](RecordReader& in) {
+      std::string name = in.text();
+      return std::make_pair(std::move(name), in.text());
+    });
+    imported.isDefault = in.flag();
+    imported.isNamespace = in.flag();
+    return imported;
+  });
+  readList(in, skeleton.items,
+           [&valid](RecordReader& in) { return readSkeletonItem(in, true, valid); });
+  readList(in, skeleton.surface, [](RecordReader& in) {
+    SurfaceItem item;
+    item.name = in.text();
+    item.type = in.text();
+    item.signature = in.text();
+    readList(in, item.members, readText);
+    item.source = in.text();
+    item.isDefault = in.flag();
+    return item;
+  });
+  return valid && in.ok();
+}
+
+}  // namespace
+
+std::string encodeFileAnalysis(const std::string& filePath, const FileAnalysis& analysis) {
+  RecordWriter out(filePath);
+  const ExtractionResult& extraction = *analysis.extraction;
+  writeList(out, extraction.symbols, writeSymbol);
+  writeList(out, extraction.imports, [](RecordWriter& out, const ImportEntry& entry) {
+    out.text(entry.source);
+    out.number(entry.imported.size());
+    for (const auto& name : entry.imported) out.text(name);
+    out.flag(entry.isTypeOnly);
+  });
+  writeList(out, extraction.callSites, writeReference);
+  writeList(out, extraction.bases, [](RecordWriter& out, const ClassBase& base) {
+    out.text(base.classId);
+    out.text(base.name);
+    out.flag(base.isImplements);
+  });
+  writeList(out, extraction.exports, [](RecordWriter& out, const ExportEntry& entry) {
+    out.text(entry.name);
+    out.text(entry.localName);
+    out.text(entry.source);
+    out.flag(entry.isTypeOnly);
+  });
+  writeList(out, analysis.configCallSites, writeReference);
+  writeList(out, analysis.functionFacts, [](RecordWriter& out, const LocalFunctionFacts& facts) {
+    out.text(facts.symbolId);
+    out.text(facts.name);
+    out.number(facts.bodyHash);
+    out.number(facts.parameters.size());
+    for (const auto& parameter : facts.parameters) out.text(parameter);
+    out.number(facts.calls.size());
+    for (const auto& call : facts.calls) {
+      out.text(call.callee);
+      out.number(call.line);
+      out.number(call.arguments.size());
+      for (const auto& argument : call.arguments) out.bits(argument);
+    }
+    out.bits(facts.returns);
+    out.number(facts.globalWrites.size());
+    for (const auto& write : facts.globalWrites) {
+      out.text(write.first);
+      out.bits(write.second);
+    }
+  });
+  writeList(out, analysis.usedNames, [](RecordWriter& out, std::string_view name) {
+    out.text(name);
+  });
+
+  // Occurrence names are stored once each and referred to by index.
+  std::vector<std::string_view> names;
+  std::unordered_map<std::string_view, uint32_t> nameIndex;
+  for (const auto& occurrence : analysis.occurrences) {
+    if (nameIndex.emplace(occurrence.name, static_cast<uint32_t>(names.size())).second) {
+      names.push_back(occurrence.name);
+    }
+  }
+  writeList(out, names, [](RecordWriter& out, std::string_view name) { out.text(name); });
+  writeList(out, analysis.occurrences, [&](RecordWriter& out, const Occurrence& occurrence) {
+    out.number(nameIndex.at(occurrence.name));
+    out.number(occurrence.line);
+    out.number(occurrence.column);
+    out.number(static_cast<uint64_t>(occurrence.kind));
+    out.number(occurrence.flags);
+  });
+  out.flag(analysis.skeleton != nullptr);
+  if (analysis.skeleton) writeSkeleton(out, *analysis.skeleton);
+  return std::move(out.bytes());
+}
+
+bool decodeFileAnalysis(std::string_view payload, const std::string& filePath,
+                        FileAnalysis& out) {
+  RecordReader in(payload, filePath);
+  auto extraction = std::make_shared<ExtractionResult>();
+  readList(in, extraction->symbols, readSymbol);
+  readList(in, extraction->imports, [](RecordReader& in) {
+    ImportEntry entry;
+    entry.source = in.text();
+    readList(in, entry.imported, [](RecordReader& in) { return in.text(); });
+    entry.isTypeOnly = in.flag();
+    return entry;
+  });
+  readList(in, extraction->callSites, readReference);
+  readList(in, extraction->bases, [](RecordReader& in) {
+    ClassBase base;
+    base.classId = in.text();
+    base.name = in.text();
+    base.isImplements = in.flag();
+    return base;
+  });
+  readList(in, extraction->exports, [](RecordReader& in) {
+    ExportEntry entry;
+    entry.name = in.text();
+    entry.localName = in.text();
+    entry.source = in.text();
+    entry.isTypeOnly = in.flag();
+    return entry;
+  });
+  readList(in, out.configCallSites, readReference);
+  readList(in, out.functionFacts, [](RecordReader& in) {
+    LocalFunctionFacts facts;
+    facts.symbolId = in.text();
+    facts.name = in.text();
+    facts.bodyHash = in.number();
+    readList(in, facts.parameters, [](RecordReader& in) { return in.text(); });
+    readList(in, facts.calls, [](RecordReader& in) {
+      SummaryCall call;
+      call.callee = in.text();
+      call.line = static_cast<uint32_t>(in.number());
+      readList(in, call.arguments, [](RecordReader& in) { return in.bits(); });
+      return call;
+    });
+    facts.returns = in.bits();
+    readList(in, facts.globalWrites, [](RecordReader& in) {
+      std::string global = in.text();
+      return std::make_pair(std::move(global), in.bits());
+    });
+    return facts;
+  });
+
+  // Names back the usedNames and occurrence views, so they are read into
+  // storage reserved up front and never reallocated.
+  size_t usedCount = in.count();
+  std::vector<std::string> usedNames;
+  usedNames.reserve(usedCount);
+  for (size_t i = 0; i < usedCount && in.ok(); i++) usedNames.push_back(in.text());
+  size_t nameCount = in.count();
+  out.names.reserve(usedCount + nameCount);
+  for (auto& name : usedNames) out.names.push_back(std::move(name));
+  for (size_t i = 0; i < nameCount && in.ok(); i++) out.names.push_back(in.text());
+  if (!in.ok()) return false;
+  out.usedNames.assign(out.names.begin(), out.names.begin() + usedCount);
+
+  size_t occurrenceCount = in.count();
+  out.occurrences.reserve(occurrenceCount);
+  for (size_t i = 0; i < occurrenceCount && in.ok(); i++) {
+    uint64_t name = in.number();
+    Occurrence occurrence;
+    occurrence.line = static_cast<uint32_t>(in.number());
+    occurrence.column = static_cast<uint32_t>(in.number());
+    occurrence.kind = static_cast<UsageKind>(in.number());
+    occurrence.flags = static_cast<uint8_t>(in.number());
+    if (name >= nameCount) return false;
+    occurrence.name = out.names[usedCount + name];
+    out.occurrences.push_back(occurrence);
+  }
+  if (in.flag()) {
+    auto skeleton = std::make_shared<FileSkeleton>();
+    if (!readSkeleton(in, *skeleton)) return false;
+    out.skeleton = std::move(skeleton);
+  }
+  if (!in.done()) return false;
+  out.extraction = std::move(extraction);
+  return true;
+}
+
+namespace {
+
+bool readWhole(int fd, std::string& out) {
+  struct stat info;
+  if (fstat(fd, &info) != 0) return false;
+  out.resize(static_cast<size_t>(info.st_size));
+  size_t done = 0;
+  while (done < out.size()) {
+    ssize_t n = read(fd, &out[done], out.size() - done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool writeWhole(int fd, const std::string& bytes) {
+  size_t done = 0;
+  while (done < bytes.size()) {
+    ssize_t n = write(fd, bytes.data() + done, bytes.size() - done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+}  // namespace
+
+DiskParseCache::DiskParseCache(std::string directory, uint64_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+  std::error_code ec;
+  fs::create_directories(directory_, ec);
+  usable_ = fs::is_directory(directory_, ec);
+}
+
+std::string DiskParseCache::recordPath(LanguageId language, const std::string& filePath,
+                                       const SourceBuffer& source) const {
+  std::string hash = hex(source.contentHash());
+  return directory_ + "/" + hash.substr(0, 2) + "/" + hash + "-" +
+         hex(grammarFingerprint(language, configFormatForPath(filePath))) + kRecordSuffix;
+}
+
+bool DiskParseCache::load(const std::string& filePath, LanguageId language,
+                          const SourceBuffer& source, FileAnalysis& out,
+                          std::string* payloadOut) {
+  if (!usable_) return false;
+  std::string path = recordPath(language, filePath, source);
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.misses++;
+    return false;
+  }
+  std::string bytes;
+  bool read = readWhole(fd, bytes);
+  struct stat info;
+  if (read && fstat(fd, &info) == 0) {
+    auto modified = std::chrono::system_clock::from_time_t(info.st_mtime);
+    if (std::chrono::system_clock::now() - modified > kTouchInterval) futimens(fd, nullptr);
+  }
+  close(fd);
+
+  RecordHeader header;
+  bool valid = read && bytes.size() >= sizeof(header);
+  if (valid) {
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    std::string_view payload(bytes.data() + sizeof(header), bytes.size() - sizeof(header));
+    valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+            header.format == kFormatVersion &&
+            header.fingerprint == grammarFingerprint(language, configFormatForPath(filePath)) &&
+            header.contentHash == source.contentHash() && header.contentSize == source.size() &&
+            header.payloadSize == payload.size() &&
+            header.payloadHash == hashBytes(payload.data(), payload.size()) &&
+            decodeFileAnalysis(payload, filePath, out);
+    if (valid && payloadOut) payloadOut->assign(payload);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!valid) {
+    out = FileAnalysis();
+    stats_.rejected++;
+    stats_.misses++;
+    return false;
+  }
+  stats_.hits++;
+  return true;
+}
+
+void DiskParseCache::store(const std::string& filePath, LanguageId language,
+                           const SourceBuffer& source, const FileAnalysis& analysis) {
+  if (!usable_ || !analysis.extraction) return;
+  std::string payload = encodeFileAnalysis(filePath, analysis);
+  RecordHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format = kFormatVersion;
+  header.reserved = 0;
+  header.fingerprint = grammarFingerprint(language, configFormatForPath(filePath));
+  header.contentHash = source.contentHash();
+  header.contentSize = source.size();
+  header.payloadSize = payload.size();
+  header.payloadHash = hashBytes(payload.data(), payload.size());
+  std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+  bytes += payload;
+
+  std::string path = recordPath(language, filePath, source);
+  std::error_code ec;
+  fs::create_directories(fs::path(path).parent_path(), ec);
+  std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." +
+                          std::to_string(nextTemporary_.fetch_add(1));
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  bool written = fd >= 0 && writeWhole(fd, bytes);
+  if (fd >= 0 && close(fd) != 0) written = false;
+  // rename replaces any record another process wrote meanwhile, which holds
+  // the same analysis.
+  if (!written || rename(temporary.c_str(), path.c_str()) != 0) {
+    if (fd >= 0) unlink(temporary.c_str());
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.writeFailures++;
+    return;
+  }
+  noteWrite(bytes.size());
+}
+
+void DiskParseCache::noteWrite(uint64_t bytes) {
+  bool collectNow;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.writes++;
+    stats_.bytes += bytes;
+    collectNow = (!scanned_ || stats_.bytes > maxBytes_) && stats_.bytes >= retryAt_;
+  }
+  if (collectNow) collect();
+}
+
+void DiskParseCache::collect() {
+  if (!usable_) return;
+  std::string lockPath = directory_ + "/gc.lock";
+  int lockFd = open(lockPath.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+  if (lockFd >= 0 && flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+    close(lockFd);  // Another process is collecting
+    lockFd = -1;
+  }
+  if (lockFd < 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.deferredCollections++;
+    retryAt_ = stats_.bytes + std::max<uint64_t>(maxBytes_ / 10, 1);
+    return;
+  }
+
+  struct Record {
+    std::string path;
+    uint64_t size;
+    fs::file_time_type modified;
+  };
+  std::vector<Record> records;
+  uint64_t total = 0;
+  auto now = fs::file_time_type::clock::now();
+  std::error_code ec;
+  fs::recursive_directory_iterator it(directory_, fs::directory_options::skip_permission_denied,
+                                      ec);
+  for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+    const fs::directory_entry& entry = *it;
+    if (!entry.is_regular_file(ec)) continue;
+    std::string path = entry.path().string();
+    fs::file_time_type modified = entry.last_write_time(ec);
+    if (ec) continue;
+    if (path.find(".tmp.") != std::string::npos) {
+      if (now - modified > kStaleTemporary) fs::remove(entry.path(), ec);
+      continue;
+    }
+    if (path.size() < 4 || path.compare(path.size() - 4, 4, kRecordSuffix) != 0) continue;
+    uint64_t size = entry.file_size(ec);
+    if (ec) continue;
+    records.push_back({std::move(path), size, modified});
+    total += size;
+  }
+
+  size_t removed = 0;
+  if (total > maxBytes_) {
+    std::sort(records.begin(), records.end(),
+              [](const Record& a, const Record& b) { return a.modified < b.modified; });
+    uint64_t target = maxBytes_ / 10 * 8;
+    for (const auto& record : records) {
+      if (total <= target) break;
+      if (unlink(record.path.c_str()) == 0 || errno == ENOENT) {
+        total -= record.size;
+        removed++;
+      }
+    }
+  }
+
+  flock(lockFd, LOCK_UN);
+  close(lockFd);
+  std::lock_guard<std::mutex> lock(mutex_);
+  scanned_ = true;
+  retryAt_ = 0;
+  stats_.bytes = total;
+  stats_.collections++;
+  stats_.collectedFiles += removed;
+}
+
+DiskCacheStats DiskParseCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace prism
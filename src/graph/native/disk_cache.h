@@ -0,0 +1,102 @@
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "extractor.h"
+#include "function_summary.h"
+#include "identifier_index.h"
+#include "skeleton.h"
+#include "source_buffer.h"
+#include "syntax_tree.h"
+
+namespace prism {
+
+// Everything the project index derives from one file's bytes.
+struct FileAnalysis {
+  std::shared_ptr<const ExtractionResult> extraction;
+  std::vector<Reference> configCallSites;
+  std::vector<LocalFunctionFacts> functionFacts;
+  std::vector<std::string_view> usedNames;
+  std::vector<Occurrence> occurrences;
+  std::shared_ptr<const FileSkeleton> skeleton;
+  // Backing for the views above when loaded from disk; they view the tree's
+  // source otherwise.
+  std::vector<std::string> names;
+};
+
+// The record body: filePath in any string is stored as a placeholder, and
+// decoding restores whichever path is given.
+std::string encodeFileAnalysis(const std::string& filePath, const FileAnalysis& analysis);
+bool decodeFileAnalysis(std::string_view payload, const std::string& filePath,
+                        FileAnalysis& out);
+
+struct DiskCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t writes = 0;
+  size_t writeFailures = 0;
+  size_t rejected = 0;       // Unreadable, truncated or for other bytes
+  size_t collections = 0;
+  size_t collectedFiles = 0;
+  size_t deferredCollections = 0;  // Skipped while another process held the lock
+  size_t bytes = 0;          // On disk as of the last scan, plus writes since
+};
+
+// File analyses on disk under directory, content-addressed by the source's
+// hash and a fingerprint of the grammar and record format, so an unchanged
+// file is not reparsed after a restart or by another server process. Records
+// hold no paths: the file's own path is stored as a placeholder and restored
+// for whichever path loads it.
+//
+// Records are written to a temporary file and renamed into place, so readers
+// in any process see a whole record or none. Once the directory grows past
+// maxBytes, the least recently used records are deleted down to 80% of it;
+// one process collects at a time, and a process that finds the lock taken
+// waits for another tenth of maxBytes of writes before trying again.
+class DiskParseCache {
+ public:
+  DiskParseCache(std::string directory, uint64_t maxBytes);
+
+  DiskParseCache(const DiskParseCache&) = delete;
+  DiskParseCache& operator=(const DiskParseCache&) = delete;
+
+  const std::string& directory() const { return directory_; }
+  // False when the directory cannot be created.
+  bool usable() const { return usable_; }
+
+  // On a hit, payloadOut (when given) receives the record's encoded analysis.
+  bool load(const std::string& filePath, LanguageId language, const SourceBuffer& source,
+            FileAnalysis& out, std::string* payloadOut = nullptr);
+  void store(const std::string& filePath, LanguageId language, const SourceBuffer& source,
+             const FileAnalysis& analysis);
+  // Deletes least recently used records until the directory fits maxBytes.
+  void collect();
+  DiskCacheStats stats() const;
+
+ private:
+  std::string directory_;
+  uint64_t maxBytes_;
+  bool usable_ = false;
+
+  mutable std::mutex mutex_;  // Guards stats_ and the size estimate
+  DiskCacheStats stats_;
+  bool scanned_ = false;
+  uint64_t retryAt_ = 0;  // Size estimate a deferred collection waits for
+  std::atomic<uint64_t> nextTemporary_{0};
+
+  std::string recordPath(LanguageId language, const std::string& filePath,
+                         const SourceBuffer& source) const;
+  void noteWrite(uint64_t bytes);
+};
+
+using DiskParseCachePtr = std::shared_ptr<DiskParseCache>;
+
+}  // namespace prism
+
+#endif  // DISK_CACHE_H
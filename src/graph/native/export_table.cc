@@ -0,0 +1,157 @@
+#include "export_table.h"
+
+namespace prism {
+
+void ExportTable::updateFile(const std::string& filePath, std::vector<ExportEntry> entries) {
+  auto it = files_.find(filePath);
+  if (it != files_.end() && it->second == entries) return;
+
+  unlink(filePath);
+  invalidate(filePath);
+  for (const auto& entry : entries) {
+    if (!entry.resolvedPath.empty()) reexporters_[entry.resolvedPath].insert(filePath);
+  }
+  files_[filePath] = std::move(entries);
+}
+
+void ExportTable::removeFile(const std::string& filePath) {
+  if (!files_.count(filePath)) return;
+  unlink(filePath);
+  invalidate(filePath);
+  files_.erase(filePath);
+}
+
+const std::vector<ExportOrigin>& ExportTable::surface(const std::string& filePath) {
+  return cachedSurface(filePath).origins;
+}
+
+bool ExportTable::resolve(const std::string& filePath, const std::string& name, ExportOrigin& out) {
+  const Surface& resolved = cachedSurface(filePath);
+  auto it = resolved.byName.find(name);
+  if (it == resolved.byName.end()) return false;
+  out = resolved.origins[it->second];
+  return true;
+}
+
+ExportTableStats ExportTable::stats() const {
+  ExportTableStats stats;
+  stats.files = files_.size();
+  stats.surfaces = surfaces_.size();
+  stats.computed = computed_;
+  return stats;
+}
+
+const ExportTable::Surface& ExportTable::cachedSurface(const std::string& filePath) {
+  auto it = surfaces_.find(filePath);
+  if (it != surfaces_.end()) return it->second;
+
+  // The outermost file of a cycle sees every name, so it is always cached.
+  std::unordered_set<std::string> visiting;
+  bool cyclic = false;
+  Surface computed = computeSurface(filePath, visiting, cyclic);
+  return surfaces_.emplace(filePath, std::move(computed)).first->second;
+}
+
+ExportTable::Surface ExportTable::surfaceFor(const std::string& filePath,
+                                             std::unordered_set<std::string>& visiting,
+                                             bool& cyclic) {
+  auto it = surfaces_.find(filePath);
+  if (it != surfaces_.end()) return it->second;
+  if (visiting.count(filePath)) {
+    cyclic = true;
+    return Surface();
+  }
+
+  bool childCyclic = false;
+  Surface computed = computeSurface(filePath, visiting, childCyclic);
+  if (childCyclic) {
+    cyclic = true;
+    return computed;
+  }
+  return surfaces_.emplace(filePath, std::move(computed)).first->second;
+}
+
+ExportTable::Surface ExportTable::computeSurface(const std::string& filePath,
+                                                 std::unordered_set<std::string>& visiting,
+                                                 bool& cyclic) {
+  Surface surface;
+  auto fileIt = files_.find(filePath);
+  if (fileIt == files_.end()) return surface;
+  computed_++;
+  visiting.insert(filePath);
+
+  auto add = [&surface](ExportOrigin origin) {
+    if (surface.byName.count(origin.name)) return;
+    surface.byName.emplace(origin.name, surface.origins.size());
+    surface.origins.push_back(std::move(origin));
+  };
+
+  for (const auto& entry : fileIt->second) {
+    if (entry.name == "*") continue;
+    ExportOrigin origin;
+    origin.name = entry.name;
+    origin.localName = entry.localName;
+    if (entry.source.empty()) {
+      origin.filePath = filePath;
+    } else if (entry.resolvedPath.empty()) {
+      origin.module = entry.source;
+      origin.depth = 1;
+    } else {
+      origin.filePath = entry.resolvedPath;
+      origin.depth = 1;
+      if (entry.localName != "*") {
+        Surface target = surfaceFor(entry.resolvedPath, visiting, cyclic);
+        auto it = target.byName.find(entry.localName);
+        // A target that is not indexed, or lacks the name, ends the chain there.
+        if (it != target.byName.end()) {
+          origin = std::move(target.origins[it->second]);
+          origin.name = entry.name;
+          origin.depth++;
+        }
+      }
+    }
+    add(std::move(origin));
+  }
+
+  for (const auto& entry : fileIt->second) {
+    if (entry.name != "*" || entry.resolvedPath.empty()) continue;
+    Surface target = surfaceFor(entry.resolvedPath, visiting, cyclic);
+    for (auto& origin : target.origins) {
+      if (origin.name == "default") continue;
+      origin.depth++;
+      add(std::move(origin));
+    }
+  }
+
+  visiting.erase(filePath);
+  return surface;
+}
+
+void ExportTable::invalidate(const std::string& filePath) {
+  std::unordered_set<std::string> seen = {filePath};
+  std::vector<std::string> pending = {filePath};
+  while (!pending.empty()) {
+    std::string current = std::move(pending.back());
+    pending.pop_back();
+    surfaces_.erase(current);
+    auto it = reexporters_.find(current);
+    if (it == reexporters_.end()) continue;
+    for (const auto& barrel : it->second) {
+      if (seen.insert(barrel).second) pending.push_back(barrel);
+    }
+  }
+}
+
+void ExportTable::unlink(const std::string& filePath) {
+  auto it = files_.find(filePath);
+  if (it == files_.end()) return;
+  for (const auto& entry : it->second) {
+    if (entry.resolvedPath.empty()) continue;
+    auto edgeIt = reexporters_.find(entry.resolvedPath);
+    if (edgeIt == reexporters_.end()) continue;
+    edgeIt->second.erase(filePath);
+    if (edgeIt->second.empty()) reexporters_.erase(edgeIt);
+  }
+}
+
+}  // namespace prism
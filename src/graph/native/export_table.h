@@ -0,0 +1,83 @@
+#ifndef EXPORT_TABLE_H
+#define EXPORT_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace prism {
+
+// One name a TypeScript/JavaScript module exports, as written.
+struct ExportEntry {
+  std::string name;          // As exported; "*" for `export * from`
+  std::string localName;     // Name in this file or in source; "*" for a whole module
+  std::string source;        // Module it is re-exported from; empty when defined here
+  std::string resolvedPath;  // Absolute target of source, when it resolved
+  bool isTypeOnly = false;
+
+  bool operator==(const ExportEntry& other) const {
+    return name == other.name && localName == other.localName && source == other.source &&
+           resolvedPath == other.resolvedPath && isTypeOnly == other.isTypeOnly;
+  }
+};
+
+// Where an exported name is really defined, after following re-exports.
+struct ExportOrigin {
+  std::string name;       // As exported by the queried file
+  std::string filePath;   // Defining file; empty when the chain leaves the project
+  std::string localName;  // Name there; "*" for a namespace re-export of the whole module
+  std::string module;     // Unresolved specifier the chain ends in, such as a package
+  uint32_t depth = 0;     // Re-export hops from the queried file
+};
+
+struct ExportTableStats {
+  size_t files = 0;
+  size_t surfaces = 0;  // Files whose resolved surface is cached
+  size_t computed = 0;  // Surfaces computed since the table was created
+};
+
+// Per-file export entries with re-export edges, and the transitive
+// "which file defines name X exported from M" mapping computed from them.
+// Resolved surfaces are memoized per file; updating a file drops only its
+// surface and those of the barrels that re-export from it, directly or
+// through other barrels. Explicit exports shadow names from `export *`, and
+// `export *` never forwards default. Not synchronized; ProjectIndex
+// serializes access.
+class ExportTable {
+ public:
+  void updateFile(const std::string& filePath, std::vector<ExportEntry> entries);
+  void removeFile(const std::string& filePath);
+
+  // Empty when filePath has no exports or is not indexed.
+  const std::vector<ExportOrigin>& surface(const std::string& filePath);
+  bool resolve(const std::string& filePath, const std::string& name, ExportOrigin& out);
+
+  ExportTableStats stats() const;
+
+ private:
+  struct Surface {
+    std::vector<ExportOrigin> origins;
+    std::unordered_map<std::string, size_t> byName;
+  };
+
+  std::unordered_map<std::string, std::vector<ExportEntry>> files_;
+  std::unordered_map<std::string, std::unordered_set<std::string>> reexporters_;  // Target -> barrels
+  std::unordered_map<std::string, Surface> surfaces_;
+  size_t computed_ = 0;
+
+  const Surface& cachedSurface(const std::string& filePath);
+  // cyclic is set when the computation reached a file already in visiting;
+  // such a result is missing that file's names and is not cached.
+  Surface surfaceFor(const std::string& filePath, std::unordered_set<std::string>& visiting,
+                     bool& cyclic);
+  Surface computeSurface(const std::string& filePath, std::unordered_set<std::string>& visiting,
+                         bool& cyclic);
+  void invalidate(const std::string& filePath);
+  void unlink(const std::string& filePath);
+};
+
+}  // namespace prism
+
+#endif  // EXPORT_TABLE_H
@@ -0,0 +1,741 @@
+#include "extractor.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace prism {
+
+namespace {
+
+const char kTypeScriptQuery[] =
+#include "queries/typescript.scm"
+    ;
+
+const char kPythonQuery[] =
+#include "queries/python.scm"
+    ;
+
+enum class CaptureRole : uint8_t {
+  Unknown,
+  Name,
+  DefinitionFunction,
+  DefinitionMethod,
+  DefinitionClass,
+  DefinitionVariable,
+  Import,
+  Export,
+  ExportName,
+  Call,
+  CallMethod,
+  CallNew,
+  CallCallback,
+  CallName,
+};
+
+CaptureRole roleForCapture(const std::string& name) {
+  if (name == "name") return CaptureRole::Name;
+  if (name == "definition.function") return CaptureRole::DefinitionFunction;
+  if (name == "definition.method") return CaptureRole::DefinitionMethod;
+  if (name == "definition.class") return CaptureRole::DefinitionClass;
+  if (name == "definition.variable") return CaptureRole::DefinitionVariable;
+  if (name == "import") return CaptureRole::Import;
+  if (name == "export") return CaptureRole::Export;
+  if (name == "export.name") return CaptureRole::ExportName;
+  if (name == "call") return CaptureRole::Call;
+  if (name == "call.method") return CaptureRole::CallMethod;
+  if (name == "call.new") return CaptureRole::CallNew;
+  if (name == "call.callback") return CaptureRole::CallCallback;
+  if (name == "call.name") return CaptureRole::CallName;
+  return CaptureRole::Unknown;
+}
+
+struct CompiledQuery {
+  TSQuery* query = nullptr;
+  std::vector<CaptureRole> roles;  // Indexed by capture id
+};
+
+CompiledQuery compiledQueries[3];
+std::once_flag compiledQueryFlags[3];
+
+const CompiledQuery* compiledQueryFor(LanguageId language) {
+  if (language == LanguageId::Unknown) return nullptr;
+  auto index = static_cast<size_t>(language);
+  std::call_once(compiledQueryFlags[index], [language, index]() {
+    const char* source = language == LanguageId::Python ? kPythonQuery : kTypeScriptQuery;
+    uint32_t errorOffset = 0;
+    TSQueryError errorType = TSQueryErrorNone;
+    TSQuery* query = ts_query_new(tsLanguageFor(language), source,
+                                  static_cast<uint32_t>(strlen(source)), &errorOffset, &errorType);
+    if (!query) return;
+    CompiledQuery& compiled = compiledQueries[index];
+    compiled.query = query;
+    uint32_t captureCount = ts_query_capture_count(query);
+    compiled.roles.resize(captureCount);
+    for (uint32_t i = 0; i < captureCount; i++) {
+      uint32_t length = 0;
+      const char* name = ts_query_capture_name_for_id(query, i, &length);
+      compiled.roles[i] = roleForCapture(std::string(name, length));
+    }
+  });
+  const CompiledQuery* compiled = &compiledQueries[index];
+  return compiled->query ? compiled : nullptr;
+}
+
+bool isType(TSNode node, const char* type) {
+  return strcmp(ts_node_type(node), type) == 0;
+}
+
+bool isClassNode(TSNode node) {
+  return isType(node, "class_declaration") || isType(node, "abstract_class_declaration") ||
+         isType(node, "class") || isType(node, "class_definition");
+}
+
+bool isFunctionValue(TSNode node) {
+  return isType(node, "arrow_function") || isType(node, "function_expression") ||
+         isType(node, "function") || isType(node, "generator_function");
+}
+
+bool isFunctionScope(TSNode node) {
+  return isFunctionValue(node) || isType(node, "function_declaration") ||
+         isType(node, "generator_function_declaration") || isType(node, "method_definition") ||
+         isType(node, "function_definition");
+}
+
+std::string stripQuotes(std::string_view text) {
+  if (text.size() >= 2 && (text.front() == '"' || text.front() == '\'' || text.front() == '`') &&
+      text.back() == text.front()) {
+    text = text.substr(1, text.size() - 2);
+  }
+  return std::string(text);
+}
+
+template <typename Fn>
+void forEachFieldChild(TSNode node, const char* field, Fn&& fn) {
+  TSTreeCursor cursor = ts_tree_cursor_new(node);
+  if (ts_tree_cursor_goto_first_child(&cursor)) {
+    do {
+      const char* name = ts_tree_cursor_current_field_name(&cursor);
+      if (name && strcmp(name, field) == 0) {
+        fn(ts_tree_cursor_current_node(&cursor));
+      }
+    } while (ts_tree_cursor_goto_next_sibling(&cursor));
+  }
+  ts_tree_cursor_delete(&cursor);
+}
+
+bool hasChildOfType(TSNode node, const char* type) {
+  uint32_t count = ts_node_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    if (isType(ts_node_child(node, i), type)) return true;
+  }
+  return false;
+}
+
+// Imports and exports affect the whole file (export marking, re-exported
+// bindings), so an edit touching one is re-extracted in full.
+bool isModuleLinkage(TSNode node) {
+  return isType(node, "import_statement") || isType(node, "export_statement") ||
+         isType(node, "import_from_statement") || isType(node, "future_import_statement");
+}
+
+// Widens [start, end) to the top-level statements of root that overlap or
+// touch it. False when one of them is an import or export.
+bool topLevelSpan(TSNode root, uint32_t& start, uint32_t& end) {
+  uint32_t spanStart = start;
+  uint32_t spanEnd = end;
+  uint32_t count = ts_node_child_count(root);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_child(root, i);
+    uint32_t childStart = ts_node_start_byte(child);
+    uint32_t childEnd = ts_node_end_byte(child);
+    if (childStart > end || childEnd < start) continue;
+    if (isModuleLinkage(child)) return false;
+    spanStart = std::min(spanStart, childStart);
+    spanEnd = std::max(spanEnd, childEnd);
+  }
+  start = spanStart;
+  end = spanEnd;
+  return true;
+}
+
+bool pointBefore(TSPoint a, TSPoint b) {
+  return a.row < b.row || (a.row == b.row && a.column < b.column);
+}
+
+class FileExtractor {
+ public:
+  FileExtractor(const SyntaxTree& tree, const std::string& filePath)
+      : tree_(tree), filePath_(filePath), python_(tree.language() == LanguageId::Python) {}
+
+  // Only matches overlapping [startByte, endByte) are extracted.
+  ExtractionResult run(const CompiledQuery& compiled, uint32_t startByte = 0,
+                       uint32_t endByte = UINT32_MAX) {
+    TSQueryCursor* cursor = ts_query_cursor_new();
+    if (startByte != 0 || endByte != UINT32_MAX) {
+      ts_query_cursor_set_byte_range(cursor, startByte, endByte);
+    }
+    ts_query_cursor_exec(cursor, compiled.query, tree_.root());
+
+    TSQueryMatch match;
+    while (ts_query_cursor_next_match(cursor, &match)) {
+      TSNode outer = {};
+      TSNode name = {};
+      CaptureRole outerRole = CaptureRole::Unknown;
+      bool hasOuter = false;
+      bool hasName = false;
+
+      for (uint16_t i = 0; i < match.capture_count; i++) {
+        const TSQueryCapture& capture = match.captures[i];
+        CaptureRole role = compiled.roles[capture.index];
+        if (role == CaptureRole::Name || role == CaptureRole::CallName ||
+            role == CaptureRole::ExportName) {
+          name = capture.node;
+          hasName = true;
+          if (role == CaptureRole::ExportName) exportedNames_.insert(text(name));
+        } else if (role != CaptureRole::Unknown) {
+          outer = capture.node;
+          outerRole = role;
+          hasOuter = true;
+        }
+      }
+
+      if (!hasOuter) continue;
+      switch (outerRole) {
+        case CaptureRole::DefinitionFunction:
+        case CaptureRole::DefinitionMethod:
+        case CaptureRole::DefinitionClass:
+        case CaptureRole::DefinitionVariable:
+          if (hasName) addDefinition(outerRole, outer, name);
+          break;
+        case CaptureRole::Import:
+          addImport(outer);
+          break;
+        case CaptureRole::Export:
+          addExport(outer);
+          break;
+        case CaptureRole::Call:
+        case CaptureRole::CallMethod:
+        case CaptureRole::CallNew:
+        case CaptureRole::CallCallback:
+          if (hasName) addCallSite(outerRole, outer, name);
+          break;
+        default:
+          break;
+      }
+    }
+    ts_query_cursor_delete(cursor);
+
+    // Resolved after the pass so the result does not depend on match order.
+    for (auto& pending : pendingCalls_) {
+      for (TSNode parent = ts_node_parent(pending.second); !ts_node_is_null(parent);
+           parent = ts_node_parent(parent)) {
+        auto it = scopes_.find(parent.id);
+        if (it != scopes_.end()) {
+          result_.callSites[pending.first].fromSymbolId = result_.symbols[it->second].id;
+          break;
+        }
+      }
+    }
+
+    // `import { a } from './a'; export { a }` re-exports a.
+    for (auto& entry : result_.exports) {
+      if (!entry.source.empty()) continue;
+      auto it = importBindings_.find(entry.localName);
+      if (it == importBindings_.end()) continue;
+      entry.source = it->second.first;
+      entry.localName = it->second.second;
+    }
+
+    // `export { a }` and `export default a` may follow the declaration.
+    for (auto& symbol : result_.symbols) {
+      if (!symbol.isExported && symbol.type != "method" && exportedNames_.count(symbol.name)) {
+        symbol.isExported = true;
+      }
+    }
+    return std::move(result_);
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  const std::string& filePath_;
+  bool python_;
+  ExtractionResult result_;
+  std::unordered_set<std::string> exportedNames_;
+  std::unordered_map<const void*, size_t> scopes_;  // Function-like node id -> symbol index
+  std::vector<std::pair<size_t, TSNode>> pendingCalls_;  // Call site index -> call node
+  // Local name -> (source, name imported); "*" for namespace imports
+  std::unordered_map<std::string, std::pair<std::string, std::string>> importBindings_;
+
+  std::string text(TSNode node) const { return std::string(tree_.text(node)); }
+
+  TSNode enclosingClass(TSNode node) const {
+    for (TSNode parent = ts_node_parent(node); !ts_node_is_null(parent);
+         parent = ts_node_parent(parent)) {
+      if (isClassNode(parent)) return parent;
+      // Functions nested inside a method body are not methods themselves.
+      if (isFunctionScope(parent)) return TSNode{};
+    }
+    return TSNode{};
+  }
+
+  std::string enclosingClassName(TSNode node) const {
+    TSNode cls = enclosingClass(node);
+    if (ts_node_is_null(cls)) return "";
+    TSNode name = ts_node_child_by_field_name(cls, "name", 4);
+    return ts_node_is_null(name) ? "" : text(name);
+  }
+
+  // The class whose `this`/`self` a call inside node sees. Arrow functions
+  // keep the `this` of their surroundings.
+  TSNode receiverScopeClass(TSNode node) const {
+    for (TSNode parent = ts_node_parent(node); !ts_node_is_null(parent);
+         parent = ts_node_parent(parent)) {
+      if (isType(parent, "arrow_function")) continue;
+      if (isFunctionScope(parent)) return enclosingClass(parent);
+      if (isClassNode(parent)) return parent;
+    }
+    return TSNode{};
+  }
+
+  // Class name a base expression refers to: `Base`, `ns.Base`, `Base<T>`.
+  // Empty for anything computed, such as mixin calls.
+  std::string baseName(TSNode node) const {
+    if (isType(node, "identifier") || isType(node, "type_identifier")) return text(node);
+    const char* field = nullptr;
+    if (isType(node, "member_expression")) {
+      field = "property";
+    } else if (isType(node, "attribute")) {
+      field = "attribute";
+    } else if (isType(node, "nested_type_identifier") || isType(node, "generic_type")) {
+      field = "name";
+    }
+    if (!field) return "";
+    TSNode part = ts_node_child_by_field_name(node, field, strlen(field));
+    return ts_node_is_null(part) ? "" : baseName(part);
+  }
+
+  // Direct bases of a class node in declaration order; second is true for
+  // TypeScript `implements`.
+  std::vector<std::pair<std::string, bool>> classBases(TSNode node) const {
+    std::vector<std::pair<std::string, bool>> bases;
+    auto add = [&](TSNode base, bool isImplements) {
+      std::string name = baseName(base);
+      if (!name.empty() && name != "object") bases.emplace_back(std::move(name), isImplements);
+    };
+    if (python_) {
+      TSNode arguments = ts_node_child_by_field_name(node, "superclasses", 12);
+      if (ts_node_is_null(arguments)) return bases;
+      uint32_t count = ts_node_named_child_count(arguments);
+      for (uint32_t i = 0; i < count; i++) add(ts_node_named_child(arguments, i), false);
+      return bases;
+    }
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode heritage = ts_node_named_child(node, i);
+      if (!isType(heritage, "class_heritage")) continue;
+      uint32_t clauseCount = ts_node_named_child_count(heritage);
+      for (uint32_t j = 0; j < clauseCount; j++) {
+        TSNode clause = ts_node_named_child(heritage, j);
+        bool isImplements = isType(clause, "implements_clause");
+        if (!isImplements && !isType(clause, "extends_clause")) continue;
+        uint32_t baseCount = ts_node_named_child_count(clause);
+        for (uint32_t k = 0; k < baseCount; k++) {
+          TSNode base = ts_node_named_child(clause, k);
+          if (!isType(base, "type_arguments")) add(base, isImplements);
+        }
+      }
+    }
+    return bases;
+  }
+
+  // Static receiver class of a method call, when the object expression names
+  // one: this/self/cls, super, `new X()`, Python `X()` or a capitalized
+  // identifier.
+  void setReceiverClass(TSNode call, Reference& ref) const {
+    TSNode function = ts_node_child_by_field_name(call, "function", 8);
+    if (ts_node_is_null(function)) return;
+    TSNode object = ts_node_child_by_field_name(function, "object", 6);
+    while (!ts_node_is_null(object) && isType(object, "parenthesized_expression")) {
+      object = ts_node_named_child(object, 0);
+    }
+    if (ts_node_is_null(object)) return;
+
+    std::string_view objectText = tree_.text(object);
+    bool superCall = isType(object, "super");
+    if (python_ && isType(object, "call")) {
+      TSNode callee = ts_node_child_by_field_name(object, "function", 8);
+      superCall = !ts_node_is_null(callee) && tree_.text(callee) == "super";
+    }
+
+    if (superCall) {
+      TSNode cls = receiverScopeClass(call);
+      if (ts_node_is_null(cls)) return;
+      for (auto& base : classBases(cls)) {
+        if (base.second) continue;
+        ref.receiverClass = std::move(base.first);
+        ref.superCall = true;
+        return;
+      }
+    } else if (isType(object, "this") || (python_ && (objectText == "self" || objectText == "cls"))) {
+      TSNode cls = receiverScopeClass(call);
+      if (ts_node_is_null(cls)) return;
+      TSNode name = ts_node_child_by_field_name(cls, "name", 4);
+      if (!ts_node_is_null(name)) ref.receiverClass = text(name);
+    } else if (isType(object, "new_expression")) {
+      TSNode constructor = ts_node_child_by_field_name(object, "constructor", 11);
+      if (!ts_node_is_null(constructor)) ref.receiverClass = baseName(constructor);
+    } else if (python_ && isType(object, "call")) {
+      TSNode callee = ts_node_child_by_field_name(object, "function", 8);
+      if (!ts_node_is_null(callee) && isType(callee, "identifier") &&
+          isupper(static_cast<unsigned char>(tree_.text(callee)[0]))) {
+        ref.receiverClass = text(callee);
+      }
+    } else if (isType(object, "identifier") && !objectText.empty() &&
+               isupper(static_cast<unsigned char>(objectText[0]))) {
+      ref.receiverClass = std::string(objectText);
+    }
+  }
+
+  bool isExportedDeclaration(TSNode node) const {
+    TSNode parent = ts_node_parent(node);
+    if (ts_node_is_null(parent)) return false;
+    if (isType(parent, "lexical_declaration") || isType(parent, "variable_declaration")) {
+      parent = ts_node_parent(parent);
+      if (ts_node_is_null(parent)) return false;
+    }
+    return isType(parent, "export_statement");
+  }
+
+  bool isStaticMethod(TSNode node) const {
+    if (!python_) return hasChildOfType(node, "static");
+    TSNode parent = ts_node_parent(node);
+    if (ts_node_is_null(parent) || !isType(parent, "decorated_definition")) return false;
+    uint32_t count = ts_node_named_child_count(parent);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_named_child(parent, i);
+      if (isType(child, "decorator") && tree_.text(child) == "@staticmethod") return true;
+    }
+    return false;
+  }
+
+  void addDefinition(CaptureRole role, TSNode node, TSNode nameNode) {
+    Symbol symbol;
+    symbol.name = text(nameNode);
+    symbol.filePath = filePath_;
+
+    switch (role) {
+      case CaptureRole::DefinitionFunction:
+        symbol.className = enclosingClassName(node);
+        symbol.type = symbol.className.empty() ? "function" : "method";
+        break;
+      case CaptureRole::DefinitionMethod:
+        symbol.className = enclosingClassName(node);
+        symbol.type = "method";
+        break;
+      case CaptureRole::DefinitionClass:
+        symbol.type = "class";
+        break;
+      default:
+        symbol.type = "variable";
+        break;
+    }
+
+    TSNode positionNode = (python_ && role == CaptureRole::DefinitionVariable) ? nameNode : node;
+    TSPoint start = ts_node_start_point(positionNode);
+    symbol.line = static_cast<int>(start.row) + 1;
+    symbol.column = static_cast<int>(start.column);
+    symbol.endLine = static_cast<int>(ts_node_end_point(node).row) + 1;
+    symbol.isExported = !python_ && isExportedDeclaration(node);
+    symbol.isStatic = symbol.type == "method" && isStaticMethod(node);
+    symbol.id = makeSymbolId(symbol.type, symbol.name, symbol.className, filePath_);
+
+    bool isScope = role == CaptureRole::DefinitionFunction || role == CaptureRole::DefinitionMethod;
+    if (role == CaptureRole::DefinitionVariable && !python_) {
+      TSNode value = ts_node_child_by_field_name(node, "value", 5);
+      isScope = !ts_node_is_null(value) && isFunctionValue(value);
+    }
+    if (isScope) scopes_[node.id] = result_.symbols.size();
+
+    if (role == CaptureRole::DefinitionClass) {
+      for (auto& base : classBases(node)) {
+        result_.bases.push_back({symbol.id, std::move(base.first), base.second});
+      }
+    }
+
+    result_.symbols.push_back(std::move(symbol));
+  }
+
+  void addCallSite(CaptureRole role, TSNode node, TSNode nameNode) {
+    Reference ref;
+    ref.name = text(nameNode);
+    switch (role) {
+      case CaptureRole::CallMethod: ref.type = "method"; break;
+      case CaptureRole::CallNew: ref.type = "new"; break;
+      // An identifier passed as an argument; node is the argument list.
+      case CaptureRole::CallCallback: ref.type = "callback"; break;
+      default: ref.type = "direct"; break;
+    }
+    ref.filePath = filePath_;
+    TSPoint start = ts_node_start_point(node);
+    ref.line = static_cast<int>(start.row) + 1;
+    ref.column = static_cast<int>(start.column);
+    ref.id = filePath_ + ":" + std::to_string(ref.line) + ":" + std::to_string(ref.column) + ":" +
+             ref.name;
+    if (role == CaptureRole::CallMethod) setReceiverClass(node, ref);
+
+    pendingCalls_.emplace_back(result_.callSites.size(), node);
+    result_.callSites.push_back(std::move(ref));
+  }
+
+  void addImport(TSNode node) {
+    if (python_) {
+      addPythonImport(node);
+      return;
+    }
+
+    TSNode source = ts_node_child_by_field_name(node, "source", 6);
+    if (ts_node_is_null(source)) return;
+
+    ImportEntry entry;
+    entry.source = stripQuotes(tree_.text(source));
+    entry.isTypeOnly = hasChildOfType(node, "type");
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode clause = ts_node_named_child(node, i);
+      if (!isType(clause, "import_clause")) continue;
+      uint32_t clauseCount = ts_node_named_child_count(clause);
+      for (uint32_t j = 0; j < clauseCount; j++) {
+        TSNode child = ts_node_named_child(clause, j);
+        if (isType(child, "identifier")) {
+          entry.imported.push_back(text(child));
+          importBindings_[text(child)] = {entry.source, "default"};
+        } else if (isType(child, "namespace_import")) {
+          entry.imported.push_back("*");
+          if (ts_node_named_child_count(child) > 0) {
+            importBindings_[text(ts_node_named_child(child, 0))] = {entry.source, "*"};
+          }
+        } else if (isType(child, "named_imports")) {
+          uint32_t specCount = ts_node_named_child_count(child);
+          for (uint32_t k = 0; k < specCount; k++) {
+            TSNode spec = ts_node_named_child(child, k);
+            TSNode specName = ts_node_child_by_field_name(spec, "name", 4);
+            if (ts_node_is_null(specName)) continue;
+            entry.imported.push_back(text(specName));
+            TSNode alias = ts_node_child_by_field_name(spec, "alias", 5);
+            importBindings_[text(ts_node_is_null(alias) ? specName : alias)] = {entry.source,
+                                                                                 text(specName)};
+          }
+        }
+      }
+    }
+    result_.imports.push_back(std::move(entry));
+  }
+
+  void addExport(TSNode node) {
+    TSNode source = ts_node_child_by_field_name(node, "source", 6);
+    std::string from = ts_node_is_null(source) ? "" : stripQuotes(tree_.text(source));
+    bool isTypeOnly = hasChildOfType(node, "type");
+    bool isDefault = hasChildOfType(node, "default");
+    size_t first = result_.exports.size();
+    auto add = [&](std::string name, std::string localName) {
+      ExportEntry entry;
+      entry.name = std::move(name);
+      entry.localName = std::move(localName);
+      entry.source = from;
+      entry.isTypeOnly = isTypeOnly;
+      result_.exports.push_back(std::move(entry));
+    };
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_named_child(node, i);
+      if (isType(child, "export_clause")) {
+        uint32_t specCount = ts_node_named_child_count(child);
+        for (uint32_t j = 0; j < specCount; j++) {
+          TSNode spec = ts_node_named_child(child, j);
+          TSNode name = ts_node_child_by_field_name(spec, "name", 4);
+          if (ts_node_is_null(name)) continue;
+          TSNode alias = ts_node_child_by_field_name(spec, "alias", 5);
+          add(stripQuotes(tree_.text(ts_node_is_null(alias) ? name : alias)),
+              stripQuotes(tree_.text(name)));
+        }
+      } else if (isType(child, "namespace_export")) {
+        // export * as ns from './mod'
+        if (ts_node_named_child_count(child) > 0) {
+          add(stripQuotes(tree_.text(ts_node_named_child(child, 0))), "*");
+        }
+      } else if (isType(child, "lexical_declaration") || isType(child, "variable_declaration")) {
+        uint32_t declCount = ts_node_named_child_count(child);
+        for (uint32_t j = 0; j < declCount; j++) {
+          TSNode name = ts_node_child_by_field_name(ts_node_named_child(child, j), "name", 4);
+          if (!ts_node_is_null(name) && isType(name, "identifier")) add(text(name), text(name));
+        }
+      } else if (!ts_node_eq(child, source) && !isType(child, "comment") &&
+                 !isType(child, "decorator")) {
+        TSNode name = ts_node_child_by_field_name(child, "name", 4);
+        std::string local = !ts_node_is_null(name) ? text(name)
+                            : isType(child, "identifier") ? text(child)
+                                                          : "default";
+        add(isDefault ? "default" : local, local);
+      }
+    }
+
+    if (result_.exports.size() == first && !from.empty()) add("*", "*");
+  }
+
+  std::string importedName(TSNode node) const {
+    if (isType(node, "aliased_import")) {
+      TSNode name = ts_node_child_by_field_name(node, "name", 4);
+      return ts_node_is_null(name) ? "" : text(name);
+    }
+    return text(node);
+  }
+
+  void addPythonImport(TSNode node) {
+    if (isType(node, "import_statement")) {
+      forEachFieldChild(node, "name", [&](TSNode child) {
+        ImportEntry entry;
+        entry.source = importedName(child);
+        entry.imported.push_back(entry.source);
+        result_.imports.push_back(std::move(entry));
+      });
+      return;
+    }
+
+    TSNode module = ts_node_child_by_field_name(node, "module_name", 11);
+    if (ts_node_is_null(module)) return;
+    ImportEntry entry;
+    entry.source = text(module);
+    forEachFieldChild(node, "name", [&](TSNode child) {
+      entry.imported.push_back(importedName(child));
+    });
+    if (hasChildOfType(node, "wildcard_import")) entry.imported.push_back("*");
+    result_.imports.push_back(std::move(entry));
+  }
+};
+
+}  // namespace
+
+const TSQuery* definitionQueryFor(LanguageId language) {
+  const CompiledQuery* compiled = compiledQueryFor(language);
+  return compiled ? compiled->query : nullptr;
+}
+
+ExtractionResult extractFile(const SyntaxTree& tree, const std::string& filePath) {
+  const CompiledQuery* compiled = compiledQueryFor(tree.language());
+  if (!compiled) return ExtractionResult();
+  return FileExtractor(tree, filePath).run(*compiled);
+}
+
+ExtractionResult reextractFile(const SyntaxTree& oldTree, const ExtractionResult& previous,
+                               const SyntaxTree& tree, const TSInputEdit& edit,
+                               const std::vector<TSRange>& changedRanges,
+                               const std::string& filePath, bool* partial) {
+  if (partial) *partial = false;
+  const CompiledQuery* compiled = compiledQueryFor(tree.language());
+  if (!compiled || oldTree.language() != tree.language()) return extractFile(tree, filePath);
+
+  uint32_t start = edit.start_byte;
+  uint32_t end = edit.new_end_byte;
+  for (const auto& range : changedRanges) {
+    start = std::min(start, range.start_byte);
+    end = std::max(end, range.end_byte);
+  }
+
+  // Grow the span until it covers whole top-level statements in both trees.
+  // Bytes before the edit are shared; bytes after it moved by the size change.
+  uint32_t oldEnd = 0;
+  for (;;) {
+    if (!topLevelSpan(tree.root(), start, end)) return extractFile(tree, filePath);
+    uint32_t oldStart = start;
+    oldEnd = end - edit.new_end_byte + edit.old_end_byte;
+    if (!topLevelSpan(oldTree.root(), oldStart, oldEnd)) return extractFile(tree, filePath);
+    uint32_t mappedEnd = oldEnd - edit.old_end_byte + edit.new_end_byte;
+    if (oldStart >= start && mappedEnd <= end) break;
+    start = std::min(start, oldStart);
+    end = std::max(end, mappedEnd);
+  }
+
+  std::string_view oldText = oldTree.source()->view();
+  TSPoint regionStart = pointAt(oldText, start);
+  TSPoint regionEnd = pointAt(oldText, oldEnd);
+  int rowDelta = static_cast<int>(edit.new_end_point.row) - static_cast<int>(edit.old_end_point.row);
+  int columnDelta =
+      static_cast<int>(edit.new_end_point.column) - static_cast<int>(edit.old_end_point.column);
+
+  // -1 before the re-extracted region, 0 inside it, 1 after it.
+  auto placement = [&](int line, int column) {
+    TSPoint point = {static_cast<uint32_t>(line - 1), static_cast<uint32_t>(column)};
+    if (pointBefore(point, regionStart)) return -1;
+    return pointBefore(point, regionEnd) ? 0 : 1;
+  };
+  // Items after the region sit after the edit and move with it.
+  auto shift = [&](int& line, int& column) {
+    if (static_cast<uint32_t>(line - 1) == edit.old_end_point.row) column += columnDelta;
+    line += rowDelta;
+  };
+
+  ExtractionResult region = FileExtractor(tree, filePath).run(*compiled, start, end);
+  ExtractionResult result;
+  result.imports = previous.imports;
+  result.exports = previous.exports;
+
+  std::unordered_set<std::string> exportedNames;
+  for (const auto& entry : previous.exports) {
+    if (entry.source.empty()) exportedNames.insert(entry.localName);
+  }
+  std::unordered_set<std::string> droppedClasses;
+  std::vector<Symbol> after;
+  for (const auto& symbol : previous.symbols) {
+    int where = placement(symbol.line, symbol.column);
+    if (where < 0) {
+      result.symbols.push_back(symbol);
+    } else if (where == 0) {
+      if (symbol.type == "class") droppedClasses.insert(symbol.id);
+    } else {
+      Symbol moved = symbol;
+      shift(moved.line, moved.column);
+      moved.endLine += rowDelta;
+      after.push_back(std::move(moved));
+    }
+  }
+  for (auto& symbol : region.symbols) {
+    if (!symbol.isExported && symbol.type != "method" && exportedNames.count(symbol.name)) {
+      symbol.isExported = true;
+    }
+    result.symbols.push_back(std::move(symbol));
+  }
+  result.symbols.insert(result.symbols.end(), std::make_move_iterator(after.begin()),
+                        std::make_move_iterator(after.end()));
+
+  std::vector<Reference> callsAfter;
+  for (const auto& site : previous.callSites) {
+    int where = placement(site.line, site.column);
+    if (where < 0) {
+      result.callSites.push_back(site);
+    } else if (where > 0) {
+      Reference moved = site;
+      shift(moved.line, moved.column);
+      moved.id = filePath + ":" + std::to_string(moved.line) + ":" +
+                 std::to_string(moved.column) + ":" + moved.name;
+      callsAfter.push_back(std::move(moved));
+    }
+  }
+  for (auto& site : region.callSites) result.callSites.push_back(std::move(site));
+  for (auto& site : callsAfter) result.callSites.push_back(std::move(site));
+
+  for (const auto& base : previous.bases) {
+    if (!droppedClasses.count(base.classId)) result.bases.push_back(base);
+  }
+  for (auto& base : region.bases) result.bases.push_back(std::move(base));
+
+  if (partial) *partial = true;
+  return result;
+}
+
+}  // namespace prism
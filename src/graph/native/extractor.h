@@ -0,0 +1,42 @@
+#ifndef EXTRACTOR_H
+#define EXTRACTOR_H
+
+#include <string>
+#include <vector>
+#include "export_table.h"
+#include "graph.h"
+#include "syntax_tree.h"
+
+namespace prism {
+
+struct ExtractionResult {
+  std::vector<Symbol> symbols;
+  std::vector<ImportEntry> imports;
+  // Unresolved: toSymbolId is empty and name holds the callee. fromSymbolId is
+  // the enclosing function or method, or empty at module level.
+  std::vector<Reference> callSites;
+  std::vector<ClassBase> bases;
+  std::vector<ExportEntry> exports;  // TypeScript/JavaScript only; resolvedPath unset
+};
+
+// Runs the language's definition query over the tree once and collects
+// functions, methods, classes, variables, imports, exports and call sites.
+ExtractionResult extractFile(const SyntaxTree& tree, const std::string& filePath);
+
+// Extraction of tree, which edit made from oldTree, reusing previous (the
+// extraction of oldTree): only the top-level statements overlapping the edit
+// or changedRanges are queried again, and items after them are moved by the
+// edit. Falls back to extractFile when those statements include an import or
+// export; partial reports which path was taken.
+ExtractionResult reextractFile(const SyntaxTree& oldTree, const ExtractionResult& previous,
+                               const SyntaxTree& tree, const TSInputEdit& edit,
+                               const std::vector<TSRange>& changedRanges,
+                               const std::string& filePath, bool* partial = nullptr);
+
+// Compiled once per grammar and shared by every thread; TSQuery is immutable
+// after construction.
+const TSQuery* definitionQueryFor(LanguageId language);
+
+}  // namespace prism
+
+#endif  // EXTRACTOR_H
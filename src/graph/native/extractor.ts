@@ -0,0 +1,61 @@
+import { addon } from './addon.js';
+import type { Symbol, Reference, ImportEntry, ClassBase } from './index.js';
+
+export interface ConfigReference {
+  /** Last segment of the dotted path, e.g. `AuthMiddleware` for `app.auth.AuthMiddleware`. */
+  name: string;
+  line: number;
+  column: number;
+}
+
+export interface ExtractionResult {
+  symbols: Symbol[];
+  imports: ImportEntry[];
+  /** Unresolved call sites: `name` is the callee, `fromSymbolId` the enclosing function. */
+  callSites: Reference[];
+  bases: ClassBase[];
+}
+
+/**
+ * Parses and extracts a file in one native pass using the precompiled
+ * per-language queries. Returns null for unsupported file types.
+ */
+export function extractFile(source: string | Buffer, filePath: string): ExtractionResult | null {
+  return addon.extractFile(source, filePath);
+}
+
+/**
+ * Distinct identifier names the file uses outside of declarations and imports.
+ * Returns null for unsupported file types.
+ */
+export function scanIdentifierUsages(source: string | Buffer, filePath: string): string[] | null {
+  return addon.scanIdentifierUsages(source, filePath);
+}
+
+/**
+ * Class names referenced by dotted paths in a config file, with the rules
+ * find_dead_code applies to Python, JSON, JS/TS and YAML configs. Results are
+ * cached natively by content hash. Returns null for files that are not
+ * scanned as configuration.
+ */
+export function scanConfigReferences(
+  source: string | Buffer,
+  filePath: string
+): ConfigReference[] | null {
+  return addon.scanConfigReferences(source, filePath);
+}
+
+export interface ClassifiableSymbol {
+  name: string;
+  type: string;
+  className?: string;
+  filePath: string;
+}
+
+/**
+ * Framework and middleware heuristic flags (SymbolFlags) for each symbol,
+ * matched against every pattern list in one native automaton pass.
+ */
+export function classifySymbols(symbols: ClassifiableSymbol[]): Uint32Array {
+  return addon.classifySymbols(symbols);
+}
@@ -0,0 +1,377 @@
+#include <napi.h>
+#include "bindings.h"
+#include "config_scanner.h"
+#include "control_flow.h"
+#include "dataflow.h"
+#include "extractor.h"
+#include "pattern_query.h"
+#include "symbol_classifier.h"
+#include "tree_cache.h"
+#include "usage_scanner.h"
+
+static Napi::Value ExtractFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 2 || !JsToSourceBuffer(info[0], source) || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer) and filePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string filePath = info[1].As<Napi::String>().Utf8Value();
+  prism::LanguageId language = prism::languageForPath(filePath);
+  if (language == prism::LanguageId::Unknown) return env.Null();
+
+  prism::SyntaxTreePtr tree =
+      prism::parseCached(language, std::move(source));
+  if (!tree) return env.Null();
+  prism::ExtractionResult result = prism::extractFile(*tree, filePath);
+
+  Napi::Array symbols = Napi::Array::New(env, result.symbols.size());
+  for (size_t i = 0; i < result.symbols.size(); i++) {
+    symbols.Set(i, SymbolToJs(env, result.symbols[i]));
+  }
+  Napi::Array imports = Napi::Array::New(env, result.imports.size());
+  for (size_t i = 0; i < result.imports.size(); i++) {
+    imports.Set(i, ImportEntryToJs(env, result.imports[i]));
+  }
+  Napi::Array callSites = Napi::Array::New(env, result.callSites.size());
+  for (size_t i = 0; i < result.callSites.size(); i++) {
+    callSites.Set(i, ReferenceToJs(env, result.callSites[i]));
+  }
+
+  Napi::Array bases = Napi::Array::New(env, result.bases.size());
+  for (size_t i = 0; i < result.bases.size(); i++) {
+    bases.Set(i, ClassBaseToJs(env, result.bases[i]));
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("symbols", symbols);
+  obj.Set("imports", imports);
+  obj.Set("callSites", callSites);
+  obj.Set("bases", bases);
+  return obj;
+}
+
+static Napi::Value ScanIdentifierUsages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 2 || !JsToSourceBuffer(info[0], source) || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer) and filePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::LanguageId language = prism::languageForPath(info[1].As<Napi::String>().Utf8Value());
+  if (language == prism::LanguageId::Unknown) return env.Null();
+
+  prism::SyntaxTreePtr tree =
+      prism::parseCached(language, std::move(source));
+  if (!tree) return env.Null();
+
+  std::vector<std::string_view> names = prism::scanIdentifierUsages(*tree);
+  Napi::Array arr = Napi::Array::New(env, names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    arr.Set(i, Napi::String::New(env, names[i].data(), names[i].size()));
+  }
+  return arr;
+}
+
+static Napi::Value ScanConfigReferences(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::string bytes;
+  if (info.Length() < 2 || !JsToSourceBytes(info[0], bytes) || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer) and filePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::ConfigFormat format = prism::configFormatForPath(info[1].As<Napi::String>().Utf8Value());
+  if (format == prism::ConfigFormat::None) return env.Null();
+
+  auto refs = prism::scanConfigReferencesCached(bytes, format);
+  Napi::Array arr = Napi::Array::New(env, refs->size());
+  for (size_t i = 0; i < refs->size(); i++) {
+    const prism::ConfigReference& ref = (*refs)[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("name", ref.name);
+    obj.Set("line", ref.line);
+    obj.Set("column", ref.column);
+    arr.Set(i, obj);
+  }
+  return arr;
+}
+
+static std::string OptionalString(Napi::Object obj, const char* key) {
+  Napi::Value value = obj.Get(key);
+  return value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+}
+
+static Napi::Value ClassifySymbols(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Symbols array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<prism::Symbol> symbols(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Object obj = arr.Get(i).As<Napi::Object>();
+    symbols[i].type = OptionalString(obj, "type");
+    symbols[i].name = OptionalString(obj, "name");
+    symbols[i].className = OptionalString(obj, "className");
+    symbols[i].filePath = OptionalString(obj, "filePath");
+  }
+
+  prism::classifySymbols(symbols);
+  Napi::Uint32Array flags = Napi::Uint32Array::New(env, symbols.size());
+  for (size_t i = 0; i < symbols.size(); i++) flags[i] = symbols[i].flags;
+  return flags;
+}
+
+static std::string BlockId(uint32_t block) {
+  return "block_" + std::to_string(block);
+}
+
+static Napi::Value BuildControlFlow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 3 || !JsToSourceBuffer(info[0], source) || !info[1].IsString() ||
+      !info[2].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer), filePath and functionName strings expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::ControlFlowGraphPtr graph = prism::controlFlowGraphFor(
+      info[1].As<Napi::String>().Utf8Value(), info[2].As<Napi::String>().Utf8Value(),
+      std::move(source));
+  if (!graph) return env.Null();
+
+  Napi::Array nodes = Napi::Array::New(env, graph->blocks.size());
+  for (size_t i = 0; i < graph->blocks.size(); i++) {
+    const prism::CfgBlock& block = graph->blocks[i];
+    Napi::Array statements = Napi::Array::New(env, block.statementCount);
+    for (uint32_t s = 0; s < block.statementCount; s++) {
+      std::string_view text = graph->text(graph->statements[block.firstStatement + s]);
+      statements.Set(s, Napi::String::New(env, text.data(), text.size()));
+    }
+    std::string_view label = graph->label(block);
+    Napi::Object node = Napi::Object::New(env);
+    node.Set("id", BlockId(static_cast<uint32_t>(i)));
+    node.Set("type", prism::cfgBlockKindName(block.kind));
+    node.Set("label", Napi::String::New(env, label.data(), label.size()));
+    node.Set("statements", statements);
+    if (!block.reachable) node.Set("unreachable", true);
+    nodes.Set(i, node);
+  }
+  Napi::Array edges = Napi::Array::New(env, graph->edges.size());
+  for (size_t i = 0; i < graph->edges.size(); i++) {
+    const prism::CfgEdge& edge = graph->edges[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("from", BlockId(edge.from));
+    obj.Set("to", BlockId(edge.to));
+    if (edge.label != prism::CfgEdgeLabel::None) obj.Set("label", prism::cfgEdgeLabelName(edge.label));
+    edges.Set(i, obj);
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("nodes", nodes);
+  obj.Set("edges", edges);
+  return obj;
+}
+
+static Napi::Value ControlFlowCacheStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::ControlFlowCacheStats stats = prism::controlFlowCacheStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("entries", Napi::Number::New(env, stats.entries));
+  obj.Set("hits", Napi::Number::New(env, stats.hits));
+  obj.Set("misses", Napi::Number::New(env, stats.misses));
+  return obj;
+}
+
+// Row and UTF-16 column of the point at byte in source, as the JS parsers
+// report them; tree-sitter's own columns count bytes.
+static Napi::Object PositionToJs(Napi::Env env, std::string_view source, TSPoint point,
+                                 uint32_t byte) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("row", point.row);
+  obj.Set("column", prism::utf16Length(source.substr(byte - point.column, point.column)));
+  return obj;
+}
+
+static Napi::Value FindPatterns(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 3 || !JsToSourceBuffer(info[0], source) || !info[1].IsString() ||
+      !info[2].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer), filePath and query strings expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::LanguageId language = prism::languageForPath(info[1].As<Napi::String>().Utf8Value());
+  if (language == prism::LanguageId::Unknown) return env.Null();
+
+  std::string error;
+  prism::CompiledPatternPtr pattern =
+      prism::compilePattern(language, info[2].As<Napi::String>().Utf8Value(), error);
+  if (!pattern) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::SyntaxTreePtr tree =
+      prism::parseCached(language, std::move(source));
+  if (!tree) return env.Null();
+
+  std::vector<prism::PatternMatch> matches = prism::matchPattern(*tree, *pattern);
+  Napi::Array result = Napi::Array::New(env, matches.size());
+  for (size_t i = 0; i < matches.size(); i++) {
+    const prism::PatternMatch& match = matches[i];
+    Napi::Array captures = Napi::Array::New(env, match.captures.size());
+    for (size_t j = 0; j < match.captures.size(); j++) {
+      const prism::PatternCapture& capture = match.captures[j];
+      std::string_view name = pattern->captureName(capture.captureId);
+      std::string_view text = tree->text(capture.node);
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("name", Napi::String::New(env, name.data(), name.size()));
+      obj.Set("text", Napi::String::New(env, text.data(), text.size()));
+      obj.Set("type", ts_node_type(capture.node));
+      obj.Set("startPosition", PositionToJs(env, tree->source()->view(),
+                                            ts_node_start_point(capture.node),
+                                            ts_node_start_byte(capture.node)));
+      obj.Set("endPosition", PositionToJs(env, tree->source()->view(),
+                                          ts_node_end_point(capture.node),
+                                          ts_node_end_byte(capture.node)));
+      captures.Set(j, obj);
+    }
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("pattern", match.patternIndex);
+    obj.Set("captures", captures);
+    result.Set(i, obj);
+  }
+  return result;
+}
+
+static Napi::Value PatternCacheStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::PatternCacheStats stats = prism::patternCacheStats();
+  prism::ParserPoolStats parsers = prism::parserPoolStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("entries", Napi::Number::New(env, stats.entries));
+  obj.Set("hits", Napi::Number::New(env, stats.hits));
+  obj.Set("misses", Napi::Number::New(env, stats.misses));
+  obj.Set("evictions", Napi::Number::New(env, stats.evictions));
+  obj.Set("parsers", Napi::Number::New(env, parsers.parsers));
+  obj.Set("parses", Napi::Number::New(env, parsers.parses));
+  return obj;
+}
+
+static Napi::Object DefinitionToJs(Napi::Env env, const prism::Definition& def) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("name", def.name);
+  obj.Set("kind", prism::definitionKindName(def.kind));
+  obj.Set("line", def.line);
+  obj.Set("column", def.column);
+  obj.Set("block", BlockId(def.block));
+  if (!def.type.empty()) obj.Set("type", def.type);
+  return obj;
+}
+
+static Napi::Object NarrowingToJs(Napi::Env env, const prism::FunctionDataflow& dataflow,
+                                  const prism::Narrowing& narrowing) {
+  std::string_view condition = dataflow.condition(narrowing);
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("variableName", narrowing.variable);
+  obj.Set("narrowedType", narrowing.type);
+  obj.Set("reason", prism::narrowingReasonName(narrowing.reason));
+  obj.Set("condition", Napi::String::New(env, condition.data(), condition.size()));
+  obj.Set("line", narrowing.line);
+  obj.Set("column", narrowing.column);
+  return obj;
+}
+
+static Napi::Array FactsToJs(Napi::Env env, const prism::BitVector& facts) {
+  std::vector<uint32_t> indices;
+  facts.forEach([&](uint32_t fact) { indices.push_back(fact); });
+  Napi::Array arr = Napi::Array::New(env, indices.size());
+  for (size_t i = 0; i < indices.size(); i++) arr.Set(i, indices[i]);
+  return arr;
+}
+
+static prism::FunctionDataflowPtr DataflowArgs(const Napi::CallbackInfo& info) {
+  prism::SourceBufferPtr source;
+  if (info.Length() < 3 || !JsToSourceBuffer(info[0], source) || !info[1].IsString() ||
+      !info[2].IsString()) {
+    Napi::TypeError::New(info.Env(), "Source (string or Buffer), filePath and functionName strings expected").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return prism::functionDataflowFor(info[1].As<Napi::String>().Utf8Value(),
+                                    info[2].As<Napi::String>().Utf8Value(),
+                                    std::move(source));
+}
+
+static Napi::Value AnalyzeDataflow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::FunctionDataflowPtr dataflow = DataflowArgs(info);
+  if (!dataflow) return env.Null();
+
+  Napi::Array definitions = Napi::Array::New(env, dataflow->definitions.size());
+  for (size_t i = 0; i < dataflow->definitions.size(); i++) {
+    definitions.Set(i, DefinitionToJs(env, dataflow->definitions[i]));
+  }
+  Napi::Array narrowings = Napi::Array::New(env, dataflow->narrowings.size());
+  for (size_t i = 0; i < dataflow->narrowings.size(); i++) {
+    narrowings.Set(i, NarrowingToJs(env, *dataflow, dataflow->narrowings[i]));
+  }
+  const prism::ControlFlowGraph& graph = *dataflow->graph;
+  Napi::Array blocks = Napi::Array::New(env, graph.blocks.size());
+  for (uint32_t b = 0; b < graph.blocks.size(); b++) {
+    Napi::Object block = Napi::Object::New(env);
+    block.Set("id", BlockId(b));
+    block.Set("reachingIn", FactsToJs(env, dataflow->reaching.in[b]));
+    block.Set("reachingOut", FactsToJs(env, dataflow->reaching.out[b]));
+    block.Set("narrowedIn", graph.blocks[b].reachable ? FactsToJs(env, dataflow->narrowed.in[b])
+                                                      : Napi::Array::New(env));
+    blocks.Set(b, block);
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("definitions", definitions);
+  obj.Set("narrowings", narrowings);
+  obj.Set("blocks", blocks);
+  obj.Set("iterations", Napi::Number::New(env, dataflow->reaching.iterations + dataflow->narrowed.iterations));
+  return obj;
+}
+
+static Napi::Value DataflowAt(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 4 || !info[3].IsNumber()) {
+    Napi::TypeError::New(env, "Source, filePath, functionName and line expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::FunctionDataflowPtr dataflow = DataflowArgs(info);
+  prism::DataflowPoint point;
+  if (!dataflow || !prism::dataflowAt(*dataflow, info[3].As<Napi::Number>().Uint32Value(), point)) {
+    return env.Null();
+  }
+
+  Napi::Array definitions = Napi::Array::New(env, point.reachingDefinitions.size());
+  for (size_t i = 0; i < point.reachingDefinitions.size(); i++) {
+    definitions.Set(i, DefinitionToJs(env, dataflow->definitions[point.reachingDefinitions[i]]));
+  }
+  Napi::Array narrowings = Napi::Array::New(env, point.narrowings.size());
+  for (size_t i = 0; i < point.narrowings.size(); i++) {
+    narrowings.Set(i, NarrowingToJs(env, *dataflow, dataflow->narrowings[point.narrowings[i]]));
+  }
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("block", BlockId(point.block));
+  obj.Set("reachingDefinitions", definitions);
+  obj.Set("narrowings", narrowings);
+  return obj;
+}
+
+Napi::Object InitExtractor(Napi::Env env, Napi::Object exports) {
+  exports.Set("extractFile", Napi::Function::New(env, ExtractFile, "extractFile"));
+  exports.Set("scanIdentifierUsages", Napi::Function::New(env, ScanIdentifierUsages, "scanIdentifierUsages"));
+  exports.Set("classifySymbols", Napi::Function::New(env, ClassifySymbols, "classifySymbols"));
+  exports.Set("scanConfigReferences", Napi::Function::New(env, ScanConfigReferences, "scanConfigReferences"));
+  exports.Set("buildControlFlow", Napi::Function::New(env, BuildControlFlow, "buildControlFlow"));
+  exports.Set("controlFlowCacheStats", Napi::Function::New(env, ControlFlowCacheStats, "controlFlowCacheStats"));
+  exports.Set("analyzeDataflow", Napi::Function::New(env, AnalyzeDataflow, "analyzeDataflow"));
+  exports.Set("dataflowAt", Napi::Function::New(env, DataflowAt, "dataflowAt"));
+  exports.Set("findPatterns", Napi::Function::New(env, FindPatterns, "findPatterns"));
+  exports.Set("patternCacheStats", Napi::Function::New(env, PatternCacheStats, "patternCacheStats"));
+  return exports;
+}
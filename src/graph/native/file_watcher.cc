@@ -0,0 +1,284 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace prism {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t kDirectoryMask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE |
+                                    IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW |
+                                    IN_EXCL_UNLINK;
+
+bool isUnderDirectory(const std::string& path, const std::string& directory) {
+  return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 &&
+         path[directory.size()] == '/';
+}
+
+}  // namespace
+
+struct FileWatcher::State {
+  using Clock = std::chrono::steady_clock;
+
+  FileWatcherOptions options;
+  BatchCallback onBatch;
+  int inotifyFd = -1;
+  int wakeFd = -1;
+  std::thread thread;
+
+  mutable std::mutex mutex;
+  std::vector<std::string> roots;
+  std::unordered_map<int, std::string> directoryByWatch;
+  std::unordered_map<std::string, int> watchByDirectory;
+  std::unordered_set<std::string> pendingFiles;
+  std::unordered_set<std::string> pendingDirectories;
+  bool pendingOverflow = false;
+  Clock::time_point firstEvent;
+  Clock::time_point lastEvent;
+  FileWatcherStats stats;
+
+  ~State() {
+    if (thread.joinable()) {
+      uint64_t one = 1;
+      ssize_t written = write(wakeFd, &one, sizeof(one));
+      (void)written;
+      thread.join();
+    }
+    if (inotifyFd >= 0) close(inotifyFd);
+    if (wakeFd >= 0) close(wakeFd);
+  }
+
+  bool skip(const std::string& name) const {
+    return options.skipDirectory && options.skipDirectory(name);
+  }
+
+  bool accept(const std::string& path) const {
+    return !options.acceptFile || options.acceptFile(path);
+  }
+
+  // Caller holds mutex.
+  bool watchDirectory(const std::string& directory) {
+    int wd = inotify_add_watch(inotifyFd, directory.c_str(), kDirectoryMask);
+    if (wd < 0) {
+      stats.watchFailures++;
+      return false;
+    }
+    // Re-adding a watched inode returns its existing descriptor
+    auto previous = directoryByWatch.find(wd);
+    if (previous != directoryByWatch.end() && previous->second != directory) {
+      watchByDirectory.erase(previous->second);
+    }
+    directoryByWatch[wd] = directory;
+    watchByDirectory[directory] = wd;
+    return true;
+  }
+
+  // Watches directory and its subdirectories. With reportFiles, files already
+  // inside are queued too, since they may have been written before the watch
+  // existed. Caller holds mutex.
+  bool watchTree(const std::string& directory, bool reportFiles) {
+    if (!watchDirectory(directory)) return false;
+    std::error_code ec;
+    fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+      const fs::directory_entry& entry = *it;
+      std::string path = entry.path().string();
+      if (entry.is_symlink(ec)) continue;
+      if (entry.is_directory(ec)) {
+        if (skip(entry.path().filename().string()) || !watchDirectory(path)) {
+          it.disable_recursion_pending();
+        }
+      } else if (reportFiles && entry.is_regular_file(ec) && accept(path)) {
+        pendingFiles.insert(path);
+      }
+    }
+    return true;
+  }
+
+  // A directory moved away keeps its watches under the old path; drop them so
+  // later events are not misattributed. Caller holds mutex.
+  void unwatchTree(const std::string& directory) {
+    for (auto it = watchByDirectory.begin(); it != watchByDirectory.end();) {
+      if (it->first == directory || isUnderDirectory(it->first, directory)) {
+        inotify_rm_watch(inotifyFd, it->second);
+        directoryByWatch.erase(it->second);
+        it = watchByDirectory.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // Caller holds mutex.
+  void noteEvent() {
+    Clock::time_point now = Clock::now();
+    if (pendingFiles.empty() && pendingDirectories.empty() && !pendingOverflow) firstEvent = now;
+    lastEvent = now;
+    stats.events++;
+  }
+
+  // Caller holds mutex.
+  void handle(const inotify_event& event) {
+    if (event.mask & IN_Q_OVERFLOW) {
+      // Events were lost: rescan everything and treat every root as changed.
+      noteEvent();
+      stats.overflows++;
+      pendingOverflow = true;
+      for (const auto& root : roots) {
+        watchTree(root, true);
+        pendingDirectories.insert(root);
+      }
+      return;
+    }
+    if (event.mask & IN_IGNORED) {
+      auto it = directoryByWatch.find(event.wd);
+      if (it != directoryByWatch.end()) {
+        auto byDirectory = watchByDirectory.find(it->second);
+        if (byDirectory != watchByDirectory.end() && byDirectory->second == event.wd) {
+          watchByDirectory.erase(byDirectory);
+        }
+        directoryByWatch.erase(it);
+      }
+      return;
+    }
+    if (event.len == 0) return;  // About the watched directory itself
+    auto it = directoryByWatch.find(event.wd);
+    if (it == directoryByWatch.end()) return;
+
+    std::string name(event.name);
+    std::string path = it->second + "/" + name;
+    if (event.mask & IN_ISDIR) {
+      if (skip(name)) return;
+      noteEvent();
+      if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+        watchTree(path, true);
+      } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+        unwatchTree(path);
+        pendingDirectories.insert(path);
+      }
+      return;
+    }
+    if (!accept(path)) return;
+    noteEvent();
+    pendingFiles.insert(path);
+  }
+
+  // Milliseconds until the pending burst is due, or -1 when nothing is pending.
+  int dueIn() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingFiles.empty() && pendingDirectories.empty() && !pendingOverflow) return -1;
+    Clock::time_point due = std::min(lastEvent + std::chrono::milliseconds(options.quietMs),
+                                     firstEvent + std::chrono::milliseconds(options.maxDelayMs));
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(due - Clock::now());
+    return static_cast<int>(std::max<int64_t>(0, remaining.count()));
+  }
+
+  void flush() {
+    WatchBatch batch;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      batch.files.assign(pendingFiles.begin(), pendingFiles.end());
+      batch.directories.assign(pendingDirectories.begin(), pendingDirectories.end());
+      batch.overflowed = pendingOverflow;
+      pendingFiles.clear();
+      pendingDirectories.clear();
+      pendingOverflow = false;
+      stats.batches++;
+    }
+    std::sort(batch.files.begin(), batch.files.end());
+    std::sort(batch.directories.begin(), batch.directories.end());
+    onBatch(batch);
+  }
+
+  void run() {
+    alignas(inotify_event) char buffer[64 * 1024];
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    for (;;) {
+      int timeout = dueIn();
+      int ready = poll(fds, 2, timeout);
+      if (ready < 0 && errno != EINTR) return;
+      if (fds[1].revents & POLLIN) return;
+
+      if (ready > 0 && (fds[0].revents & POLLIN)) {
+        for (;;) {
+          ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+          if (length <= 0) break;
+          std::lock_guard<std::mutex> lock(mutex);
+          for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            handle(*event);
+            offset += sizeof(inotify_event) + event->len;
+          }
+        }
+      }
+      if (dueIn() == 0) flush();
+    }
+  }
+};
+
+FileWatcher::FileWatcher(FileWatcherOptions options, BatchCallback onBatch)
+    : state_(new State()) {
+  state_->options = std::move(options);
+  state_->onBatch = std::move(onBatch);
+  state_->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  state_->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::addRoot(const std::string& root) {
+  State& state = *state_;
+  if (state.inotifyFd < 0 || state.wakeFd < 0) return false;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (std::find(state.roots.begin(), state.roots.end(), root) != state.roots.end()) return true;
+    if (!state.watchTree(root, false)) return false;
+    state.roots.push_back(root);
+  }
+  if (!state.thread.joinable()) state.thread = std::thread([&state] { state.run(); });
+  return true;
+}
+
+FileWatcherStats FileWatcher::stats() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  FileWatcherStats stats = state_->stats;
+  stats.directories = state_->watchByDirectory.size();
+  return stats;
+}
+
+#else
+
+struct FileWatcher::State {};
+
+FileWatcher::FileWatcher(FileWatcherOptions, BatchCallback) : state_(new State()) {}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::addRoot(const std::string&) {
+  return false;
+}
+
+FileWatcherStats FileWatcher::stats() const {
+  return FileWatcherStats();
+}
+
+#endif  // __linux__
+
+}  // namespace prism
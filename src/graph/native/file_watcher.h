@@ -0,0 +1,62 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace prism {
+
+// One coalesced burst of file system activity.
+struct WatchBatch {
+  std::vector<std::string> files;        // Created, changed or removed files, deduplicated
+  std::vector<std::string> directories;  // Removed or moved away; covers every file beneath
+  bool overflowed = false;               // The kernel dropped events; directories lists the roots
+};
+
+struct FileWatcherStats {
+  size_t directories = 0;  // Directories with a live watch
+  size_t events = 0;
+  size_t batches = 0;
+  size_t overflows = 0;
+  size_t watchFailures = 0;  // Directories that could not be watched (e.g. watch limit)
+};
+
+struct FileWatcherOptions {
+  uint32_t quietMs = 50;      // Deliver once no event has arrived for this long
+  uint32_t maxDelayMs = 500;  // ...or this long after the first event of a burst
+  std::function<bool(const std::string& name)> skipDirectory;
+  std::function<bool(const std::string& path)> acceptFile;
+};
+
+// Recursive inotify watcher. Events are read on a background thread and held
+// until the tree goes quiet, so a checkout or formatter run that touches
+// thousands of files arrives as one batch. Directories created later are
+// watched as they appear. Linux only; elsewhere addRoot returns false and
+// callers keep their portable watcher.
+class FileWatcher {
+ public:
+  using BatchCallback = std::function<void(const WatchBatch&)>;
+
+  FileWatcher(FileWatcherOptions options, BatchCallback onBatch);
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  // Watches root and every directory beneath it that skipDirectory allows.
+  // False when root cannot be watched.
+  bool addRoot(const std::string& root);
+  FileWatcherStats stats() const;
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace prism
+
+#endif  // FILE_WATCHER_H
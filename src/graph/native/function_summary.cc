@@ -0,0 +1,611 @@
+#include "function_summary.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace prism {
+
+namespace {
+
+bool isType(TSNode node, const char* type) {
+  return !ts_node_is_null(node) && strcmp(ts_node_type(node), type) == 0;
+}
+
+TSNode field(TSNode node, const char* name) {
+  return ts_node_child_by_field_name(node, name, static_cast<uint32_t>(strlen(name)));
+}
+
+bool isFunctionValue(TSNode node) {
+  return isType(node, "arrow_function") || isType(node, "function_expression") ||
+         isType(node, "function") || isType(node, "generator_function");
+}
+
+bool isScope(TSNode node) {
+  return isFunctionValue(node) || isType(node, "function_declaration") ||
+         isType(node, "generator_function_declaration") || isType(node, "method_definition") ||
+         isType(node, "function_definition") || isType(node, "class_declaration") ||
+         isType(node, "class") || isType(node, "class_definition") || isType(node, "lambda");
+}
+
+bool isCall(TSNode node) { return isType(node, "call_expression") || isType(node, "call"); }
+
+uint64_t pointKey(TSPoint point) { return (uint64_t(point.row) << 32) | point.column; }
+
+// Collects the flow facts of one function node.
+class FactsBuilder {
+ public:
+  FactsBuilder(const SyntaxTree& tree, const Symbol& symbol, TSNode node, TSNode function)
+      : tree_(tree), python_(tree.language() == LanguageId::Python) {
+    facts_.symbolId = symbol.id;
+    facts_.name = symbol.name;
+    std::string_view text = tree.text(node);
+    facts_.bodyHash = hashBytes(text.data(), text.size()) * 31 + ts_node_start_point(node).row;
+    skipReceiver_ = python_ && symbol.type == "method" && !symbol.isStatic;
+    function_ = function;
+  }
+
+  LocalFunctionFacts run() {
+    collectParameters();
+    TSNode body = field(function_, "body");
+    if (!ts_node_is_null(body)) {
+      // Arrow functions with an expression body return it
+      if (isType(function_, "arrow_function") && !isType(body, "statement_block")) {
+        returns_.push_back(body);
+      }
+      walk(body);
+    }
+
+    size_t parameterCount = facts_.parameters.size();
+    width_ = parameterCount + calls_.size();
+    for (const auto& binding : parameterBindings_) {
+      BitVector sources(width_);
+      sources.set(binding.second);
+      env_[binding.first].unionWith(sources);
+    }
+
+    // Flow-insensitive: propagate assignments until no local gains a source
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (const auto& assignment : assignments_) {
+        std::string_view name = tree_.text(assignment.first);
+        if (!isLocal(name)) continue;
+        BitVector sources = sourcesOf(assignment.second);
+        auto it = env_.find(name);
+        if (it == env_.end()) {
+          env_.emplace(name, std::move(sources));
+          changed = true;
+        } else if (it->second.unionWith(sources)) {
+          changed = true;
+        }
+      }
+    }
+
+    for (TSNode call : calls_) facts_.calls.push_back(summarizeCall(call));
+    facts_.returns = BitVector(width_);
+    for (TSNode value : returns_) facts_.returns.unionWith(sourcesOf(value));
+    for (const auto& assignment : assignments_) {
+      std::string_view name = tree_.text(assignment.first);
+      if (isLocal(name) && !isType(assignment.first, "member_expression") &&
+          !isType(assignment.first, "attribute")) {
+        continue;
+      }
+      facts_.globalWrites.emplace_back(std::string(name), sourcesOf(assignment.second));
+    }
+    return std::move(facts_);
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  bool python_;
+  bool skipReceiver_;
+  TSNode function_;
+  LocalFunctionFacts facts_;
+  size_t width_ = 0;
+  std::vector<std::pair<std::string_view, uint32_t>> parameterBindings_;
+  std::unordered_set<std::string_view> declared_;
+  std::unordered_set<std::string_view> globals_;  // Python `global` names
+  std::vector<TSNode> calls_;
+  std::unordered_map<const void*, uint32_t> callIndex_;
+  std::vector<std::pair<TSNode, TSNode>> assignments_;  // Target, value
+  std::vector<TSNode> returns_;
+  std::unordered_map<std::string_view, BitVector> env_;
+
+  bool isLocal(std::string_view name) const {
+    return declared_.count(name) && !globals_.count(name);
+  }
+
+  void bindNames(TSNode pattern, std::vector<TSNode>& out) const {
+    if (ts_node_is_null(pattern)) return;
+    if (isType(pattern, "identifier") || isType(pattern, "shorthand_property_identifier_pattern")) {
+      out.push_back(pattern);
+    } else if (isType(pattern, "pair_pattern")) {
+      bindNames(field(pattern, "value"), out);
+    } else if (isType(pattern, "assignment_pattern") || isType(pattern, "object_assignment_pattern")) {
+      bindNames(field(pattern, "left"), out);
+    } else if (!isType(pattern, "member_expression") && !isType(pattern, "attribute") &&
+               !isType(pattern, "subscript_expression") && !isType(pattern, "subscript")) {
+      uint32_t count = ts_node_named_child_count(pattern);
+      for (uint32_t i = 0; i < count; i++) bindNames(ts_node_named_child(pattern, i), out);
+    }
+  }
+
+  void collectParameters() {
+    TSNode single = field(function_, "parameter");  // x => ...
+    if (!ts_node_is_null(single)) {
+      addParameter(single, single);
+      return;
+    }
+    TSNode parameters = field(function_, "parameters");
+    uint32_t count = ts_node_is_null(parameters) ? 0 : ts_node_named_child_count(parameters);
+    bool receiver = skipReceiver_;
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode parameter = ts_node_named_child(parameters, i);
+      if (isType(parameter, "comment")) continue;
+      if (receiver) {
+        receiver = false;
+        continue;
+      }
+      TSNode pattern = field(parameter, "pattern");
+      if (ts_node_is_null(pattern)) pattern = field(parameter, "name");
+      if (ts_node_is_null(pattern) && isType(parameter, "assignment_pattern")) pattern = field(parameter, "left");
+      if (ts_node_is_null(pattern) && isType(parameter, "typed_parameter")) {
+        pattern = ts_node_named_child(parameter, 0);
+      }
+      if (ts_node_is_null(pattern)) pattern = parameter;
+      addParameter(parameter, pattern);
+    }
+  }
+
+  void addParameter(TSNode parameter, TSNode pattern) {
+    auto index = static_cast<uint32_t>(facts_.parameters.size());
+    std::vector<TSNode> names;
+    bindNames(pattern, names);
+    facts_.parameters.push_back(names.size() == 1 ? std::string(tree_.text(names[0]))
+                                                  : std::string(tree_.text(parameter)));
+    for (TSNode name : names) {
+      std::string_view text = tree_.text(name);
+      declared_.insert(text);
+      parameterBindings_.emplace_back(text, index);
+    }
+  }
+
+  void assign(TSNode target, TSNode value, bool declares) {
+    if (isType(target, "member_expression") || isType(target, "attribute")) {
+      TSNode object = field(target, "object");
+      if (isType(object, "this") || (python_ && tree_.text(object) == "self")) {
+        assignments_.emplace_back(target, value);
+      }
+      return;
+    }
+    std::vector<TSNode> names;
+    bindNames(target, names);
+    for (TSNode name : names) {
+      if (declares || python_) declared_.insert(tree_.text(name));
+      assignments_.emplace_back(name, value);
+    }
+  }
+
+  void walk(TSNode node) {
+    if (isScope(node) && !ts_node_eq(node, function_)) return;
+
+    if (isCall(node)) {
+      callIndex_[node.id] = static_cast<uint32_t>(calls_.size());
+      calls_.push_back(node);
+    } else if (isType(node, "variable_declarator")) {
+      assign(field(node, "name"), field(node, "value"), true);
+    } else if (isType(node, "assignment_expression") || isType(node, "assignment") ||
+               isType(node, "augmented_assignment_expression") || isType(node, "augmented_assignment")) {
+      assign(field(node, "left"), field(node, "right"), false);
+    } else if (isType(node, "for_in_statement") || (python_ && isType(node, "for_statement"))) {
+      assign(field(node, "left"), field(node, "right"), isType(node, "for_in_statement"));
+    } else if (isType(node, "return_statement")) {
+      if (ts_node_named_child_count(node) > 0) returns_.push_back(ts_node_named_child(node, 0));
+    } else if (isType(node, "global_statement")) {
+      uint32_t count = ts_node_named_child_count(node);
+      for (uint32_t i = 0; i < count; i++) globals_.insert(tree_.text(ts_node_named_child(node, i)));
+    }
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) walk(ts_node_named_child(node, i));
+  }
+
+  BitVector sourcesOf(TSNode node) const {
+    BitVector sources(width_);
+    addSources(node, sources);
+    return sources;
+  }
+
+  void addSources(TSNode node, BitVector& sources) const {
+    if (ts_node_is_null(node) || isScope(node)) return;
+    if (isType(node, "identifier") || isType(node, "shorthand_property_identifier")) {
+      auto it = env_.find(tree_.text(node));
+      if (it != env_.end()) sources.unionWith(it->second);
+      return;
+    }
+    if (isCall(node)) {
+      auto it = callIndex_.find(node.id);
+      if (it != callIndex_.end()) sources.set(facts_.parameters.size() + it->second);
+      return;
+    }
+    // A property or element carries whatever its object carries
+    if (isType(node, "member_expression") || isType(node, "subscript_expression") ||
+        isType(node, "attribute") || isType(node, "subscript")) {
+      TSNode object = field(node, "object");
+      if (ts_node_is_null(object)) object = field(node, "value");
+      addSources(object, sources);
+      return;
+    }
+    if (isType(node, "pair")) {
+      addSources(field(node, "value"), sources);
+      return;
+    }
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; i++) addSources(ts_node_named_child(node, i), sources);
+  }
+
+  SummaryCall summarizeCall(TSNode call) const {
+    SummaryCall summary;
+    TSNode callee = field(call, "function");
+    if (isType(callee, "member_expression")) {
+      callee = field(callee, "property");
+    } else if (isType(callee, "attribute")) {
+      callee = field(callee, "attribute");
+    }
+    if (!ts_node_is_null(callee)) summary.callee = std::string(tree_.text(callee));
+    summary.line = ts_node_start_point(call).row + 1;
+
+    TSNode arguments = field(call, "arguments");
+    uint32_t count = ts_node_is_null(arguments) ? 0 : ts_node_named_child_count(arguments);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode argument = ts_node_named_child(arguments, i);
+      if (isType(argument, "comment")) continue;
+      // Keyword and spread arguments no longer line up with parameters
+      if (isType(argument, "keyword_argument") || isType(argument, "spread_element") ||
+          isType(argument, "list_splat") || isType(argument, "dictionary_splat")) {
+        break;
+      }
+      summary.arguments.push_back(sourcesOf(argument));
+    }
+    return summary;
+  }
+};
+
+void collectFunctionNodes(TSNode node, std::unordered_map<uint64_t, TSNode>& out) {
+  if (isType(node, "function_declaration") || isType(node, "generator_function_declaration") ||
+      isType(node, "method_definition") || isType(node, "function_definition") ||
+      (isType(node, "variable_declarator") && isFunctionValue(field(node, "value")))) {
+    out.emplace(pointKey(ts_node_start_point(node)), node);
+  }
+  uint32_t count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < count; i++) collectFunctionNodes(ts_node_named_child(node, i), out);
+}
+
+template <typename T>
+void sortUnique(std::vector<T>& items) {
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end()), items.end());
+}
+
+}  // namespace
+
+std::vector<LocalFunctionFacts> collectFunctionFacts(const SyntaxTree& tree,
+                                                     const std::vector<Symbol>& symbols) {
+  std::unordered_map<uint64_t, TSNode> functions;
+  collectFunctionNodes(tree.root(), functions);
+
+  std::vector<LocalFunctionFacts> facts;
+  for (const auto& symbol : symbols) {
+    if (symbol.type != "function" && symbol.type != "method" && symbol.type != "variable") continue;
+    TSPoint start = {static_cast<uint32_t>(symbol.line - 1), static_cast<uint32_t>(symbol.column)};
+    auto it = functions.find(pointKey(start));
+    if (it == functions.end()) continue;
+    TSNode node = it->second;
+    TSNode function = isType(node, "variable_declarator") ? field(node, "value") : node;
+    facts.push_back(FactsBuilder(tree, symbol, node, function).run());
+  }
+  return facts;
+}
+
+void FunctionSummaryStore::updateFile(const std::string& filePath,
+                                      std::vector<LocalFunctionFacts> facts) {
+  std::unordered_set<std::string> current;
+  for (const auto& function : facts) current.insert(function.symbolId);
+
+  auto fileIt = fileFunctions_.find(filePath);
+  if (fileIt != fileFunctions_.end()) {
+    for (const auto& symbolId : fileIt->second) {
+      if (!current.count(symbolId)) removeFunction(symbolId);
+    }
+  }
+
+  std::vector<std::string>& functions = fileFunctions_[filePath];
+  functions.clear();
+  for (auto& function : facts) {
+    functions.push_back(function.symbolId);
+    auto it = facts_.find(function.symbolId);
+    if (it != facts_.end() && it->second.bodyHash == function.bodyHash) continue;
+
+    if (it != facts_.end()) {
+      for (const auto& call : it->second.calls) callersByName_[call.callee].erase(function.symbolId);
+    } else {
+      // Calls by this name now resolve to one more function
+      markCallersDirty(function.name);
+      functionsByName_[function.name].insert(function.symbolId);
+    }
+    for (const auto& call : function.calls) callersByName_[call.callee].insert(function.symbolId);
+    dirty_.insert(function.symbolId);
+    facts_[function.symbolId] = std::move(function);
+  }
+  if (functions.empty()) fileFunctions_.erase(filePath);
+}
+
+void FunctionSummaryStore::removeFile(const std::string& filePath) {
+  updateFile(filePath, {});
+}
+
+void FunctionSummaryStore::removeFunction(const std::string& symbolId) {
+  auto it = facts_.find(symbolId);
+  if (it == facts_.end()) return;
+  for (const auto& call : it->second.calls) {
+    auto callersIt = callersByName_.find(call.callee);
+    if (callersIt == callersByName_.end()) continue;
+    callersIt->second.erase(symbolId);
+    if (callersIt->second.empty()) callersByName_.erase(callersIt);
+  }
+  auto namesIt = functionsByName_.find(it->second.name);
+  if (namesIt != functionsByName_.end()) {
+    namesIt->second.erase(symbolId);
+    if (namesIt->second.empty()) functionsByName_.erase(namesIt);
+  }
+  markCallersDirty(it->second.name);
+  summaries_.erase(symbolId);
+  dirty_.erase(symbolId);
+  facts_.erase(it);
+}
+
+void FunctionSummaryStore::markCallersDirty(const std::string& name) {
+  auto it = callersByName_.find(name);
+  if (it == callersByName_.end()) return;
+  dirty_.insert(it->second.begin(), it->second.end());
+}
+
+FunctionSummary FunctionSummaryStore::compose(const LocalFunctionFacts& facts) const {
+  size_t parameterCount = facts.parameters.size();
+  std::vector<std::vector<const FunctionSummary*>> callees(facts.calls.size());
+  for (size_t c = 0; c < facts.calls.size(); c++) {
+    auto namesIt = functionsByName_.find(facts.calls[c].callee);
+    if (namesIt == functionsByName_.end()) continue;
+    for (const auto& symbolId : namesIt->second) {
+      auto it = summaries_.find(symbolId);
+      if (it != summaries_.end()) callees[c].push_back(&it->second);
+    }
+  }
+
+  // Parameters each call result may carry. A call's arguments can hold other
+  // call results (x = f(x)), so iterate to a fixed point.
+  std::vector<BitVector> results(facts.calls.size(), BitVector(parameterCount));
+  auto parametersOf = [&](const BitVector& sources) {
+    BitVector parameters(parameterCount);
+    sources.forEach([&](uint32_t bit) {
+      if (bit < parameterCount) {
+        parameters.set(bit);
+      } else {
+        parameters.unionWith(results[bit - parameterCount]);
+      }
+    });
+    return parameters;
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t c = 0; c < facts.calls.size(); c++) {
+      const auto& arguments = facts.calls[c].arguments;
+      for (const FunctionSummary* callee : callees[c]) {
+        for (uint32_t j : callee->returnedParameters) {
+          if (j < arguments.size() && results[c].unionWith(parametersOf(arguments[j]))) changed = true;
+        }
+      }
+    }
+  }
+
+  FunctionSummary summary;
+  summary.symbolId = facts.symbolId;
+  summary.parameters = facts.parameters;
+  parametersOf(facts.returns).forEach([&](uint32_t p) { summary.returnedParameters.push_back(p); });
+  for (const auto& write : facts.globalWrites) {
+    parametersOf(write.second).forEach([&](uint32_t p) { summary.globalFlows.push_back({p, write.first}); });
+  }
+  for (size_t c = 0; c < facts.calls.size(); c++) {
+    const SummaryCall& call = facts.calls[c];
+    for (uint32_t j = 0; j < call.arguments.size(); j++) {
+      BitVector passed = parametersOf(call.arguments[j]);
+      passed.forEach([&](uint32_t p) { summary.calleeFlows.push_back({p, call.callee, j, call.line}); });
+      for (const FunctionSummary* callee : callees[c]) {
+        for (const auto& flow : callee->globalFlows) {
+          if (flow.parameter != j) continue;
+          passed.forEach([&](uint32_t p) { summary.globalFlows.push_back({p, flow.global}); });
+        }
+      }
+    }
+  }
+
+  auto byParameter = [](const auto& a, const auto& b) {
+    return std::tie(a.parameter, a.global) < std::tie(b.parameter, b.global);
+  };
+  std::sort(summary.globalFlows.begin(), summary.globalFlows.end(), byParameter);
+  summary.globalFlows.erase(std::unique(summary.globalFlows.begin(), summary.globalFlows.end()),
+                            summary.globalFlows.end());
+  return summary;
+}
+
+void FunctionSummaryStore::refresh() {
+  if (dirty_.empty()) return;
+
+  // Call graph over the functions with facts, by name like the graph links it
+  std::vector<const LocalFunctionFacts*> nodes;
+  std::unordered_map<std::string_view, uint32_t> ids;
+  nodes.reserve(facts_.size());
+  for (const auto& entry : facts_) {
+    ids.emplace(entry.first, static_cast<uint32_t>(nodes.size()));
+    nodes.push_back(&entry.second);
+  }
+  std::vector<std::vector<uint32_t>> callees(nodes.size());
+  for (uint32_t n = 0; n < nodes.size(); n++) {
+    for (const auto& call : nodes[n]->calls) {
+      auto namesIt = functionsByName_.find(call.callee);
+      if (namesIt == functionsByName_.end()) continue;
+      for (const auto& symbolId : namesIt->second) callees[n].push_back(ids.at(symbolId));
+    }
+    sortUnique(callees[n]);
+  }
+
+  // Iterative Tarjan; components come out callees first
+  constexpr uint32_t kUnvisited = UINT32_MAX;
+  std::vector<uint32_t> index(nodes.size(), kUnvisited);
+  std::vector<uint32_t> lowLink(nodes.size(), 0);
+  std::vector<uint8_t> onStack(nodes.size(), 0);
+  std::vector<uint32_t> stack;
+  std::vector<std::vector<uint32_t>> components;
+  uint32_t nextIndex = 0;
+  for (uint32_t root = 0; root < nodes.size(); root++) {
+    if (index[root] != kUnvisited) continue;
+    std::vector<std::pair<uint32_t, size_t>> frames = {{root, 0}};
+    index[root] = lowLink[root] = nextIndex++;
+    stack.push_back(root);
+    onStack[root] = 1;
+    while (!frames.empty()) {
+      auto& [node, child] = frames.back();
+      if (child < callees[node].size()) {
+        uint32_t next = callees[node][child++];
+        if (index[next] == kUnvisited) {
+          index[next] = lowLink[next] = nextIndex++;
+          stack.push_back(next);
+          onStack[next] = 1;
+          frames.push_back({next, 0});
+        } else if (onStack[next]) {
+          lowLink[node] = std::min(lowLink[node], index[next]);
+        }
+        continue;
+      }
+      uint32_t finished = node;
+      frames.pop_back();
+      if (!frames.empty()) {
+        lowLink[frames.back().first] = std::min(lowLink[frames.back().first], lowLink[finished]);
+      }
+      if (lowLink[finished] != index[finished]) continue;
+      std::vector<uint32_t> component;
+      uint32_t member;
+      do {
+        member = stack.back();
+        stack.pop_back();
+        onStack[member] = 0;
+        component.push_back(member);
+      } while (member != finished);
+      components.push_back(std::move(component));
+    }
+  }
+
+  // Recompose a component when a member changed or a callee's summary did
+  std::vector<uint8_t> changed(nodes.size(), 0);
+  for (const auto& component : components) {
+    bool stale = false;
+    for (uint32_t member : component) {
+      stale = stale || dirty_.count(nodes[member]->symbolId);
+      for (uint32_t callee : callees[member]) stale = stale || changed[callee];
+    }
+    if (!stale) continue;
+
+    std::vector<FunctionSummary> previous;
+    for (uint32_t member : component) {
+      auto it = summaries_.find(nodes[member]->symbolId);
+      previous.push_back(it != summaries_.end() ? std::move(it->second) : FunctionSummary());
+      FunctionSummary& empty = summaries_[nodes[member]->symbolId];
+      empty = FunctionSummary();
+      empty.symbolId = nodes[member]->symbolId;
+    }
+    // Summaries only grow, so recursion converges
+    for (bool grew = true; grew;) {
+      grew = false;
+      for (uint32_t member : component) {
+        FunctionSummary next = compose(*nodes[member]);
+        FunctionSummary& current = summaries_[nodes[member]->symbolId];
+        if (!next.sameFlows(current)) grew = true;
+        current = std::move(next);
+      }
+    }
+    computed_ += component.size();
+    for (size_t i = 0; i < component.size(); i++) {
+      FunctionSummary& current = summaries_[nodes[component[i]]->symbolId];
+      current.sccSize = static_cast<uint32_t>(component.size());
+      changed[component[i]] = !current.sameFlows(previous[i]) ||
+                              current.parameters != previous[i].parameters;
+    }
+  }
+  dirty_.clear();
+}
+
+bool FunctionSummaryStore::summary(const std::string& symbolId, FunctionSummary& out) {
+  refresh();
+  auto it = summaries_.find(symbolId);
+  if (it == summaries_.end()) return false;
+  out = it->second;
+  return true;
+}
+
+bool FunctionSummaryStore::traceParameter(const std::string& symbolId, uint32_t parameter,
+                                          ParameterFlow& flow) {
+  refresh();
+  auto originIt = summaries_.find(symbolId);
+  if (originIt == summaries_.end() || parameter >= originIt->second.parameters.size()) return false;
+
+  const FunctionSummary& origin = originIt->second;
+  flow = ParameterFlow();
+  flow.returned = std::find(origin.returnedParameters.begin(), origin.returnedParameters.end(),
+                            parameter) != origin.returnedParameters.end();
+  for (const auto& global : origin.globalFlows) {
+    if (global.parameter == parameter) flow.globals.push_back(global.global);
+  }
+
+  // Breadth-first over (function, parameter) pairs, composing callee flows
+  std::unordered_set<std::string> visited = {symbolId + '\0' + std::to_string(parameter)};
+  flow.reaches.push_back({symbolId, parameter, origin.parameters[parameter], 0});
+  for (size_t i = 0; i < flow.reaches.size(); i++) {
+    FlowStep step = flow.reaches[i];
+    const FunctionSummary& summary = summaries_.at(step.symbolId);
+    for (const auto& callee : summary.calleeFlows) {
+      if (callee.parameter != step.parameter) continue;
+      auto namesIt = functionsByName_.find(callee.callee);
+      if (namesIt == functionsByName_.end()) continue;
+      for (const auto& target : namesIt->second) {
+        auto targetIt = summaries_.find(target);
+        if (targetIt == summaries_.end() || callee.argument >= targetIt->second.parameters.size()) continue;
+        if (!visited.insert(target + '\0' + std::to_string(callee.argument)).second) continue;
+        flow.reaches.push_back(
+            {target, callee.argument, targetIt->second.parameters[callee.argument], step.depth + 1});
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<std::pair<std::string, uint32_t>> FunctionSummaryStore::parametersNamed(
+    const std::string& filePath, const std::string& name) const {
+  std::vector<std::pair<std::string, uint32_t>> result;
+  auto fileIt = fileFunctions_.find(filePath);
+  if (fileIt == fileFunctions_.end()) return result;
+  for (const auto& symbolId : fileIt->second) {
+    const std::vector<std::string>& parameters = facts_.at(symbolId).parameters;
+    auto it = std::find(parameters.begin(), parameters.end(), name);
+    if (it != parameters.end()) result.emplace_back(symbolId, it - parameters.begin());
+  }
+  return result;
+}
+
+FunctionSummaryStats FunctionSummaryStore::stats() const {
+  FunctionSummaryStats stats;
+  stats.functions = facts_.size();
+  stats.summaries = summaries_.size();
+  stats.computed = computed_;
+  return stats;
+}
+
+}  // namespace prism
@@ -0,0 +1,136 @@
+#ifndef FUNCTION_SUMMARY_H
+#define FUNCTION_SUMMARY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "dataflow.h"
+#include "graph.h"
+#include "syntax_tree.h"
+
+namespace prism {
+
+// Value sources inside one function are bit sets over its parameters followed
+// by its calls: bit i < parameters.size() is parameter i, and bit
+// parameters.size() + c is whatever call c returns.
+struct SummaryCall {
+  std::string callee;  // As written; the graph links call sites by this name
+  uint32_t line;
+  std::vector<BitVector> arguments;  // Positional only
+};
+
+// What a function body does with its inputs, independent of its callees.
+// Collected when the file is indexed and kept until the body changes.
+struct LocalFunctionFacts {
+  std::string symbolId;
+  std::string name;
+  uint64_t bodyHash;  // Text and position of the function node
+  std::vector<std::string> parameters;  // Python receivers excluded
+  std::vector<SummaryCall> calls;
+  BitVector returns;
+  std::vector<std::pair<std::string, BitVector>> globalWrites;  // Module names, this./self. fields
+};
+
+// Facts for every function, method and function-valued variable in symbols
+// (as extracted from tree).
+std::vector<LocalFunctionFacts> collectFunctionFacts(const SyntaxTree& tree,
+                                                     const std::vector<Symbol>& symbols);
+
+struct CalleeFlow {
+  uint32_t parameter;
+  std::string callee;
+  uint32_t argument;
+  uint32_t line;
+
+  bool operator==(const CalleeFlow& other) const {
+    return parameter == other.parameter && argument == other.argument && line == other.line &&
+           callee == other.callee;
+  }
+};
+
+struct GlobalFlow {
+  uint32_t parameter;
+  std::string global;
+
+  bool operator==(const GlobalFlow& other) const {
+    return parameter == other.parameter && global == other.global;
+  }
+};
+
+// Where a function's parameters can end up: its return value, the arguments
+// of the calls it makes, and globals it or any callee writes.
+struct FunctionSummary {
+  std::string symbolId;
+  std::vector<std::string> parameters;
+  std::vector<uint32_t> returnedParameters;  // Including through callees' returns
+  std::vector<CalleeFlow> calleeFlows;       // Direct calls only
+  std::vector<GlobalFlow> globalFlows;       // Including writes made by callees
+  uint32_t sccSize = 1;                      // Functions in its recursion cycle
+
+  bool sameFlows(const FunctionSummary& other) const {
+    return returnedParameters == other.returnedParameters && calleeFlows == other.calleeFlows &&
+           globalFlows == other.globalFlows;
+  }
+};
+
+struct FlowStep {
+  std::string symbolId;
+  uint32_t parameter;
+  std::string parameterName;
+  uint32_t depth;  // Calls away from the origin
+};
+
+struct ParameterFlow {
+  std::vector<FlowStep> reaches;  // The origin first, then every parameter it is passed to
+  std::vector<std::string> globals;
+  bool returned = false;
+};
+
+struct FunctionSummaryStats {
+  size_t functions = 0;
+  size_t summaries = 0;
+  size_t computed = 0;  // Summaries (re)computed since the store was created
+};
+
+// Per-function summaries keyed by graph symbol id, computed bottom-up over
+// the strongly connected components of the call graph. Calls resolve by name
+// like ReferenceGraph's call-site linking. A file update only invalidates
+// functions whose body changed, or whose callees appeared or vanished; their
+// callers are recomposed only if a summary actually changes. Not synchronized;
+// ProjectIndex serializes access.
+class FunctionSummaryStore {
+ public:
+  void updateFile(const std::string& filePath, std::vector<LocalFunctionFacts> facts);
+  void removeFile(const std::string& filePath);
+
+  // False when symbolId has no body facts.
+  bool summary(const std::string& symbolId, FunctionSummary& out);
+  // Follows parameter across calls by composing summaries; no body is read.
+  bool traceParameter(const std::string& symbolId, uint32_t parameter, ParameterFlow& flow);
+  // Functions in filePath with a parameter called name, and that parameter's
+  // index, in declaration order.
+  std::vector<std::pair<std::string, uint32_t>> parametersNamed(const std::string& filePath,
+                                                                const std::string& name) const;
+
+  FunctionSummaryStats stats() const;
+
+ private:
+  std::unordered_map<std::string, LocalFunctionFacts> facts_;
+  std::unordered_map<std::string, FunctionSummary> summaries_;
+  std::unordered_map<std::string, std::vector<std::string>> fileFunctions_;
+  std::unordered_map<std::string, std::unordered_set<std::string>> functionsByName_;
+  std::unordered_map<std::string, std::unordered_set<std::string>> callersByName_;
+  std::unordered_set<std::string> dirty_;
+  size_t computed_ = 0;
+
+  void refresh();
+  void removeFunction(const std::string& symbolId);
+  void markCallersDirty(const std::string& name);
+  FunctionSummary compose(const LocalFunctionFacts& facts) const;
+};
+
+}  // namespace prism
+
+#endif  // FUNCTION_SUMMARY_H
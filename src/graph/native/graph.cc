@@ -1,15 +1,31 @@
 #include "graph.h"
+#include "config_scanner.h"
+#include "symbol_classifier.h"
 #include <iostream>
 #include <algorithm>
 
 namespace prism {
 
+std::string makeSymbolId(const std::string& type, const std::string& name,
+                         const std::string& className, const std::string& filePath) {
+  std::string id = type + ":" + name;
+  if (!className.empty()) id += ":" + className;
+  return id + ":" + filePath;
+}
+
 ReferenceGraph::ReferenceGraph() {}
 
 ReferenceGraph::~ReferenceGraph() {}
 
 void ReferenceGraph::addSymbol(const Symbol& symbol) {
+  auto it = symbols_.find(symbol.id);
+  if (it != symbols_.end()) {
+    auto& ids = symbolsByName_[it->second.name];
+    ids.erase(std::remove(ids.begin(), ids.end(), symbol.id), ids.end());
+  }
   symbols_[symbol.id] = symbol;
+  symbolsByName_[symbol.name].push_back(symbol.id);
+  if (symbol.type == "class" || symbol.type == "method") dispatchCache_.clear();
 }
 
 void ReferenceGraph::addSymbols(const std::vector<Symbol>& symbols) {
@@ -69,28 +85,23 @@ void ReferenceGraph::removeReferences(const std::string& symbolId) {
 }
 
 std::vector<Reference> ReferenceGraph::findCallers(const std::string& symbolId) const {
-  std::vector<Reference> result;
   auto it = symbolToCallers_.find(symbolId);
-  if (it != symbolToCallers_.end()) {
-    for (const auto& refId : it->second) {
-      auto refIt = references_.find(refId);
-      if (refIt != references_.end()) {
-        result.push_back(refIt->second);
-      }
-    }
-  }
-  return result;
+  if (it == symbolToCallers_.end()) return {};
+  return collectReferences(it->second);
 }
 
 std::vector<Reference> ReferenceGraph::findCallees(const std::string& symbolId) const {
-  std::vector<Reference> result;
   auto it = symbolToReferences_.find(symbolId);
-  if (it != symbolToReferences_.end()) {
-    for (const auto& refId : it->second) {
-      auto refIt = references_.find(refId);
-      if (refIt != references_.end()) {
-        result.push_back(refIt->second);
-      }
+  if (it == symbolToReferences_.end()) return {};
+  return collectReferences(it->second);
+}
+
+std::vector<Reference> ReferenceGraph::collectReferences(const std::vector<std::string>& referenceIds) const {
+  std::vector<Reference> result;
+  for (const auto& refId : referenceIds) {
+    auto refIt = references_.find(refId);
+    if (refIt != references_.end() && dispatches(refIt->second)) {
+      result.push_back(refIt->second);
     }
   }
   return result;
@@ -99,6 +110,12 @@ std::vector<Reference> ReferenceGraph::findCallees(const std::string& symbolId)
 void ReferenceGraph::addFile(const FileData& file) {
   files_[file.path] = file;
   addSymbols(file.symbols);
+  for (const auto& base : file.bases) {
+    classBases_[base.classId].push_back(base);
+    subclassesByName_[base.name].push_back(base.classId);
+  }
+  if (!file.bases.empty()) dispatchCache_.clear();
+  linkCallSites(file.path);
 }
 
 void ReferenceGraph::updateFile(const std::string& filePath, const FileData& file) {
@@ -109,10 +126,47 @@ void ReferenceGraph::updateFile(const std::string& filePath, const FileData& fil
 void ReferenceGraph::removeFile(const std::string& filePath) {
   auto it = files_.find(filePath);
   if (it != files_.end()) {
+    // Remove edges resolved from this file's call sites
+    auto refsIt = fileReferences_.find(filePath);
+    if (refsIt != fileReferences_.end()) {
+        for (const auto& refId : refsIt->second) {
+            removeReference(refId);
+        }
+        fileReferences_.erase(refsIt);
+    }
+    // Each shared per-name list is filtered once, however often the file calls the name
+    std::unordered_set<std::string> calledNames;
+    for (const auto& site : it->second.callSites) calledNames.insert(site.name);
+    for (const auto& name : calledNames) {
+        auto sitesIt = callSitesByName_.find(name);
+        if (sitesIt == callSitesByName_.end()) continue;
+        auto& sites = sitesIt->second;
+        sites.erase(std::remove_if(sites.begin(), sites.end(),
+                                   [&](const CallSiteRef& ref) { return ref.filePath == filePath; }),
+                    sites.end());
+        if (sites.empty()) callSitesByName_.erase(sitesIt);
+    }
+
+    for (const auto& base : it->second.bases) {
+        classBases_.erase(base.classId);
+        auto subIt = subclassesByName_.find(base.name);
+        if (subIt == subclassesByName_.end()) continue;
+        auto& ids = subIt->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), base.classId), ids.end());
+        if (ids.empty()) subclassesByName_.erase(subIt);
+    }
+
     // Remove symbols defined in this file
     for (const auto& sym : it->second.symbols) {
+        if (sym.type == "class" || sym.type == "method") dispatchCache_.clear();
         removeReferences(sym.id); // Remove references FROM this symbol
         symbols_.erase(sym.id);
+        auto namesIt = symbolsByName_.find(sym.name);
+        if (namesIt != symbolsByName_.end()) {
+            auto& ids = namesIt->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), sym.id), ids.end());
+            if (ids.empty()) symbolsByName_.erase(namesIt);
+        }
         
         // Remove references TO this symbol
         auto callersIt = symbolToCallers_.find(sym.id);
@@ -130,6 +184,7 @@ void ReferenceGraph::removeFile(const std::string& filePath) {
     }
     files_.erase(it);
   }
+  clearFileUsages(filePath);
 }
 
 void ReferenceGraph::markFileDirty(const std::string& filePath) {
@@ -140,10 +195,238 @@ void ReferenceGraph::clearDirtyFiles() {
   dirtyFiles_.clear();
 }
 
+std::vector<std::string> ReferenceGraph::getDirtyFiles() const {
+  return std::vector<std::string>(dirtyFiles_.begin(), dirtyFiles_.end());
+}
+
 bool ReferenceGraph::hasFile(const std::string& filePath) const {
   return files_.find(filePath) != files_.end();
 }
 
+std::vector<std::string> ReferenceGraph::getFilePaths() const {
+  std::vector<std::string> paths;
+  paths.reserve(files_.size());
+  for (const auto& pair : files_) {
+    paths.push_back(pair.first);
+  }
+  return paths;
+}
+
+void ReferenceGraph::setFileUsages(const std::string& filePath,
+                                   const std::vector<std::string_view>& names) {
+  clearFileUsages(filePath);
+  std::vector<NameHandle> handles;
+  handles.reserve(names.size());
+  for (const auto& name : names) {
+    handles.push_back(names_.intern(name));
+  }
+  std::sort(handles.begin(), handles.end());
+  handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+  if (usageFileCounts_.size() < names_.size()) usageFileCounts_.resize(names_.size(), 0);
+  for (NameHandle handle : handles) {
+    usageFileCounts_[handle]++;
+  }
+  fileUsages_[filePath] = std::move(handles);
+}
+
+std::vector<std::string> ReferenceGraph::getImportedFiles(const std::string& filePath) const {
+  std::vector<std::string> result;
+  auto it = files_.find(filePath);
+  if (it == files_.end()) return result;
+  for (const auto& entry : it->second.imports) {
+    if (!entry.resolvedPath.empty()) result.push_back(entry.resolvedPath);
+  }
+  return result;
+}
+
+std::shared_ptr<const FileSkeleton> ReferenceGraph::getSkeleton(
+    const std::string& filePath) const {
+  auto it = files_.find(filePath);
+  return it == files_.end() ? nullptr : it->second.skeleton;
+}
+
+uint64_t ReferenceGraph::getContentHash(const std::string& filePath) const {
+  auto it = files_.find(filePath);
+  return it == files_.end() ? 0 : it->second.contentHash;
+}
+
+FileStamp ReferenceGraph::getFileStamp(const std::string& filePath) const {
+  auto it = files_.find(filePath);
+  return it == files_.end() ? FileStamp() : it->second.stamp;
+}
+
+std::vector<std::string> ReferenceGraph::getFileUsages(const std::string& filePath) const {
+  std::vector<std::string> result;
+  auto it = fileUsages_.find(filePath);
+  if (it == fileUsages_.end()) return result;
+  result.reserve(it->second.size());
+  for (NameHandle handle : it->second) {
+    result.push_back(names_.name(handle));
+  }
+  return result;
+}
+
+std::vector<uint32_t> ReferenceGraph::countNameUsages(const std::vector<std::string>& names,
+                                                      const std::vector<std::string>& filePaths) const {
+  std::vector<uint32_t> counts(names.size(), 0);
+  // Requested slot per handle; names never interned cannot have been used
+  std::unordered_map<NameHandle, std::vector<size_t>> slots;
+  for (size_t i = 0; i < names.size(); i++) {
+    NameHandle handle;
+    if (names_.find(names[i], handle)) slots[handle].push_back(i);
+  }
+  if (slots.empty()) return counts;
+
+  if (filePaths.empty()) {
+    for (const auto& pair : slots) {
+      for (size_t slot : pair.second) counts[slot] = usageFileCounts_[pair.first];
+    }
+    return counts;
+  }
+
+  for (const auto& filePath : filePaths) {
+    auto it = fileUsages_.find(filePath);
+    if (it == fileUsages_.end()) continue;
+    for (NameHandle handle : it->second) {
+      auto slotIt = slots.find(handle);
+      if (slotIt == slots.end()) continue;
+      for (size_t slot : slotIt->second) counts[slot]++;
+    }
+  }
+  return counts;
+}
+
+std::vector<std::string> ReferenceGraph::findCandidateFiles(
+    const std::vector<std::string>& names, const std::vector<std::string>& filePaths) const {
+  std::vector<BloomFilter::Probe> probes;
+  probes.reserve(names.size());
+  for (const auto& name : names) {
+    probes.push_back(BloomFilter::probeFor(name));
+  }
+
+  std::vector<std::string> result;
+  auto consider = [&](const std::string& path, const FileData& file) {
+    for (const auto& probe : probes) {
+      if (file.identifierFilter.mayContain(probe)) {
+        result.push_back(path);
+        return;
+      }
+    }
+  };
+
+  if (filePaths.empty()) {
+    for (const auto& pair : files_) consider(pair.first, pair.second);
+  } else {
+    for (const auto& path : filePaths) {
+      auto it = files_.find(path);
+      if (it == files_.end()) {
+        result.push_back(path);
+      } else {
+        consider(path, it->second);
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<ClassBase> ReferenceGraph::getBaseClasses(const std::string& classId) const {
+  auto it = classBases_.find(classId);
+  return it != classBases_.end() ? it->second : std::vector<ClassBase>();
+}
+
+std::vector<std::string> ReferenceGraph::getSubclasses(const std::string& classId) const {
+  auto symIt = symbols_.find(classId);
+  if (symIt == symbols_.end()) return {};
+  auto it = subclassesByName_.find(symIt->second.name);
+  return it != subclassesByName_.end() ? it->second : std::vector<std::string>();
+}
+
+bool ReferenceGraph::isClassName(const std::string& name) const {
+  auto it = symbolsByName_.find(name);
+  if (it == symbolsByName_.end()) return false;
+  for (const auto& id : it->second) {
+    auto symIt = symbols_.find(id);
+    if (symIt != symbols_.end() && symIt->second.type == "class") return true;
+  }
+  return false;
+}
+
+std::vector<std::string> ReferenceGraph::resolveMethod(const std::string& className,
+                                                       const std::string& methodName) const {
+  std::vector<std::string> result;
+  std::unordered_set<std::string> visited;
+  // Depth-first, bases in declaration order: Python's MRO for the usual shapes
+  std::vector<std::string> pending = {className};
+  while (!pending.empty()) {
+    std::string name = std::move(pending.back());
+    pending.pop_back();
+    if (!visited.insert(name).second) continue;
+    auto namesIt = symbolsByName_.find(name);
+    if (namesIt == symbolsByName_.end()) continue;
+    for (const auto& classId : namesIt->second) {
+      auto symIt = symbols_.find(classId);
+      if (symIt == symbols_.end() || symIt->second.type != "class") continue;
+      std::string own = makeSymbolId("method", methodName, name, symIt->second.filePath);
+      if (symbols_.count(own)) {
+        result.push_back(own);
+        continue;
+      }
+      auto basesIt = classBases_.find(classId);
+      if (basesIt == classBases_.end()) continue;
+      for (auto base = basesIt->second.rbegin(); base != basesIt->second.rend(); ++base) {
+        if (!base->isImplements) pending.push_back(base->name);
+      }
+    }
+  }
+  return result;
+}
+
+const std::vector<std::string>& ReferenceGraph::dispatchTargets(const std::string& className,
+                                                                const std::string& methodName) const {
+  std::string key = className;
+  key.push_back('\0');
+  key += methodName;
+  auto cached = dispatchCache_.find(key);
+  if (cached != dispatchCache_.end()) return cached->second;
+
+  std::vector<std::string> targets = resolveMethod(className, methodName);
+  std::unordered_set<std::string> visited = {className};
+  std::vector<std::string> pending = {className};
+  while (!pending.empty()) {
+    auto subIt = subclassesByName_.find(pending.back());
+    pending.pop_back();
+    if (subIt == subclassesByName_.end()) continue;
+    for (const auto& classId : subIt->second) {
+      auto symIt = symbols_.find(classId);
+      if (symIt == symbols_.end()) continue;
+      const Symbol& subclass = symIt->second;
+      std::string own = makeSymbolId("method", methodName, subclass.name, subclass.filePath);
+      if (symbols_.count(own)) targets.push_back(own);
+      if (visited.insert(subclass.name).second) pending.push_back(subclass.name);
+    }
+  }
+  std::sort(targets.begin(), targets.end());
+  targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+  return dispatchCache_.emplace(std::move(key), std::move(targets)).first->second;
+}
+
+bool ReferenceGraph::dispatches(const Reference& reference) const {
+  // Without a known receiver class any method of the name may run
+  if (reference.type != "method" || reference.receiverClass.empty() ||
+      !isClassName(reference.receiverClass)) {
+    return true;
+  }
+  auto symIt = symbols_.find(reference.toSymbolId);
+  if (symIt == symbols_.end() || symIt->second.type == "class") return true;
+  if (reference.superCall) {
+    auto resolved = resolveMethod(reference.receiverClass, reference.name);
+    return std::find(resolved.begin(), resolved.end(), reference.toSymbolId) != resolved.end();
+  }
+  const auto& targets = dispatchTargets(reference.receiverClass, reference.name);
+  return std::binary_search(targets.begin(), targets.end(), reference.toSymbolId);
+}
+
 bool ReferenceGraph::isSymbolUsed(const std::string& symbolId) const {
   auto it = symbolToCallers_.find(symbolId);
   return it != symbolToCallers_.end() && !it->second.empty();
@@ -152,7 +435,7 @@ bool ReferenceGraph::isSymbolUsed(const std::string& symbolId) const {
 std::vector<Symbol> ReferenceGraph::findUnusedSymbols() const {
   std::vector<Symbol> unused;
   for (const auto& pair : symbols_) {
-    if (!isSymbolUsed(pair.first)) {
+    if (!(pair.second.flags & kSymbolDeadCodeRoot) && !isSymbolUsed(pair.first)) {
       unused.push_back(pair.second);
     }
   }
@@ -161,9 +444,13 @@ std::vector<Symbol> ReferenceGraph::findUnusedSymbols() const {
 
 std::vector<Symbol> ReferenceGraph::findSymbolsByName(const std::string& name) const {
   std::vector<Symbol> result;
-  for (const auto& pair : symbols_) {
-    if (pair.second.name == name) {
-      result.push_back(pair.second);
+  auto it = symbolsByName_.find(name);
+  if (it != symbolsByName_.end()) {
+    for (const auto& id : it->second) {
+      auto symIt = symbols_.find(id);
+      if (symIt != symbols_.end()) {
+        result.push_back(symIt->second);
+      }
     }
   }
   return result;
@@ -208,6 +495,15 @@ void ReferenceGraph::clear() {
   symbolToCallers_.clear();
   files_.clear();
   dirtyFiles_.clear();
+  symbolsByName_.clear();
+  callSitesByName_.clear();
+  fileReferences_.clear();
+  fileUsages_.clear();
+  usageFileCounts_.clear();
+  names_.clear();
+  classBases_.clear();
+  subclassesByName_.clear();
+  dispatchCache_.clear();
 }
 
 std::string ReferenceGraph::generateSymbolId(const std::string& name, const std::string& filePath, int line) const {
@@ -219,8 +515,98 @@ size_t ReferenceGraph::calculateMemoryUsage() const {
   size += symbols_.size() * sizeof(Symbol);
   size += references_.size() * sizeof(Reference);
   size += files_.size() * sizeof(FileData);
+  for (const auto& pair : files_) {
+    size += pair.second.callSites.size() * sizeof(Reference);
+    size += pair.second.identifierFilter.sizeBytes();
+  }
+  for (const auto& pair : fileUsages_) {
+    size += pair.second.size() * sizeof(NameHandle);
+  }
+  size += usageFileCounts_.size() * sizeof(uint32_t) + names_.memoryUsage();
   // Approximation, ignoring dynamic string allocations for now
   return size;
 }
 
+void ReferenceGraph::removeReference(const std::string& referenceId) {
+  auto refIt = references_.find(referenceId);
+  if (refIt == references_.end()) return;
+  auto outIt = symbolToReferences_.find(refIt->second.fromSymbolId);
+  if (outIt != symbolToReferences_.end()) {
+    auto& outgoing = outIt->second;
+    outgoing.erase(std::remove(outgoing.begin(), outgoing.end(), referenceId), outgoing.end());
+  }
+  auto inIt = symbolToCallers_.find(refIt->second.toSymbolId);
+  if (inIt != symbolToCallers_.end()) {
+    auto& callers = inIt->second;
+    callers.erase(std::remove(callers.begin(), callers.end(), referenceId), callers.end());
+  }
+  references_.erase(refIt);
+}
+
+// Distinct names the config root references, in the order the files call them.
+std::vector<std::string> ReferenceGraph::getConfigReferences(
+    const std::vector<std::string>& filePaths) const {
+  std::vector<std::string> result;
+  std::unordered_set<std::string> seen;
+  for (const auto& path : filePaths) {
+    auto it = files_.find(path);
+    if (it == files_.end()) continue;
+    for (const auto& site : it->second.callSites) {
+      if (site.fromSymbolId == kConfigRootId && seen.insert(site.name).second) {
+        result.push_back(site.name);
+      }
+    }
+  }
+  return result;
+}
+
+// Call sites are resolved by name, in both directions: this file's calls to
+// every known symbol, and earlier files' calls to the symbols this file adds.
+void ReferenceGraph::linkCallSites(const std::string& filePath) {
+  const FileData& file = files_.at(filePath);
+  for (size_t i = 0; i < file.callSites.size(); i++) {
+    const Reference& site = file.callSites[i];
+    callSitesByName_[site.name].push_back({filePath, i});
+    auto namesIt = symbolsByName_.find(site.name);
+    if (namesIt == symbolsByName_.end()) continue;
+    for (const auto& symbolId : namesIt->second) {
+      linkCallSite(filePath, site, symbolId);
+    }
+  }
+  for (const auto& symbol : file.symbols) {
+    auto sitesIt = callSitesByName_.find(symbol.name);
+    if (sitesIt == callSitesByName_.end()) continue;
+    for (const auto& ref : sitesIt->second) {
+      if (ref.filePath == filePath) continue;
+      auto fileIt = files_.find(ref.filePath);
+      if (fileIt == files_.end()) continue;
+      linkCallSite(ref.filePath, fileIt->second.callSites[ref.index], symbol.id);
+    }
+  }
+}
+
+void ReferenceGraph::linkCallSite(const std::string& sitePath, const Reference& site,
+                                  const std::string& symbolId) {
+  auto symIt = symbols_.find(symbolId);
+  if (symIt == symbols_.end()) return;
+  const std::string& type = symIt->second.type;
+  if (type != "function" && type != "method" && type != "class") return;
+
+  Reference ref = site;
+  ref.toSymbolId = symbolId;
+  ref.id = site.id + "->" + symbolId;
+  if (references_.count(ref.id)) return;
+  addReference(ref);
+  fileReferences_[sitePath].insert(ref.id);
+}
+
+void ReferenceGraph::clearFileUsages(const std::string& filePath) {
+  auto it = fileUsages_.find(filePath);
+  if (it == fileUsages_.end()) return;
+  for (NameHandle handle : it->second) {
+    usageFileCounts_[handle]--;
+  }
+  fileUsages_.erase(it);
+}
+
 } // namespace prism
@@ -1,11 +1,17 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <string_view>
+#include "bloom_filter.h"
+#include "name_table.h"
+#include "skeleton.h"
+#include "source_buffer.h"
 
 namespace prism {
 
@@ -14,6 +20,7 @@ struct Position {
   int column;
 };
 
+// Positions: line is 1-based, column is 0-based (as reported by the tools).
 struct Symbol {
   std::string id;
   std::string name;
@@ -21,31 +28,58 @@ struct Symbol {
   std::string filePath;
   int line = 0;
   int column = 0;
+  int endLine = 0;
   std::string className;
   bool isExported = false;
   bool isStatic = false;
+  uint32_t flags = 0;  // SymbolFlag bits from classifySymbols
 };
 
 struct Reference {
   std::string id;
   std::string fromSymbolId;
   std::string toSymbolId;
-  std::string type;  // "direct", "method", "callback", "indirect"
+  std::string type;  // "direct", "method", "new", "callback", "indirect"
   std::string filePath;
   int line = 0;
   int column = 0;
+  std::string name;  // Callee as written at the call site; set on unresolved call sites
+  // Class a method call's receiver is known to be an instance of (`this`,
+  // `self`, `new C()`) or the class itself (`C.create()`); empty otherwise.
+  // For `super.m()` it is the enclosing class's base and superCall is set.
+  std::string receiverClass;
+  bool superCall = false;
+};
+
+// Direct base of a class: `extends`, `implements` or a Python superclass.
+struct ClassBase {
+  std::string classId;
+  std::string name;  // Last segment as written (`models.Model` -> `Model`)
+  bool isImplements = false;
 };
 
 struct ImportEntry {
   std::string source;
   std::vector<std::string> imported;
   bool isTypeOnly = false;
+  std::string resolvedPath;  // Absolute target file; empty when external or unresolved
 };
 
 struct FileData {
   std::string path;
   std::vector<Symbol> symbols;
   std::vector<ImportEntry> imports;
+  std::vector<Reference> callSites;  // Unresolved; linked to symbols by name
+  std::vector<ClassBase> bases;
+  BloomFilter identifierFilter;      // Every identifier in the file; empty when not built
+  std::shared_ptr<const FileSkeleton> skeleton;  // Null when not computed
+  uint64_t contentHash = 0;  // Of the source the entry was built from
+  FileStamp stamp;           // Of the file that source was read from; zero when not read from disk
+};
+
+struct CallSiteRef {
+  std::string filePath;
+  size_t index;  // Into FileData::callSites
 };
 
 struct GraphStats {
@@ -55,6 +89,10 @@ struct GraphStats {
   size_t memoryUsageBytes;
 };
 
+// Same layout as the ids the tools generate: type:name[:className]:filePath
+std::string makeSymbolId(const std::string& type, const std::string& name,
+                         const std::string& className, const std::string& filePath);
+
 class ReferenceGraph {
  private:
   std::unordered_map<std::string, Symbol> symbols_;
@@ -63,6 +101,16 @@ class ReferenceGraph {
   std::unordered_map<std::string, std::vector<std::string>> symbolToCallers_;
   std::unordered_map<std::string, FileData> files_;
   std::unordered_set<std::string> dirtyFiles_;
+  std::unordered_map<std::string, std::vector<std::string>> symbolsByName_;
+  std::unordered_map<std::string, std::vector<CallSiteRef>> callSitesByName_;
+  std::unordered_map<std::string, std::unordered_set<std::string>> fileReferences_;  // Resolved from call sites
+  NameTable names_;
+  std::unordered_map<std::string, std::vector<NameHandle>> fileUsages_;  // Sorted, distinct
+  std::vector<uint32_t> usageFileCounts_;  // Files using each name, indexed by handle
+  std::unordered_map<std::string, std::vector<ClassBase>> classBases_;  // Class id -> direct bases
+  std::unordered_map<std::string, std::vector<std::string>> subclassesByName_;  // Base name -> class ids
+  // Class name + '\0' + method -> dispatch targets; cleared when classes change
+  mutable std::unordered_map<std::string, std::vector<std::string>> dispatchCache_;
 
  public:
   ReferenceGraph();
@@ -79,6 +127,8 @@ class ReferenceGraph {
   void addReference(const Reference& reference);
   void addReferences(const std::vector<Reference>& references);
   void removeReferences(const std::string& symbolId);
+  // Method call edges whose receiver class is known are kept only when class
+  // hierarchy analysis says the call can dispatch to the target.
   std::vector<Reference> findCallers(const std::string& symbolId) const;
   std::vector<Reference> findCallees(const std::string& symbolId) const;
 
@@ -88,7 +138,45 @@ class ReferenceGraph {
   void removeFile(const std::string& filePath);
   void markFileDirty(const std::string& filePath);
   void clearDirtyFiles();
+  std::vector<std::string> getDirtyFiles() const;
   bool hasFile(const std::string& filePath) const;
+  std::vector<std::string> getFilePaths() const;
+  // Project files filePath imports, by resolved path
+  std::vector<std::string> getImportedFiles(const std::string& filePath) const;
+  // Null when the file is not indexed or has no skeleton
+  std::shared_ptr<const FileSkeleton> getSkeleton(const std::string& filePath) const;
+  // 0 when the file is not indexed
+  uint64_t getContentHash(const std::string& filePath) const;
+  // Zero when the file is not indexed or was not indexed from disk
+  FileStamp getFileStamp(const std::string& filePath) const;
+
+  // Identifier usage table: the names each file uses outside declarations
+  void setFileUsages(const std::string& filePath, const std::vector<std::string_view>& names);
+  std::vector<std::string> getFileUsages(const std::string& filePath) const;
+  // For each name, the number of files using it, limited to filePaths when non-empty
+  std::vector<uint32_t> countNameUsages(const std::vector<std::string>& names,
+                                        const std::vector<std::string>& filePaths) const;
+  // Files that may mention any of names, by their identifier filters. When
+  // filePaths is non-empty only those are checked, and paths the graph has no
+  // entry for are kept since nothing rules them out.
+  std::vector<std::string> findCandidateFiles(const std::vector<std::string>& names,
+                                              const std::vector<std::string>& filePaths) const;
+
+  // Names referenced from the config root by call sites in filePaths, distinct
+  std::vector<std::string> getConfigReferences(const std::vector<std::string>& filePaths) const;
+
+  // Class hierarchy. Classes are matched by name, so every class of that name
+  // contributes.
+  std::vector<ClassBase> getBaseClasses(const std::string& classId) const;
+  std::vector<std::string> getSubclasses(const std::string& classId) const;  // Direct only
+  // Method an instance of className runs for methodName: its own, else the
+  // nearest base's along extends edges. Empty when none is indexed.
+  std::vector<std::string> resolveMethod(const std::string& className,
+                                         const std::string& methodName) const;
+  // Class-hierarchy analysis: the resolved method plus every override in
+  // (transitive) subclasses. Cached per class and method name.
+  const std::vector<std::string>& dispatchTargets(const std::string& className,
+                                                  const std::string& methodName) const;
 
   // Query operations
   bool isSymbolUsed(const std::string& symbolId) const;
@@ -105,6 +193,14 @@ class ReferenceGraph {
  private:
   std::string generateSymbolId(const std::string& name, const std::string& filePath, int line) const;
   size_t calculateMemoryUsage() const;
+  void removeReference(const std::string& referenceId);
+  void linkCallSites(const std::string& filePath);
+  void linkCallSite(const std::string& sitePath, const Reference& site, const std::string& symbolId);
+  void clearFileUsages(const std::string& filePath);
+  bool isClassName(const std::string& name) const;
+  // Whether a call site edge is possible once its receiver is taken into account
+  bool dispatches(const Reference& reference) const;
+  std::vector<Reference> collectReferences(const std::vector<std::string>& referenceIds) const;
 };
 
 }  // namespace prism
@@ -0,0 +1,396 @@
+#include "identifier_index.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace prism {
+
+namespace {
+
+enum class NodeRole : uint8_t {
+  Other,
+  Identifier,
+  PropertyIdentifier,
+  ShorthandPattern,
+  ShorthandProperty,
+  Import,
+  VariableDeclarator,
+  Definition,
+  ParameterList,
+  Parameter,          // TS required/optional parameter: the pattern field declares
+  TypedParameter,     // Python: bare identifier children declare
+  DefaultParameter,   // Python: the name field declares
+  PairPattern,
+  AssignmentExpression,
+  PythonAssignment,
+  AugmentedAssignment,
+  UpdateExpression,
+  Call,
+  NewExpression,
+  MemberAccess,
+  Arguments,
+  Module,
+  ExpressionStatement,
+};
+
+NodeRole roleForType(const char* type) {
+  static const struct {
+    const char* type;
+    NodeRole role;
+  } kRoles[] = {
+      {"identifier", NodeRole::Identifier},
+      {"property_identifier", NodeRole::PropertyIdentifier},
+      {"shorthand_property_identifier_pattern", NodeRole::ShorthandPattern},
+      {"shorthand_property_identifier", NodeRole::ShorthandProperty},
+      {"import_statement", NodeRole::Import},
+      {"import_from_statement", NodeRole::Import},
+      {"future_import_statement", NodeRole::Import},
+      {"variable_declarator", NodeRole::VariableDeclarator},
+      {"function_declaration", NodeRole::Definition},
+      {"generator_function_declaration", NodeRole::Definition},
+      {"function_definition", NodeRole::Definition},
+      {"method_definition", NodeRole::Definition},
+      {"class_declaration", NodeRole::Definition},
+      {"abstract_class_declaration", NodeRole::Definition},
+      {"class_definition", NodeRole::Definition},
+      {"formal_parameters", NodeRole::ParameterList},
+      {"parameters", NodeRole::ParameterList},
+      {"lambda_parameters", NodeRole::ParameterList},
+      {"required_parameter", NodeRole::Parameter},
+      {"optional_parameter", NodeRole::Parameter},
+      {"typed_parameter", NodeRole::TypedParameter},
+      {"default_parameter", NodeRole::DefaultParameter},
+      {"typed_default_parameter", NodeRole::DefaultParameter},
+      {"pair_pattern", NodeRole::PairPattern},
+      {"assignment_expression", NodeRole::AssignmentExpression},
+      {"augmented_assignment_expression", NodeRole::AugmentedAssignment},
+      {"assignment", NodeRole::PythonAssignment},
+      {"augmented_assignment", NodeRole::AugmentedAssignment},
+      {"update_expression", NodeRole::UpdateExpression},
+      {"call_expression", NodeRole::Call},
+      {"call", NodeRole::Call},
+      {"new_expression", NodeRole::NewExpression},
+      {"member_expression", NodeRole::MemberAccess},
+      {"attribute", NodeRole::MemberAccess},
+      {"arguments", NodeRole::Arguments},
+      {"argument_list", NodeRole::Arguments},
+      {"module", NodeRole::Module},
+      {"expression_statement", NodeRole::ExpressionStatement},
+  };
+  for (const auto& entry : kRoles) {
+    if (!strcmp(type, entry.type)) return entry.role;
+  }
+  return NodeRole::Other;
+}
+
+struct GrammarTables {
+  std::vector<NodeRole> roles;  // Indexed by grammar symbol
+  TSFieldId name = 0, left = 0, function = 0, constructor = 0, property = 0, attribute = 0,
+            pattern = 0, value = 0;
+};
+
+GrammarTables grammarTables[3];
+std::once_flag grammarTableFlags[3];
+
+TSFieldId fieldId(const TSLanguage* language, const char* name) {
+  return ts_language_field_id_for_name(language, name, static_cast<uint32_t>(strlen(name)));
+}
+
+const GrammarTables& grammarTablesFor(LanguageId language) {
+  auto index = static_cast<size_t>(language);
+  std::call_once(grammarTableFlags[index], [language, index]() {
+    const TSLanguage* tsLanguage = tsLanguageFor(language);
+    GrammarTables& tables = grammarTables[index];
+    uint32_t count = ts_language_symbol_count(tsLanguage);
+    tables.roles.resize(count, NodeRole::Other);
+    for (uint32_t symbol = 0; symbol < count; symbol++) {
+      const char* name = ts_language_symbol_name(tsLanguage, static_cast<TSSymbol>(symbol));
+      if (name) tables.roles[symbol] = roleForType(name);
+    }
+    tables.name = fieldId(tsLanguage, "name");
+    tables.left = fieldId(tsLanguage, "left");
+    tables.function = fieldId(tsLanguage, "function");
+    tables.constructor = fieldId(tsLanguage, "constructor");
+    tables.property = fieldId(tsLanguage, "property");
+    tables.attribute = fieldId(tsLanguage, "attribute");
+    tables.pattern = fieldId(tsLanguage, "pattern");
+    tables.value = fieldId(tsLanguage, "value");
+  });
+  return grammarTables[index];
+}
+
+class OccurrenceScanner {
+ public:
+  explicit OccurrenceScanner(const SyntaxTree& tree)
+      : tree_(tree), tables_(grammarTablesFor(tree.language())) {}
+
+  std::vector<Occurrence> run() {
+    TSNode root = tree_.root();
+    frames_.push_back({roleOf(root), 0});
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    visitChildren(&cursor);
+    ts_tree_cursor_delete(&cursor);
+    return std::move(occurrences_);
+  }
+
+ private:
+  struct Frame {
+    NodeRole role;
+    TSFieldId field;  // This node's field in its parent
+  };
+
+  const SyntaxTree& tree_;
+  const GrammarTables& tables_;
+  std::vector<Frame> frames_;
+  std::vector<Occurrence> occurrences_;
+  int importDepth_ = 0;
+
+  NodeRole roleOf(TSNode node) const {
+    TSSymbol symbol = ts_node_symbol(node);
+    return symbol < tables_.roles.size() ? tables_.roles[symbol] : NodeRole::Other;
+  }
+
+  const Frame* ancestor(size_t levels) const {
+    return frames_.size() > levels ? &frames_[frames_.size() - 1 - levels] : nullptr;
+  }
+
+  void visitChildren(TSTreeCursor* cursor) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) return;
+    do {
+      TSNode node = ts_tree_cursor_current_node(cursor);
+      if (!ts_node_is_named(node)) continue;
+      TSFieldId field = ts_tree_cursor_current_field_id(cursor);
+      NodeRole role = roleOf(node);
+      switch (role) {
+        case NodeRole::Identifier:
+        case NodeRole::PropertyIdentifier:
+        case NodeRole::ShorthandPattern:
+        case NodeRole::ShorthandProperty:
+          record(node, role, field);
+          break;
+        default:
+          break;
+      }
+      if (role == NodeRole::Import) importDepth_++;
+      frames_.push_back({role, field});
+      visitChildren(cursor);
+      frames_.pop_back();
+      if (role == NodeRole::Import) importDepth_--;
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+  }
+
+  void record(TSNode node, NodeRole role, TSFieldId field) {
+    uint8_t flags = 0;
+    if (role == NodeRole::PropertyIdentifier || role == NodeRole::ShorthandProperty) {
+      flags |= kUsageProperty;
+    }
+    if (importDepth_ > 0) flags |= kUsageImport;
+    UsageKind kind = classify(role, field, flags);
+    TSPoint start = ts_node_start_point(node);
+    occurrences_.push_back({tree_.text(node), start.row + 1, start.column, kind, flags});
+  }
+
+  UsageKind classify(NodeRole role, TSFieldId field, uint8_t& flags) const {
+    if (importDepth_ > 0 || role == NodeRole::ShorthandPattern) return UsageKind::Declaration;
+
+    const Frame* parent = ancestor(0);
+    const Frame* grandparent = ancestor(1);
+    switch (parent->role) {
+      case NodeRole::VariableDeclarator:
+      case NodeRole::Definition:
+      case NodeRole::DefaultParameter:
+        if (field == tables_.name) return UsageKind::Declaration;
+        break;
+      case NodeRole::ParameterList:
+        return UsageKind::Declaration;
+      case NodeRole::Parameter:
+        if (field == tables_.pattern) return UsageKind::Declaration;
+        break;
+      case NodeRole::TypedParameter:
+        if (field == 0) return UsageKind::Declaration;
+        break;
+      case NodeRole::PairPattern:
+        if (field == tables_.value) return UsageKind::Declaration;
+        break;
+      case NodeRole::AssignmentExpression:
+      case NodeRole::AugmentedAssignment:
+        if (field == tables_.left) return UsageKind::Assignment;
+        break;
+      case NodeRole::PythonAssignment:
+        if (field == tables_.left) {
+          // Module-level assignments are how Python declares globals
+          const Frame* outer = grandparent && grandparent->role == NodeRole::ExpressionStatement
+                                   ? ancestor(2)
+                                   : grandparent;
+          return outer && outer->role == NodeRole::Module ? UsageKind::Declaration
+                                                          : UsageKind::Assignment;
+        }
+        break;
+      case NodeRole::UpdateExpression:
+        return UsageKind::Assignment;
+      case NodeRole::Call:
+        if (field == tables_.function) return UsageKind::Call;
+        break;
+      case NodeRole::NewExpression:
+        if (field == tables_.constructor) return UsageKind::Call;
+        break;
+      case NodeRole::MemberAccess:
+        if (field == tables_.property || field == tables_.attribute) {
+          flags |= kUsageMember;
+          if (grandparent && grandparent->role == NodeRole::Call &&
+              parent->field == tables_.function) {
+            return UsageKind::Call;
+          }
+        }
+        break;
+      case NodeRole::Arguments:
+        flags |= kUsageArgument;
+        break;
+      default:
+        break;
+    }
+    return UsageKind::Read;
+  }
+};
+
+void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t getVarint(const uint8_t*& p) {
+  uint32_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = *p++;
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+bool hasPathPrefix(const std::string& path, const std::string& prefix) {
+  if (path.compare(0, prefix.size(), prefix) != 0) return false;
+  return path.size() == prefix.size() || prefix.back() == '/' || path[prefix.size()] == '/';
+}
+
+}  // namespace
+
+std::vector<Occurrence> scanOccurrences(const SyntaxTree& tree) {
+  if (tree.language() == LanguageId::Unknown) return {};
+  return OccurrenceScanner(tree).run();
+}
+
+const char* usageKindName(UsageKind kind) {
+  switch (kind) {
+    case UsageKind::Declaration: return "declaration";
+    case UsageKind::Assignment: return "assignment";
+    case UsageKind::Read: return "read";
+    case UsageKind::Call: return "call";
+  }
+  return "read";
+}
+
+void IdentifierIndex::updateFile(const std::string& filePath,
+                                 const std::vector<Occurrence>& occurrences) {
+  removeFile(filePath);
+  if (occurrences.empty()) return;
+  NameHandle file = files_.intern(filePath);
+
+  // Occurrences arrive in document order, so each name's run is already sorted
+  std::unordered_map<NameHandle, size_t> blockOf;
+  std::vector<Block> blocks;
+  std::vector<NameHandle> blockNames;
+  std::vector<std::pair<uint32_t, uint32_t>> last;  // Previous (line, column) per block
+  for (const auto& occurrence : occurrences) {
+    NameHandle name = names_.intern(occurrence.name);
+    auto inserted = blockOf.emplace(name, blocks.size());
+    if (inserted.second) {
+      blocks.push_back({file, 0, {}});
+      blockNames.push_back(name);
+      last.push_back({0, 0});
+    }
+    size_t i = inserted.first->second;
+    Block& block = blocks[i];
+    uint32_t lineDelta = occurrence.line - last[i].first;
+    uint32_t column = lineDelta == 0 ? occurrence.column - last[i].second : occurrence.column;
+    putVarint(block.encoded, lineDelta);
+    putVarint(block.encoded, (column << 6) | (static_cast<uint32_t>(occurrence.kind) << 4) |
+                                 (occurrence.flags & 15));
+    block.count++;
+    last[i] = {occurrence.line, occurrence.column};
+  }
+
+  for (size_t i = 0; i < blocks.size(); i++) {
+    blocks[i].encoded.shrink_to_fit();
+    postings_[blockNames[i]].push_back(std::move(blocks[i]));
+  }
+  fileNames_[file] = std::move(blockNames);
+}
+
+void IdentifierIndex::removeFile(const std::string& filePath) {
+  NameHandle file;
+  if (!files_.find(filePath, file)) return;
+  auto it = fileNames_.find(file);
+  if (it == fileNames_.end()) return;
+  for (NameHandle name : it->second) {
+    auto postingsIt = postings_.find(name);
+    if (postingsIt == postings_.end()) continue;
+    auto& blocks = postingsIt->second;
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                                [file](const Block& block) { return block.file == file; }),
+                 blocks.end());
+    if (blocks.empty()) postings_.erase(postingsIt);
+  }
+  fileNames_.erase(it);
+}
+
+std::vector<Posting> IdentifierIndex::lookup(std::string_view name,
+                                             const std::string& pathPrefix) const {
+  std::vector<Posting> result;
+  NameHandle handle;
+  if (!names_.find(name, handle)) return result;
+  auto it = postings_.find(handle);
+  if (it == postings_.end()) return result;
+
+  for (const auto& block : it->second) {
+    const std::string& filePath = files_.name(block.file);
+    if (!pathPrefix.empty() && !hasPathPrefix(filePath, pathPrefix)) continue;
+    const uint8_t* p = block.encoded.data();
+    uint32_t line = 0;
+    uint32_t column = 0;
+    for (uint32_t i = 0; i < block.count; i++) {
+      uint32_t lineDelta = getVarint(p);
+      uint32_t packed = getVarint(p);
+      line += lineDelta;
+      column = lineDelta == 0 ? column + (packed >> 6) : (packed >> 6);
+      result.push_back({filePath, line, column, static_cast<UsageKind>((packed >> 4) & 3),
+                        static_cast<uint8_t>(packed & 15)});
+    }
+  }
+  return result;
+}
+
+IdentifierIndexStats IdentifierIndex::stats() const {
+  IdentifierIndexStats stats;
+  stats.names = postings_.size();
+  stats.files = fileNames_.size();
+  for (const auto& pair : postings_) {
+    for (const auto& block : pair.second) {
+      stats.postings += block.count;
+      stats.encodedBytes += block.encoded.size();
+    }
+  }
+  return stats;
+}
+
+void IdentifierIndex::clear() {
+  postings_.clear();
+  fileNames_.clear();
+  names_.clear();
+  files_.clear();
+}
+
+}  // namespace prism
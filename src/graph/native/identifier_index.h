@@ -0,0 +1,87 @@
+#ifndef IDENTIFIER_INDEX_H
+#define IDENTIFIER_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "name_table.h"
+#include "syntax_tree.h"
+
+namespace prism {
+
+enum class UsageKind : uint8_t {
+  Declaration = 0,
+  Assignment = 1,
+  Read = 2,
+  Call = 3,
+};
+
+// Where the identifier sits, beyond its usage kind
+enum UsageFlags : uint8_t {
+  kUsageMember = 1,    // Property of a member access: obj.name
+  kUsageArgument = 2,  // Passed directly as a call argument
+  kUsageProperty = 4,  // A property name node: keys, method names, class fields, obj.name
+  kUsageImport = 8,    // Bound by an import statement
+};
+
+struct Occurrence {
+  std::string_view name;
+  uint32_t line;    // 1-based
+  uint32_t column;  // 0-based
+  UsageKind kind;
+  uint8_t flags;
+};
+
+struct Posting {
+  std::string filePath;
+  uint32_t line;
+  uint32_t column;
+  UsageKind kind;
+  uint8_t flags;
+};
+
+struct IdentifierIndexStats {
+  size_t names = 0;
+  size_t files = 0;
+  size_t postings = 0;
+  size_t encodedBytes = 0;
+};
+
+// Every identifier occurrence in the tree, in document order.
+std::vector<Occurrence> scanOccurrences(const SyntaxTree& tree);
+
+const char* usageKindName(UsageKind kind);
+
+// Inverted index from identifier name to its occurrences across files.
+// Each (name, file) pair holds one block of postings sorted by position and
+// delta-encoded as varints: line delta, then column (a delta when the line
+// repeats) with kind and flags in the low four bits. Updating a file rewrites
+// only that file's blocks; a lookup decodes only the blocks for one name.
+class IdentifierIndex {
+ public:
+  void updateFile(const std::string& filePath, const std::vector<Occurrence>& occurrences);
+  void removeFile(const std::string& filePath);
+
+  // Postings for name, limited to files under pathPrefix when it is non-empty.
+  std::vector<Posting> lookup(std::string_view name, const std::string& pathPrefix) const;
+  IdentifierIndexStats stats() const;
+  void clear();
+
+ private:
+  struct Block {
+    NameHandle file;
+    uint32_t count;
+    std::vector<uint8_t> encoded;
+  };
+
+  NameTable names_;
+  NameTable files_;
+  std::unordered_map<NameHandle, std::vector<Block>> postings_;  // By name
+  std::unordered_map<NameHandle, std::vector<NameHandle>> fileNames_;  // Names with a block per file
+};
+
+}  // namespace prism
+
+#endif  // IDENTIFIER_INDEX_H
@@ -0,0 +1,467 @@
+#include "import_resolver.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace prism {
+
+namespace {
+
+constexpr int kMaxExtendsDepth = 8;
+
+// Just enough of JSON-with-comments for tsconfig files: comments and trailing
+// commas are accepted, numbers and literals are skipped.
+struct JsonValue {
+  enum class Kind { Other, String, Array, Object } kind = Kind::Other;
+  std::string string;
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+
+  const JsonValue* get(const std::string& key) const {
+    for (const auto& member : members) {
+      if (member.first == key) return &member.second;
+    }
+    return nullptr;
+  }
+};
+
+class JsoncParser {
+ public:
+  explicit JsoncParser(const std::string& text) : text_(text) {}
+
+  bool parse(JsonValue& out) {
+    skipTrivia();
+    return parseValue(out, 0);
+  }
+
+ private:
+  static constexpr int kMaxDepth = 64;
+
+  void skipTrivia() {
+    while (pos_ < text_.size()) {
+      char c = text_[pos_];
+      if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        pos_++;
+      } else if (text_.compare(pos_, 2, "//") == 0) {
+        size_t end = text_.find('\n', pos_);
+        pos_ = end == std::string::npos ? text_.size() : end + 1;
+      } else if (text_.compare(pos_, 2, "/*") == 0) {
+        size_t end = text_.find("*/", pos_ + 2);
+        pos_ = end == std::string::npos ? text_.size() : end + 2;
+      } else {
+        return;
+      }
+    }
+  }
+
+  bool parseValue(JsonValue& out, int depth) {
+    if (pos_ >= text_.size() || depth > kMaxDepth) return false;
+    char c = text_[pos_];
+    if (c == '"') {
+      out.kind = JsonValue::Kind::String;
+      return parseString(out.string);
+    }
+    if (c == '[') return parseArray(out, depth);
+    if (c == '{') return parseObject(out, depth);
+    size_t start = pos_;
+    while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' && text_[pos_] != ']' &&
+           text_[pos_] != ' ' && text_[pos_] != '\n' && text_[pos_] != '\r' && text_[pos_] != '\t') {
+      pos_++;
+    }
+    return pos_ > start;
+  }
+
+  bool parseString(std::string& out) {
+    out.clear();
+    pos_++;
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"') return true;
+      if (c != '\\') {
+        out.push_back(c);
+        continue;
+      }
+      if (pos_ >= text_.size()) return false;
+      char escape = text_[pos_++];
+      switch (escape) {
+        case 'n': out.push_back('\n'); break;
+        case 't': out.push_back('\t'); break;
+        case 'r': out.push_back('\r'); break;
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'u': {
+          if (pos_ + 4 > text_.size()) return false;
+          unsigned long code = std::strtoul(text_.substr(pos_, 4).c_str(), nullptr, 16);
+          pos_ += 4;
+          // Paths are ASCII in practice; anything else is kept as UTF-8
+          if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+          } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+          } else {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+          }
+          break;
+        }
+        default: out.push_back(escape); break;
+      }
+    }
+    return false;
+  }
+
+  bool parseArray(JsonValue& out, int depth) {
+    out.kind = JsonValue::Kind::Array;
+    pos_++;
+    while (true) {
+      skipTrivia();
+      if (pos_ >= text_.size()) return false;
+      if (text_[pos_] == ']') {
+        pos_++;
+        return true;
+      }
+      out.items.emplace_back();
+      if (!parseValue(out.items.back(), depth + 1)) return false;
+      skipTrivia();
+      if (pos_ < text_.size() && text_[pos_] == ',') pos_++;
+    }
+  }
+
+  bool parseObject(JsonValue& out, int depth) {
+    out.kind = JsonValue::Kind::Object;
+    pos_++;
+    while (true) {
+      skipTrivia();
+      if (pos_ >= text_.size()) return false;
+      if (text_[pos_] == '}') {
+        pos_++;
+        return true;
+      }
+      std::string key;
+      if (text_[pos_] != '"' || !parseString(key)) return false;
+      skipTrivia();
+      if (pos_ >= text_.size() || text_[pos_] != ':') return false;
+      pos_++;
+      skipTrivia();
+      out.members.emplace_back(std::move(key), JsonValue());
+      if (!parseValue(out.members.back().second, depth + 1)) return false;
+      skipTrivia();
+      if (pos_ < text_.size() && text_[pos_] == ',') pos_++;
+    }
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+};
+
+std::string joinPath(const std::string& dir, const std::string& relative) {
+  std::string joined = (fs::path(dir) / relative).lexically_normal().string();
+  if (joined.size() > 1 && joined.back() == '/') joined.pop_back();
+  return joined;
+}
+
+std::string parentDir(const std::string& path) {
+  return fs::path(path).parent_path().string();
+}
+
+bool isRelativeSpecifier(const std::string& source) {
+  return source == "." || source == ".." || source.compare(0, 2, "./") == 0 ||
+         source.compare(0, 3, "../") == 0 || (!source.empty() && source[0] == '/');
+}
+
+bool isPythonFile(const std::string& path) {
+  std::string ext = fs::path(path).extension().string();
+  return ext == ".py" || ext == ".pyw";
+}
+
+// Capture for a tsconfig "paths" pattern with at most one '*', or false.
+bool matchPathPattern(const std::string& pattern, const std::string& source, std::string& capture) {
+  size_t star = pattern.find('*');
+  if (star == std::string::npos) {
+    capture.clear();
+    return pattern == source;
+  }
+  size_t suffixLength = pattern.size() - star - 1;
+  if (source.size() < star + suffixLength) return false;
+  if (source.compare(0, star, pattern, 0, star) != 0) return false;
+  if (source.compare(source.size() - suffixLength, suffixLength, pattern, star + 1, suffixLength) != 0) {
+    return false;
+  }
+  capture = source.substr(star, source.size() - star - suffixLength);
+  return true;
+}
+
+}  // namespace
+
+FileKind FileSystemCache::kind(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = kinds_.find(path);
+    if (it != kinds_.end()) {
+      hits_++;
+      return it->second;
+    }
+    misses_++;
+  }
+
+  std::error_code ec;
+  fs::file_status status = fs::status(path, ec);
+  FileKind kind = FileKind::Missing;
+  if (!ec && fs::is_regular_file(status)) kind = FileKind::File;
+  else if (!ec && fs::is_directory(status)) kind = FileKind::Directory;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  kinds_[path] = kind;
+  return kind;
+}
+
+void FileSystemCache::invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fs::path current(path);
+  while (true) {
+    kinds_.erase(current.string());
+    fs::path parent = current.parent_path();
+    if (parent.empty() || parent == current) break;
+    current = parent;
+  }
+}
+
+void FileSystemCache::counts(size_t& hits, size_t& misses) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  hits = hits_;
+  misses = misses_;
+}
+
+void FileSystemCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  kinds_.clear();
+}
+
+std::string ImportResolver::resolve(const std::string& fromFile, const std::string& source) {
+  if (source.empty()) return std::string();
+  std::string fromDir = parentDir(fromFile);
+  std::string key = fromDir + '\0' + (isPythonFile(fromFile) ? "py:" : "js:") + source;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolutions_++;
+    auto it = resolved_.find(key);
+    if (it != resolved_.end()) {
+      cachedResolutions_++;
+      return it->second;
+    }
+  }
+
+  std::string result =
+      isPythonFile(fromFile) ? resolvePython(fromDir, source) : resolveScript(fromDir, source);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  resolved_[key] = result;
+  return result;
+}
+
+std::string ImportResolver::resolveScript(const std::string& fromDir, const std::string& source) {
+  if (isRelativeSpecifier(source)) return probeScript(joinPath(fromDir, source));
+
+  std::shared_ptr<const TsConfigPaths> config = tsConfigFor(fromDir);
+  if (!config) return std::string();
+
+  // The pattern with the longest literal prefix wins, as in tsc
+  const std::vector<std::string>* targets = nullptr;
+  std::string capture;
+  size_t bestPrefix = 0;
+  for (const auto& entry : config->paths) {
+    std::string candidate;
+    if (!matchPathPattern(entry.first, source, candidate)) continue;
+    size_t prefix = entry.first.find('*');
+    if (prefix == std::string::npos) prefix = entry.first.size() + 1;
+    if (!targets || prefix > bestPrefix) {
+      targets = &entry.second;
+      capture = candidate;
+      bestPrefix = prefix;
+    }
+  }
+  if (targets) {
+    for (const auto& target : *targets) {
+      std::string substituted = target;
+      size_t star = substituted.find('*');
+      if (star != std::string::npos) substituted.replace(star, 1, capture);
+      std::string found = probeScript(joinPath(config->pathsBase, substituted));
+      if (!found.empty()) return found;
+    }
+  }
+
+  if (!config->baseUrl.empty()) return probeScript(joinPath(config->baseUrl, source));
+  return std::string();
+}
+
+std::string ImportResolver::probeScript(const std::string& base) {
+  if (files_.isFile(base)) return base;
+
+  // NodeNext-style specifiers name the emitted .js file
+  static const std::pair<const char*, const char*> kEmittedExtensions[] = {
+      {".js", ".ts"}, {".js", ".tsx"}, {".jsx", ".tsx"}, {".mjs", ".mts"}, {".cjs", ".cts"},
+  };
+  std::string ext = fs::path(base).extension().string();
+  for (const auto& mapping : kEmittedExtensions) {
+    if (ext != mapping.first) continue;
+    std::string candidate = base.substr(0, base.size() - ext.size()) + mapping.second;
+    if (files_.isFile(candidate)) return candidate;
+  }
+
+  for (const char* extension : {".ts", ".tsx", ".js", ".jsx", ".mjs", ".py"}) {
+    std::string candidate = base + extension;
+    if (files_.isFile(candidate)) return candidate;
+  }
+
+  if (files_.kind(base) != FileKind::Directory) return std::string();
+  for (const char* index : {"index.ts", "index.tsx", "index.js", "index.jsx"}) {
+    std::string candidate = base + "/" + index;
+    if (files_.isFile(candidate)) return candidate;
+  }
+  return std::string();
+}
+
+std::string ImportResolver::resolvePython(const std::string& fromDir, const std::string& source) {
+  size_t dots = 0;
+  while (dots < source.size() && source[dots] == '.') dots++;
+  std::string modulePath = source.substr(dots);
+  for (char& c : modulePath) {
+    if (c == '.') c = '/';
+  }
+
+  if (dots > 0) {
+    std::string base = fromDir;
+    for (size_t level = 1; level < dots; level++) base = parentDir(base);
+    if (modulePath.empty()) {
+      std::string init = base + "/__init__.py";
+      return files_.isFile(init) ? init : std::string();
+    }
+    return probePythonModule(joinPath(base, modulePath));
+  }
+
+  // The importing directory, then the directory above its outermost package
+  std::string found = probePythonModule(joinPath(fromDir, modulePath));
+  if (!found.empty()) return found;
+  std::string root = fromDir;
+  bool inPackage = false;
+  while (files_.isFile(root + "/__init__.py")) {
+    std::string parent = parentDir(root);
+    if (parent == root) break;
+    root = parent;
+    inPackage = true;
+  }
+  return inPackage ? probePythonModule(joinPath(root, modulePath)) : std::string();
+}
+
+std::string ImportResolver::probePythonModule(const std::string& base) {
+  std::string module = base + ".py";
+  if (files_.isFile(module)) return module;
+  std::string package = base + "/__init__.py";
+  if (files_.isFile(package)) return package;
+  return std::string();
+}
+
+std::shared_ptr<const TsConfigPaths> ImportResolver::tsConfigFor(const std::string& dir) {
+  std::vector<std::string> visited;
+  std::shared_ptr<const TsConfigPaths> config;
+  std::string current = dir;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tsConfigs_.find(current);
+      if (it != tsConfigs_.end()) {
+        config = it->second;
+        break;
+      }
+    }
+    visited.push_back(current);
+    std::string candidate = current + "/tsconfig.json";
+    if (files_.isFile(candidate)) {
+      config = loadTsConfig(candidate, 0);
+      break;
+    }
+    std::string parent = parentDir(current);
+    if (parent.empty() || parent == current) break;
+    current = parent;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& path : visited) tsConfigs_[path] = config;
+  return config;
+}
+
+std::shared_ptr<const TsConfigPaths> ImportResolver::loadTsConfig(const std::string& path, int depth) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return nullptr;
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  std::string text = contents.str();
+
+  JsonValue root;
+  if (!JsoncParser(text).parse(root) || root.kind != JsonValue::Kind::Object) return nullptr;
+
+  auto config = std::make_shared<TsConfigPaths>();
+  std::string configDir = parentDir(path);
+  const JsonValue* extends = root.get("extends");
+  if (extends && extends->kind == JsonValue::Kind::String && isRelativeSpecifier(extends->string) &&
+      depth < kMaxExtendsDepth) {
+    std::string basePath = joinPath(configDir, extends->string);
+    if (fs::path(basePath).extension() != ".json") basePath += ".json";
+    if (auto base = loadTsConfig(basePath, depth + 1)) *config = *base;
+  }
+
+  const JsonValue* options = root.get("compilerOptions");
+  if (options && options->kind == JsonValue::Kind::Object) {
+    const JsonValue* baseUrl = options->get("baseUrl");
+    if (baseUrl && baseUrl->kind == JsonValue::Kind::String) {
+      config->baseUrl = joinPath(configDir, baseUrl->string);
+    }
+    const JsonValue* paths = options->get("paths");
+    if (paths && paths->kind == JsonValue::Kind::Object) {
+      config->paths.clear();
+      config->pathsBase = config->baseUrl.empty() ? configDir : config->baseUrl;
+      for (const auto& member : paths->members) {
+        std::vector<std::string> targets;
+        for (const auto& item : member.second.items) {
+          if (item.kind == JsonValue::Kind::String) targets.push_back(item.string);
+        }
+        config->paths.emplace_back(member.first, std::move(targets));
+      }
+    }
+  }
+  return config;
+}
+
+void ImportResolver::invalidate(const std::string& path) {
+  files_.invalidate(path);
+  std::lock_guard<std::mutex> lock(mutex_);
+  resolved_.clear();
+  // tsconfig.json and whatever it extends (tsconfig.base.json and the like)
+  if (fs::path(path).filename().string().compare(0, 8, "tsconfig") == 0) {
+    tsConfigs_.clear();
+  }
+}
+
+void ImportResolver::clear() {
+  files_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  resolved_.clear();
+  tsConfigs_.clear();
+}
+
+ImportResolverStats ImportResolver::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ImportResolverStats stats;
+  stats.resolutions = resolutions_;
+  stats.cachedResolutions = cachedResolutions_;
+  files_.counts(stats.statHits, stats.statMisses);
+  return stats;
+}
+
+}  // namespace prism
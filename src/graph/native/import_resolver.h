@@ -0,0 +1,81 @@
+#ifndef IMPORT_RESOLVER_H
+#define IMPORT_RESOLVER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prism {
+
+enum class FileKind : uint8_t { Missing, File, Directory };
+
+// Memoized stat results. Entries stay valid until invalidated, so callers must
+// invalidate paths the file watcher reports as added, changed or removed.
+class FileSystemCache {
+ public:
+  FileKind kind(const std::string& path);
+  bool isFile(const std::string& path) { return kind(path) == FileKind::File; }
+  // Drops path and its ancestors, since adding a file can create directories.
+  void invalidate(const std::string& path);
+  void clear();
+
+  void counts(size_t& hits, size_t& misses) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, FileKind> kinds_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+// compilerOptions.baseUrl and compilerOptions.paths of the nearest tsconfig.json,
+// with relative extends followed.
+struct TsConfigPaths {
+  std::string baseUrl;  // Absolute; empty when not set
+  std::string pathsBase;  // Directory "paths" targets are relative to
+  std::vector<std::pair<std::string, std::vector<std::string>>> paths;
+};
+
+struct ImportResolverStats {
+  size_t resolutions = 0;
+  size_t cachedResolutions = 0;
+  size_t statHits = 0;
+  size_t statMisses = 0;
+};
+
+// Resolves import specifiers (ImportEntry::source) to absolute file paths.
+// TS/JS: relative and absolute paths, tsconfig paths and baseUrl, extension,
+// .js-to-.ts and index-file probing. Python: relative imports by package level
+// and dotted modules against the importing file's package roots. Bare package
+// names resolve to nothing. Thread-safe.
+class ImportResolver {
+ public:
+  // Empty when the import is external or cannot be found.
+  std::string resolve(const std::string& fromFile, const std::string& source);
+  void invalidate(const std::string& path);
+  void clear();
+  ImportResolverStats stats() const;
+
+ private:
+  std::string resolveScript(const std::string& fromDir, const std::string& source);
+  std::string resolvePython(const std::string& fromDir, const std::string& source);
+  std::string probeScript(const std::string& base);
+  std::string probePythonModule(const std::string& base);
+  std::shared_ptr<const TsConfigPaths> tsConfigFor(const std::string& dir);
+  std::shared_ptr<const TsConfigPaths> loadTsConfig(const std::string& path, int depth);
+
+  FileSystemCache files_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::string> resolved_;  // fromDir + '\0' + source
+  std::unordered_map<std::string, std::shared_ptr<const TsConfigPaths>> tsConfigs_;  // By directory
+  size_t resolutions_ = 0;
+  size_t cachedResolutions_ = 0;
+};
+
+}  // namespace prism
+
+#endif  // IMPORT_RESOLVER_H
@@ -1,46 +1,11 @@
-import { createRequire } from 'module';
-import path from 'path';
-import fs from 'fs';
-
-const require = createRequire(import.meta.url);
-
-function findAddon() {
-  const possiblePaths = [
-    // When running from build/graph/native/index.js
-    '../../Release/graph.node',
-    // When running from src/graph/native/index.ts (dev/test)
-    '../../../build/Release/graph.node'
-  ];
-
-  for (const p of possiblePaths) {
-    try {
-      // Resolve relative to this file
-      const resolved = require.resolve(p);
-      return require(resolved);
-    } catch (e) {
-      // Continue
-    }
-  }
-  
-  // Fallback: try via absolute path from cwd (for vitest execution)
-  try {
-    const cwdPath = path.join(process.cwd(), 'build', 'Release', 'graph.node');
-    if (fs.existsSync(cwdPath)) {
-      return require(cwdPath);
-    }
-  } catch (e) {
-    // Continue
-  }
-  
-  // Last resort
-  try {
-     return require('../../../build/Release/graph.node');
-  } catch (e) {
-     throw new Error(`Could not find graph.node addon. Searched in: ${possiblePaths.join(', ')}`);
-  }
-}
+import { addon } from './addon.js';
 
-const addon = findAddon();
+export * from './syntax.js';
+export * from './extractor.js';
+export * from './control-flow.js';
+export * from './dataflow.js';
+export * from './patterns.js';
+export * from './project-index.js';
 
 export interface Symbol {
   id: string;
@@ -49,9 +14,12 @@ export interface Symbol {
   filePath: string;
   line: number;
   column: number;
+  endLine?: number;
   className?: string;
   isExported?: boolean;
   isStatic?: boolean;
+  /** SymbolFlags bits; set on symbols from the project index. */
+  flags?: number;
 }
 
 export interface Reference {
@@ -62,18 +30,34 @@ export interface Reference {
   filePath: string;
   line: number;
   column: number;
+  name?: string;
+  /** Static type of a method call's receiver, when the extractor could tell. */
+  receiverClass?: string;
+  /** `super.m()`: dispatches to the receiver class's own resolution only. */
+  superCall?: boolean;
+}
+
+export interface ClassBase {
+  classId: string;
+  /** Base class or interface name, last segment as written. */
+  name: string;
+  isImplements: boolean;
 }
 
 export interface ImportEntry {
   source: string;
   imported: string[];
   isTypeOnly: boolean;
+  /** Absolute target file, when the project index resolved the import. */
+  resolvedPath?: string;
 }
 
 export interface FileData {
   path: string;
   symbols: Symbol[];
   imports: ImportEntry[];
+  callSites?: Reference[];
+  bases?: ClassBase[];
 }
 
 export interface GraphStats {
@@ -0,0 +1,32 @@
+#include "name_table.h"
+
+namespace prism {
+
+NameHandle NameTable::intern(std::string_view name) {
+  auto it = handles_.find(name);
+  if (it != handles_.end()) return it->second;
+  NameHandle handle = static_cast<NameHandle>(names_.size());
+  names_.emplace_back(name);
+  handles_.emplace(std::string_view(names_.back()), handle);
+  return handle;
+}
+
+bool NameTable::find(std::string_view name, NameHandle& handle) const {
+  auto it = handles_.find(name);
+  if (it == handles_.end()) return false;
+  handle = it->second;
+  return true;
+}
+
+size_t NameTable::memoryUsage() const {
+  size_t size = names_.size() * (sizeof(std::string) + sizeof(std::string_view) + sizeof(NameHandle));
+  for (const auto& name : names_) size += name.capacity();
+  return size;
+}
+
+void NameTable::clear() {
+  handles_.clear();
+  names_.clear();
+}
+
+}  // namespace prism
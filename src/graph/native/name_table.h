@@ -0,0 +1,32 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace prism {
+
+using NameHandle = uint32_t;
+
+// Interns identifier names into dense handles. Handles stay valid until
+// clear(); names are stored once and looked up without allocating.
+class NameTable {
+ public:
+  NameHandle intern(std::string_view name);
+  bool find(std::string_view name, NameHandle& handle) const;
+  const std::string& name(NameHandle handle) const { return names_[handle]; }
+  size_t size() const { return names_.size(); }
+  size_t memoryUsage() const;
+  void clear();
+
+ private:
+  std::deque<std::string> names_;  // deque: element addresses back the map's keys
+  std::unordered_map<std::string_view, NameHandle> handles_;
+};
+
+}  // namespace prism
+
+#endif  // NAME_TABLE_H
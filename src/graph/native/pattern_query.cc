@@ -0,0 +1,218 @@
+#include "pattern_query.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace prism {
+
+namespace {
+
+constexpr size_t kMaxCachedPatterns = 128;
+
+const char* queryErrorName(TSQueryError error) {
+  switch (error) {
+    case TSQueryErrorSyntax:
+      return "syntax error";
+    case TSQueryErrorNodeType:
+      return "unknown node type";
+    case TSQueryErrorField:
+      return "unknown field";
+    case TSQueryErrorCapture:
+      return "unknown capture";
+    case TSQueryErrorStructure:
+      return "impossible pattern";
+    case TSQueryErrorLanguage:
+      return "incompatible language";
+    default:
+      return "error";
+  }
+}
+
+std::string_view stringValue(const TSQuery* query, uint32_t id) {
+  uint32_t length = 0;
+  const char* value = ts_query_string_value_for_id(query, id, &length);
+  return std::string_view(value, length);
+}
+
+struct PatternCache {
+  std::mutex mutex;
+  // Most recently used at the front
+  std::list<std::pair<std::string, CompiledPatternPtr>> order;
+  std::unordered_map<std::string, std::list<std::pair<std::string, CompiledPatternPtr>>::iterator>
+      entries;  // Language byte + query text
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+};
+
+PatternCache& patternCache() {
+  static PatternCache cache;
+  return cache;
+}
+
+// One cursor per thread; ts_query_cursor_exec resets it for each query.
+struct ThreadCursor {
+  TSQueryCursor* cursor = ts_query_cursor_new();
+  ~ThreadCursor() { ts_query_cursor_delete(cursor); }
+};
+
+thread_local ThreadCursor threadCursor;
+
+}  // namespace
+
+CompiledPattern::CompiledPattern(LanguageId language, TSQuery* query)
+    : language_(language), query_(query) {
+  uint32_t patternCount = ts_query_pattern_count(query);
+  predicates_.resize(patternCount);
+  for (uint32_t pattern = 0; pattern < patternCount; pattern++) {
+    uint32_t stepCount = 0;
+    const TSQueryPredicateStep* steps = ts_query_predicates_for_pattern(query, pattern, &stepCount);
+    // Predicates are step runs ending in Done: the name, then its arguments.
+    for (uint32_t begin = 0; begin < stepCount;) {
+      uint32_t end = begin;
+      while (end < stepCount && steps[end].type != TSQueryPredicateStepTypeDone) end++;
+      if (end - begin == 3 && steps[begin].type == TSQueryPredicateStepTypeString &&
+          steps[begin + 1].type == TSQueryPredicateStepTypeCapture) {
+        std::string_view name = stringValue(query, steps[begin].value_id);
+        PatternPredicate predicate;
+        predicate.negated = name.substr(0, 4) == "not-";
+        std::string_view op = predicate.negated ? name.substr(4) : name;
+        if (op == "eq?" || op == "match?") {
+          predicate.isMatch = op == "match?";
+          predicate.captureId = steps[begin + 1].value_id;
+          const TSQueryPredicateStep& argument = steps[begin + 2];
+          if (argument.type == TSQueryPredicateStepTypeCapture) {
+            predicate.againstCapture = !predicate.isMatch;
+            predicate.otherCaptureId = argument.value_id;
+          } else {
+            predicate.value = std::string(stringValue(query, argument.value_id));
+          }
+          // Throws std::regex_error on a bad expression; compilePattern reports it.
+          if (predicate.isMatch) predicate.regex = std::regex(predicate.value);
+          predicates_[pattern].push_back(std::move(predicate));
+        }
+      }
+      begin = end + 1;
+    }
+  }
+}
+
+CompiledPattern::~CompiledPattern() {
+  ts_query_delete(query_);
+}
+
+std::string_view CompiledPattern::captureName(uint32_t captureId) const {
+  uint32_t length = 0;
+  const char* name = ts_query_capture_name_for_id(query_, captureId, &length);
+  return std::string_view(name, length);
+}
+
+bool CompiledPattern::accepts(const SyntaxTree& tree, const TSQueryMatch& match) const {
+  if (match.pattern_index >= predicates_.size()) return true;
+  auto captured = [&](uint32_t captureId, std::string_view& text) {
+    for (uint16_t i = 0; i < match.capture_count; i++) {
+      if (match.captures[i].index == captureId) {
+        text = tree.text(match.captures[i].node);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (const auto& predicate : predicates_[match.pattern_index]) {
+    std::string_view text;
+    if (!captured(predicate.captureId, text)) continue;
+    bool holds;
+    if (predicate.isMatch) {
+      holds = std::regex_search(text.begin(), text.end(), predicate.regex);
+    } else if (predicate.againstCapture) {
+      std::string_view other;
+      holds = !captured(predicate.otherCaptureId, other) || text == other;
+    } else {
+      holds = text == predicate.value;
+    }
+    if (holds == predicate.negated) return false;
+  }
+  return true;
+}
+
+CompiledPatternPtr compilePattern(LanguageId language, const std::string& text, std::string& error) {
+  const TSLanguage* grammar = tsLanguageFor(language);
+  if (!grammar) {
+    error = "Unsupported language";
+    return nullptr;
+  }
+
+  std::string key(1, static_cast<char>(language));
+  key += text;
+  PatternCache& cache = patternCache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+      cache.hits++;
+      cache.order.splice(cache.order.begin(), cache.order, it->second);
+      return it->second->second;
+    }
+    cache.misses++;
+  }
+
+  uint32_t errorOffset = 0;
+  TSQueryError errorType = TSQueryErrorNone;
+  TSQuery* query = ts_query_new(grammar, text.data(), static_cast<uint32_t>(text.size()),
+                                &errorOffset, &errorType);
+  if (!query) {
+    error = std::string("Invalid query: ") + queryErrorName(errorType) + " at offset " +
+            std::to_string(errorOffset);
+    return nullptr;
+  }
+  CompiledPatternPtr compiled;
+  try {
+    compiled = std::make_shared<const CompiledPattern>(language, query);
+  } catch (const std::regex_error& e) {
+    // The constructor owns query only once it returns.
+    ts_query_delete(query);
+    error = std::string("Invalid #match? expression: ") + e.what();
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.entries.find(key);
+  if (it != cache.entries.end()) return it->second->second;  // Compiled concurrently
+  cache.order.emplace_front(std::move(key), compiled);
+  cache.entries[cache.order.front().first] = cache.order.begin();
+  while (cache.order.size() > kMaxCachedPatterns) {
+    cache.entries.erase(cache.order.back().first);
+    cache.order.pop_back();
+    cache.evictions++;
+  }
+  return compiled;
+}
+
+std::vector<PatternMatch> matchPattern(const SyntaxTree& tree, const CompiledPattern& pattern) {
+  std::vector<PatternMatch> matches;
+  if (tree.language() != pattern.language()) return matches;
+
+  TSQueryCursor* cursor = threadCursor.cursor;
+  ts_query_cursor_exec(cursor, pattern.query(), tree.root());
+  TSQueryMatch match;
+  while (ts_query_cursor_next_match(cursor, &match)) {
+    if (!pattern.accepts(tree, match)) continue;
+    PatternMatch result;
+    result.patternIndex = match.pattern_index;
+    result.captures.reserve(match.capture_count);
+    for (uint16_t i = 0; i < match.capture_count; i++) {
+      result.captures.push_back({match.captures[i].index, match.captures[i].node});
+    }
+    matches.push_back(std::move(result));
+  }
+  return matches;
+}
+
+PatternCacheStats patternCacheStats() {
+  PatternCache& cache = patternCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return {cache.entries.size(), cache.hits, cache.misses, cache.evictions};
+}
+
+}  // namespace prism
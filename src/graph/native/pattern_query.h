@@ -0,0 +1,82 @@
+#ifndef PATTERN_QUERY_H
+#define PATTERN_QUERY_H
+
+#include <tree_sitter/api.h>
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "syntax_tree.h"
+
+namespace prism {
+
+// A text predicate of one pattern: #eq?, #not-eq?, #match? or #not-match?.
+// Other predicates are ignored, as the JS bindings do.
+struct PatternPredicate {
+  uint32_t captureId;
+  bool negated = false;
+  bool isMatch = false;          // Regex instead of equality
+  bool againstCapture = false;   // #eq? @a @b
+  uint32_t otherCaptureId = 0;
+  std::string value;
+  std::regex regex;
+};
+
+// A user-supplied query compiled for one grammar. Immutable, so one instance
+// serves every thread.
+class CompiledPattern {
+ public:
+  CompiledPattern(LanguageId language, TSQuery* query);
+  ~CompiledPattern();
+
+  CompiledPattern(const CompiledPattern&) = delete;
+  CompiledPattern& operator=(const CompiledPattern&) = delete;
+
+  LanguageId language() const { return language_; }
+  const TSQuery* query() const { return query_; }
+  std::string_view captureName(uint32_t captureId) const;
+  // Whether the predicates of match's pattern hold on tree's text.
+  bool accepts(const SyntaxTree& tree, const TSQueryMatch& match) const;
+
+ private:
+  LanguageId language_;
+  TSQuery* query_;
+  std::vector<std::vector<PatternPredicate>> predicates_;  // By pattern index
+};
+
+using CompiledPatternPtr = std::shared_ptr<const CompiledPattern>;
+
+// Compiles text for language, or returns the cached instance for the same
+// grammar and text. The cache is shared by every thread and evicts the least
+// recently used query past kMaxCachedPatterns. Null, with error describing
+// the problem and its offset, when text does not compile.
+CompiledPatternPtr compilePattern(LanguageId language, const std::string& text, std::string& error);
+
+struct PatternCapture {
+  uint32_t captureId;
+  TSNode node;
+};
+
+struct PatternMatch {
+  uint32_t patternIndex;
+  std::vector<PatternCapture> captures;
+};
+
+// Every match of pattern in tree whose predicates hold, in document order.
+// Query cursors are reused per thread.
+std::vector<PatternMatch> matchPattern(const SyntaxTree& tree, const CompiledPattern& pattern);
+
+struct PatternCacheStats {
+  size_t entries;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+};
+
+PatternCacheStats patternCacheStats();
+
+}  // namespace prism
+
+#endif  // PATTERN_QUERY_H
@@ -0,0 +1,52 @@
+import { addon } from './addon.js';
+
+export interface NativePatternPosition {
+  row: number;
+  /** In UTF-16 code units, as the JS parsers count columns. */
+  column: number;
+}
+
+export interface NativePatternCapture {
+  name: string;
+  text: string;
+  type: string;
+  startPosition: NativePatternPosition;
+  endPosition: NativePatternPosition;
+}
+
+export interface NativePatternMatch {
+  /** Index of the matching pattern within the query. */
+  pattern: number;
+  captures: NativePatternCapture[];
+}
+
+export interface PatternCacheStats {
+  /** Compiled queries currently cached. */
+  entries: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+  /** Tree-sitter parsers created across all threads; each thread keeps one per language. */
+  parsers: number;
+  /** Parses run on those parsers. */
+  parses: number;
+}
+
+/**
+ * Matches a tree-sitter query against source natively. Compiled queries are
+ * cached by grammar and query text, and parsers and query cursors are reused
+ * per thread, so repeated searches only pay for the parse. #eq?, #not-eq?,
+ * #match? and #not-match? predicates are applied. Returns null when the file
+ * type is unsupported; throws when the query does not compile.
+ */
+export function findPatterns(
+  source: string | Buffer,
+  filePath: string,
+  query: string
+): NativePatternMatch[] | null {
+  return addon.findPatterns(source, filePath, query);
+}
+
+export function patternCacheStats(): PatternCacheStats {
+  return addon.patternCacheStats();
+}
@@ -0,0 +1,506 @@
+import { addon } from './addon.js';
+import type { Symbol, Reference, ClassBase } from './index.js';
+import type { FileSkeleton } from '../../types/ast.js';
+
+export type IdentifierUsageKind = 'declaration' | 'assignment' | 'read' | 'call';
+
+export interface IdentifierUsage {
+  filePath: string;
+  line: number;
+  /** Byte offset within the line. */
+  column: number;
+  kind: IdentifierUsageKind;
+  /** The identifier is the property of a member access (`obj.name`). */
+  isMember: boolean;
+  /** The identifier is passed directly as a call argument. */
+  isArgument: boolean;
+  /**
+   * The identifier is a property name node: an object key, method name, class
+   * field or the property of a member access, rather than a plain identifier.
+   */
+  isProperty: boolean;
+  /** The identifier is bound by an import statement. */
+  isImport: boolean;
+  /** With withLines: the line's text, from the bytes the file was indexed from. */
+  lineText?: string;
+  /** With withLines: the column in UTF-16 code units, as JS strings and the parsers count. */
+  lineColumn?: number;
+}
+
+export interface IndexedReference extends Reference {
+  /** With withLines: the line's text, from the bytes the file was indexed from. */
+  lineText?: string;
+  /** With withLines: the column in UTF-16 code units, as JS strings and the parsers count. */
+  lineColumn?: number;
+}
+
+export interface ProjectIndexStats {
+  indexedFiles: number;
+  failedFiles: number;
+  dirtyFiles: number;
+  lastWarmMs: number;
+  warm: boolean;
+  totalSymbols: number;
+  totalReferences: number;
+  memoryUsageBytes: number;
+  identifierNames: number;
+  identifierPostings: number;
+  postingBytes: number;
+  importResolutions: number;
+  cachedImportResolutions: number;
+  functionSummaries: number;
+  /** Summaries computed since the index was created; an edit recomputes only what it affects. */
+  summaryComputations: number;
+  /** Files whose resolved export surface is cached. */
+  exportSurfaces: number;
+  exportSurfaceComputations: number;
+  /** Files whose last tree is kept for incremental reparsing. */
+  retainedTrees: number;
+  /** Measured size of the retained trees and extractions, capped at 64 MiB. */
+  retainedBytes: number;
+  retainedEvictions: number;
+  incrementalParses: number;
+  /** Incremental parses that re-extracted only the statements around the edit. */
+  partialExtractions: number;
+  /** Parses dropped because a newer read of the same file started while they ran. */
+  supersededParses: number;
+  /** How the last warm() read files: 'io_uring' where the kernel allows it, else 'threads'. */
+  readBackend: ReadBackend;
+  /** Wall time of the last warm() from first read to last parse, reads overlapping parsing. */
+  lastReadMs: number;
+  lastReadBytes: number;
+  /** Whether the native watcher is running; see watch(). */
+  watching: boolean;
+  watchedDirectories: number;
+  watchEvents: number;
+  /** Coalesced batches delivered; each is one JS callback. */
+  watchBatches: number;
+  /** Times the kernel queue overflowed and the watched roots were rescanned. */
+  watchOverflows: number;
+  /** Dirty files waiting for the background reindexer; same as dirtyFiles. */
+  reindexQueueDepth: number;
+  /** Queued files a query moved to the front, such as the imports of a file it read. */
+  reindexPrioritized: number;
+  /** How long the longest-waiting dirty file has been queued. */
+  reindexLagMs: number;
+  /** From first change to reindexed, for the most recent file. */
+  lastReindexLagMs: number;
+  reindexed: number;
+  backgroundReindexed: number;
+  /** Changes to files that were already queued, folded into one reindex. */
+  coalescedChanges: number;
+  /**
+   * Lookups of the tiered analysis cache: files indexed with no retained tree.
+   * Each is a hit in one tier or a miss, which parses.
+   */
+  cacheLookups: number;
+  /** Decoded analyses held in memory. */
+  hotEntries: number;
+  hotBytes: number;
+  hotHits: number;
+  /** Share of cacheLookups served by the tier, 0 to 1. */
+  hotHitRate: number;
+  /** Compressed analyses held in memory. */
+  warmEntries: number;
+  warmBytes: number;
+  /** What the warm tier decompresses to. */
+  warmRawBytes: number;
+  warmHits: number;
+  warmHitRate: number;
+  /** Hits of the on-disk cache, the cold tier; same as diskCacheHits. */
+  coldHits: number;
+  coldHitRate: number;
+  cacheMisses: number;
+  /** Warm analyses used again and moved back to hot. */
+  cachePromotions: number;
+  /** Hot analyses compressed into warm to stay within hotBytes. */
+  cacheDemotions: number;
+  /** Warm analyses dropped to stay within warmBytes, left to the disk cache. */
+  cacheEvictions: number;
+  /** Files and symbols with access counts, kept with the disk cache for prefetch(). */
+  accessedFiles: number;
+  accessedSymbols: number;
+  /** Accesses recorded by this process. */
+  accessRecords: number;
+  accessLogSaves: number;
+  lastPrefetch: PrefetchResult;
+  /** Whether analyses are looked up in, and saved to, an on-disk cache; see setCacheDir(). */
+  diskCache: boolean;
+  /** Files restored from the disk cache instead of parsed. */
+  diskCacheHits: number;
+  diskCacheMisses: number;
+  diskCacheWrites: number;
+  /** Records found truncated, corrupt or for other bytes, and ignored. */
+  diskCacheRejected: number;
+  diskCacheBytes: number;
+  diskCacheCollections: number;
+  /** Collections skipped because another process was collecting. */
+  diskCacheDeferredCollections: number;
+}
+
+export interface PrefetchOptions {
+  /** Most accessed files to load; default 64. */
+  maxFiles?: number;
+  /** Most accessed symbols to summarize; their files fill any room left. Default 256. */
+  maxSymbols?: number;
+  /** Default 2000. */
+  timeMs?: number;
+  /** Bytes of trees to retain for the files; default 32 MiB. */
+  memoryBytes?: number;
+}
+
+export interface PrefetchResult {
+  files: number;
+  symbols: number;
+  bytes: number;
+  ms: number;
+  timedOut: boolean;
+  outOfMemory: boolean;
+}
+
+export interface CacheBudgets {
+  /** Decoded analyses in memory; default 32 MiB. */
+  hotBytes?: number;
+  /** Compressed analyses in memory; default 64 MiB. */
+  warmBytes?: number;
+}
+
+export interface ReindexOptions {
+  /** Quiet time after a file's last change before the background worker picks it up. */
+  debounceMs?: number;
+  /** Share of one core the background worker may use, 0 to 1; 0 leaves files for queries. */
+  cpuBudget?: number;
+}
+
+export type ReadBackend = 'io_uring' | 'threads' | 'sequential';
+
+/** Where a name a module exports is really defined, after following re-exports. */
+export interface ExportOrigin {
+  name: string;
+  /** Defining file; absent when the chain ends in an unresolved module such as a package. */
+  filePath?: string;
+  /** Name in the defining file; '*' for `export * as ns` of a whole module. */
+  localName: string;
+  module?: string;
+  /** Re-export hops from the queried file; 0 when defined there. */
+  depth: number;
+}
+
+/** One name of a module's public surface as written, before re-exports are followed. */
+export interface SurfaceItem {
+  name: string;
+  type: 'function' | 'class' | 'variable' | 'interface' | 'type' | 're-export' | 'unknown';
+  signature?: string;
+  /** Public members of classes and interfaces. */
+  members?: string[];
+  /** Module a re-export forwards. */
+  source?: string;
+  isDefault?: boolean;
+}
+
+/**
+ * Where a function's parameters can end up, composed over the call graph.
+ * Parameters are named; Python receivers are not counted.
+ */
+export interface FunctionSummary {
+  symbolId: string;
+  parameters: string[];
+  /** Parameters the return value may carry, directly or through callees' returns. */
+  returnedParameters: string[];
+  /** Parameters passed to direct calls, with the 0-based argument position. */
+  calleeFlows: { parameter: string; callee: string; argument: number; line: number }[];
+  /** Module-level names and `this.`/`self.` fields a parameter may be written to, here or in a callee. */
+  globalFlows: { parameter: string; global: string }[];
+  /** Functions in the same recursion cycle, including this one. */
+  sccSize: number;
+}
+
+export interface ParameterFlow {
+  /** The origin first, then every function parameter the value is passed to. */
+  reaches: { symbolId: string; parameter: string; depth: number }[];
+  globals: string[];
+  returned: boolean;
+}
+
+/**
+ * Project-wide symbol and call-site index kept in the addon. Files are parsed
+ * and extracted natively; call sites are linked to their targets by name as
+ * files arrive, so findCallers is a lookup rather than a re-parse.
+ */
+export class ProjectIndex {
+  private _addonInstance: any;
+
+  constructor() {
+    this._addonInstance = new addon.ProjectIndex();
+  }
+
+  /**
+   * Indexes every supported file under root on a worker thread, parsing files
+   * as their reads complete. Resolves with the number of files indexed.
+   * readBackend overrides the automatic choice, for benchmarks.
+   */
+  warm(root: string, readBackend?: ReadBackend): Promise<number> {
+    return this._addonInstance.warm(root, readBackend);
+  }
+
+  indexFile(filePath: string): boolean {
+    return this._addonInstance.indexFile(filePath);
+  }
+
+  /**
+   * Indexes source as filePath's contents. When the file's previous tree is
+   * still retained the parse is incremental and only the top-level statements
+   * that changed are re-extracted.
+   */
+  indexSource(filePath: string, source: string | Buffer): boolean {
+    return this._addonInstance.indexSource(filePath, source);
+  }
+
+  /**
+   * Replaces UTF-8 bytes [startByte, oldEndByte) of the file's retained source
+   * with text and reindexes incrementally. Returns false when no tree is
+   * retained for the file; call indexSource with the full contents instead.
+   */
+  applyEdit(filePath: string, startByte: number, oldEndByte: number, text: string): boolean {
+    return this._addonInstance.applyEdit(filePath, startByte, oldEndByte, text);
+  }
+
+  removeFile(filePath: string): void {
+    this._addonInstance.removeFile(filePath);
+  }
+
+  markFileDirty(filePath: string): void {
+    this._addonInstance.markFileDirty(filePath);
+  }
+
+  /**
+   * Watches root with a native recursive inotify watcher. Bursts of changes
+   * are coalesced and marked dirty in the index directly; onBatch then runs
+   * once per burst with its deduplicated files. Returns false where native
+   * watching is unavailable (non-Linux, inotify limits), leaving the caller to
+   * watch and call markFileDirty itself.
+   */
+  watch(root: string, onBatch?: (filePaths: string[]) => void): boolean {
+    return this._addonInstance.watch(root, onBatch);
+  }
+
+  unwatch(): void {
+    this._addonInstance.unwatch();
+  }
+
+  /** Re-reads dirty files, dropping ones that no longer exist. */
+  refreshDirtyFiles(): number {
+    return this._addonInstance.refreshDirtyFiles();
+  }
+
+  /**
+   * Re-reads whichever of filePaths are dirty, ahead of the background queue,
+   * and moves the dirty files they import to its front. Other dirty files are
+   * left to the background reindexer. Returns files re-read.
+   */
+  refreshFiles(filePaths: string[]): number {
+    return this._addonInstance.refreshFiles(filePaths);
+  }
+
+  /** Tunes the background reindexer; omitted fields take their defaults (100 ms, 0.25). */
+  setReindexOptions(options: ReindexOptions): void {
+    this._addonInstance.setReindexOptions(options);
+  }
+
+  /**
+   * Saves each file's analysis under dir, keyed by its contents and the grammar
+   * version, and reuses it for identical bytes after a restart or from another
+   * server process. The directory is trimmed to maxBytes (default 512 MiB);
+   * null turns the cache off. Returns false when dir cannot be created.
+   */
+  setCacheDir(dir: string | null, maxBytes?: number): boolean {
+    return this._addonInstance.setCacheDir(dir, maxBytes);
+  }
+
+  /** Sizes the in-memory tiers of the analysis cache; the disk tier is sized by setCacheDir(). */
+  setCacheBudgets(budgets: CacheBudgets): void {
+    this._addonInstance.setCacheBudgets(budgets);
+  }
+
+  /**
+   * Counts filePaths as read by a query, toward the working set prefetch()
+   * loads next session. Queries that take a file or symbol count it already.
+   */
+  recordFileAccess(filePaths: string[]): void {
+    this._addonInstance.recordFileAccess(filePaths);
+  }
+
+  /** Saves access counts now; they are also saved every 30 seconds while queries come in. */
+  flushAccessLog(): boolean {
+    return this._addonInstance.flushAccessLog();
+  }
+
+  /**
+   * Loads the files and symbols past sessions used most, as counted beside
+   * the disk cache, on a worker thread: their trees, analyses, export
+   * surfaces and function summaries. Call after warm().
+   */
+  prefetch(options?: PrefetchOptions): Promise<PrefetchResult> {
+    return this._addonInstance.prefetch(options ?? {});
+  }
+
+  isWarm(): boolean {
+    return this._addonInstance.isWarm();
+  }
+
+  /** True when filePath lies under a directory that has been warmed. */
+  covers(filePath: string): boolean {
+    return this._addonInstance.covers(filePath);
+  }
+
+  hasFile(filePath: string): boolean {
+    return this._addonInstance.hasFile(filePath);
+  }
+
+  getSymbol(symbolId: string): Symbol | null {
+    return this._addonInstance.getSymbol(symbolId);
+  }
+
+  findSymbolsByName(name: string): Symbol[] {
+    return this._addonInstance.findSymbolsByName(name);
+  }
+
+  findSymbolsByFile(filePath: string): Symbol[] {
+    return this._addonInstance.findSymbolsByFile(filePath);
+  }
+
+  /**
+   * withLines adds lineText and lineColumn to each call site, as findUsages
+   * does: left out for files changed on disk since they were indexed.
+   */
+  findCallers(symbolId: string, withLines = false): IndexedReference[] {
+    return this._addonInstance.findCallers(symbolId, withLines);
+  }
+
+  findCallees(symbolId: string): Reference[] {
+    return this._addonInstance.findCallees(symbolId);
+  }
+
+  getBaseClasses(classId: string): ClassBase[] {
+    return this._addonInstance.getBaseClasses(classId);
+  }
+
+  /** Ids of the classes that extend or implement classId directly. */
+  getSubclasses(classId: string): string[] {
+    return this._addonInstance.getSubclasses(classId);
+  }
+
+  /** The method a call on className runs, inherited or own; empty when none. */
+  resolveMethod(className: string, methodName: string): string[] {
+    return this._addonInstance.resolveMethod(className, methodName);
+  }
+
+  /** Identifier names the file uses outside declarations, from the usage table. */
+  getFileUsages(filePath: string): string[] {
+    return this._addonInstance.getFileUsages(filePath);
+  }
+
+  /**
+   * For each name, the number of indexed files that use it. Counting is limited
+   * to filePaths when given, otherwise it covers the whole index.
+   */
+  countUsages(names: string[], filePaths?: string[]): number[] {
+    return this._addonInstance.countUsages(names, filePaths);
+  }
+
+  /**
+   * Every occurrence of an identifier from the inverted index, limited to
+   * files under pathPrefix when given. Only the postings for name are decoded.
+   * withLines adds lineText and lineColumn, left out for files changed on disk
+   * since they were indexed (unless their tree is retained).
+   */
+  findUsages(name: string, pathPrefix?: string, withLines = false): IdentifierUsage[] {
+    return this._addonInstance.findUsages(name, pathPrefix, withLines);
+  }
+
+  /**
+   * Files that may mention any of names, judged by each file's identifier Bloom
+   * filter. False positives are possible, false negatives are not. When
+   * filePaths is given only those are checked, and paths the index has not
+   * seen, or that changed on disk since it read them, are always returned.
+   */
+  findCandidateFiles(names: string[], filePaths?: string[]): string[] {
+    return this._addonInstance.findCandidateFiles(names, filePaths);
+  }
+
+  /**
+   * Distinct class names that the given files reference from configuration
+   * (call sites from the synthetic `config` root). Files that are not indexed contribute nothing.
+   */
+  getConfigReferences(filePaths: string[]): string[] {
+    return this._addonInstance.getConfigReferences(filePaths);
+  }
+
+  /**
+   * Absolute path of the file an import specifier in fromFile refers to, or
+   * null for external packages and missing files. Handles tsconfig paths and
+   * baseUrl, extension and index probing, and Python module layouts. Works
+   * whether or not fromFile is indexed; under a watched root, stat results are
+   * cached until the watcher reports the path as changed.
+   */
+  resolveImport(fromFile: string, source: string): string | null {
+    return this._addonInstance.resolveImport(fromFile, source);
+  }
+
+  /**
+   * Interprocedural summary of a function, method or function-valued
+   * variable, or null when it is not indexed. Summaries are computed
+   * bottom-up over the call graph's strongly connected components and kept
+   * until a file change affects them.
+   */
+  getFunctionSummary(symbolId: string): FunctionSummary | null {
+    return this._addonInstance.getFunctionSummary(symbolId);
+  }
+
+  /**
+   * Follows a parameter (0-based) through every call it is passed to by
+   * composing summaries, without re-reading any function body.
+   */
+  traceParameterFlow(symbolId: string, parameter: number): ParameterFlow | null {
+    return this._addonInstance.traceParameterFlow(symbolId, parameter);
+  }
+
+  /**
+   * traceParameterFlow for every parameter called name of a function declared
+   * in filePaths. Not recorded as an access to those functions.
+   */
+  traceParametersNamed(name: string, filePaths: string[]): ParameterFlow[] {
+    return this._addonInstance.traceParametersNamed(name, filePaths);
+  }
+
+  /** Every name filePath exports, barrel chains followed to the defining file. */
+  getExports(filePath: string): ExportOrigin[] {
+    return this._addonInstance.getExports(filePath);
+  }
+
+  resolveExport(filePath: string, name: string): ExportOrigin | null {
+    return this._addonInstance.resolveExport(filePath, name);
+  }
+
+  /**
+   * The outline get_skeleton reports, computed when filePath was last indexed.
+   * Null when it is not indexed.
+   */
+  getSkeleton(filePath: string): FileSkeleton | null {
+    return this._addonInstance.getSkeleton(filePath);
+  }
+
+  /** Skeletons of every indexed file under dir, sorted by path. */
+  getSkeletons(dir: string): FileSkeleton[] {
+    return this._addonInstance.getSkeletons(dir);
+  }
+
+  /** What filePath exports as written; null when it is not indexed. */
+  getPublicSurface(filePath: string): SurfaceItem[] | null {
+    return this._addonInstance.getPublicSurface(filePath);
+  }
+
+  getStats(): ProjectIndexStats {
+    return this._addonInstance.getStats();
+  }
+}
@@ -0,0 +1,774 @@
+#include "project_index.h"
+#include "config_scanner.h"
+#include <chrono>
+#include <filesystem>
+#include <unordered_set>
+#include "extractor.h"
+#include "symbol_classifier.h"
+#include "syntax_tree.h"
+#include "usage_scanner.h"
+
+namespace fs = std::filesystem;
+
+namespace prism {
+
+namespace {
+
+bool isUnder(const std::string& path, const std::string& root) {
+  if (path.compare(0, root.size(), root) != 0) return false;
+  return path.size() == root.size() || root.back() == '/' || path[root.size()] == '/';
+}
+
+// Class names a config file refers to become call sites from the config root,
+// so they link to (and keep alive) the classes like any other caller.
+std::vector<Reference> configCallSites(const SyntaxTree& tree, const std::string& filePath) {
+  std::vector<Reference> sites;
+  ConfigFormat format = configFormatForPath(filePath);
+  if (format == ConfigFormat::None) return sites;
+  auto refs = scanConfigReferencesCached(tree.source()->view(), format);
+  for (const auto& configRef : *refs) {
+    Reference site;
+    site.name = configRef.name;
+    site.fromSymbolId = kConfigRootId;
+    site.type = "indirect";
+    site.filePath = filePath;
+    site.line = static_cast<int>(configRef.line);
+    site.column = static_cast<int>(configRef.column);
+    site.id = filePath + ":" + std::to_string(site.line) + ":" + std::to_string(site.column) +
+              ":" + kConfigRootId + ":" + site.name;
+    sites.push_back(std::move(site));
+  }
+  return sites;
+}
+
+// The content hash each position's file was indexed with. Called under the
+// index's mutex, alongside the lookup that produced positions.
+template <typename Position>
+std::unordered_map<std::string, uint64_t> contentHashes(const ReferenceGraph& graph,
+                                                        const std::vector<Position>& positions) {
+  std::unordered_map<std::string, uint64_t> hashes;
+  for (const auto& position : positions) {
+    if (!hashes.count(position.filePath)) {
+      hashes[position.filePath] = graph.getContentHash(position.filePath);
+    }
+  }
+  return hashes;
+}
+
+// Each position's line from the bytes its file was indexed from: the retained
+// tree's source, or the file itself while it still hashes the same. Parallel
+// to positions, whose columns are UTF-8 byte offsets.
+template <typename Position>
+std::vector<PostingLine> indexedLines(TreeCache& retained, const std::vector<Position>& positions,
+                                      std::unordered_map<std::string, uint64_t>& hashes) {
+  struct IndexedSource {
+    SourceBufferPtr source;
+    std::vector<uint32_t> lineStarts;
+  };
+  std::unordered_map<std::string, IndexedSource> sources;
+  std::vector<PostingLine> lines(positions.size());
+  for (size_t i = 0; i < positions.size(); i++) {
+    const Position& position = positions[i];
+    auto it = sources.find(position.filePath);
+    if (it == sources.end()) {
+      IndexedSource indexed;
+      uint64_t hash = hashes[position.filePath];
+      TreeCacheEntry entry;
+      if (retained.get(position.filePath, entry) && entry.tree->source()->contentHash() == hash) {
+        indexed.source = entry.tree->source();
+      } else {
+        indexed.source = loadSource(position.filePath);
+        if (indexed.source && indexed.source->contentHash() != hash) indexed.source = nullptr;
+      }
+      if (indexed.source) {
+        std::string_view bytes = indexed.source->view();
+        indexed.lineStarts.push_back(0);
+        for (size_t at = bytes.find('\n'); at != std::string_view::npos;
+             at = bytes.find('\n', at + 1)) {
+          indexed.lineStarts.push_back(static_cast<uint32_t>(at + 1));
+        }
+      }
+      it = sources.emplace(position.filePath, std::move(indexed)).first;
+    }
+
+    const IndexedSource& indexed = it->second;
+    // Posting positions are unsigned, Reference ones int
+    int64_t line = position.line;
+    int64_t column = position.column;
+    if (!indexed.source || line <= 0 || column < 0 ||
+        static_cast<size_t>(line) > indexed.lineStarts.size()) {
+      continue;
+    }
+    std::string_view bytes = indexed.source->view();
+    size_t start = indexed.lineStarts[line - 1];
+    size_t end = static_cast<size_t>(line) < indexed.lineStarts.size()
+                     ? indexed.lineStarts[line] - 1
+                     : bytes.size();
+    std::string_view text = bytes.substr(start, end - start);
+    if (static_cast<size_t>(column) > text.size()) continue;
+    lines[i].found = true;
+    lines[i].text = std::string(text);
+    lines[i].utf16Column = utf16Length(text.substr(0, column));
+  }
+  return lines;
+}
+
+}  // namespace
+
+bool isSkippedDirectory(const std::string& name) {
+  return name == "node_modules" || name == "build" || name == "dist" ||
+         (!name.empty() && name[0] == '.');
+}
+
+std::vector<std::string> findSourceFiles(const std::string& root) {
+  std::vector<std::string> files;
+  std::error_code ec;
+  fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+  for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+    const fs::directory_entry& entry = *it;
+    std::string name = entry.path().filename().string();
+    if (entry.is_directory(ec)) {
+      if (isSkippedDirectory(name)) it.disable_recursion_pending();
+      continue;
+    }
+    if (entry.is_regular_file(ec) && languageForPath(name) != LanguageId::Unknown) {
+      files.push_back(entry.path().string());
+    }
+  }
+  return files;
+}
+
+ProjectIndex::ProjectIndex()
+    : reindex_([this](const std::string& filePath) { refreshFile(filePath); }) {}
+
+size_t ProjectIndex::indexDirectory(const std::string& root, ReadBackend readBackend) {
+  auto start = std::chrono::steady_clock::now();
+  std::string absoluteRoot = fs::absolute(root).lexically_normal().string();
+  if (absoluteRoot.size() > 1 && absoluteRoot.back() == '/') absoluteRoot.pop_back();
+
+  std::vector<std::string> files = findSourceFiles(absoluteRoot);
+  std::vector<uint64_t> generations;
+  generations.reserve(files.size());
+  for (const auto& filePath : files) generations.push_back(beginIndexing(filePath));
+  size_t indexed = 0;
+  BulkReadStats reads = readFiles(files, [&](size_t i, SourceBufferPtr source) {
+    if (!source) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      failedFiles_++;
+    } else if (indexSource(files[i], std::move(source), generations[i])) {
+      indexed++;
+    }
+  }, readBackend);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  lastRead_ = reads;
+  if (std::find(roots_.begin(), roots_.end(), absoluteRoot) == roots_.end()) {
+    roots_.push_back(absoluteRoot);
+  }
+  lastWarmMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  warm_.store(true);
+  return indexed;
+}
+
+bool ProjectIndex::indexFile(const std::string& filePath) {
+  uint64_t generation = beginIndexing(filePath);
+  SourceBufferPtr source = loadSource(filePath);
+  if (!source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failedFiles_++;
+    return false;
+  }
+  return indexSource(filePath, std::move(source), generation);
+}
+
+bool ProjectIndex::indexSource(const std::string& filePath, SourceBufferPtr source) {
+  return indexSource(filePath, std::move(source), beginIndexing(filePath));
+}
+
+bool ProjectIndex::indexSource(const std::string& filePath, SourceBufferPtr source,
+                               uint64_t generation) {
+  TreeCacheEntry previous;
+  retained_.get(filePath, previous);
+  return indexTree(filePath, generation, std::move(source), std::move(previous.tree),
+                   std::move(previous.extraction), nullptr);
+}
+
+uint64_t ProjectIndex::beginIndexing(const std::string& filePath) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t generation = ++nextGeneration_;
+  generations_[filePath] = generation;
+  return generation;
+}
+
+bool ProjectIndex::applyEdit(const std::string& filePath, uint32_t startByte, uint32_t oldEndByte,
+                             const std::string& text) {
+  TreeCacheEntry previous;
+  if (!retained_.get(filePath, previous)) return false;
+  SyntaxTreePtr previousTree = std::move(previous.tree);
+  std::shared_ptr<const ExtractionResult> previousExtraction = std::move(previous.extraction);
+
+  std::string_view before = previousTree->source()->view();
+  if (startByte > oldEndByte || oldEndByte > before.size()) return false;
+  uint64_t generation = beginIndexing(filePath);
+  TSInputEdit edit = replacementEdit(before, startByte, oldEndByte, text);
+  std::string bytes;
+  bytes.reserve(before.size() - (oldEndByte - startByte) + text.size());
+  bytes.append(before.substr(0, startByte)).append(text).append(before.substr(oldEndByte));
+  return indexTree(filePath, generation, SourceBuffer::fromString(std::move(bytes)),
+                   std::move(previousTree), std::move(previousExtraction), &edit);
+}
+
+bool ProjectIndex::indexTree(const std::string& filePath, uint64_t generation,
+                             SourceBufferPtr source, SyntaxTreePtr previousTree,
+                             std::shared_ptr<const ExtractionResult> previousExtraction,
+                             const TSInputEdit* edit) {
+  LanguageId language = languageForPath(filePath);
+  SyntaxTreePtr tree;
+  std::shared_ptr<const ExtractionResult> extraction;
+  bool incremental = false;
+  bool partial = false;
+
+  if (previousTree && previousTree->language() == language) {
+    const SourceBufferPtr& before = previousTree->source();
+    if (before->contentHash() == source->contentHash() && before->view() == source->view()) {
+      tree = previousTree;
+      extraction = previousExtraction;
+    } else {
+      TSInputEdit diff = edit ? *edit : diffSourceEdit(before->view(), source->view());
+      std::vector<TSRange> changedRanges;
+      tree = SyntaxTree::reparse(*previousTree, source, diff, &changedRanges);
+      if (tree) {
+        incremental = true;
+        extraction = std::make_shared<const ExtractionResult>(
+            reextractFile(*previousTree, *previousExtraction, *tree, diff, changedRanges, filePath,
+                          &partial));
+      }
+    }
+  }
+  // Without a tree to reuse, a file whose bytes were analysed before, by this
+  // process or another, is restored from the analysis cache instead of parsed.
+  std::shared_ptr<const FileAnalysis> cached;
+  if (!tree) {
+    cached = analyses_.get(filePath, language, *source);
+    if (cached) {
+      extraction = cached->extraction;
+    } else {
+      tree = SyntaxTree::parse(language, source);
+      if (!tree) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failedFiles_++;
+        return false;
+      }
+      extraction = std::make_shared<const ExtractionResult>(extractFile(*tree, filePath));
+    }
+  }
+
+  FileData file;
+  file.path = filePath;
+  file.symbols = extraction->symbols;
+  classifySymbols(file.symbols);
+  FileAnalysis parsed;
+  if (tree) {
+    parsed.extraction = extraction;
+    parsed.configCallSites = configCallSites(*tree, filePath);
+    parsed.functionFacts = collectFunctionFacts(*tree, file.symbols);
+    parsed.usedNames = scanIdentifierUsages(*tree);
+    parsed.occurrences = scanOccurrences(*tree);
+    parsed.skeleton = std::make_shared<const FileSkeleton>(extractSkeleton(*tree));
+    analyses_.put(filePath, language, *source, parsed);
+  }
+  const FileAnalysis& analysis = tree ? parsed : *cached;
+  std::vector<LocalFunctionFacts> functionFacts =
+      tree ? std::move(parsed.functionFacts) : cached->functionFacts;
+  file.imports = extraction->imports;
+  for (auto& entry : file.imports) {
+    entry.resolvedPath = resolver_.resolve(filePath, entry.source);
+  }
+  file.callSites = extraction->callSites;
+  file.callSites.insert(file.callSites.end(), analysis.configCallSites.begin(),
+                        analysis.configCallSites.end());
+  file.bases = extraction->bases;
+  file.skeleton = analysis.skeleton;
+  file.contentHash = source->contentHash();
+  file.stamp = registeredStamp(filePath, source);
+  std::vector<ExportEntry> exports = extraction->exports;
+  for (auto& entry : exports) {
+    if (!entry.source.empty()) entry.resolvedPath = resolver_.resolve(filePath, entry.source);
+  }
+
+  std::unordered_set<std::string_view> distinctNames;
+  for (const auto& occurrence : analysis.occurrences) distinctNames.insert(occurrence.name);
+  file.identifierFilter.build(std::vector<std::string_view>(distinctNames.begin(), distinctNames.end()));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto current = generations_.find(filePath);
+  if (current == generations_.end() || current->second != generation) {
+    // A newer pass, or removeFile, started while this one parsed.
+    supersededParses_++;
+    return true;
+  }
+  graph_.updateFile(filePath, file);
+  graph_.setFileUsages(filePath, analysis.usedNames);
+  identifiers_.updateFile(filePath, analysis.occurrences);
+  summaries_.updateFile(filePath, std::move(functionFacts));
+  exports_.updateFile(filePath, std::move(exports));
+  if (tree) {
+    retained_.put(filePath, {std::move(tree), std::move(extraction)});
+  } else {
+    retained_.erase(filePath);
+  }
+  if (incremental) incrementalParses_++;
+  if (partial) partialExtractions_++;
+  return true;
+}
+
+void ProjectIndex::removeFile(const std::string& filePath) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generations_.erase(filePath);
+  graph_.removeFile(filePath);
+  identifiers_.removeFile(filePath);
+  summaries_.removeFile(filePath);
+  exports_.removeFile(filePath);
+  retained_.erase(filePath);
+  analyses_.erase(filePath);
+}
+
+void ProjectIndex::markFileDirty(const std::string& filePath) {
+  resolver_.invalidate(filePath);
+  reindex_.enqueue({filePath});
+}
+
+void ProjectIndex::markFilesDirty(const std::vector<std::string>& filePaths) {
+  for (const auto& filePath : filePaths) resolver_.invalidate(filePath);
+  reindex_.enqueue(filePaths);
+}
+
+bool ProjectIndex::watch(const std::string& root, WatchListener listener) {
+  std::string absoluteRoot = fs::absolute(root).lexically_normal().string();
+  if (absoluteRoot.size() > 1 && absoluteRoot.back() == '/') absoluteRoot.pop_back();
+
+  std::lock_guard<std::mutex> lock(watchMutex_);
+  watchListener_ = std::move(listener);
+  if (!watcher_) {
+    FileWatcherOptions options;
+    options.skipDirectory = isSkippedDirectory;
+    options.acceptFile = [](const std::string& path) {
+      return languageForPath(path) != LanguageId::Unknown;
+    };
+    watcher_ = std::make_unique<FileWatcher>(
+        std::move(options), [this](const WatchBatch& batch) { applyWatchBatch(batch); });
+  }
+  return watcher_->addRoot(absoluteRoot);
+}
+
+void ProjectIndex::unwatch() {
+  std::unique_ptr<FileWatcher> watcher;
+  {
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    watcher = std::move(watcher_);
+    watchListener_ = nullptr;
+  }
+  // Joins the watcher thread, which may be waiting on watchMutex_.
+  watcher.reset();
+}
+
+void ProjectIndex::applyWatchBatch(const WatchBatch& batch) {
+  std::vector<std::string> changed = batch.files;
+  if (!batch.directories.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& file : graph_.getFilePaths()) {
+      for (const auto& directory : batch.directories) {
+        if (isUnder(file, directory)) {
+          changed.push_back(file);
+          break;
+        }
+      }
+    }
+  }
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+  for (const auto& directory : batch.directories) resolver_.invalidate(directory);
+  markFilesDirty(changed);
+
+  WatchListener listener;
+  {
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    listener = watchListener_;
+  }
+  if (listener && !changed.empty()) listener(changed);
+}
+
+void ProjectIndex::refreshFile(const std::string& filePath) {
+  std::error_code ec;
+  if (fs::is_regular_file(filePath, ec) && languageForPath(filePath) != LanguageId::Unknown) {
+    indexFile(filePath);
+  } else {
+    removeFile(filePath);
+  }
+}
+
+size_t ProjectIndex::refreshDirtyFiles() {
+  return reindex_.flushAll();
+}
+
+size_t ProjectIndex::refreshFiles(const std::vector<std::string>& filePaths) {
+  size_t refreshed = reindex_.flush(filePaths);
+  // Imports are read after the files themselves are current.
+  std::vector<std::string> imported;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& filePath : filePaths) {
+      std::vector<std::string> targets = graph_.getImportedFiles(filePath);
+      imported.insert(imported.end(), targets.begin(), targets.end());
+    }
+  }
+  reindex_.prioritize(imported);
+  return refreshed;
+}
+
+void ProjectIndex::setReindexOptions(const ReindexSchedulerOptions& options) {
+  reindex_.setOptions(options);
+}
+
+void ProjectIndex::setDiskCache(DiskParseCachePtr cache) {
+  access_.attach(cache ? cache->directory() + "/access.tsv" : std::string());
+  analyses_.setCold(std::move(cache));
+}
+
+void ProjectIndex::setAnalysisCacheOptions(const AnalysisCacheOptions& options) {
+  analyses_.setOptions(options);
+}
+
+void ProjectIndex::recordFileAccess(const std::vector<std::string>& filePaths) {
+  access_.recordFiles(filePaths);
+}
+
+bool ProjectIndex::flushAccessLog() {
+  return access_.flush();
+}
+
+PrefetchStats ProjectIndex::prefetch(const PrefetchOptions& options) {
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::milliseconds(options.timeMs);
+  PrefetchStats result;
+  std::vector<std::string> symbols = access_.topSymbols(options.maxSymbols);
+  std::vector<std::string> files = access_.topFiles(options.maxFiles);
+
+  // The files of the hottest symbols fill whatever room is left.
+  std::unordered_set<std::string> queued(files.begin(), files.end());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& symbolId : symbols) {
+      if (files.size() >= options.maxFiles) break;
+      std::string filePath = graph_.getSymbol(symbolId).filePath;
+      if (!filePath.empty() && queued.insert(filePath).second) files.push_back(filePath);
+    }
+  }
+
+  for (const auto& filePath : files) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      result.timedOut = true;
+      break;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!graph_.hasFile(filePath)) continue;
+    }
+    TreeCacheEntry entry;
+    if (retained_.get(filePath, entry)) continue;
+    SourceBufferPtr source = loadSource(filePath);
+    if (!source) continue;
+    LanguageId language = languageForPath(filePath);
+    // Through the process-wide parse cache, so tools that parse the file get
+    // this tree too.
+    entry.tree = parseCached(language, source);
+    if (!entry.tree) continue;
+    std::shared_ptr<const FileAnalysis> cached = analyses_.get(filePath, language, *source);
+    entry.extraction = cached ? cached->extraction
+                              : std::make_shared<const ExtractionResult>(
+                                    extractFile(*entry.tree, filePath));
+    size_t bytes = treeCacheEntryBytes(entry);
+    if (result.bytes + bytes > options.memoryBytes) {
+      result.outOfMemory = true;
+      break;
+    }
+    retained_.put(filePath, std::move(entry));
+    result.bytes += bytes;
+    result.files++;
+    std::lock_guard<std::mutex> lock(mutex_);
+    exports_.surface(filePath);
+  }
+
+  for (const auto& symbolId : symbols) {
+    if (result.timedOut || result.outOfMemory) break;
+    if (std::chrono::steady_clock::now() >= deadline) {
+      result.timedOut = true;
+      break;
+    }
+    FunctionSummary summary;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (summaries_.summary(symbolId, summary)) result.symbols++;
+  }
+
+  result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                  .count();
+  std::lock_guard<std::mutex> lock(mutex_);
+  lastPrefetch_ = result;
+  return result;
+}
+
+std::vector<std::string> ProjectIndex::roots() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return roots_;
+}
+
+bool ProjectIndex::covers(const std::string& filePath) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& root : roots_) {
+    if (isUnder(filePath, root)) return true;
+  }
+  return false;
+}
+
+bool ProjectIndex::hasFile(const std::string& filePath) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.hasFile(filePath);
+}
+
+Symbol ProjectIndex::getSymbol(const std::string& symbolId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getSymbol(symbolId);
+}
+
+std::vector<Symbol> ProjectIndex::findSymbolsByName(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.findSymbolsByName(name);
+}
+
+std::vector<Symbol> ProjectIndex::findSymbolsByFile(const std::string& filePath) const {
+  access_.recordFile(filePath);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.findSymbolsByFile(filePath);
+}
+
+std::shared_ptr<const FileSkeleton> ProjectIndex::skeleton(const std::string& filePath) const {
+  access_.recordFile(filePath);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getSkeleton(filePath);
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<const FileSkeleton>>> ProjectIndex::skeletons(
+    const std::string& directory) const {
+  std::string root = fs::absolute(directory).lexically_normal().string();
+  if (root.size() > 1 && root.back() == '/') root.pop_back();
+  std::vector<std::pair<std::string, std::shared_ptr<const FileSkeleton>>> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& filePath : graph_.getFilePaths()) {
+    if (!isUnder(filePath, root)) continue;
+    auto skeleton = graph_.getSkeleton(filePath);
+    if (skeleton) result.emplace_back(std::move(filePath), std::move(skeleton));
+  }
+  std::sort(result.begin(), result.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  return result;
+}
+
+std::vector<Reference> ProjectIndex::findCallers(const std::string& symbolId) const {
+  access_.recordSymbol(symbolId);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.findCallers(symbolId);
+}
+
+std::vector<Reference> ProjectIndex::findCallers(const std::string& symbolId,
+                                                 std::vector<PostingLine>& lines) {
+  access_.recordSymbol(symbolId);
+  std::vector<Reference> callers;
+  std::unordered_map<std::string, uint64_t> hashes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callers = graph_.findCallers(symbolId);
+    hashes = contentHashes(graph_, callers);
+  }
+  lines = indexedLines(retained_, callers, hashes);
+  return callers;
+}
+
+std::vector<Reference> ProjectIndex::findCallees(const std::string& symbolId) const {
+  access_.recordSymbol(symbolId);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.findCallees(symbolId);
+}
+
+std::vector<ClassBase> ProjectIndex::getBaseClasses(const std::string& classId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getBaseClasses(classId);
+}
+
+std::vector<std::string> ProjectIndex::getSubclasses(const std::string& classId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getSubclasses(classId);
+}
+
+std::vector<std::string> ProjectIndex::resolveMethod(const std::string& className,
+                                                     const std::string& methodName) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.resolveMethod(className, methodName);
+}
+
+std::vector<std::string> ProjectIndex::getFileUsages(const std::string& filePath) const {
+  access_.recordFile(filePath);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getFileUsages(filePath);
+}
+
+std::vector<uint32_t> ProjectIndex::countNameUsages(const std::vector<std::string>& names,
+                                                    const std::vector<std::string>& filePaths) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.countNameUsages(names, filePaths);
+}
+
+std::vector<std::string> ProjectIndex::findCandidateFiles(
+    const std::vector<std::string>& names, const std::vector<std::string>& filePaths) const {
+  if (filePaths.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return graph_.findCandidateFiles(names, filePaths);
+  }
+
+  // A file changed on disk since it was indexed, and not yet re-read, may
+  // mention names its filter has never seen, so it is kept without consulting
+  // it. Sources handed in from memory have no stamp and their filter stands.
+  std::vector<FileStamp> stamps;
+  stamps.reserve(filePaths.size());
+  for (const auto& filePath : filePaths) stamps.push_back(statStamp(filePath));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<bool> changed(filePaths.size(), false);
+  std::vector<std::string> unchanged;
+  for (size_t i = 0; i < filePaths.size(); i++) {
+    if (!graph_.hasFile(filePaths[i])) continue;
+    FileStamp indexed = graph_.getFileStamp(filePaths[i]);
+    changed[i] = indexed != FileStamp() && indexed != stamps[i];
+    if (!changed[i]) unchanged.push_back(filePaths[i]);
+  }
+  std::vector<std::string> matched = graph_.findCandidateFiles(names, unchanged);
+  std::unordered_set<std::string> candidates(matched.begin(), matched.end());
+
+  std::vector<std::string> result;
+  for (size_t i = 0; i < filePaths.size(); i++) {
+    if (changed[i] || !graph_.hasFile(filePaths[i]) || candidates.count(filePaths[i])) {
+      result.push_back(filePaths[i]);
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> ProjectIndex::getConfigReferences(
+    const std::vector<std::string>& filePaths) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getConfigReferences(filePaths);
+}
+
+std::string ProjectIndex::resolveImport(const std::string& fromFile, const std::string& source) {
+  if (covers(fromFile)) return resolver_.resolve(fromFile, source);
+  // No watcher invalidates stat results outside the roots, so do not keep any
+  ImportResolver uncached;
+  return uncached.resolve(fromFile, source);
+}
+
+std::vector<Posting> ProjectIndex::findUsages(const std::string& name,
+                                              const std::string& pathPrefix) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return identifiers_.lookup(name, pathPrefix);
+}
+
+std::vector<Posting> ProjectIndex::findUsages(const std::string& name,
+                                              const std::string& pathPrefix,
+                                              std::vector<PostingLine>& lines) {
+  std::vector<Posting> postings;
+  std::unordered_map<std::string, uint64_t> hashes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    postings = identifiers_.lookup(name, pathPrefix);
+    hashes = contentHashes(graph_, postings);
+  }
+  lines = indexedLines(retained_, postings, hashes);
+  return postings;
+}
+
+bool ProjectIndex::functionSummary(const std::string& symbolId, FunctionSummary& out) {
+  access_.recordSymbol(symbolId);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return summaries_.summary(symbolId, out);
+}
+
+bool ProjectIndex::traceParameterFlow(const std::string& symbolId, uint32_t parameter,
+                                      ParameterFlow& flow) {
+  access_.recordSymbol(symbolId);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return summaries_.traceParameter(symbolId, parameter, flow);
+}
+
+std::vector<ParameterFlow> ProjectIndex::traceParametersNamed(
+    const std::string& name, const std::vector<std::string>& filePaths) {
+  std::vector<ParameterFlow> flows;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& filePath : filePaths) {
+    for (const auto& [symbolId, parameter] : summaries_.parametersNamed(filePath, name)) {
+      ParameterFlow flow;
+      if (summaries_.traceParameter(symbolId, parameter, flow)) flows.push_back(std::move(flow));
+    }
+  }
+  return flows;
+}
+
+std::vector<ExportOrigin> ProjectIndex::exportSurface(const std::string& filePath) {
+  access_.recordFile(filePath);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return exports_.surface(filePath);
+}
+
+bool ProjectIndex::resolveExport(const std::string& filePath, const std::string& name,
+                                 ExportOrigin& out) {
+  access_.recordFile(filePath);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return exports_.resolve(filePath, name, out);
+}
+
+GraphStats ProjectIndex::graphStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_.getStats();
+}
+
+ProjectIndexStats ProjectIndex::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ProjectIndexStats stats;
+  stats.indexedFiles = graph_.getStats().totalFiles;
+  stats.failedFiles = failedFiles_;
+  stats.reindex = reindex_.stats();
+  stats.dirtyFiles = stats.reindex.queueDepth;
+  stats.lastWarmMs = lastWarmMs_;
+  stats.warm = warm_.load();
+  stats.identifiers = identifiers_.stats();
+  stats.imports = resolver_.stats();
+  stats.summaries = summaries_.stats();
+  stats.exports = exports_.stats();
+  stats.retained = retained_.stats();
+  stats.incrementalParses = incrementalParses_;
+  stats.partialExtractions = partialExtractions_;
+  stats.supersededParses = supersededParses_;
+  stats.lastRead = lastRead_;
+  stats.analyses = analyses_.stats();
+  stats.access = access_.stats();
+  stats.lastPrefetch = lastPrefetch_;
+  DiskParseCachePtr diskCache = analyses_.cold();
+  stats.diskCache = diskCache != nullptr;
+  if (diskCache) stats.disk = diskCache->stats();
+  {
+    std::lock_guard<std::mutex> watchLock(watchMutex_);
+    stats.watching = watcher_ != nullptr;
+    if (watcher_) stats.watcher = watcher_->stats();
+  }
+  return stats;
+}
+
+}  // namespace prism
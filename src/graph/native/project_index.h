@@ -0,0 +1,248 @@
+#ifndef PROJECT_INDEX_H
+#define PROJECT_INDEX_H
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bulk_reader.h"
+#include "access_log.h"
+#include "analysis_cache.h"
+#include "disk_cache.h"
+#include "export_table.h"
+#include "extractor.h"
+#include "file_watcher.h"
+#include "function_summary.h"
+#include "graph.h"
+#include "identifier_index.h"
+#include "import_resolver.h"
+#include "reindex_scheduler.h"
+#include "skeleton.h"
+#include "tree_cache.h"
+
+namespace prism {
+
+struct PrefetchOptions {
+  size_t maxFiles = 64;
+  size_t maxSymbols = 256;
+  uint32_t timeMs = 2000;
+  size_t memoryBytes = 32u << 20;  // Trees retained for the files
+};
+
+struct PrefetchStats {
+  size_t files = 0;
+  size_t symbols = 0;
+  size_t bytes = 0;
+  double ms = 0;
+  bool timedOut = false;
+  bool outOfMemory = false;
+};
+
+// A posting's line as it read when its file was indexed.
+struct PostingLine {
+  bool found = false;        // False once those bytes are no longer available
+  std::string text;          // Without the line break
+  uint32_t utf16Column = 0;  // The posting's column in UTF-16 code units
+};
+
+struct ProjectIndexStats {
+  size_t indexedFiles = 0;
+  size_t failedFiles = 0;
+  size_t dirtyFiles = 0;
+  double lastWarmMs = 0;
+  bool warm = false;
+  IdentifierIndexStats identifiers;
+  ImportResolverStats imports;
+  FunctionSummaryStats summaries;
+  ExportTableStats exports;
+  TreeCacheStats retained;        // Trees kept for incremental reparsing
+  size_t incrementalParses = 0;   // Reparses that reused the file's previous tree
+  size_t partialExtractions = 0;  // Of those, re-extracted only around the edit
+  size_t supersededParses = 0;    // Dropped because a newer read of the file started
+  BulkReadStats lastRead;         // File reads of the last indexDirectory
+  bool watching = false;
+  FileWatcherStats watcher;
+  ReindexSchedulerStats reindex;
+  AnalysisCacheStats analyses;  // Hot and warm tiers, and cold tier hits
+  AccessLogStats access;
+  PrefetchStats lastPrefetch;
+  bool diskCache = false;
+  DiskCacheStats disk;
+};
+
+// Long-lived project index: parses and extracts files natively and keeps the
+// ReferenceGraph current as files change. All public methods are thread-safe;
+// parsing happens outside the lock so warm-up can run on a worker thread.
+class ProjectIndex {
+ public:
+  ProjectIndex();
+
+  // Walks root and indexes every supported source file, parsing each as soon
+  // as its read completes. Returns files indexed.
+  size_t indexDirectory(const std::string& root, ReadBackend readBackend = ReadBackend::Auto);
+  bool indexFile(const std::string& filePath);
+  // Reparses incrementally when the file's previous tree is retained,
+  // diffing bytes against the source it was parsed from.
+  bool indexSource(const std::string& filePath, SourceBufferPtr source);
+  // Replaces [startByte, oldEndByte) of the retained source with text and
+  // reindexes. False when no tree is retained for filePath or the range is
+  // outside it; index the whole source instead.
+  bool applyEdit(const std::string& filePath, uint32_t startByte, uint32_t oldEndByte,
+                 const std::string& text);
+  void removeFile(const std::string& filePath);
+
+  // Queues the file for background reindexing. Also drops cached stat results
+  // for the path, so watcher events keep import resolution current.
+  void markFileDirty(const std::string& filePath);
+  void markFilesDirty(const std::vector<std::string>& filePaths);
+
+  using WatchListener = std::function<void(const std::vector<std::string>& filePaths)>;
+  // Watches root natively. Each coalesced burst of changes goes straight into
+  // the dirty set, then listener is called once with the batch's files (on
+  // the watcher thread). False when native watching is unavailable here; the
+  // caller keeps its own watcher and calls markFileDirty instead.
+  bool watch(const std::string& root, WatchListener listener);
+  void unwatch();
+  // Re-reads every dirty file (removing ones that vanished), highest priority
+  // first. Returns files processed.
+  size_t refreshDirtyFiles();
+  // Re-reads whichever of filePaths are dirty, for a query about to read them,
+  // and moves the dirty files they import to the front of the background queue.
+  size_t refreshFiles(const std::vector<std::string>& filePaths);
+  void setReindexOptions(const ReindexSchedulerOptions& options);
+  // The cold tier of the analysis cache: files parsed from here on are looked
+  // up in, and saved to, cache. Access counts are kept beside it. Null turns
+  // the disk cache off.
+  void setDiskCache(DiskParseCachePtr cache);
+  void setAnalysisCacheOptions(const AnalysisCacheOptions& options);
+
+  // Counts filePaths as read by a query. Queries below that name a file or
+  // symbol count it themselves.
+  void recordFileAccess(const std::vector<std::string>& filePaths);
+  bool flushAccessLog();
+  // Materializes the most accessed files and symbols, by the counts saved
+  // with the disk cache: retains each file's tree and extraction and brings
+  // its analysis and export surface into memory, then computes the symbols'
+  // function summaries. Stops when options.timeMs have passed or the trees
+  // would exceed options.memoryBytes. Meant to run on a worker thread right
+  // after indexDirectory.
+  PrefetchStats prefetch(const PrefetchOptions& options);
+
+  bool isWarm() const { return warm_.load(); }
+  std::vector<std::string> roots() const;
+  bool covers(const std::string& filePath) const;
+
+  // Graph queries, serialized with indexing.
+  bool hasFile(const std::string& filePath) const;
+  Symbol getSymbol(const std::string& symbolId) const;
+  std::vector<Symbol> findSymbolsByName(const std::string& name) const;
+  std::vector<Symbol> findSymbolsByFile(const std::string& filePath) const;
+  // Outline of filePath computed when it was last indexed: what get_skeleton
+  // and get_public_surface report. Null when filePath is not indexed.
+  std::shared_ptr<const FileSkeleton> skeleton(const std::string& filePath) const;
+  // Skeletons of every indexed file under directory, by path.
+  std::vector<std::pair<std::string, std::shared_ptr<const FileSkeleton>>> skeletons(
+      const std::string& directory) const;
+  std::vector<Reference> findCallers(const std::string& symbolId) const;
+  // findCallers, plus each call site's line as findUsages gives it with lines.
+  std::vector<Reference> findCallers(const std::string& symbolId, std::vector<PostingLine>& lines);
+  std::vector<Reference> findCallees(const std::string& symbolId) const;
+  std::vector<ClassBase> getBaseClasses(const std::string& classId) const;
+  std::vector<std::string> getSubclasses(const std::string& classId) const;
+  std::vector<std::string> resolveMethod(const std::string& className,
+                                         const std::string& methodName) const;
+  std::vector<std::string> getFileUsages(const std::string& filePath) const;
+  std::vector<uint32_t> countNameUsages(const std::vector<std::string>& names,
+                                        const std::vector<std::string>& filePaths) const;
+  std::vector<std::string> findCandidateFiles(const std::vector<std::string>& names,
+                                              const std::vector<std::string>& filePaths) const;
+  std::vector<std::string> getConfigReferences(const std::vector<std::string>& filePaths) const;
+  // Absolute path an import in fromFile refers to, or empty. Needs no warmed
+  // root; stat results are cached only under the watched roots.
+  std::string resolveImport(const std::string& fromFile, const std::string& source);
+  std::vector<Posting> findUsages(const std::string& name, const std::string& pathPrefix) const;
+  // findUsages, plus each posting's line from the bytes its file was indexed
+  // from: the retained tree's source, or the file itself while it still
+  // hashes the same. lines is parallel to the result.
+  std::vector<Posting> findUsages(const std::string& name, const std::string& pathPrefix,
+                                  std::vector<PostingLine>& lines);
+  // Interprocedural summaries, brought up to date on demand.
+  bool functionSummary(const std::string& symbolId, FunctionSummary& out);
+  bool traceParameterFlow(const std::string& symbolId, uint32_t parameter, ParameterFlow& flow);
+  // traceParameterFlow for every parameter called name of a function in
+  // filePaths. A sweep rather than a lookup, so no access is recorded.
+  std::vector<ParameterFlow> traceParametersNamed(const std::string& name,
+                                                  const std::vector<std::string>& filePaths);
+  // Names filePath exports, with barrel re-export chains followed to the
+  // defining file.
+  std::vector<ExportOrigin> exportSurface(const std::string& filePath);
+  bool resolveExport(const std::string& filePath, const std::string& name, ExportOrigin& out);
+  GraphStats graphStats() const;
+  ProjectIndexStats stats() const;
+
+ private:
+  mutable std::mutex mutex_;
+  ReferenceGraph graph_;
+  IdentifierIndex identifiers_;
+  FunctionSummaryStore summaries_;
+  ExportTable exports_;
+  ImportResolver resolver_;  // Internally synchronized; used outside mutex_
+  std::vector<std::string> roots_;
+  std::atomic<bool> warm_{false};
+  size_t failedFiles_ = 0;
+  double lastWarmMs_ = 0;
+  BulkReadStats lastRead_;
+
+  // The last tree and extraction of recently indexed files, for incremental
+  // reparsing, within kRetainedTreeBytes.
+  static constexpr size_t kRetainedTreeBytes = 64u << 20;
+  TreeCache retained_{kRetainedTreeBytes};
+  // Everything else indexing derives from each file, kept so that a file
+  // indexed again without a retained tree is not reparsed.
+  AnalysisCache analyses_;
+  mutable AccessLog access_;  // Internally synchronized; recorded by const queries
+  PrefetchStats lastPrefetch_;
+  size_t incrementalParses_ = 0;
+  size_t partialExtractions_ = 0;
+  size_t supersededParses_ = 0;
+  // Latest indexing pass started on each path. Passes parse outside mutex_
+  // and commit only while still the latest, so warm-up, the reindex worker
+  // and queries indexing one file never leave an older read in place.
+  std::unordered_map<std::string, uint64_t> generations_;
+  uint64_t nextGeneration_ = 0;
+
+  // Dirty files. Its worker calls back into the index, so it is declared
+  // after everything that uses and stops before any of it is destroyed.
+  ReindexScheduler reindex_;
+
+  // Guards the watcher pointer and listener only; batches are applied
+  // without it. Declared last so the watcher thread stops first.
+  mutable std::mutex watchMutex_;
+  WatchListener watchListener_;
+  std::unique_ptr<FileWatcher> watcher_;
+
+  // Starts an indexing pass on filePath, before its source is read.
+  uint64_t beginIndexing(const std::string& filePath);
+  bool indexSource(const std::string& filePath, SourceBufferPtr source, uint64_t generation);
+  // previousTree and previousExtraction are the retained state, or null.
+  // edit, when given, turns previousTree's source into source.
+  bool indexTree(const std::string& filePath, uint64_t generation, SourceBufferPtr source,
+                 SyntaxTreePtr previousTree,
+                 std::shared_ptr<const ExtractionResult> previousExtraction,
+                 const TSInputEdit* edit);
+  void applyWatchBatch(const WatchBatch& batch);
+  void refreshFile(const std::string& filePath);
+};
+
+// Source files under root, skipping dependency, VCS, build and hidden directories.
+// findSourceFiles in src/tools/find_callers.ts walks the same scope for parsing.
+std::vector<std::string> findSourceFiles(const std::string& root);
+bool isSkippedDirectory(const std::string& name);
+
+}  // namespace prism
+
+#endif  // PROJECT_INDEX_H
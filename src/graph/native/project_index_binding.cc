@@ -0,0 +1,1067 @@
+#include <napi.h>
+#include <memory>
+#include "bindings.h"
+#include "project_index.h"
+
+class ProjectIndexWrapper : public Napi::ObjectWrap<ProjectIndexWrapper> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::FunctionReference constructor;
+  ProjectIndexWrapper(const Napi::CallbackInfo& info);
+  ~ProjectIndexWrapper();
+
+ private:
+  // Shared with in-flight warm-up workers so the index outlives a collected wrapper.
+  std::shared_ptr<prism::ProjectIndex> index_;
+
+  Napi::Value Warm(const Napi::CallbackInfo& info);
+  Napi::Value IndexFile(const Napi::CallbackInfo& info);
+  Napi::Value IndexSource(const Napi::CallbackInfo& info);
+  Napi::Value ApplyEdit(const Napi::CallbackInfo& info);
+  void RemoveFile(const Napi::CallbackInfo& info);
+  void MarkFileDirty(const Napi::CallbackInfo& info);
+  Napi::Value Watch(const Napi::CallbackInfo& info);
+  void Unwatch(const Napi::CallbackInfo& info);
+  Napi::Value RefreshDirtyFiles(const Napi::CallbackInfo& info);
+  Napi::Value RefreshFiles(const Napi::CallbackInfo& info);
+  void SetReindexOptions(const Napi::CallbackInfo& info);
+  Napi::Value SetCacheDir(const Napi::CallbackInfo& info);
+  void SetCacheBudgets(const Napi::CallbackInfo& info);
+  void RecordFileAccess(const Napi::CallbackInfo& info);
+  Napi::Value FlushAccessLog(const Napi::CallbackInfo& info);
+  Napi::Value Prefetch(const Napi::CallbackInfo& info);
+  Napi::Value IsWarm(const Napi::CallbackInfo& info);
+  Napi::Value Covers(const Napi::CallbackInfo& info);
+  Napi::Value HasFile(const Napi::CallbackInfo& info);
+  Napi::Value GetSymbol(const Napi::CallbackInfo& info);
+  Napi::Value FindSymbolsByName(const Napi::CallbackInfo& info);
+  Napi::Value FindSymbolsByFile(const Napi::CallbackInfo& info);
+  Napi::Value FindCallers(const Napi::CallbackInfo& info);
+  Napi::Value FindCallees(const Napi::CallbackInfo& info);
+  Napi::Value GetBaseClasses(const Napi::CallbackInfo& info);
+  Napi::Value GetSubclasses(const Napi::CallbackInfo& info);
+  Napi::Value ResolveMethod(const Napi::CallbackInfo& info);
+  Napi::Value GetFileUsages(const Napi::CallbackInfo& info);
+  Napi::Value CountUsages(const Napi::CallbackInfo& info);
+  Napi::Value FindUsages(const Napi::CallbackInfo& info);
+  Napi::Value FindCandidateFiles(const Napi::CallbackInfo& info);
+  Napi::Value GetConfigReferences(const Napi::CallbackInfo& info);
+  Napi::Value ResolveImport(const Napi::CallbackInfo& info);
+  Napi::Value GetFunctionSummary(const Napi::CallbackInfo& info);
+  Napi::Value TraceParameterFlow(const Napi::CallbackInfo& info);
+  Napi::Value TraceParametersNamed(const Napi::CallbackInfo& info);
+  Napi::Value GetExports(const Napi::CallbackInfo& info);
+  Napi::Value ResolveExport(const Napi::CallbackInfo& info);
+  Napi::Value GetSkeleton(const Napi::CallbackInfo& info);
+  Napi::Value GetSkeletons(const Napi::CallbackInfo& info);
+  Napi::Value GetPublicSurface(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+};
+
+Napi::FunctionReference ProjectIndexWrapper::constructor;
+
+// Walks a directory on the libuv thread pool and resolves with the file count.
+class WarmWorker : public Napi::AsyncWorker {
+ public:
+  WarmWorker(Napi::Env env, std::shared_ptr<prism::ProjectIndex> index, std::string root,
+             prism::ReadBackend readBackend)
+      : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+        index_(std::move(index)), root_(std::move(root)), readBackend_(readBackend) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    try {
+      indexed_ = index_->indexDirectory(root_, readBackend_);
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override { deferred_.Resolve(Napi::Number::New(Env(), indexed_)); }
+
+  void OnError(const Napi::Error& error) override { deferred_.Reject(error.Value()); }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<prism::ProjectIndex> index_;
+  std::string root_;
+  prism::ReadBackend readBackend_;
+  size_t indexed_ = 0;
+};
+
+static Napi::Object PrefetchStatsToJs(Napi::Env env, const prism::PrefetchStats& stats) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("files", Napi::Number::New(env, stats.files));
+  obj.Set("symbols", Napi::Number::New(env, stats.symbols));
+  obj.Set("bytes", Napi::Number::New(env, stats.bytes));
+  obj.Set("ms", Napi::Number::New(env, stats.ms));
+  obj.Set("timedOut", Napi::Boolean::New(env, stats.timedOut));
+  obj.Set("outOfMemory", Napi::Boolean::New(env, stats.outOfMemory));
+  return obj;
+}
+
+class PrefetchWorker : public Napi::AsyncWorker {
+ public:
+  PrefetchWorker(Napi::Env env, std::shared_ptr<prism::ProjectIndex> index,
+                 prism::PrefetchOptions options)
+      : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+        index_(std::move(index)), options_(options) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    try {
+      result_ = index_->prefetch(options_);
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override { deferred_.Resolve(PrefetchStatsToJs(Env(), result_)); }
+
+  void OnError(const Napi::Error& error) override { deferred_.Reject(error.Value()); }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<prism::ProjectIndex> index_;
+  prism::PrefetchOptions options_;
+  prism::PrefetchStats result_;
+};
+
+static Napi::Array SymbolsToJs(Napi::Env env, const std::vector<prism::Symbol>& symbols) {
+  Napi::Array arr = Napi::Array::New(env, symbols.size());
+  for (size_t i = 0; i < symbols.size(); i++) {
+    arr.Set(i, SymbolToJs(env, symbols[i]));
+  }
+  return arr;
+}
+
+static Napi::Array ReferencesToJs(Napi::Env env, const std::vector<prism::Reference>& refs) {
+  Napi::Array arr = Napi::Array::New(env, refs.size());
+  for (size_t i = 0; i < refs.size(); i++) {
+    arr.Set(i, ReferenceToJs(env, refs[i]));
+  }
+  return arr;
+}
+
+Napi::Object ProjectIndexWrapper::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "ProjectIndex", {
+    InstanceMethod("warm", &ProjectIndexWrapper::Warm),
+    InstanceMethod("indexFile", &ProjectIndexWrapper::IndexFile),
+    InstanceMethod("indexSource", &ProjectIndexWrapper::IndexSource),
+    InstanceMethod("applyEdit", &ProjectIndexWrapper::ApplyEdit),
+    InstanceMethod("removeFile", &ProjectIndexWrapper::RemoveFile),
+    InstanceMethod("markFileDirty", &ProjectIndexWrapper::MarkFileDirty),
+    InstanceMethod("watch", &ProjectIndexWrapper::Watch),
+    InstanceMethod("unwatch", &ProjectIndexWrapper::Unwatch),
+    InstanceMethod("refreshDirtyFiles", &ProjectIndexWrapper::RefreshDirtyFiles),
+    InstanceMethod("refreshFiles", &ProjectIndexWrapper::RefreshFiles),
+    InstanceMethod("setReindexOptions", &ProjectIndexWrapper::SetReindexOptions),
+    InstanceMethod("setCacheDir", &ProjectIndexWrapper::SetCacheDir),
+    InstanceMethod("setCacheBudgets", &ProjectIndexWrapper::SetCacheBudgets),
+    InstanceMethod("recordFileAccess", &ProjectIndexWrapper::RecordFileAccess),
+    InstanceMethod("flushAccessLog", &ProjectIndexWrapper::FlushAccessLog),
+    InstanceMethod("prefetch", &ProjectIndexWrapper::Prefetch),
+    InstanceMethod("isWarm", &ProjectIndexWrapper::IsWarm),
+    InstanceMethod("covers", &ProjectIndexWrapper::Covers),
+    InstanceMethod("hasFile", &ProjectIndexWrapper::HasFile),
+    InstanceMethod("getSymbol", &ProjectIndexWrapper::GetSymbol),
+    InstanceMethod("findSymbolsByName", &ProjectIndexWrapper::FindSymbolsByName),
+    InstanceMethod("findSymbolsByFile", &ProjectIndexWrapper::FindSymbolsByFile),
+    InstanceMethod("findCallers", &ProjectIndexWrapper::FindCallers),
+    InstanceMethod("findCallees", &ProjectIndexWrapper::FindCallees),
+    InstanceMethod("getBaseClasses", &ProjectIndexWrapper::GetBaseClasses),
+    InstanceMethod("getSubclasses", &ProjectIndexWrapper::GetSubclasses),
+    InstanceMethod("resolveMethod", &ProjectIndexWrapper::ResolveMethod),
+    InstanceMethod("getFileUsages", &ProjectIndexWrapper::GetFileUsages),
+    InstanceMethod("countUsages", &ProjectIndexWrapper::CountUsages),
+    InstanceMethod("findUsages", &ProjectIndexWrapper::FindUsages),
+    InstanceMethod("findCandidateFiles", &ProjectIndexWrapper::FindCandidateFiles),
+    InstanceMethod("getConfigReferences", &ProjectIndexWrapper::GetConfigReferences),
+    InstanceMethod("resolveImport", &ProjectIndexWrapper::ResolveImport),
+    InstanceMethod("getFunctionSummary", &ProjectIndexWrapper::GetFunctionSummary),
+    InstanceMethod("traceParameterFlow", &ProjectIndexWrapper::TraceParameterFlow),
+    InstanceMethod("traceParametersNamed", &ProjectIndexWrapper::TraceParametersNamed),
+    InstanceMethod("getExports", &ProjectIndexWrapper::GetExports),
+    InstanceMethod("resolveExport", &ProjectIndexWrapper::ResolveExport),
+    InstanceMethod("getSkeleton", &ProjectIndexWrapper::GetSkeleton),
+    InstanceMethod("getSkeletons", &ProjectIndexWrapper::GetSkeletons),
+    InstanceMethod("getPublicSurface", &ProjectIndexWrapper::GetPublicSurface),
+    InstanceMethod("getStats", &ProjectIndexWrapper::GetStats),
+  });
+
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+
+  exports.Set("ProjectIndex", func);
+  return exports;
+}
+
+ProjectIndexWrapper::ProjectIndexWrapper(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<ProjectIndexWrapper>(info), index_(std::make_shared<prism::ProjectIndex>()) {}
+
+// The watcher would otherwise keep calling into a collected wrapper's callback.
+ProjectIndexWrapper::~ProjectIndexWrapper() {
+  index_->unwatch();
+  index_->flushAccessLog();
+}
+
+Napi::Value ProjectIndexWrapper::Warm(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Root directory string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::ReadBackend readBackend = prism::ReadBackend::Auto;
+  if (info.Length() > 1 && info[1].IsString()) {
+    readBackend = prism::readBackendFromName(info[1].As<Napi::String>().Utf8Value());
+  }
+  WarmWorker* worker =
+      new WarmWorker(env, index_, info[0].As<Napi::String>().Utf8Value(), readBackend);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value ProjectIndexWrapper::IndexFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, index_->indexFile(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::IndexSource(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 2 || !info[0].IsString() || !JsToSourceBuffer(info[1], source)) {
+    Napi::TypeError::New(env, "FilePath string and source (string or Buffer) expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, index_->indexSource(info[0].As<Napi::String>().Utf8Value(), std::move(source)));
+}
+
+Napi::Value ProjectIndexWrapper::ApplyEdit(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::string text;
+  if (info.Length() < 4 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber() ||
+      !JsToSourceBytes(info[3], text)) {
+    Napi::TypeError::New(env, "FilePath, start byte, old end byte and replacement text expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, index_->applyEdit(info[0].As<Napi::String>().Utf8Value(),
+                                                   info[1].As<Napi::Number>().Uint32Value(),
+                                                   info[2].As<Napi::Number>().Uint32Value(), text));
+}
+
+void ProjectIndexWrapper::RemoveFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return;
+  }
+  index_->removeFile(info[0].As<Napi::String>().Utf8Value());
+}
+
+void ProjectIndexWrapper::MarkFileDirty(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return;
+  }
+  index_->markFileDirty(info[0].As<Napi::String>().Utf8Value());
+}
+
+Napi::Value ProjectIndexWrapper::Watch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Root directory string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  prism::ProjectIndex::WatchListener listener;
+  if (info.Length() > 1 && info[1].IsFunction()) {
+    // Released when the index drops the listener, from whichever thread that is.
+    std::shared_ptr<Napi::ThreadSafeFunction> callback(
+        new Napi::ThreadSafeFunction(Napi::ThreadSafeFunction::New(
+            env, info[1].As<Napi::Function>(), "prismWatchBatch", 0, 1)),
+        [](Napi::ThreadSafeFunction* tsfn) {
+          tsfn->Release();
+          delete tsfn;
+        });
+    // Watching alone does not keep the process alive.
+    callback->Unref(env);
+    listener = [callback](const std::vector<std::string>& filePaths) {
+      auto* batch = new std::vector<std::string>(filePaths);
+      napi_status status = callback->NonBlockingCall(
+          batch, [](Napi::Env env, Napi::Function fn, std::vector<std::string>* data) {
+            if (env != nullptr && fn != nullptr) fn.Call({StringsToJs(env, *data)});
+            delete data;
+          });
+      if (status != napi_ok) delete batch;
+    };
+  }
+  return Napi::Boolean::New(env, index_->watch(info[0].As<Napi::String>().Utf8Value(),
+                                               std::move(listener)));
+}
+
+void ProjectIndexWrapper::Unwatch(const Napi::CallbackInfo& info) {
+  index_->unwatch();
+}
+
+Napi::Value ProjectIndexWrapper::RefreshDirtyFiles(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return Napi::Number::New(env, index_->refreshDirtyFiles());
+}
+
+Napi::Value ProjectIndexWrapper::RefreshFiles(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "FilePaths array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Number::New(env, index_->refreshFiles(JsToStrings(info[0].As<Napi::Array>())));
+}
+
+void ProjectIndexWrapper::SetReindexOptions(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Options object expected").ThrowAsJavaScriptException();
+    return;
+  }
+  Napi::Object obj = info[0].As<Napi::Object>();
+  prism::ReindexSchedulerOptions options;
+  if (obj.Has("debounceMs") && obj.Get("debounceMs").IsNumber()) {
+    options.debounceMs = obj.Get("debounceMs").As<Napi::Number>().Uint32Value();
+  }
+  if (obj.Has("cpuBudget") && obj.Get("cpuBudget").IsNumber()) {
+    options.cpuBudget = obj.Get("cpuBudget").As<Napi::Number>().DoubleValue();
+  }
+  index_->setReindexOptions(options);
+}
+
+Napi::Value ProjectIndexWrapper::SetCacheDir(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !(info[0].IsString() || info[0].IsNull())) {
+    Napi::TypeError::New(env, "Directory string or null expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (info[0].IsNull()) {
+    index_->setDiskCache(nullptr);
+    return Napi::Boolean::New(env, true);
+  }
+  uint64_t maxBytes = 512ull << 20;
+  if (info.Length() > 1 && info[1].IsNumber()) {
+    maxBytes = static_cast<uint64_t>(info[1].As<Napi::Number>().Int64Value());
+  }
+  auto cache = std::make_shared<prism::DiskParseCache>(info[0].As<Napi::String>().Utf8Value(),
+                                                       maxBytes);
+  if (!cache->usable()) return Napi::Boolean::New(env, false);
+  index_->setDiskCache(std::move(cache));
+  return Napi::Boolean::New(env, true);
+}
+
+void ProjectIndexWrapper::SetCacheBudgets(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Budgets object expected").ThrowAsJavaScriptException();
+    return;
+  }
+  Napi::Object obj = info[0].As<Napi::Object>();
+  prism::AnalysisCacheOptions options;
+  if (obj.Has("hotBytes") && obj.Get("hotBytes").IsNumber()) {
+    options.hotBytes = static_cast<size_t>(obj.Get("hotBytes").As<Napi::Number>().Int64Value());
+  }
+  if (obj.Has("warmBytes") && obj.Get("warmBytes").IsNumber()) {
+    options.warmBytes = static_cast<size_t>(obj.Get("warmBytes").As<Napi::Number>().Int64Value());
+  }
+  index_->setAnalysisCacheOptions(options);
+}
+
+void ProjectIndexWrapper::RecordFileAccess(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "FilePaths array expected").ThrowAsJavaScriptException();
+    return;
+  }
+  index_->recordFileAccess(JsToStrings(info[0].As<Napi::Array>()));
+}
+
+Napi::Value ProjectIndexWrapper::FlushAccessLog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return Napi::Boolean::New(env, index_->flushAccessLog());
+}
+
+Napi::Value ProjectIndexWrapper::Prefetch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::PrefetchOptions options;
+  if (info.Length() > 0 && info[0].IsObject()) {
+    Napi::Object obj = info[0].As<Napi::Object>();
+    if (obj.Has("maxFiles") && obj.Get("maxFiles").IsNumber()) {
+      options.maxFiles = obj.Get("maxFiles").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("maxSymbols") && obj.Get("maxSymbols").IsNumber()) {
+      options.maxSymbols = obj.Get("maxSymbols").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("timeMs") && obj.Get("timeMs").IsNumber()) {
+      options.timeMs = obj.Get("timeMs").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("memoryBytes") && obj.Get("memoryBytes").IsNumber()) {
+      options.memoryBytes =
+          static_cast<size_t>(obj.Get("memoryBytes").As<Napi::Number>().Int64Value());
+    }
+  }
+  PrefetchWorker* worker = new PrefetchWorker(env, index_, options);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value ProjectIndexWrapper::IsWarm(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return Napi::Boolean::New(env, index_->isWarm());
+}
+
+Napi::Value ProjectIndexWrapper::Covers(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Path string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, index_->covers(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::HasFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, index_->hasFile(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::GetSymbol(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::Symbol symbol = index_->getSymbol(info[0].As<Napi::String>().Utf8Value());
+  if (symbol.id.empty()) return env.Null();
+  return SymbolToJs(env, symbol);
+}
+
+Napi::Value ProjectIndexWrapper::FindSymbolsByName(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Name string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return SymbolsToJs(env, index_->findSymbolsByName(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::FindSymbolsByFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return SymbolsToJs(env, index_->findSymbolsByFile(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::FindCallers(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string symbolId = info[0].As<Napi::String>().Utf8Value();
+  bool withLines = info.Length() > 1 && info[1].IsBoolean() && info[1].As<Napi::Boolean>().Value();
+  if (!withLines) return ReferencesToJs(env, index_->findCallers(symbolId));
+
+  std::vector<prism::PostingLine> lines;
+  std::vector<prism::Reference> refs = index_->findCallers(symbolId, lines);
+  Napi::Array arr = Napi::Array::New(env, refs.size());
+  for (size_t i = 0; i < refs.size(); i++) {
+    Napi::Object obj = ReferenceToJs(env, refs[i]);
+    if (lines[i].found) {
+      obj.Set("lineText", lines[i].text);
+      obj.Set("lineColumn", lines[i].utf16Column);
+    }
+    arr.Set(i, obj);
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::FindCallees(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return ReferencesToJs(env, index_->findCallees(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::GetBaseClasses(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Class symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<prism::ClassBase> bases = index_->getBaseClasses(info[0].As<Napi::String>().Utf8Value());
+  Napi::Array arr = Napi::Array::New(env, bases.size());
+  for (size_t i = 0; i < bases.size(); i++) {
+    arr.Set(i, ClassBaseToJs(env, bases[i]));
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::GetSubclasses(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Class symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return StringsToJs(env, index_->getSubclasses(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::ResolveMethod(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Class name and method name expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return StringsToJs(env, index_->resolveMethod(info[0].As<Napi::String>().Utf8Value(),
+                                                info[1].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::GetFileUsages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return StringsToJs(env, index_->getFileUsages(info[0].As<Napi::String>().Utf8Value()));
+}
+
+Napi::Value ProjectIndexWrapper::CountUsages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray() || (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsArray())) {
+    Napi::TypeError::New(env, "Names array and optional filePaths array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<std::string> names = JsToStrings(info[0].As<Napi::Array>());
+  std::vector<std::string> filePaths;
+  if (info.Length() > 1 && info[1].IsArray()) filePaths = JsToStrings(info[1].As<Napi::Array>());
+
+  std::vector<uint32_t> counts = index_->countNameUsages(names, filePaths);
+  Napi::Array arr = Napi::Array::New(env, counts.size());
+  for (size_t i = 0; i < counts.size(); i++) {
+    arr.Set(i, Napi::Number::New(env, counts[i]));
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::FindUsages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Name string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string pathPrefix;
+  if (info.Length() > 1 && info[1].IsString()) pathPrefix = info[1].As<Napi::String>().Utf8Value();
+  bool withLines = info.Length() > 2 && info[2].IsBoolean() && info[2].As<Napi::Boolean>().Value();
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  std::vector<prism::PostingLine> lines;
+  std::vector<prism::Posting> postings = withLines ? index_->findUsages(name, pathPrefix, lines)
+                                                   : index_->findUsages(name, pathPrefix);
+  Napi::Array arr = Napi::Array::New(env, postings.size());
+  for (size_t i = 0; i < postings.size(); i++) {
+    const prism::Posting& posting = postings[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("filePath", posting.filePath);
+    obj.Set("line", posting.line);
+    obj.Set("column", posting.column);
+    obj.Set("kind", prism::usageKindName(posting.kind));
+    obj.Set("isMember", (posting.flags & prism::kUsageMember) != 0);
+    obj.Set("isArgument", (posting.flags & prism::kUsageArgument) != 0);
+    obj.Set("isProperty", (posting.flags & prism::kUsageProperty) != 0);
+    obj.Set("isImport", (posting.flags & prism::kUsageImport) != 0);
+    if (withLines && lines[i].found) {
+      obj.Set("lineText", lines[i].text);
+      obj.Set("lineColumn", lines[i].utf16Column);
+    }
+    arr.Set(i, obj);
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::FindCandidateFiles(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray() || (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsArray())) {
+    Napi::TypeError::New(env, "Names array and optional filePaths array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<std::string> names = JsToStrings(info[0].As<Napi::Array>());
+  std::vector<std::string> filePaths;
+  if (info.Length() > 1 && info[1].IsArray()) filePaths = JsToStrings(info[1].As<Napi::Array>());
+  return StringsToJs(env, index_->findCandidateFiles(names, filePaths));
+}
+
+Napi::Value ProjectIndexWrapper::GetConfigReferences(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "FilePaths array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return StringsToJs(env, index_->getConfigReferences(JsToStrings(info[0].As<Napi::Array>())));
+}
+
+Napi::Value ProjectIndexWrapper::ResolveImport(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "FromFile and source strings expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string resolved = index_->resolveImport(info[0].As<Napi::String>().Utf8Value(),
+                                               info[1].As<Napi::String>().Utf8Value());
+  if (resolved.empty()) return env.Null();
+  return Napi::String::New(env, resolved);
+}
+
+Napi::Value ProjectIndexWrapper::GetFunctionSummary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Symbol ID string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::FunctionSummary summary;
+  if (!index_->functionSummary(info[0].As<Napi::String>().Utf8Value(), summary)) return env.Null();
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("symbolId", summary.symbolId);
+  obj.Set("parameters", StringsToJs(env, summary.parameters));
+  Napi::Array returned = Napi::Array::New(env, summary.returnedParameters.size());
+  for (size_t i = 0; i < summary.returnedParameters.size(); i++) {
+    returned.Set(i, summary.parameters[summary.returnedParameters[i]]);
+  }
+  obj.Set("returnedParameters", returned);
+  Napi::Array callees = Napi::Array::New(env, summary.calleeFlows.size());
+  for (size_t i = 0; i < summary.calleeFlows.size(); i++) {
+    const prism::CalleeFlow& flow = summary.calleeFlows[i];
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("parameter", summary.parameters[flow.parameter]);
+    entry.Set("callee", flow.callee);
+    entry.Set("argument", Napi::Number::New(env, flow.argument));
+    entry.Set("line", Napi::Number::New(env, flow.line));
+    callees.Set(i, entry);
+  }
+  obj.Set("calleeFlows", callees);
+  Napi::Array globals = Napi::Array::New(env, summary.globalFlows.size());
+  for (size_t i = 0; i < summary.globalFlows.size(); i++) {
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("parameter", summary.parameters[summary.globalFlows[i].parameter]);
+    entry.Set("global", summary.globalFlows[i].global);
+    globals.Set(i, entry);
+  }
+  obj.Set("globalFlows", globals);
+  obj.Set("sccSize", Napi::Number::New(env, summary.sccSize));
+  return obj;
+}
+
+static Napi::Object ParameterFlowToJs(Napi::Env env, const prism::ParameterFlow& flow) {
+  Napi::Object obj = Napi::Object::New(env);
+  Napi::Array reaches = Napi::Array::New(env, flow.reaches.size());
+  for (size_t i = 0; i < flow.reaches.size(); i++) {
+    const prism::FlowStep& step = flow.reaches[i];
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("symbolId", step.symbolId);
+    entry.Set("parameter", step.parameterName);
+    entry.Set("depth", Napi::Number::New(env, step.depth));
+    reaches.Set(i, entry);
+  }
+  obj.Set("reaches", reaches);
+  obj.Set("globals", StringsToJs(env, flow.globals));
+  obj.Set("returned", Napi::Boolean::New(env, flow.returned));
+  return obj;
+}
+
+Napi::Value ProjectIndexWrapper::TraceParameterFlow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Symbol ID string and parameter index expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::ParameterFlow flow;
+  if (!index_->traceParameterFlow(info[0].As<Napi::String>().Utf8Value(),
+                                  info[1].As<Napi::Number>().Uint32Value(), flow)) {
+    return env.Null();
+  }
+  return ParameterFlowToJs(env, flow);
+}
+
+Napi::Value ProjectIndexWrapper::TraceParametersNamed(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "Parameter name and file paths expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<prism::ParameterFlow> flows = index_->traceParametersNamed(
+      info[0].As<Napi::String>().Utf8Value(), JsToStrings(info[1].As<Napi::Array>()));
+
+  Napi::Array result = Napi::Array::New(env, flows.size());
+  for (size_t i = 0; i < flows.size(); i++) result.Set(i, ParameterFlowToJs(env, flows[i]));
+  return result;
+}
+
+static Napi::Object ExportOriginToJs(Napi::Env env, const prism::ExportOrigin& origin) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("name", origin.name);
+  if (!origin.filePath.empty()) obj.Set("filePath", origin.filePath);
+  obj.Set("localName", origin.localName);
+  if (!origin.module.empty()) obj.Set("module", origin.module);
+  obj.Set("depth", Napi::Number::New(env, origin.depth));
+  return obj;
+}
+
+Napi::Value ProjectIndexWrapper::GetExports(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<prism::ExportOrigin> origins =
+      index_->exportSurface(info[0].As<Napi::String>().Utf8Value());
+  Napi::Array arr = Napi::Array::New(env, origins.size());
+  for (size_t i = 0; i < origins.size(); i++) {
+    arr.Set(i, ExportOriginToJs(env, origins[i]));
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::ResolveExport(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "FilePath and export name expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::ExportOrigin origin;
+  if (!index_->resolveExport(info[0].As<Napi::String>().Utf8Value(),
+                             info[1].As<Napi::String>().Utf8Value(), origin)) {
+    return env.Null();
+  }
+  return ExportOriginToJs(env, origin);
+}
+
+// Skeletons in the shapes of src/types/ast.ts; optional fields are left out
+// when empty.
+static Napi::Array SkeletonParametersToJs(Napi::Env env,
+                                          const std::vector<prism::SkeletonParameter>& params) {
+  Napi::Array arr = Napi::Array::New(env, params.size());
+  for (size_t i = 0; i < params.size(); i++) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("name", params[i].name);
+    if (!params[i].type.empty()) obj.Set("type", params[i].type);
+    if (!params[i].defaultValue.empty()) obj.Set("defaultValue", params[i].defaultValue);
+    arr.Set(i, obj);
+  }
+  return arr;
+}
+
+static void SetSkeletonFlags(Napi::Env env, Napi::Object obj, const prism::SkeletonItem& item) {
+  static const char* const kVisibilities[] = {nullptr, "public", "private", "protected"};
+  const char* visibility = kVisibilities[static_cast<size_t>(item.visibility)];
+  if (visibility) obj.Set("visibility", visibility);
+  auto set = [&](uint8_t flag, const char* name) {
+    if (item.flags & flag) obj.Set(name, Napi::Boolean::New(env, true));
+  };
+  switch (item.kind) {
+    case prism::SkeletonKind::Function:
+      set(prism::kSkeletonExported, "isExported");
+      set(prism::kSkeletonDefault, "isDefault");
+      [[fallthrough]];
+    case prism::SkeletonKind::Method:
+      set(prism::kSkeletonStatic, "isStatic");
+      set(prism::kSkeletonAsync, "isAsync");
+      set(prism::kSkeletonGenerator, "isGenerator");
+      set(prism::kSkeletonAbstract, "isAbstract");
+      break;
+    case prism::SkeletonKind::Property:
+      set(prism::kSkeletonReadonly, "isReadonly");
+      set(prism::kSkeletonStatic, "isStatic");
+      break;
+    case prism::SkeletonKind::Variable:
+      set(prism::kSkeletonExported, "isExported");
+      set(prism::kSkeletonConst, "isConst");
+      break;
+    default:
+      break;
+  }
+  if (!item.decorators.empty()) obj.Set("decorators", StringsToJs(env, item.decorators));
+}
+
+static Napi::Object SkeletonFunctionToJs(Napi::Env env, const prism::SkeletonItem& item) {
+  Napi::Object obj = Napi::Object::New(env);
+  if (item.kind == prism::SkeletonKind::Function) obj.Set("type", "function");
+  obj.Set("name", item.name);
+  obj.Set("parameters", SkeletonParametersToJs(env, item.parameters));
+  if (!item.type.empty()) obj.Set("returnType", item.type);
+  SetSkeletonFlags(env, obj, item);
+  return obj;
+}
+
+static Napi::Object SkeletonPropertyToJs(Napi::Env env, const prism::SkeletonItem& item) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("name", item.name);
+  if (!item.type.empty()) obj.Set("type", item.type);
+  SetSkeletonFlags(env, obj, item);
+  return obj;
+}
+
+static Napi::Object SkeletonToJs(Napi::Env env, const std::string& filePath,
+                                 const prism::FileSkeleton& skeleton) {
+  Napi::Array imports = Napi::Array::New(env, skeleton.imports.size());
+  for (size_t i = 0; i < skeleton.imports.size(); i++) {
+    const prism::SkeletonImport& entry = skeleton.imports[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("type", "import");
+    obj.Set("source", entry.source);
+    Napi::Array imported = Napi::Array::New(env, entry.imported.size());
+    for (size_t j = 0; j < entry.imported.size(); j++) {
+      Napi::Object name = Napi::Object::New(env);
+      name.Set("name", entry.imported[j].first);
+      if (!entry.imported[j].second.empty()) name.Set("alias", entry.imported[j].second);
+      imported.Set(j, name);
+    }
+    obj.Set("imported", imported);
+    if (entry.isDefault) obj.Set("isDefault", Napi::Boolean::New(env, true));
+    if (entry.isNamespace) obj.Set("isNamespace", Napi::Boolean::New(env, true));
+    imports.Set(i, obj);
+  }
+
+  Napi::Array classes = Napi::Array::New(env);
+  Napi::Array functions = Napi::Array::New(env);
+  Napi::Array interfaces = Napi::Array::New(env);
+  Napi::Array enums = Napi::Array::New(env);
+  Napi::Array typeAliases = Napi::Array::New(env);
+  Napi::Array variables = Napi::Array::New(env);
+  auto push = [](Napi::Array& arr, Napi::Object obj) { arr.Set(arr.Length(), obj); };
+  for (const auto& item : skeleton.items) {
+    Napi::Object obj = Napi::Object::New(env);
+    switch (item.kind) {
+      case prism::SkeletonKind::Class:
+      case prism::SkeletonKind::Interface: {
+        bool isClass = item.kind == prism::SkeletonKind::Class;
+        obj.Set("type", isClass ? "class" : "interface");
+        obj.Set("name", item.name);
+        if (!item.extends.empty()) obj.Set("extends", item.extends);
+        if (!item.bases.empty()) {
+          obj.Set(isClass ? "implements" : "extends", StringsToJs(env, item.bases));
+        }
+        Napi::Array properties = Napi::Array::New(env);
+        Napi::Array methods = Napi::Array::New(env);
+        for (const auto& member : item.members) {
+          if (member.kind == prism::SkeletonKind::Property) {
+            push(properties, SkeletonPropertyToJs(env, member));
+          } else if (member.kind == prism::SkeletonKind::Method) {
+            push(methods, SkeletonFunctionToJs(env, member));
+          } else if (member.kind == prism::SkeletonKind::Constructor) {
+            Napi::Object constructorDef = Napi::Object::New(env);
+            constructorDef.Set("parameters", SkeletonParametersToJs(env, member.parameters));
+            SetSkeletonFlags(env, constructorDef, member);
+            obj.Set("constructorDef", constructorDef);
+          }
+        }
+        obj.Set("properties", properties);
+        obj.Set("methods", methods);
+        if (!item.decorators.empty()) obj.Set("decorators", StringsToJs(env, item.decorators));
+        push(isClass ? classes : interfaces, obj);
+        break;
+      }
+      case prism::SkeletonKind::Function:
+        push(functions, SkeletonFunctionToJs(env, item));
+        break;
+      case prism::SkeletonKind::Enum: {
+        obj.Set("type", "enum");
+        obj.Set("name", item.name);
+        Napi::Array members = Napi::Array::New(env, item.members.size());
+        for (size_t i = 0; i < item.members.size(); i++) {
+          Napi::Object member = Napi::Object::New(env);
+          member.Set("name", item.members[i].name);
+          if (!item.members[i].type.empty()) member.Set("value", item.members[i].type);
+          members.Set(i, member);
+        }
+        obj.Set("members", members);
+        push(enums, obj);
+        break;
+      }
+      case prism::SkeletonKind::TypeAlias:
+        obj.Set("type", "type_alias");
+        obj.Set("name", item.name);
+        if (!item.type.empty()) obj.Set("definition", item.type);
+        push(typeAliases, obj);
+        break;
+      case prism::SkeletonKind::Variable:
+        obj.Set("type", "variable");
+        obj.Set("name", item.name);
+        if (!item.type.empty()) obj.Set("varType", item.type);
+        if (!item.alias.empty()) obj.Set("alias", item.alias);
+        SetSkeletonFlags(env, obj, item);
+        push(variables, obj);
+        break;
+      default:
+        break;
+    }
+  }
+
+  Napi::Object exports = Napi::Object::New(env);
+  exports.Set("classes", classes);
+  exports.Set("functions", functions);
+  exports.Set("interfaces", interfaces);
+  exports.Set("enums", enums);
+  exports.Set("typeAliases", typeAliases);
+  exports.Set("variables", variables);
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("filePath", filePath);
+  obj.Set("language", prism::languageName(prism::languageForPath(filePath)));
+  obj.Set("imports", imports);
+  obj.Set("exports", exports);
+  return obj;
+}
+
+Napi::Value ProjectIndexWrapper::GetSkeleton(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string filePath = info[0].As<Napi::String>().Utf8Value();
+  std::shared_ptr<const prism::FileSkeleton> skeleton = index_->skeleton(filePath);
+  if (!skeleton) return env.Null();
+  return SkeletonToJs(env, filePath, *skeleton);
+}
+
+Napi::Value ProjectIndexWrapper::GetSkeletons(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Directory string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  auto skeletons = index_->skeletons(info[0].As<Napi::String>().Utf8Value());
+  Napi::Array arr = Napi::Array::New(env, skeletons.size());
+  for (size_t i = 0; i < skeletons.size(); i++) {
+    arr.Set(i, SkeletonToJs(env, skeletons[i].first, *skeletons[i].second));
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::GetPublicSurface(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::shared_ptr<const prism::FileSkeleton> skeleton =
+      index_->skeleton(info[0].As<Napi::String>().Utf8Value());
+  if (!skeleton) return env.Null();
+  Napi::Array arr = Napi::Array::New(env, skeleton->surface.size());
+  for (size_t i = 0; i < skeleton->surface.size(); i++) {
+    const prism::SurfaceItem& item = skeleton->surface[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("name", item.name);
+    obj.Set("type", item.type);
+    if (!item.signature.empty()) obj.Set("signature", item.signature);
+    if (item.type == "class" || item.type == "interface") {
+      obj.Set("members", StringsToJs(env, item.members));
+    }
+    if (!item.source.empty()) obj.Set("source", item.source);
+    if (item.isDefault) obj.Set("isDefault", Napi::Boolean::New(env, true));
+    arr.Set(i, obj);
+  }
+  return arr;
+}
+
+Napi::Value ProjectIndexWrapper::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::ProjectIndexStats stats = index_->stats();
+  prism::GraphStats graphStats = index_->graphStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("indexedFiles", Napi::Number::New(env, stats.indexedFiles));
+  obj.Set("failedFiles", Napi::Number::New(env, stats.failedFiles));
+  obj.Set("dirtyFiles", Napi::Number::New(env, stats.dirtyFiles));
+  obj.Set("lastWarmMs", Napi::Number::New(env, stats.lastWarmMs));
+  obj.Set("warm", Napi::Boolean::New(env, stats.warm));
+  obj.Set("totalSymbols", Napi::Number::New(env, graphStats.totalSymbols));
+  obj.Set("totalReferences", Napi::Number::New(env, graphStats.totalReferences));
+  obj.Set("memoryUsageBytes", Napi::Number::New(env, graphStats.memoryUsageBytes));
+  obj.Set("identifierNames", Napi::Number::New(env, stats.identifiers.names));
+  obj.Set("identifierPostings", Napi::Number::New(env, stats.identifiers.postings));
+  obj.Set("postingBytes", Napi::Number::New(env, stats.identifiers.encodedBytes));
+  obj.Set("importResolutions", Napi::Number::New(env, stats.imports.resolutions));
+  obj.Set("cachedImportResolutions", Napi::Number::New(env, stats.imports.cachedResolutions));
+  obj.Set("functionSummaries", Napi::Number::New(env, stats.summaries.summaries));
+  obj.Set("summaryComputations", Napi::Number::New(env, stats.summaries.computed));
+  obj.Set("exportSurfaces", Napi::Number::New(env, stats.exports.surfaces));
+  obj.Set("exportSurfaceComputations", Napi::Number::New(env, stats.exports.computed));
+  obj.Set("retainedTrees", Napi::Number::New(env, stats.retained.entries));
+  obj.Set("retainedBytes", Napi::Number::New(env, stats.retained.residentBytes));
+  obj.Set("retainedEvictions", Napi::Number::New(env, stats.retained.evictions));
+  obj.Set("incrementalParses", Napi::Number::New(env, stats.incrementalParses));
+  obj.Set("partialExtractions", Napi::Number::New(env, stats.partialExtractions));
+  obj.Set("supersededParses", Napi::Number::New(env, stats.supersededParses));
+  obj.Set("readBackend", Napi::String::New(env, prism::readBackendName(stats.lastRead.backend)));
+  obj.Set("lastReadMs", Napi::Number::New(env, stats.lastRead.ms));
+  obj.Set("lastReadBytes", Napi::Number::New(env, stats.lastRead.bytes));
+  obj.Set("watching", Napi::Boolean::New(env, stats.watching));
+  obj.Set("watchedDirectories", Napi::Number::New(env, stats.watcher.directories));
+  obj.Set("watchEvents", Napi::Number::New(env, stats.watcher.events));
+  obj.Set("watchBatches", Napi::Number::New(env, stats.watcher.batches));
+  obj.Set("watchOverflows", Napi::Number::New(env, stats.watcher.overflows));
+  obj.Set("reindexQueueDepth", Napi::Number::New(env, stats.reindex.queueDepth));
+  obj.Set("reindexPrioritized", Napi::Number::New(env, stats.reindex.prioritized));
+  obj.Set("reindexLagMs", Napi::Number::New(env, stats.reindex.oldestLagMs));
+  obj.Set("lastReindexLagMs", Napi::Number::New(env, stats.reindex.lastLagMs));
+  obj.Set("reindexed", Napi::Number::New(env, stats.reindex.processed));
+  obj.Set("backgroundReindexed", Napi::Number::New(env, stats.reindex.backgroundProcessed));
+  obj.Set("coalescedChanges", Napi::Number::New(env, stats.reindex.coalesced));
+  const prism::AnalysisCacheStats& tiers = stats.analyses;
+  double lookups = tiers.lookups ? static_cast<double>(tiers.lookups) : 1;
+  obj.Set("cacheLookups", Napi::Number::New(env, tiers.lookups));
+  obj.Set("hotEntries", Napi::Number::New(env, tiers.hot.entries));
+  obj.Set("hotBytes", Napi::Number::New(env, tiers.hot.bytes));
+  obj.Set("hotHits", Napi::Number::New(env, tiers.hot.hits));
+  obj.Set("hotHitRate", Napi::Number::New(env, tiers.hot.hits / lookups));
+  obj.Set("warmEntries", Napi::Number::New(env, tiers.warm.entries));
+  obj.Set("warmBytes", Napi::Number::New(env, tiers.warm.bytes));
+  obj.Set("warmRawBytes", Napi::Number::New(env, tiers.warmRawBytes));
+  obj.Set("warmHits", Napi::Number::New(env, tiers.warm.hits));
+  obj.Set("warmHitRate", Napi::Number::New(env, tiers.warm.hits / lookups));
+  obj.Set("coldHits", Napi::Number::New(env, tiers.coldHits));
+  obj.Set("coldHitRate", Napi::Number::New(env, tiers.coldHits / lookups));
+  obj.Set("cacheMisses", Napi::Number::New(env, tiers.misses));
+  obj.Set("cachePromotions", Napi::Number::New(env, tiers.promotions));
+  obj.Set("cacheDemotions", Napi::Number::New(env, tiers.demotions));
+  obj.Set("cacheEvictions", Napi::Number::New(env, tiers.evictions));
+  obj.Set("accessedFiles", Napi::Number::New(env, stats.access.files));
+  obj.Set("accessedSymbols", Napi::Number::New(env, stats.access.symbols));
+  obj.Set("accessRecords", Napi::Number::New(env, stats.access.records));
+  obj.Set("accessLogSaves", Napi::Number::New(env, stats.access.saves));
+  obj.Set("lastPrefetch", PrefetchStatsToJs(env, stats.lastPrefetch));
+  obj.Set("diskCache", Napi::Boolean::New(env, stats.diskCache));
+  obj.Set("diskCacheHits", Napi::Number::New(env, stats.disk.hits));
+  obj.Set("diskCacheMisses", Napi::Number::New(env, stats.disk.misses));
+  obj.Set("diskCacheWrites", Napi::Number::New(env, stats.disk.writes));
+  obj.Set("diskCacheRejected", Napi::Number::New(env, stats.disk.rejected));
+  obj.Set("diskCacheBytes", Napi::Number::New(env, stats.disk.bytes));
+  obj.Set("diskCacheCollections", Napi::Number::New(env, stats.disk.collections));
+  obj.Set("diskCacheDeferredCollections",
+          Napi::Number::New(env, stats.disk.deferredCollections));
+  return obj;
+}
+
+Napi::Object InitProjectIndex(Napi::Env env, Napi::Object exports) {
+  return ProjectIndexWrapper::Init(env, exports);
+}
@@ -0,0 +1,15 @@
+R"scm(
+; Definitions, imports and call sites for Python.
+; This file is #included as a C++ raw string literal by extractor.cc; keep the
+; delimiter lines above and below intact.
+
+(function_definition name: (identifier) @name) @definition.function
+(class_definition name: (identifier) @name) @definition.class
+(module (expression_statement (assignment left: (identifier) @name) @definition.variable))
+
+(import_statement) @import
+(import_from_statement) @import
+
+(call function: (identifier) @call.name) @call
+(call function: (attribute attribute: (identifier) @call.name)) @call.method
+)scm"
@@ -0,0 +1,24 @@
+R"scm(
+; Definitions, imports, exports and call sites for TypeScript, JavaScript and TSX.
+; This file is #included as a C++ raw string literal by extractor.cc; keep the
+; delimiter lines above and below intact.
+
+(function_declaration name: (identifier) @name) @definition.function
+(generator_function_declaration name: (identifier) @name) @definition.function
+(method_definition name: (_) @name) @definition.method
+(class_declaration name: (type_identifier) @name) @definition.class
+(abstract_class_declaration name: (type_identifier) @name) @definition.class
+(variable_declarator name: (identifier) @name) @definition.variable
+
+(import_statement) @import
+
+(export_statement) @export
+(export_statement (export_clause (export_specifier name: (identifier) @export.name)))
+(export_statement value: (identifier) @export.name)
+
+(call_expression function: (identifier) @call.name) @call
+(call_expression
+  function: (member_expression property: (property_identifier) @call.name)) @call.method
+(new_expression constructor: (identifier) @call.name) @call.new
+(arguments (identifier) @call.name) @call.callback
+)scm"
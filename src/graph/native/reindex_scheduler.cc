@@ -0,0 +1,202 @@
+#include "reindex_scheduler.h"
+#include <algorithm>
+
+namespace prism {
+
+bool ReindexScheduler::Key::operator<(const Key& other) const {
+  if (priority != other.priority) return priority > other.priority;
+  if (firstChange != other.firstChange) return firstChange < other.firstChange;
+  return filePath < other.filePath;
+}
+
+ReindexScheduler::ReindexScheduler(Reindex reindex) : reindex_(std::move(reindex)) {}
+
+ReindexScheduler::~ReindexScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  changed_.notify_all();
+  if (worker_.joinable()) worker_.join();
+}
+
+void ReindexScheduler::setOptions(const ReindexSchedulerOptions& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_ = options;
+  options_.cpuBudget = std::min(1.0, std::max(0.0, options_.cpuBudget));
+  if (!queue_.empty()) startWorker();
+  changed_.notify_all();
+}
+
+ReindexSchedulerOptions ReindexScheduler::options() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return options_;
+}
+
+void ReindexScheduler::enqueue(const std::vector<std::string>& filePaths) {
+  if (filePaths.empty()) return;
+  Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& filePath : filePaths) {
+    auto it = entries_.find(filePath);
+    if (it != entries_.end()) {
+      it->second.lastChange = now;
+      stats_.coalesced++;
+      continue;
+    }
+    Entry entry{{0, now, filePath}, now};
+    queue_.insert(entry.key);
+    entries_.emplace(filePath, std::move(entry));
+  }
+  startWorker();
+  changed_.notify_all();
+}
+
+void ReindexScheduler::prioritize(const std::vector<std::string>& filePaths) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t priority = nextPriority_++;
+  bool raised = false;
+  for (const auto& filePath : filePaths) {
+    auto it = entries_.find(filePath);
+    if (it == entries_.end() || it->second.key.priority == priority) continue;
+    queue_.erase(it->second.key);
+    it->second.key.priority = priority;
+    queue_.insert(it->second.key);
+    raised = true;
+  }
+  if (raised) changed_.notify_all();
+}
+
+ReindexScheduler::Clock::time_point ReindexScheduler::take(const std::string& filePath) {
+  auto it = entries_.find(filePath);
+  Clock::time_point firstChange = it->second.key.firstChange;
+  queue_.erase(it->second.key);
+  entries_.erase(it);
+  running_.insert(filePath);
+  return firstChange;
+}
+
+void ReindexScheduler::startWorker() {
+  if (worker_.joinable() || options_.cpuBudget <= 0) return;
+  worker_ = std::thread([this] { work(); });
+}
+
+void ReindexScheduler::run(const std::string& filePath, Clock::time_point firstChange,
+                           bool background) {
+  reindex_(filePath);
+  Clock::time_point now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_.erase(filePath);
+    stats_.processed++;
+    if (background) stats_.backgroundProcessed++;
+    stats_.lastLagMs = std::chrono::duration<double, std::milli>(now - firstChange).count();
+  }
+  changed_.notify_all();
+}
+
+size_t ReindexScheduler::flush(const std::vector<std::string>& filePaths) {
+  size_t flushed = 0;
+  for (const auto& filePath : filePaths) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [&] { return running_.count(filePath) == 0; });
+    if (entries_.find(filePath) == entries_.end()) continue;
+    Clock::time_point firstChange = take(filePath);
+    lock.unlock();
+    run(filePath, firstChange, false);
+    flushed++;
+  }
+  return flushed;
+}
+
+size_t ReindexScheduler::flushAll() {
+  size_t flushed = 0;
+  for (;;) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.empty()) {
+      // Files the worker has in hand count as not yet reindexed.
+      changed_.wait(lock, [&] { return running_.empty() || !queue_.empty(); });
+      if (queue_.empty()) return flushed;
+    }
+    auto next = std::find_if(queue_.begin(), queue_.end(),
+                             [&](const Key& key) { return running_.count(key.filePath) == 0; });
+    if (next == queue_.end()) {
+      // Each queued file is being reindexed already and changed again since.
+      changed_.wait(lock);
+      continue;
+    }
+    std::string filePath = next->filePath;
+    Clock::time_point firstChange = take(filePath);
+    lock.unlock();
+    run(filePath, firstChange, false);
+    flushed++;
+  }
+}
+
+bool ReindexScheduler::isQueued(const std::string& filePath) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.find(filePath) != entries_.end();
+}
+
+ReindexSchedulerStats ReindexScheduler::stats() const {
+  Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReindexSchedulerStats stats = stats_;
+  stats.queueDepth = entries_.size();
+  for (auto it = queue_.begin(); it != queue_.end() && it->priority > 0; ++it) stats.prioritized++;
+  for (const auto& pair : entries_) {
+    double lag = std::chrono::duration<double, std::milli>(now - pair.second.key.firstChange).count();
+    stats.oldestLagMs = std::max(stats.oldestLagMs, lag);
+  }
+  return stats;
+}
+
+void ReindexScheduler::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (options_.cpuBudget <= 0 || queue_.empty()) {
+      changed_.wait(lock);
+      continue;
+    }
+
+    // The first file in priority order that has been quiet long enough.
+    Clock::time_point now = Clock::now();
+    std::chrono::milliseconds debounce(options_.debounceMs);
+    const Key* due = nullptr;
+    Clock::time_point wake = Clock::time_point::max();
+    for (const Key& key : queue_) {
+      if (running_.count(key.filePath)) continue;
+      Clock::time_point ready = entries_.at(key.filePath).lastChange + debounce;
+      if (ready <= now) {
+        due = &key;
+        break;
+      }
+      wake = std::min(wake, ready);
+    }
+    if (!due) {
+      if (wake == Clock::time_point::max()) {
+        changed_.wait(lock);
+      } else {
+        changed_.wait_until(lock, wake);
+      }
+      continue;
+    }
+
+    std::string filePath = due->filePath;
+    Clock::time_point firstChange = take(filePath);
+    lock.unlock();
+    Clock::time_point start = Clock::now();
+    run(filePath, firstChange, true);
+    Clock::duration busy = Clock::now() - start;
+    lock.lock();
+
+    // Idle long enough that busy time stays at cpuBudget of the wall clock.
+    double budget = options_.cpuBudget;
+    if (budget > 0 && budget < 1) {
+      auto pause = std::chrono::duration_cast<Clock::duration>(busy * ((1 - budget) / budget));
+      changed_.wait_for(lock, pause, [this] { return stopping_; });
+    }
+  }
+}
+
+}  // namespace prism
@@ -0,0 +1,100 @@
+#ifndef REINDEX_SCHEDULER_H
+#define REINDEX_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace prism {
+
+struct ReindexSchedulerOptions {
+  uint32_t debounceMs = 100;  // Quiet time after a file's last change before it is picked up
+  double cpuBudget = 0.25;    // Share of one core the background worker may use; 0 disables it
+};
+
+struct ReindexSchedulerStats {
+  size_t queueDepth = 0;
+  size_t prioritized = 0;     // Queued files a query raised
+  double oldestLagMs = 0;     // Since the longest-waiting queued file was first changed
+  double lastLagMs = 0;       // From first change to reindexed, for the last file processed
+  size_t processed = 0;
+  size_t backgroundProcessed = 0;
+  size_t coalesced = 0;       // Changes to files that were already queued
+};
+
+// Queue of files waiting to be reindexed. Files are ordered by priority, then
+// by when they first changed; a worker thread drains the queue once each
+// file has been quiet for debounceMs, sleeping between files to stay within
+// cpuBudget. Queries call flush for the files they are about to read, which
+// reindexes them on the caller's thread without waiting for the debounce.
+class ReindexScheduler {
+ public:
+  using Reindex = std::function<void(const std::string& filePath)>;
+
+  explicit ReindexScheduler(Reindex reindex);
+  ~ReindexScheduler();
+
+  ReindexScheduler(const ReindexScheduler&) = delete;
+  ReindexScheduler& operator=(const ReindexScheduler&) = delete;
+
+  void setOptions(const ReindexSchedulerOptions& options);
+  ReindexSchedulerOptions options() const;
+
+  // Queues files, or restarts their debounce when already queued.
+  void enqueue(const std::vector<std::string>& filePaths);
+  // Moves queued files ahead of everything raised earlier. Files that are
+  // not queued are ignored.
+  void prioritize(const std::vector<std::string>& filePaths);
+  // Reindexes whichever of filePaths are queued now, and waits for any the
+  // worker is already processing. Returns files reindexed here.
+  size_t flush(const std::vector<std::string>& filePaths);
+  size_t flushAll();
+
+  bool isQueued(const std::string& filePath) const;
+  ReindexSchedulerStats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Key {
+    uint64_t priority;  // Higher first; 0 until a query raises the file
+    Clock::time_point firstChange;
+    std::string filePath;
+    bool operator<(const Key& other) const;
+  };
+  struct Entry {
+    Key key;
+    Clock::time_point lastChange;
+  };
+
+  Reindex reindex_;
+  mutable std::mutex mutex_;
+  std::condition_variable changed_;
+  ReindexSchedulerOptions options_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::set<Key> queue_;
+  std::unordered_set<std::string> running_;
+  uint64_t nextPriority_ = 1;
+  bool stopping_ = false;
+  ReindexSchedulerStats stats_;
+  std::thread worker_;
+
+  // Takes filePath off the queue and marks it running. Caller holds mutex_.
+  Clock::time_point take(const std::string& filePath);
+  // Caller holds mutex_.
+  void startWorker();
+  void run(const std::string& filePath, Clock::time_point firstChange, bool background);
+  void work();
+};
+
+}  // namespace prism
+
+#endif  // REINDEX_SCHEDULER_H
@@ -0,0 +1,662 @@
+#include "skeleton.h"
+#include <cctype>
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
+#include "syntax_tree.h"
+#include "tree_cache.h"
+
+namespace prism {
+
+namespace {
+
+constexpr size_t kDefaultSignatureLength = 50;
+
+bool isType(TSNode node, const char* type) {
+  return strcmp(ts_node_type(node), type) == 0;
+}
+
+TSNode field(TSNode node, const char* name) {
+  return ts_node_child_by_field_name(node, name, static_cast<uint32_t>(strlen(name)));
+}
+
+bool hasChildOfType(TSNode node, const char* type) {
+  uint32_t count = ts_node_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    if (isType(ts_node_child(node, i), type)) return true;
+  }
+  return false;
+}
+
+template <typename Fn>
+void forEachNamedChild(TSNode node, Fn&& fn) {
+  uint32_t count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < count; i++) fn(ts_node_named_child(node, i));
+}
+
+template <typename Fn>
+void forEachFieldChild(TSNode node, const char* name, Fn&& fn) {
+  TSTreeCursor cursor = ts_tree_cursor_new(node);
+  if (ts_tree_cursor_goto_first_child(&cursor)) {
+    do {
+      const char* current = ts_tree_cursor_current_field_name(&cursor);
+      if (current && strcmp(current, name) == 0) fn(ts_tree_cursor_current_node(&cursor));
+    } while (ts_tree_cursor_goto_next_sibling(&cursor));
+  }
+  ts_tree_cursor_delete(&cursor);
+}
+
+std::string stripQuotes(std::string_view text) {
+  if (text.size() >= 2 && (text.front() == '"' || text.front() == '\'' || text.front() == '`') &&
+      text.back() == text.front()) {
+    text = text.substr(1, text.size() - 2);
+  }
+  return std::string(text);
+}
+
+// `Promise<User>` -> `Promise`, as the TypeScript tools report return types.
+std::string withoutTypeArguments(std::string_view type) {
+  size_t open = type.find('<');
+  if (open == 0 || open == std::string_view::npos || type.back() != '>') return std::string(type);
+  for (size_t i = 0; i < open; i++) {
+    unsigned char c = static_cast<unsigned char>(type[i]);
+    if (!isalnum(c) && c != '_') return std::string(type);
+  }
+  return std::string(type.substr(0, open));
+}
+
+// At most limit bytes of text, not ending inside a UTF-8 sequence.
+std::string prefix(std::string_view text, size_t limit) {
+  if (text.size() <= limit) return std::string(text);
+  while (limit > 0 && (static_cast<unsigned char>(text[limit]) & 0xc0) == 0x80) limit--;
+  return std::string(text.substr(0, limit));
+}
+
+Visibility visibilityOf(std::string_view text) {
+  if (text == "public") return Visibility::Public;
+  if (text == "private") return Visibility::Private;
+  if (text == "protected") return Visibility::Protected;
+  return Visibility::None;
+}
+
+// extractSkeleton in src/tools/get_skeleton.ts applies the same rules to files
+// the index has not seen; a change here belongs there too.
+class SkeletonBuilder {
+ public:
+  explicit SkeletonBuilder(const SyntaxTree& tree) : tree_(tree) {}
+
+  FileSkeleton build() {
+    TSNode root = tree_.root();
+    if (tree_.language() == LanguageId::Python) {
+      forEachNamedChild(root, [&](TSNode statement) { pythonStatement(statement); });
+    } else {
+      forEachNamedChild(root, [&](TSNode statement) { typeScriptStatement(statement); });
+    }
+    return std::move(skeleton_);
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  FileSkeleton skeleton_;
+
+  std::string text(TSNode node) const {
+    return ts_node_is_null(node) ? std::string() : std::string(tree_.text(node));
+  }
+
+  // The type inside a `: Type` annotation.
+  std::string annotatedType(TSNode annotation) const {
+    if (ts_node_is_null(annotation)) return std::string();
+    if (!isType(annotation, "type_annotation")) return text(annotation);
+    return ts_node_named_child_count(annotation) > 0 ? text(ts_node_named_child(annotation, 0))
+                                                     : std::string();
+  }
+
+  std::string decorator(TSNode node) const {
+    TSNode expression = ts_node_named_child(node, 0);
+    return ts_node_is_null(expression) ? text(node) : text(expression);
+  }
+
+  // TypeScript and JavaScript
+
+  void typeScriptStatement(TSNode node) {
+    if (isType(node, "import_statement")) {
+      skeleton_.imports.push_back(typeScriptImport(node));
+    } else if (isType(node, "export_statement")) {
+      typeScriptExport(node);
+    } else {
+      typeScriptDeclaration(node, 0);
+    }
+  }
+
+  SkeletonImport typeScriptImport(TSNode node) {
+    SkeletonImport imported;
+    imported.source = stripQuotes(text(field(node, "source")));
+    forEachNamedChild(node, [&](TSNode clause) {
+      if (!isType(clause, "import_clause")) return;
+      forEachNamedChild(clause, [&](TSNode child) {
+        if (isType(child, "identifier")) {
+          imported.imported.emplace_back(text(child), std::string());
+          imported.isDefault = true;
+        } else if (isType(child, "namespace_import")) {
+          forEachNamedChild(child, [&](TSNode name) {
+            if (isType(name, "identifier")) imported.imported.emplace_back(text(name), "");
+          });
+          imported.isNamespace = true;
+        } else if (isType(child, "named_imports")) {
+          forEachNamedChild(child, [&](TSNode specifier) {
+            if (!isType(specifier, "import_specifier")) return;
+            imported.imported.emplace_back(text(field(specifier, "name")),
+                                           text(field(specifier, "alias")));
+          });
+        }
+      });
+    });
+    return imported;
+  }
+
+  // Adds the declaration node to the skeleton, when it is one.
+  void typeScriptDeclaration(TSNode node, uint8_t flags) {
+    if (isType(node, "class_declaration") || isType(node, "abstract_class_declaration")) {
+      skeleton_.items.push_back(typeScriptClass(node, flags));
+    } else if (isType(node, "function_declaration") ||
+               isType(node, "generator_function_declaration")) {
+      skeleton_.items.push_back(typeScriptFunction(node, SkeletonKind::Function, flags));
+    } else if (isType(node, "lexical_declaration") || isType(node, "variable_declaration")) {
+      // Only exported variables belong to the outline.
+      if (!(flags & kSkeletonExported)) return;
+      if (hasChildOfType(node, "const")) flags |= kSkeletonConst;
+      forEachNamedChild(node, [&](TSNode declarator) {
+        if (!isType(declarator, "variable_declarator")) return;
+        SkeletonItem variable;
+        variable.kind = SkeletonKind::Variable;
+        variable.flags = flags;
+        variable.name = text(field(declarator, "name"));
+        variable.type = annotatedType(field(declarator, "type"));
+        skeleton_.items.push_back(std::move(variable));
+      });
+    } else if (isType(node, "interface_declaration")) {
+      skeleton_.items.push_back(typeScriptInterface(node, flags));
+    } else if (isType(node, "enum_declaration")) {
+      skeleton_.items.push_back(typeScriptEnum(node, flags));
+    } else if (isType(node, "type_alias_declaration")) {
+      SkeletonItem alias;
+      alias.kind = SkeletonKind::TypeAlias;
+      alias.flags = flags;
+      alias.name = text(field(node, "name"));
+      alias.type = text(field(node, "value"));
+      skeleton_.items.push_back(std::move(alias));
+    }
+  }
+
+  void typeScriptExport(TSNode node) {
+    uint8_t flags = kSkeletonExported;
+    if (hasChildOfType(node, "default")) flags |= kSkeletonDefault;
+    TSNode declaration = field(node, "declaration");
+    if (!ts_node_is_null(declaration)) typeScriptDeclaration(declaration, flags);
+    forEachNamedChild(node, [&](TSNode clause) {
+      if (!isType(clause, "export_clause")) return;
+      forEachNamedChild(clause, [&](TSNode specifier) {
+        if (!isType(specifier, "export_specifier")) return;
+        SkeletonItem variable;
+        variable.kind = SkeletonKind::Variable;
+        variable.flags = kSkeletonExported;
+        variable.name = text(field(specifier, "name"));
+        variable.alias = text(field(specifier, "alias"));
+        skeleton_.items.push_back(std::move(variable));
+      });
+    });
+    surfaceOf(node, flags & kSkeletonDefault);
+  }
+
+  SkeletonItem typeScriptClass(TSNode node, uint8_t flags) {
+    SkeletonItem cls;
+    cls.kind = SkeletonKind::Class;
+    cls.flags = flags;
+    if (isType(node, "abstract_class_declaration")) cls.flags |= kSkeletonAbstract;
+    cls.name = text(field(node, "name"));
+    forEachNamedChild(node, [&](TSNode child) {
+      if (isType(child, "decorator")) {
+        cls.decorators.push_back(decorator(child));
+      } else if (isType(child, "class_heritage")) {
+        forEachNamedChild(child, [&](TSNode clause) {
+          if (isType(clause, "extends_clause")) {
+            TSNode value = field(clause, "value");
+            if (ts_node_is_null(value)) value = ts_node_named_child(clause, 0);
+            cls.extends = text(value);
+          } else if (isType(clause, "implements_clause")) {
+            forEachNamedChild(clause, [&](TSNode type) { cls.bases.push_back(text(type)); });
+          }
+        });
+      }
+    });
+
+    // Member decorators precede their member in the class body.
+    std::vector<std::string> decorators;
+    forEachNamedChild(field(node, "body"), [&](TSNode member) {
+      if (isType(member, "decorator")) {
+        decorators.push_back(decorator(member));
+        return;
+      }
+      SkeletonItem item;
+      if (isType(member, "method_definition")) {
+        item = typeScriptFunction(member, SkeletonKind::Method, 0);
+        if (item.name == "constructor") item.kind = SkeletonKind::Constructor;
+      } else if (isType(member, "method_signature") ||
+                 isType(member, "abstract_method_signature")) {
+        item = typeScriptFunction(member, SkeletonKind::Method, 0);
+        if (isType(member, "abstract_method_signature")) item.flags |= kSkeletonAbstract;
+      } else if (isType(member, "public_field_definition") ||
+                 isType(member, "field_definition")) {
+        item = typeScriptProperty(member);
+      } else {
+        decorators.clear();
+        return;
+      }
+      for (auto& name : decorators) item.decorators.push_back(std::move(name));
+      decorators.clear();
+      cls.members.push_back(std::move(item));
+    });
+    return cls;
+  }
+
+  uint8_t modifierFlags(TSNode node, Visibility& visibility) const {
+    uint8_t flags = 0;
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+      TSNode child = ts_node_child(node, i);
+      if (isType(child, "accessibility_modifier")) {
+        visibility = visibilityOf(tree_.text(child));
+      } else if (isType(child, "static")) {
+        flags |= kSkeletonStatic;
+      } else if (isType(child, "readonly")) {
+        flags |= kSkeletonReadonly;
+      } else if (isType(child, "async")) {
+        flags |= kSkeletonAsync;
+      } else if (isType(child, "*")) {
+        flags |= kSkeletonGenerator;
+      } else if (isType(child, "abstract")) {
+        flags |= kSkeletonAbstract;
+      }
+    }
+    return flags;
+  }
+
+  SkeletonItem typeScriptProperty(TSNode node) {
+    SkeletonItem property;
+    property.kind = SkeletonKind::Property;
+    property.flags = modifierFlags(node, property.visibility);
+    TSNode name = field(node, "name");
+    if (ts_node_is_null(name)) name = field(node, "property");
+    property.name = text(name);
+    property.type = annotatedType(field(node, "type"));
+    return property;
+  }
+
+  // Functions, methods and signatures.
+  SkeletonItem typeScriptFunction(TSNode node, SkeletonKind kind, uint8_t flags) {
+    SkeletonItem function;
+    function.kind = kind;
+    function.flags = flags | modifierFlags(node, function.visibility);
+    if (isType(node, "generator_function_declaration")) function.flags |= kSkeletonGenerator;
+    function.name = text(field(node, "name"));
+    function.parameters = typeScriptParameters(field(node, "parameters"));
+    function.type = withoutTypeArguments(annotatedType(field(node, "return_type")));
+    return function;
+  }
+
+  std::vector<SkeletonParameter> typeScriptParameters(TSNode node) {
+    std::vector<SkeletonParameter> parameters;
+    if (ts_node_is_null(node)) return parameters;
+    forEachNamedChild(node, [&](TSNode child) {
+      SkeletonParameter parameter;
+      if (isType(child, "required_parameter") || isType(child, "optional_parameter")) {
+        parameter.name = text(field(child, "pattern"));
+        parameter.type = annotatedType(field(child, "type"));
+        parameter.defaultValue = text(field(child, "value"));
+      } else if (isType(child, "assignment_pattern")) {
+        parameter.name = text(field(child, "left"));
+        parameter.defaultValue = text(field(child, "right"));
+      } else if (isType(child, "identifier") || isType(child, "rest_pattern") ||
+                 isType(child, "object_pattern") || isType(child, "array_pattern")) {
+        parameter.name = text(child);
+      } else {
+        return;
+      }
+      parameters.push_back(std::move(parameter));
+    });
+    return parameters;
+  }
+
+  SkeletonItem typeScriptInterface(TSNode node, uint8_t flags) {
+    SkeletonItem iface;
+    iface.kind = SkeletonKind::Interface;
+    iface.flags = flags;
+    iface.name = text(field(node, "name"));
+    forEachNamedChild(node, [&](TSNode child) {
+      if (isType(child, "extends_type_clause") || isType(child, "extends_clause")) {
+        forEachNamedChild(child, [&](TSNode type) { iface.bases.push_back(text(type)); });
+      }
+    });
+    forEachNamedChild(field(node, "body"), [&](TSNode member) {
+      if (isType(member, "property_signature")) {
+        SkeletonItem property;
+        property.kind = SkeletonKind::Property;
+        property.name = text(field(member, "name"));
+        property.type = annotatedType(field(member, "type"));
+        iface.members.push_back(std::move(property));
+      } else if (isType(member, "method_signature") || isType(member, "call_signature")) {
+        SkeletonItem method;
+        method.kind = SkeletonKind::Method;
+        method.name = text(field(member, "name"));
+        method.parameters = typeScriptParameters(field(member, "parameters"));
+        method.type = annotatedType(field(member, "return_type"));
+        iface.members.push_back(std::move(method));
+      }
+    });
+    return iface;
+  }
+
+  SkeletonItem typeScriptEnum(TSNode node, uint8_t flags) {
+    SkeletonItem enumeration;
+    enumeration.kind = SkeletonKind::Enum;
+    enumeration.flags = flags;
+    enumeration.name = text(field(node, "name"));
+    forEachNamedChild(field(node, "body"), [&](TSNode member) {
+      SkeletonItem item;
+      item.kind = SkeletonKind::EnumMember;
+      if (isType(member, "enum_assignment")) {
+        item.name = text(field(member, "name"));
+        TSNode value = field(member, "value");
+        item.type = isType(value, "string") ? stripQuotes(tree_.text(value)) : text(value);
+      } else if (isType(member, "property_identifier") || isType(member, "string")) {
+        item.name = stripQuotes(tree_.text(member));
+      } else {
+        return;
+      }
+      enumeration.members.push_back(std::move(item));
+    });
+    return enumeration;
+  }
+
+  // The names an export statement adds to the public surface.
+  void surfaceOf(TSNode node, bool isDefault) {
+    auto add = [&](std::string name, const char* type) -> SurfaceItem& {
+      SurfaceItem item;
+      item.name = std::move(name);
+      item.type = type;
+      skeleton_.surface.push_back(std::move(item));
+      return skeleton_.surface.back();
+    };
+    auto exportedName = [&](TSNode specifier) {
+      TSNode alias = field(specifier, "alias");
+      return text(ts_node_is_null(alias) ? field(specifier, "name") : alias);
+    };
+
+    TSNode source = field(node, "source");
+    if (!ts_node_is_null(source)) {
+      std::string module = stripQuotes(tree_.text(source));
+      if (hasChildOfType(node, "*")) {
+        add("*", "re-export").source = module;
+      }
+      forEachNamedChild(node, [&](TSNode child) {
+        if (isType(child, "namespace_export")) {
+          add(text(ts_node_named_child(child, 0)), "re-export").source = module;
+        } else if (isType(child, "export_clause")) {
+          forEachNamedChild(child, [&](TSNode specifier) {
+            if (isType(specifier, "export_specifier")) {
+              add(exportedName(specifier), "re-export").source = module;
+            }
+          });
+        }
+      });
+      return;
+    }
+
+    TSNode declaration = field(node, "declaration");
+    if (!ts_node_is_null(declaration)) {
+      std::string name = text(field(declaration, "name"));
+      if (name.empty()) name = "default";
+      if (isType(declaration, "lexical_declaration") ||
+          isType(declaration, "variable_declaration")) {
+        forEachNamedChild(declaration, [&](TSNode declarator) {
+          if (isType(declarator, "variable_declarator")) {
+            add(text(field(declarator, "name")), "variable").isDefault = isDefault;
+          }
+        });
+      } else if (isType(declaration, "function_declaration") ||
+                 isType(declaration, "generator_function_declaration")) {
+        SurfaceItem& item = add(std::move(name), "function");
+        item.isDefault = isDefault;
+        item.signature = text(field(declaration, "parameters")) +
+                         text(field(declaration, "return_type"));
+      } else if (isType(declaration, "class_declaration") ||
+                 isType(declaration, "abstract_class_declaration")) {
+        SurfaceItem& item = add(std::move(name), "class");
+        item.isDefault = isDefault;
+        item.members = publicMembers(field(declaration, "body"));
+      } else if (isType(declaration, "interface_declaration")) {
+        SurfaceItem& item = add(std::move(name), "interface");
+        item.isDefault = isDefault;
+        item.members = publicMembers(field(declaration, "body"));
+      } else if (isType(declaration, "type_alias_declaration")) {
+        add(std::move(name), "type").isDefault = isDefault;
+      }
+      return;
+    }
+
+    bool listed = false;
+    forEachNamedChild(node, [&](TSNode clause) {
+      if (!isType(clause, "export_clause")) return;
+      listed = true;
+      forEachNamedChild(clause, [&](TSNode specifier) {
+        if (isType(specifier, "export_specifier")) {
+          add(exportedName(specifier), "variable").signature = "unknown";
+        }
+      });
+    });
+    if (listed || !isDefault) return;
+
+    TSNode value = field(node, "value");
+    if (ts_node_is_null(value)) {
+      forEachNamedChild(node, [&](TSNode child) {
+        if (ts_node_is_null(value) && !isType(child, "comment")) value = child;
+      });
+    }
+    if (ts_node_is_null(value)) return;
+    SurfaceItem& item = add("default", "unknown");
+    item.isDefault = true;
+    item.signature = prefix(tree_.text(value), kDefaultSignatureLength);
+  }
+
+  std::vector<std::string> publicMembers(TSNode body) {
+    std::vector<std::string> members;
+    forEachNamedChild(body, [&](TSNode member) {
+      if (!isType(member, "method_definition") && !isType(member, "public_field_definition") &&
+          !isType(member, "field_definition") && !isType(member, "property_signature") &&
+          !isType(member, "method_signature")) {
+        return;
+      }
+      Visibility visibility = Visibility::None;
+      modifierFlags(member, visibility);
+      if (visibility == Visibility::Private || visibility == Visibility::Protected) return;
+      TSNode name = field(member, "name");
+      if (ts_node_is_null(name)) name = field(member, "property");
+      if (ts_node_is_null(name) || isType(name, "private_property_identifier")) return;
+      members.push_back(text(name));
+    });
+    return members;
+  }
+
+  // Python
+
+  void pythonStatement(TSNode node) {
+    if (isType(node, "import_statement") || isType(node, "import_from_statement")) {
+      skeleton_.imports.push_back(pythonImport(node));
+    } else if (isType(node, "class_definition")) {
+      skeleton_.items.push_back(pythonClass(node, {}));
+    } else if (isType(node, "function_definition")) {
+      skeleton_.items.push_back(pythonFunction(node, SkeletonKind::Function, {}));
+    } else if (isType(node, "decorated_definition")) {
+      std::vector<std::string> decorators;
+      forEachNamedChild(node, [&](TSNode child) {
+        if (isType(child, "decorator")) decorators.push_back(decorator(child));
+      });
+      TSNode definition = field(node, "definition");
+      if (isType(definition, "class_definition")) {
+        skeleton_.items.push_back(pythonClass(definition, std::move(decorators)));
+      } else if (isType(definition, "function_definition")) {
+        skeleton_.items.push_back(
+            pythonFunction(definition, SkeletonKind::Function, std::move(decorators)));
+      }
+    } else if (isType(node, "expression_statement")) {
+      TSNode assignment = ts_node_named_child(node, 0);
+      if (ts_node_is_null(assignment) || !isType(assignment, "assignment")) return;
+      TSNode left = field(assignment, "left");
+      if (!isType(left, "identifier") && !isType(left, "attribute")) return;
+      SkeletonItem variable;
+      variable.kind = SkeletonKind::Variable;
+      variable.name = text(left);
+      variable.type = text(field(assignment, "type"));
+      skeleton_.items.push_back(std::move(variable));
+    }
+  }
+
+  SkeletonImport pythonImport(TSNode node) {
+    SkeletonImport imported;
+    auto addName = [&](TSNode name) {
+      if (isType(name, "aliased_import")) {
+        imported.imported.emplace_back(text(field(name, "name")), text(field(name, "alias")));
+      } else {
+        imported.imported.emplace_back(text(name), std::string());
+      }
+    };
+    forEachFieldChild(node, "name", addName);
+    if (isType(node, "import_statement")) {
+      // import os.path as p
+      if (!imported.imported.empty()) imported.source = imported.imported.front().first;
+    } else {
+      imported.source = text(field(node, "module_name"));
+      if (hasChildOfType(node, "wildcard_import")) imported.imported.emplace_back("*", "");
+    }
+    return imported;
+  }
+
+  SkeletonItem pythonClass(TSNode node, std::vector<std::string> decorators) {
+    SkeletonItem cls;
+    cls.kind = SkeletonKind::Class;
+    cls.name = text(field(node, "name"));
+    cls.decorators = std::move(decorators);
+    forEachNamedChild(field(node, "superclasses"), [&](TSNode base) {
+      if (!isType(base, "identifier") && !isType(base, "attribute")) return;
+      if (!cls.extends.empty()) cls.extends += ", ";
+      cls.extends += tree_.text(base);
+    });
+
+    std::unordered_set<std::string> properties;
+    forEachNamedChild(field(node, "body"), [&](TSNode member) {
+      std::vector<std::string> memberDecorators;
+      if (isType(member, "decorated_definition")) {
+        forEachNamedChild(member, [&](TSNode child) {
+          if (isType(child, "decorator")) memberDecorators.push_back(decorator(child));
+        });
+        member = field(member, "definition");
+      }
+      if (!isType(member, "function_definition")) return;
+      SkeletonItem method =
+          pythonFunction(member, SkeletonKind::Method, std::move(memberDecorators));
+      if (method.name == "__init__") {
+        // Attributes assigned to self in __init__ are the instance's properties.
+        forEachNamedChild(field(member, "body"), [&](TSNode statement) {
+          TSNode assignment = ts_node_named_child(statement, 0);
+          if (!isType(statement, "expression_statement") || ts_node_is_null(assignment) ||
+              !isType(assignment, "assignment")) {
+            return;
+          }
+          TSNode left = field(assignment, "left");
+          if (!isType(left, "attribute") || tree_.text(field(left, "object")) != "self") return;
+          std::string name = text(field(left, "attribute"));
+          if (!properties.insert(name).second) return;
+          SkeletonItem property;
+          property.kind = SkeletonKind::Property;
+          property.name = std::move(name);
+          property.type = text(field(assignment, "type"));
+          cls.members.push_back(std::move(property));
+        });
+      }
+      cls.members.push_back(std::move(method));
+    });
+    return cls;
+  }
+
+  SkeletonItem pythonFunction(TSNode node, SkeletonKind kind,
+                              std::vector<std::string> decorators) {
+    SkeletonItem function;
+    function.kind = kind;
+    function.name = text(field(node, "name"));
+    function.type = text(field(node, "return_type"));
+    if (hasChildOfType(node, "async")) function.flags |= kSkeletonAsync;
+    for (const auto& name : decorators) {
+      if (name == "staticmethod" || name == "classmethod") function.flags |= kSkeletonStatic;
+    }
+    function.decorators = std::move(decorators);
+    bool isMethod = kind == SkeletonKind::Method;
+    forEachNamedChild(field(node, "parameters"), [&](TSNode child) {
+      SkeletonParameter parameter;
+      if (isType(child, "identifier") || isType(child, "list_splat_pattern") ||
+          isType(child, "dictionary_splat_pattern")) {
+        parameter.name = text(child);
+      } else if (isType(child, "typed_parameter")) {
+        parameter.name = text(ts_node_named_child(child, 0));
+        parameter.type = text(field(child, "type"));
+      } else if (isType(child, "default_parameter") ||
+                 isType(child, "typed_default_parameter")) {
+        parameter.name = text(field(child, "name"));
+        parameter.type = text(field(child, "type"));
+        parameter.defaultValue = text(field(child, "value"));
+      } else {
+        return;
+      }
+      if (isMethod && parameter.name == "self") return;
+      function.parameters.push_back(std::move(parameter));
+    });
+    return function;
+  }
+};
+
+size_t itemBytes(const SkeletonItem& item) {
+  size_t bytes = sizeof(SkeletonItem) + heapBytes(item.name) + heapBytes(item.type) +
+                 heapBytes(item.extends) + heapBytes(item.alias);
+  for (const auto& base : item.bases) bytes += sizeof(std::string) + heapBytes(base);
+  for (const auto& name : item.decorators) bytes += sizeof(std::string) + heapBytes(name);
+  for (const auto& parameter : item.parameters) {
+    bytes += sizeof(SkeletonParameter) + heapBytes(parameter.name) + heapBytes(parameter.type) +
+             heapBytes(parameter.defaultValue);
+  }
+  for (const auto& member : item.members) bytes += itemBytes(member);
+  return bytes;
+}
+
+}  // namespace
+
+FileSkeleton extractSkeleton(const SyntaxTree& tree) {
+  return SkeletonBuilder(tree).build();
+}
+
+size_t skeletonBytes(const FileSkeleton& skeleton) {
+  size_t bytes = sizeof(FileSkeleton);
+  for (const auto& imported : skeleton.imports) {
+    bytes += sizeof(SkeletonImport) + heapBytes(imported.source);
+    for (const auto& name : imported.imported) {
+      bytes += sizeof(name) + heapBytes(name.first) + heapBytes(name.second);
+    }
+  }
+  for (const auto& item : skeleton.items) bytes += itemBytes(item);
+  for (const auto& item : skeleton.surface) {
+    bytes += sizeof(SurfaceItem) + heapBytes(item.name) + heapBytes(item.type) +
+             heapBytes(item.signature) + heapBytes(item.source);
+    for (const auto& member : item.members) bytes += sizeof(std::string) + heapBytes(member);
+  }
+  return bytes;
+}
+
+}  // namespace prism
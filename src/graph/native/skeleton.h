@@ -0,0 +1,96 @@
+#ifndef SKELETON_H
+#define SKELETON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace prism {
+
+class SyntaxTree;
+
+enum class SkeletonKind : uint8_t {
+  Class,
+  Function,
+  Interface,
+  Enum,
+  TypeAlias,
+  Variable,
+  // Members
+  Method,
+  Property,
+  Constructor,
+  EnumMember,
+};
+
+enum class Visibility : uint8_t { None, Public, Private, Protected };
+
+enum SkeletonFlag : uint8_t {
+  kSkeletonExported = 1 << 0,
+  kSkeletonDefault = 1 << 1,
+  kSkeletonAsync = 1 << 2,
+  kSkeletonGenerator = 1 << 3,
+  kSkeletonStatic = 1 << 4,
+  kSkeletonReadonly = 1 << 5,
+  kSkeletonConst = 1 << 6,
+  kSkeletonAbstract = 1 << 7,
+};
+
+struct SkeletonParameter {
+  std::string name;
+  std::string type;
+  std::string defaultValue;
+};
+
+// A declaration or member, in the shape get_skeleton reports.
+struct SkeletonItem {
+  SkeletonKind kind = SkeletonKind::Variable;
+  Visibility visibility = Visibility::None;
+  uint8_t flags = 0;  // SkeletonFlag bits
+  std::string name;
+  // Return type of functions and methods, type of properties and variables,
+  // definition of type aliases, value of enum members.
+  std::string type;
+  std::string extends;               // Class; Python superclasses joined with ", "
+  std::vector<std::string> bases;    // Class implements; interface extends
+  std::string alias;                 // `export { name as alias }`
+  std::vector<std::string> decorators;
+  std::vector<SkeletonParameter> parameters;
+  std::vector<SkeletonItem> members;  // Class, interface and enum members
+};
+
+struct SkeletonImport {
+  std::string source;
+  std::vector<std::pair<std::string, std::string>> imported;  // Name, alias
+  bool isDefault = false;
+  bool isNamespace = false;
+};
+
+// One name of a TypeScript/JavaScript module's public surface, in the shape
+// get_public_surface reports before re-exports are followed.
+struct SurfaceItem {
+  std::string name;
+  std::string type;  // "function", "class", "variable", "interface", "type", "re-export", "unknown"
+  std::string signature;             // Empty when there is none
+  std::vector<std::string> members;  // Public members of classes and interfaces
+  std::string source;                // Re-exports
+  bool isDefault = false;
+};
+
+// The outline of one file: what get_skeleton and get_public_surface return,
+// computed once per parse so those tools are lookups.
+struct FileSkeleton {
+  std::vector<SkeletonImport> imports;
+  std::vector<SkeletonItem> items;  // Top-level declarations in source order
+  std::vector<SurfaceItem> surface;
+};
+
+FileSkeleton extractSkeleton(const SyntaxTree& tree);
+// Measured heap and inline size.
+size_t skeletonBytes(const FileSkeleton& skeleton);
+
+}  // namespace prism
+
+#endif  // SKELETON_H
@@ -0,0 +1,196 @@
+#include "source_buffer.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+namespace prism {
+
+namespace {
+
+struct LoadedSource {
+  std::weak_ptr<const SourceBuffer> buffer;
+  FileStamp stamp;
+};
+
+struct SourceRegistry {
+  std::mutex mutex;
+  std::unordered_map<std::string, LoadedSource> byPath;
+  std::unordered_map<const char*, std::weak_ptr<const SourceBuffer>> byData;
+  size_t sweepAt = 1024;
+  size_t loads = 0;
+  size_t reuses = 0;
+
+  // Drops entries whose buffers have been freed. Amortized over insertions.
+  void sweep() {
+    for (auto it = byPath.begin(); it != byPath.end();) {
+      it = it->second.buffer.expired() ? byPath.erase(it) : std::next(it);
+    }
+    for (auto it = byData.begin(); it != byData.end();) {
+      it = it->second.expired() ? byData.erase(it) : std::next(it);
+    }
+    sweepAt = std::max<size_t>(1024, byPath.size() * 2);
+  }
+};
+
+SourceRegistry& sourceRegistry() {
+  static SourceRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+FileStamp stampOf(const struct stat& st) {
+  FileStamp stamp;
+  stamp.device = st.st_dev;
+  stamp.inode = st.st_ino;
+  stamp.size = st.st_size;
+#ifdef __APPLE__
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+  return stamp;
+}
+
+FileStamp statStamp(const std::string& filePath) {
+  struct stat st;
+  if (stat(filePath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return FileStamp();
+  return stampOf(st);
+}
+
+uint64_t hashBytes(const char* data, size_t length) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+uint32_t utf16Length(std::string_view bytes) {
+  uint32_t units = 0;
+  for (unsigned char c : bytes) {
+    if ((c & 0xC0) != 0x80) units++;
+    if (c >= 0xF0) units++;
+  }
+  return units;
+}
+
+SourceBuffer::SourceBuffer(std::string bytes) : bytes_(std::move(bytes)) {
+  data_ = bytes_.data();
+  size_ = bytes_.size();
+  hash_ = hashBytes(data_, size_);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromString(std::string bytes) {
+  return std::shared_ptr<const SourceBuffer>(new SourceBuffer(std::move(bytes)));
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromDescriptor(int fd, size_t sizeHint) {
+  // st_size is only a hint for files that grow while being read. Positional
+  // reads keep the result independent of the descriptor's offset.
+  std::string bytes(sizeHint, '\0');
+  size_t filled = 0;
+  for (;;) {
+    if (filled == bytes.size()) bytes.resize(bytes.size() + 4096);
+    ssize_t n = pread(fd, &bytes[filled], bytes.size() - filled, static_cast<off_t>(filled));
+    if (n < 0) return nullptr;
+    if (n == 0) break;
+    filled += static_cast<size_t>(n);
+  }
+  bytes.resize(filled);
+  return fromString(std::move(bytes));
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromFile(const std::string& filePath) {
+  int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  SourceBufferPtr buffer;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) buffer = fromDescriptor(fd, static_cast<size_t>(st.st_size));
+  close(fd);
+  return buffer;
+}
+
+std::string_view SourceBuffer::slice(uint32_t startByte, uint32_t endByte) const {
+  if (startByte > size_) startByte = static_cast<uint32_t>(size_);
+  if (endByte > size_) endByte = static_cast<uint32_t>(size_);
+  if (endByte < startByte) endByte = startByte;
+  return std::string_view(data_ + startByte, endByte - startByte);
+}
+
+SourceBufferPtr loadSource(const std::string& filePath) {
+  SourceRegistry& registry = sourceRegistry();
+  struct stat st;
+  if (stat(filePath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return nullptr;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.byPath.find(filePath);
+    if (it != registry.byPath.end() && it->second.stamp == stampOf(st)) {
+      if (SourceBufferPtr live = it->second.buffer.lock()) {
+        registry.reuses++;
+        return live;
+      }
+    }
+  }
+
+  // Stamp from the descriptor actually read, in case the file was replaced
+  // since the stat above.
+  int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+  SourceBufferPtr buffer;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) buffer = SourceBuffer::fromDescriptor(fd, static_cast<size_t>(st.st_size));
+  close(fd);
+  if (buffer) registerSource(filePath, buffer, st);
+  return buffer;
+}
+
+void registerSource(const std::string& filePath, const SourceBufferPtr& buffer,
+                    const struct stat& st) {
+  SourceRegistry& registry = sourceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.loads++;
+  LoadedSource& entry = registry.byPath[filePath];
+  entry.buffer = buffer;
+  entry.stamp = stampOf(st);
+  if (buffer->size() > 0) registry.byData[buffer->data()] = buffer;
+  if (registry.byPath.size() + registry.byData.size() >= registry.sweepAt) registry.sweep();
+}
+
+FileStamp registeredStamp(const std::string& filePath, const SourceBufferPtr& buffer) {
+  SourceRegistry& registry = sourceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.byPath.find(filePath);
+  if (it == registry.byPath.end() || it->second.buffer.lock() != buffer) return FileStamp();
+  return it->second.stamp;
+}
+
+SourceBufferPtr findLoadedSource(const char* data, size_t size) {
+  if (!data || size == 0) return nullptr;
+  SourceRegistry& registry = sourceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.byData.find(data);
+  if (it == registry.byData.end()) return nullptr;
+  SourceBufferPtr buffer = it->second.lock();
+  if (!buffer || buffer->size() != size) return nullptr;
+  return buffer;
+}
+
+SourceBufferStats sourceBufferStats() {
+  SourceRegistry& registry = sourceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  SourceBufferStats stats{0, 0, registry.loads, registry.reuses};
+  for (const auto& [data, weak] : registry.byData) {
+    SourceBufferPtr buffer = weak.lock();
+    if (!buffer) continue;
+    stats.files++;
+    stats.residentBytes += buffer->size();
+  }
+  return stats;
+}
+
+}  // namespace prism
@@ -0,0 +1,103 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <sys/stat.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace prism {
+
+// FNV-1a over raw bytes. Used as the content key for per-file caches.
+uint64_t hashBytes(const char* data, size_t length);
+
+// Code units the UTF-8 bytes take in UTF-16: one per character, two outside
+// the Basic Multilingual Plane. Converts tree-sitter's byte columns to the
+// columns JS reports.
+uint32_t utf16Length(std::string_view bytes);
+
+// Identity of a file's contents as stat sees them. All zero when unknown.
+struct FileStamp {
+  dev_t device = 0;
+  ino_t inode = 0;
+  off_t size = 0;
+  int64_t mtimeNs = 0;
+
+  bool operator==(const FileStamp& other) const {
+    return device == other.device && inode == other.inode && size == other.size &&
+           mtimeNs == other.mtimeNs;
+  }
+  bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+FileStamp stampOf(const struct stat& st);
+// Zero when filePath cannot be stat'ed or is not a regular file.
+FileStamp statStamp(const std::string& filePath);
+
+// Immutable bytes of one source file. Trees and text slices hold a shared
+// pointer to the same buffer, so a file's contents are stored exactly once.
+// Files are read onto the heap, never mapped: buffers outlive the parse that
+// loaded them, and a mapping would see a file rewritten or truncated in place.
+class SourceBuffer {
+ public:
+  static std::shared_ptr<const SourceBuffer> fromString(std::string bytes);
+  // Null when filePath cannot be opened or read.
+  static std::shared_ptr<const SourceBuffer> fromFile(const std::string& filePath);
+  // Reads the open regular file fd from its start to EOF; sizeHint is its
+  // size as of fstat.
+  static std::shared_ptr<const SourceBuffer> fromDescriptor(int fd, size_t sizeHint);
+
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  std::string_view view() const { return std::string_view(data_, size_); }
+  std::string_view slice(uint32_t startByte, uint32_t endByte) const;
+  uint64_t contentHash() const { return hash_; }
+
+ private:
+  explicit SourceBuffer(std::string bytes);
+
+  std::string bytes_;
+  const char* data_;
+  size_t size_;
+  uint64_t hash_;
+};
+
+using SourceBufferPtr = std::shared_ptr<const SourceBuffer>;
+
+// The buffer for filePath, shared with every other holder while the file is
+// unchanged (same inode, size and mtime). Buffers are only weakly referenced
+// here: a file's bytes stay resident as long as some tree, index entry or JS
+// view holds them. Null when the file cannot be read.
+SourceBufferPtr loadSource(const std::string& filePath);
+
+// Records buffer as filePath's contents as of st, for loadSource to share.
+// Used by readers that load files without going through loadSource.
+void registerSource(const std::string& filePath, const SourceBufferPtr& buffer,
+                    const struct stat& st);
+
+// The stamp filePath had when buffer was read from it, or zero when buffer is
+// not the latest load of filePath (an edit applied in memory, say).
+FileStamp registeredStamp(const std::string& filePath, const SourceBufferPtr& buffer);
+
+// The buffer loadSource returned whose bytes are exactly [data, data + size),
+// if it is still alive. Lets a JS view handed back to the addon be parsed in
+// place instead of copied.
+SourceBufferPtr findLoadedSource(const char* data, size_t size);
+
+struct SourceBufferStats {
+  size_t files;          // Loaded buffers still alive
+  size_t residentBytes;  // Bytes held by live buffers
+  size_t loads;          // Files read
+  size_t reuses;         // loadSource calls served by a live buffer
+};
+
+SourceBufferStats sourceBufferStats();
+
+}  // namespace prism
+
+#endif  // SOURCE_BUFFER_H
@@ -0,0 +1,248 @@
+#include "symbol_classifier.h"
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include "syntax_tree.h"
+
+namespace prism {
+
+namespace {
+
+// Which string a pattern applies to
+enum Channel : uint8_t {
+  kChannelName = 1,
+  kChannelClass = 2,
+  kChannelFile = 4,
+};
+
+enum MatchBit : uint32_t {
+  kMatchFramework = 1u << 0,
+  kMatchReact = 1u << 1,
+  kMatchMagicPrefix = 1u << 2,
+  kMatchMagicSuffix = 1u << 3,
+  kMatchMiddleware = 1u << 4,
+  kMatchConfigFile = 1u << 5,
+};
+
+// Texts are scanned as kBegin + text + kEnd so patterns can be anchored.
+constexpr char kBegin = '\x02';
+constexpr char kEnd = '\x03';
+
+const char* const kReactLifecycleMethods[] = {
+    "constructor", "render", "componentDidMount", "componentDidUpdate", "componentWillUnmount",
+    "componentDidCatch", "getDerivedStateFromProps", "getDerivedStateFromError",
+    "getSnapshotBeforeUpdate", "shouldComponentUpdate", "UNSAFE_componentWillMount",
+    "UNSAFE_componentWillReceiveProps", "UNSAFE_componentWillUpdate",
+};
+
+// FastAPI/Starlette, Django and Express hooks plus Python magic methods;
+// together with the React list this is FRAMEWORK_LIFECYCLE_METHODS.
+const char* const kFrameworkMethods[] = {
+    "dispatch", "__init__", "__call__", "process_request", "process_response", "process_view",
+    "process_exception", "process_template_response", "filter", "errorHandler", "handle", "use",
+    "__str__", "__repr__", "__eq__", "__hash__", "__len__", "__getitem__", "__setitem__",
+    "__delitem__", "__iter__", "__contains__", "__enter__", "__exit__", "__getattr__",
+    "__setattr__", "__delattr__",
+};
+
+const char* const kMiddlewareClassSuffixes[] = {"middleware", "filter", "interceptor", "handler"};
+
+const char* const kConfigFileStems[] = {"config", "settings"};
+const char* const kScriptExtensions[] = {"py", "js", "ts"};
+const char* const kDataExtensions[] = {"json", "yaml", "yml", "toml", "ini"};
+
+// Byte classes: case-folded letters, digits, '_', '.', the two anchors, and
+// everything else. Keeps the dense transition table small.
+constexpr int kClassCount = 41;
+
+struct ByteClasses {
+  std::array<uint8_t, 256> table{};
+  ByteClasses() {
+    for (int c = 'a'; c <= 'z'; c++) {
+      table[c] = static_cast<uint8_t>(1 + c - 'a');
+      table[c - 'a' + 'A'] = table[c];
+    }
+    for (int c = '0'; c <= '9'; c++) table[c] = static_cast<uint8_t>(27 + c - '0');
+    table['_'] = 37;
+    table['.'] = 38;
+    table[static_cast<uint8_t>(kBegin)] = 39;
+    table[static_cast<uint8_t>(kEnd)] = 40;
+  }
+};
+
+struct Output {
+  std::string pattern;  // Anchored, original case
+  uint8_t channels;
+  uint32_t bit;
+  bool exactCase;
+};
+
+class PatternMatcher {
+ public:
+  void add(std::string pattern, uint8_t channels, uint32_t bit, bool exactCase) {
+    uint32_t state = 0;
+    for (char c : pattern) {
+      int cls = classes_.table[static_cast<uint8_t>(c)];
+      if (next_[state][cls] == 0) {
+        next_[state][cls] = static_cast<uint32_t>(next_.size());
+        next_.emplace_back();
+        outputs_.emplace_back();
+      }
+      state = next_[state][cls];
+    }
+    patterns_.push_back({std::move(pattern), channels, bit, exactCase});
+    outputs_[state].push_back(static_cast<uint32_t>(patterns_.size() - 1));
+  }
+
+  // Turns the trie into a complete DFA: failure links are folded into the
+  // transition table and each state inherits the outputs of its failure state.
+  void compile() {
+    std::vector<uint32_t> fail(next_.size(), 0);
+    std::deque<uint32_t> queue;
+    for (int cls = 0; cls < kClassCount; cls++) {
+      if (next_[0][cls] != 0) queue.push_back(next_[0][cls]);
+    }
+    while (!queue.empty()) {
+      uint32_t state = queue.front();
+      queue.pop_front();
+      const auto& inherited = outputs_[fail[state]];
+      outputs_[state].insert(outputs_[state].end(), inherited.begin(), inherited.end());
+      for (int cls = 0; cls < kClassCount; cls++) {
+        uint32_t child = next_[state][cls];
+        if (child != 0) {
+          fail[child] = next_[fail[state]][cls];
+          queue.push_back(child);
+        } else {
+          next_[state][cls] = next_[fail[state]][cls];
+        }
+      }
+    }
+  }
+
+  uint32_t scan(const std::string& text, uint8_t channels) const {
+    std::string anchored;
+    anchored.reserve(text.size() + 2);
+    anchored.push_back(kBegin);
+    anchored += text;
+    anchored.push_back(kEnd);
+
+    uint32_t bits = 0;
+    uint32_t state = 0;
+    for (size_t i = 0; i < anchored.size(); i++) {
+      state = next_[state][classes_.table[static_cast<uint8_t>(anchored[i])]];
+      for (uint32_t id : outputs_[state]) {
+        const Output& out = patterns_[id];
+        if (!(out.channels & channels) || (bits & out.bit)) continue;
+        size_t length = out.pattern.size();
+        if (out.exactCase && std::memcmp(anchored.data() + i + 1 - length, out.pattern.data(), length) != 0) {
+          continue;
+        }
+        bits |= out.bit;
+      }
+    }
+    return bits;
+  }
+
+ private:
+  ByteClasses classes_;
+  std::vector<std::array<uint32_t, kClassCount>> next_ = std::vector<std::array<uint32_t, kClassCount>>(1);
+  std::vector<std::vector<uint32_t>> outputs_ = std::vector<std::vector<uint32_t>>(1);
+  std::vector<Output> patterns_;
+};
+
+const PatternMatcher& heuristicsMatcher() {
+  static PatternMatcher matcher;
+  static std::once_flag compiled;
+  std::call_once(compiled, []() {
+    auto whole = [](const char* name) { return std::string(1, kBegin) + name + kEnd; };
+    for (const char* name : kReactLifecycleMethods) {
+      matcher.add(whole(name), kChannelName, kMatchReact, true);
+      matcher.add(whole(name), kChannelName, kMatchFramework, true);
+    }
+    for (const char* name : kFrameworkMethods) {
+      matcher.add(whole(name), kChannelName, kMatchFramework, true);
+    }
+    matcher.add(std::string(1, kBegin) + "__", kChannelName, kMatchMagicPrefix, true);
+    matcher.add(std::string("__") + kEnd, kChannelName, kMatchMagicSuffix, true);
+
+    for (const char* suffix : kMiddlewareClassSuffixes) {
+      matcher.add(std::string(suffix) + kEnd, kChannelClass, kMatchMiddleware, false);
+    }
+
+    for (const char* stem : kConfigFileStems) {
+      for (const char* ext : kScriptExtensions) {
+        matcher.add(std::string(stem) + "." + ext + kEnd, kChannelFile, kMatchConfigFile, false);
+      }
+      for (const char* ext : kDataExtensions) {
+        matcher.add(std::string(stem) + "." + ext + kEnd, kChannelFile, kMatchConfigFile, false);
+      }
+    }
+    matcher.add(std::string("__init__.py") + kEnd, kChannelFile, kMatchConfigFile, true);
+    matcher.compile();
+  });
+  return matcher;
+}
+
+std::string baseName(const std::string& filePath) {
+  size_t slash = filePath.find_last_of("/\\");
+  return slash == std::string::npos ? filePath : filePath.substr(slash + 1);
+}
+
+uint32_t classifyWithFile(const PatternMatcher& matcher, const std::string& type,
+                          const std::string& name, const std::string& className,
+                          uint32_t fileFlags, bool python) {
+  bool isClass = type == "class";
+  uint32_t match = matcher.scan(name, isClass ? kChannelName | kChannelClass : kChannelName);
+  uint32_t flags = fileFlags;
+  if (!className.empty() && (matcher.scan(className, kChannelClass) & kMatchMiddleware)) {
+    flags |= kSymbolInMiddlewareClass;
+  }
+  if (isClass && (match & kMatchMiddleware)) flags |= kSymbolMiddlewareClass;
+  if (match & kMatchFramework) flags |= kSymbolFrameworkMethod;
+  if (match & kMatchReact) flags |= kSymbolReactLifecycle;
+  if ((match & kMatchMagicPrefix) && (match & kMatchMagicSuffix)) flags |= kSymbolPythonMagic;
+
+  // Same rules find_dead_code applies when it marks symbols as externally used
+  bool isMethod = type == "method";
+  if ((type == "function" || isMethod) && (flags & kSymbolPythonMagic)) {
+    flags |= kSymbolDeadCodeRoot;
+  }
+  if (isMethod && (flags & kSymbolInMiddlewareClass) && (flags & kSymbolFrameworkMethod)) {
+    flags |= kSymbolDeadCodeRoot;
+  }
+  if (isMethod && !python && (flags & kSymbolReactLifecycle)) flags |= kSymbolDeadCodeRoot;
+  return flags;
+}
+
+uint32_t fileFlagsFor(const PatternMatcher& matcher, const std::string& filePath) {
+  return (matcher.scan(baseName(filePath), kChannelFile) & kMatchConfigFile) ? static_cast<uint32_t>(kSymbolInConfigFile) : 0u;
+}
+
+}  // namespace
+
+uint32_t classifySymbol(const std::string& type, const std::string& name,
+                        const std::string& className, const std::string& filePath) {
+  const PatternMatcher& matcher = heuristicsMatcher();
+  return classifyWithFile(matcher, type, name, className, fileFlagsFor(matcher, filePath),
+                          languageForPath(filePath) == LanguageId::Python);
+}
+
+void classifySymbols(std::vector<Symbol>& symbols) {
+  const PatternMatcher& matcher = heuristicsMatcher();
+  const std::string* lastPath = nullptr;
+  uint32_t fileFlags = 0;
+  bool python = false;
+  for (auto& symbol : symbols) {
+    if (!lastPath || *lastPath != symbol.filePath) {
+      lastPath = &symbol.filePath;
+      fileFlags = fileFlagsFor(matcher, symbol.filePath);
+      python = languageForPath(symbol.filePath) == LanguageId::Python;
+    }
+    symbol.flags = classifyWithFile(matcher, symbol.type, symbol.name, symbol.className,
+                                    fileFlags, python);
+  }
+}
+
+}  // namespace prism
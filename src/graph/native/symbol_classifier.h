@@ -0,0 +1,33 @@
+#ifndef SYMBOL_CLASSIFIER_H
+#define SYMBOL_CLASSIFIER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+namespace prism {
+
+// Per-symbol heuristic flags, mirrored by SymbolFlags in src/graph/indexer.ts.
+enum SymbolFlag : uint32_t {
+  kSymbolMiddlewareClass = 1u << 0,   // Class named like *Middleware/*Filter/*Interceptor/*Handler
+  kSymbolInMiddlewareClass = 1u << 1, // Member of such a class
+  kSymbolFrameworkMethod = 1u << 2,   // Framework lifecycle or middleware hook name
+  kSymbolReactLifecycle = 1u << 3,
+  kSymbolPythonMagic = 1u << 4,       // __name__
+  kSymbolInConfigFile = 1u << 5,      // Defined in a config/settings file
+  kSymbolDeadCodeRoot = 1u << 6,      // Called by a framework; never reported as dead
+};
+
+// Flags for one symbol. type is "function", "method", "class" or "variable".
+uint32_t classifySymbol(const std::string& type, const std::string& name,
+                        const std::string& className, const std::string& filePath);
+
+// Sets Symbol::flags on every symbol. All the name lists and suffix patterns
+// from find_dead_code are compiled into one Aho-Corasick automaton, so each
+// name, class name and file name is scanned once regardless of pattern count.
+void classifySymbols(std::vector<Symbol>& symbols);
+
+}  // namespace prism
+
+#endif  // SYMBOL_CLASSIFIER_H
@@ -0,0 +1,197 @@
+import { addon } from './addon.js';
+
+export type NativeLanguage = 'typescript' | 'tsx' | 'python';
+
+export interface NativePoint {
+  row: number;
+  column: number;
+}
+
+/**
+ * Cursor over a native syntax tree. Only the current node's fields cross into
+ * V8, and only when asked for. Indices are UTF-8 byte offsets into the source.
+ */
+export class NativeTreeCursor {
+  private _addonInstance: any;
+
+  constructor(addonInstance: any) {
+    this._addonInstance = addonInstance;
+  }
+
+  gotoFirstChild(): boolean {
+    return this._addonInstance.gotoFirstChild();
+  }
+
+  gotoNextSibling(): boolean {
+    return this._addonInstance.gotoNextSibling();
+  }
+
+  gotoParent(): boolean {
+    return this._addonInstance.gotoParent();
+  }
+
+  reset(): void {
+    this._addonInstance.reset();
+  }
+
+  depth(): number {
+    return this._addonInstance.depth();
+  }
+
+  nodeType(): string {
+    return this._addonInstance.nodeType();
+  }
+
+  nodeTypeId(): number {
+    return this._addonInstance.nodeTypeId();
+  }
+
+  isNamed(): boolean {
+    return this._addonInstance.isNamed();
+  }
+
+  fieldName(): string | null {
+    return this._addonInstance.fieldName();
+  }
+
+  childCount(): number {
+    return this._addonInstance.childCount();
+  }
+
+  startIndex(): number {
+    return this._addonInstance.startIndex();
+  }
+
+  endIndex(): number {
+    return this._addonInstance.endIndex();
+  }
+
+  startPosition(): NativePoint {
+    return this._addonInstance.startPosition();
+  }
+
+  endPosition(): NativePoint {
+    return this._addonInstance.endPosition();
+  }
+
+  text(): string {
+    return this._addonInstance.text();
+  }
+}
+
+/**
+ * A tree-sitter tree that stays in the addon. Unlike ParseResult.tree, nothing
+ * is copied into JS objects up front; walk it with a cursor instead.
+ */
+export class NativeSyntaxTree {
+  private _addonInstance: any;
+
+  constructor(source: string | Buffer, language: NativeLanguage) {
+    this._addonInstance = new addon.SyntaxTree(source, language);
+  }
+
+  static languageForFile(filePath: string): NativeLanguage | null {
+    return addon.languageForPath(filePath);
+  }
+
+  walk(): NativeTreeCursor {
+    return new NativeTreeCursor(new addon.TreeCursor(this._addonInstance));
+  }
+
+  /**
+   * Pre-order traversal. Return false from the visitor to skip a node's children.
+   */
+  forEachNode(visitor: (cursor: NativeTreeCursor) => boolean | void): void {
+    const cursor = this.walk();
+    for (;;) {
+      const descend = visitor(cursor) !== false;
+      if (descend && cursor.gotoFirstChild()) {
+        continue;
+      }
+      while (!cursor.gotoNextSibling()) {
+        if (!cursor.gotoParent()) {
+          return;
+        }
+      }
+    }
+  }
+
+  language(): NativeLanguage {
+    return this._addonInstance.language();
+  }
+
+  byteLength(): number {
+    return this._addonInstance.byteLength();
+  }
+
+  hasError(): boolean {
+    return this._addonInstance.hasError();
+  }
+
+  text(startIndex: number, endIndex: number): string {
+    return this._addonInstance.text(startIndex, endIndex);
+  }
+
+  /**
+   * The same bytes as text(), as a read-only Buffer view of the tree's source
+   * rather than a decoded copy.
+   */
+  textView(startIndex: number, endIndex: number): Buffer {
+    return this._addonInstance.textView(startIndex, endIndex);
+  }
+
+  typeId(typeName: string): number {
+    return this._addonInstance.typeId(typeName);
+  }
+
+  typeName(typeId: number): string | null {
+    return this._addonInstance.typeName(typeId);
+  }
+}
+
+export interface SourceBufferStats {
+  /** Source buffers still referenced by a tree, the index or a JS view. */
+  files: number;
+  residentBytes: number;
+  /** Files read from disk. */
+  loads: number;
+  /** readSource/index calls served by an already loaded, unchanged file. */
+  reuses: number;
+}
+
+/**
+ * A file's bytes as a read-only Buffer backed by the addon's shared copy: an
+ * unchanged file is loaded once however many trees, index entries and views
+ * use it. Passing the Buffer back to a
+ * native function parses it in place. Returns null when the file cannot be read.
+ */
+export function readSource(filePath: string): Buffer | null {
+  return addon.readSource(filePath);
+}
+
+export function sourceBufferStats(): SourceBufferStats {
+  return addon.sourceBufferStats();
+}
+
+export interface TreeCacheStats {
+  entries: number;
+  /** Source, tree nodes and extraction data of the cached trees, measured per entry. */
+  residentBytes: number;
+  budgetBytes: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+}
+
+/**
+ * Stats of the process-wide parse cache: trees of earlier parses, reused when
+ * the same bytes are parsed again in the same language.
+ */
+export function treeCacheStats(): TreeCacheStats {
+  return addon.treeCacheStats();
+}
+
+/** Caps the parse cache's resident bytes, evicting the coldest trees past it. */
+export function setTreeCacheBudget(bytes: number): void {
+  addon.setTreeCacheBudget(bytes);
+}
@@ -0,0 +1,198 @@
+#include "syntax_tree.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+
+extern "C" {
+const TSLanguage* tree_sitter_typescript(void);
+const TSLanguage* tree_sitter_tsx(void);
+const TSLanguage* tree_sitter_python(void);
+}
+
+namespace prism {
+
+namespace {
+
+std::string extensionOf(const std::string& filePath) {
+  size_t slash = filePath.find_last_of('/');
+  size_t dot = filePath.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return "";
+  }
+  std::string ext = filePath.substr(dot);
+  for (auto& c : ext) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return ext;
+}
+
+std::atomic<size_t> parsersCreated{0};
+std::atomic<size_t> parseCount{0};
+
+// One parser per language per thread; TSParser is not safe to share.
+struct ThreadParsers {
+  TSParser* parsers[3] = {nullptr, nullptr, nullptr};
+
+  ~ThreadParsers() {
+    for (auto* parser : parsers) {
+      if (parser) ts_parser_delete(parser);
+    }
+  }
+
+  TSParser* get(LanguageId language) {
+    auto index = static_cast<size_t>(language);
+    if (!parsers[index]) {
+      parsers[index] = ts_parser_new();
+      ts_parser_set_language(parsers[index], tsLanguageFor(language));
+      parsersCreated++;
+    }
+    parseCount++;
+    return parsers[index];
+  }
+};
+
+thread_local ThreadParsers threadParsers;
+
+}  // namespace
+
+const TSLanguage* tsLanguageFor(LanguageId language) {
+  switch (language) {
+    case LanguageId::TypeScript:
+      return tree_sitter_typescript();
+    case LanguageId::Tsx:
+      return tree_sitter_tsx();
+    case LanguageId::Python:
+      return tree_sitter_python();
+    default:
+      return nullptr;
+  }
+}
+
+// Mirrors the grammar selection in TypeScriptParser: JSX-capable files use
+// the tsx grammar, plain JS is parsed with the TypeScript grammar.
+LanguageId languageForPath(const std::string& filePath) {
+  std::string ext = extensionOf(filePath);
+  if (ext == ".ts" || ext == ".js" || ext == ".mjs") return LanguageId::TypeScript;
+  if (ext == ".tsx" || ext == ".jsx") return LanguageId::Tsx;
+  if (ext == ".py" || ext == ".pyw") return LanguageId::Python;
+  return LanguageId::Unknown;
+}
+
+LanguageId languageFromName(const std::string& name) {
+  if (name == "typescript" || name == "javascript") return LanguageId::TypeScript;
+  if (name == "tsx") return LanguageId::Tsx;
+  if (name == "python") return LanguageId::Python;
+  return LanguageId::Unknown;
+}
+
+const char* languageName(LanguageId language) {
+  switch (language) {
+    case LanguageId::TypeScript:
+      return "typescript";
+    case LanguageId::Tsx:
+      return "tsx";
+    case LanguageId::Python:
+      return "python";
+    default:
+      return "unknown";
+  }
+}
+
+TSPoint pointAt(std::string_view text, uint32_t byte) {
+  TSPoint point = {0, 0};
+  size_t end = std::min<size_t>(byte, text.size());
+  size_t lineStart = 0;
+  for (size_t i = 0; i < end; i++) {
+    if (text[i] == '\n') {
+      point.row++;
+      lineStart = i + 1;
+    }
+  }
+  point.column = static_cast<uint32_t>(end - lineStart);
+  return point;
+}
+
+TSInputEdit diffSourceEdit(std::string_view before, std::string_view after) {
+  size_t limit = std::min(before.size(), after.size());
+  size_t prefix = 0;
+  while (prefix < limit && before[prefix] == after[prefix]) prefix++;
+  size_t suffix = 0;
+  while (suffix < limit - prefix &&
+         before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+    suffix++;
+  }
+  return replacementEdit(before, static_cast<uint32_t>(prefix),
+                         static_cast<uint32_t>(before.size() - suffix),
+                         after.substr(prefix, after.size() - suffix - prefix));
+}
+
+TSInputEdit replacementEdit(std::string_view before, uint32_t startByte, uint32_t oldEndByte,
+                            std::string_view inserted) {
+  TSInputEdit edit;
+  edit.start_byte = startByte;
+  edit.old_end_byte = oldEndByte;
+  edit.new_end_byte = startByte + static_cast<uint32_t>(inserted.size());
+  edit.start_point = pointAt(before, startByte);
+  edit.old_end_point = pointAt(before, oldEndByte);
+  TSPoint inner = pointAt(inserted, static_cast<uint32_t>(inserted.size()));
+  edit.new_end_point.row = edit.start_point.row + inner.row;
+  edit.new_end_point.column = inner.row == 0 ? edit.start_point.column + inner.column : inner.column;
+  return edit;
+}
+
+ParserPoolStats parserPoolStats() {
+  return {parsersCreated.load(), parseCount.load()};
+}
+
+SyntaxTree::SyntaxTree(LanguageId language, SourceBufferPtr source, TSTree* tree)
+    : language_(language), source_(std::move(source)), tree_(tree) {}
+
+SyntaxTree::~SyntaxTree() {
+  if (tree_) ts_tree_delete(tree_);
+}
+
+SyntaxTreePtr SyntaxTree::parse(LanguageId language, SourceBufferPtr source) {
+  if (language == LanguageId::Unknown || !source) {
+    return nullptr;
+  }
+  TSParser* parser = threadParsers.get(language);
+  TSTree* tree = ts_parser_parse_string(parser, nullptr, source->data(),
+                                        static_cast<uint32_t>(source->size()));
+  if (!tree) {
+    ts_parser_reset(parser);
+    return nullptr;
+  }
+  return SyntaxTreePtr(new SyntaxTree(language, std::move(source), tree));
+}
+
+SyntaxTreePtr SyntaxTree::reparse(const SyntaxTree& old, SourceBufferPtr source,
+                                  const TSInputEdit& edit, std::vector<TSRange>* changedRanges) {
+  if (!source) return nullptr;
+  TSParser* parser = threadParsers.get(old.language_);
+  TSTree* edited = ts_tree_copy(old.tree_);
+  ts_tree_edit(edited, &edit);
+  TSTree* tree = ts_parser_parse_string(parser, edited, source->data(),
+                                        static_cast<uint32_t>(source->size()));
+  if (!tree) {
+    ts_tree_delete(edited);
+    ts_parser_reset(parser);
+    return nullptr;
+  }
+  if (changedRanges) {
+    uint32_t count = 0;
+    TSRange* ranges = ts_tree_get_changed_ranges(edited, tree, &count);
+    changedRanges->assign(ranges, ranges + count);
+    free(ranges);
+  }
+  ts_tree_delete(edited);
+  return SyntaxTreePtr(new SyntaxTree(old.language_, std::move(source), tree));
+}
+
+std::string_view SyntaxTree::text(TSNode node) const {
+  return source_->slice(ts_node_start_byte(node), ts_node_end_byte(node));
+}
+
+bool SyntaxTree::hasError() const {
+  return ts_node_has_error(root());
+}
+
+}  // namespace prism
@@ -0,0 +1,76 @@
+#ifndef SYNTAX_TREE_H
+#define SYNTAX_TREE_H
+
+#include <tree_sitter/api.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "source_buffer.h"
+
+namespace prism {
+
+enum class LanguageId : uint8_t {
+  TypeScript = 0,
+  Tsx = 1,
+  Python = 2,
+  Unknown = 255,
+};
+
+const TSLanguage* tsLanguageFor(LanguageId language);
+LanguageId languageForPath(const std::string& filePath);
+LanguageId languageFromName(const std::string& name);
+const char* languageName(LanguageId language);
+
+// Row and byte column of byte within text.
+TSPoint pointAt(std::string_view text, uint32_t byte);
+// The smallest single edit turning before into after: everything between
+// their common prefix and common suffix.
+TSInputEdit diffSourceEdit(std::string_view before, std::string_view after);
+// The edit replacing [startByte, oldEndByte) of before with inserted.
+TSInputEdit replacementEdit(std::string_view before, uint32_t startByte, uint32_t oldEndByte,
+                            std::string_view inserted);
+
+struct ParserPoolStats {
+  size_t parsers;  // Created across all threads; one per language per thread
+  size_t parses;   // Full and incremental
+};
+
+ParserPoolStats parserPoolStats();
+
+// A parsed tree-sitter tree kept on the native side together with the bytes
+// it was parsed from. Node text is sliced from the shared buffer on demand.
+class SyntaxTree {
+ public:
+  static std::shared_ptr<const SyntaxTree> parse(LanguageId language, SourceBufferPtr source);
+  // Parses source reusing the unchanged subtrees of old, which edit turns
+  // into source. old is not modified. changedRanges, when given, receives the
+  // ranges of the new tree whose syntactic structure differs from old's.
+  static std::shared_ptr<const SyntaxTree> reparse(const SyntaxTree& old, SourceBufferPtr source,
+                                                   const TSInputEdit& edit,
+                                                   std::vector<TSRange>* changedRanges = nullptr);
+  ~SyntaxTree();
+
+  SyntaxTree(const SyntaxTree&) = delete;
+  SyntaxTree& operator=(const SyntaxTree&) = delete;
+
+  TSNode root() const { return ts_tree_root_node(tree_); }
+  const TSTree* raw() const { return tree_; }
+  LanguageId language() const { return language_; }
+  const SourceBufferPtr& source() const { return source_; }
+  std::string_view text(TSNode node) const;
+  bool hasError() const;
+
+ private:
+  SyntaxTree(LanguageId language, SourceBufferPtr source, TSTree* tree);
+
+  LanguageId language_;
+  SourceBufferPtr source_;
+  TSTree* tree_;
+};
+
+using SyntaxTreePtr = std::shared_ptr<const SyntaxTree>;
+
+}  // namespace prism
+
+#endif  // SYNTAX_TREE_H
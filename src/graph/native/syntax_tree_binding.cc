@@ -0,0 +1,335 @@
+#include <napi.h>
+#include "bindings.h"
+#include "syntax_tree.h"
+#include "tree_cache.h"
+
+class SyntaxTreeWrapper : public Napi::ObjectWrap<SyntaxTreeWrapper> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::FunctionReference constructor;
+  SyntaxTreeWrapper(const Napi::CallbackInfo& info);
+
+  const prism::SyntaxTreePtr& tree() const { return tree_; }
+
+ private:
+  prism::SyntaxTreePtr tree_;
+
+  Napi::Value Language(const Napi::CallbackInfo& info);
+  Napi::Value ByteLength(const Napi::CallbackInfo& info);
+  Napi::Value HasError(const Napi::CallbackInfo& info);
+  Napi::Value Text(const Napi::CallbackInfo& info);
+  Napi::Value TextView(const Napi::CallbackInfo& info);
+  Napi::Value TypeId(const Napi::CallbackInfo& info);
+  Napi::Value TypeName(const Napi::CallbackInfo& info);
+};
+
+class TreeCursorWrapper : public Napi::ObjectWrap<TreeCursorWrapper> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  TreeCursorWrapper(const Napi::CallbackInfo& info);
+  ~TreeCursorWrapper();
+
+ private:
+  prism::SyntaxTreePtr tree_;  // Keeps the tree and its source alive
+  TSTreeCursor cursor_;
+  bool initialized_ = false;
+  uint32_t depth_ = 0;
+
+  Napi::Value GotoFirstChild(const Napi::CallbackInfo& info);
+  Napi::Value GotoNextSibling(const Napi::CallbackInfo& info);
+  Napi::Value GotoParent(const Napi::CallbackInfo& info);
+  void Reset(const Napi::CallbackInfo& info);
+  Napi::Value Depth(const Napi::CallbackInfo& info);
+  Napi::Value NodeType(const Napi::CallbackInfo& info);
+  Napi::Value NodeTypeId(const Napi::CallbackInfo& info);
+  Napi::Value IsNamed(const Napi::CallbackInfo& info);
+  Napi::Value FieldName(const Napi::CallbackInfo& info);
+  Napi::Value ChildCount(const Napi::CallbackInfo& info);
+  Napi::Value StartIndex(const Napi::CallbackInfo& info);
+  Napi::Value EndIndex(const Napi::CallbackInfo& info);
+  Napi::Value StartPosition(const Napi::CallbackInfo& info);
+  Napi::Value EndPosition(const Napi::CallbackInfo& info);
+  Napi::Value Text(const Napi::CallbackInfo& info);
+};
+
+Napi::FunctionReference SyntaxTreeWrapper::constructor;
+
+static Napi::Object PointToJs(Napi::Env env, TSPoint point) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("row", point.row);
+  obj.Set("column", point.column);
+  return obj;
+}
+
+Napi::Object SyntaxTreeWrapper::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "SyntaxTree", {
+    InstanceMethod("language", &SyntaxTreeWrapper::Language),
+    InstanceMethod("byteLength", &SyntaxTreeWrapper::ByteLength),
+    InstanceMethod("hasError", &SyntaxTreeWrapper::HasError),
+    InstanceMethod("text", &SyntaxTreeWrapper::Text),
+    InstanceMethod("textView", &SyntaxTreeWrapper::TextView),
+    InstanceMethod("typeId", &SyntaxTreeWrapper::TypeId),
+    InstanceMethod("typeName", &SyntaxTreeWrapper::TypeName),
+  });
+
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+
+  exports.Set("SyntaxTree", func);
+  return exports;
+}
+
+SyntaxTreeWrapper::SyntaxTreeWrapper(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<SyntaxTreeWrapper>(info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferPtr source;
+  if (info.Length() < 2 || !JsToSourceBuffer(info[0], source) || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Source (string or Buffer) and language string expected").ThrowAsJavaScriptException();
+    return;
+  }
+  prism::LanguageId language = prism::languageFromName(info[1].As<Napi::String>().Utf8Value());
+  if (language == prism::LanguageId::Unknown) {
+    Napi::TypeError::New(env, "Unsupported language").ThrowAsJavaScriptException();
+    return;
+  }
+  tree_ = prism::parseCached(language, std::move(source));
+  if (!tree_) {
+    Napi::Error::New(env, "Failed to parse source").ThrowAsJavaScriptException();
+  }
+}
+
+Napi::Value SyntaxTreeWrapper::Language(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), prism::languageName(tree_->language()));
+}
+
+Napi::Value SyntaxTreeWrapper::ByteLength(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), tree_->source()->size());
+}
+
+Napi::Value SyntaxTreeWrapper::HasError(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), tree_->hasError());
+}
+
+Napi::Value SyntaxTreeWrapper::Text(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Start and end byte offsets expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string_view slice = tree_->source()->slice(info[0].As<Napi::Number>().Uint32Value(),
+                                                  info[1].As<Napi::Number>().Uint32Value());
+  return Napi::String::New(env, slice.data(), slice.size());
+}
+
+Napi::Value SyntaxTreeWrapper::TextView(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Start and end byte offsets expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string_view slice = tree_->source()->slice(info[0].As<Napi::Number>().Uint32Value(),
+                                                  info[1].As<Napi::Number>().Uint32Value());
+  return SourceSliceToJs(env, tree_->source(), slice);
+}
+
+Napi::Value SyntaxTreeWrapper::TypeId(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Node type name expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  TSSymbol symbol = ts_language_symbol_for_name(ts_tree_language(tree_->raw()), name.c_str(),
+                                                static_cast<uint32_t>(name.size()), true);
+  return Napi::Number::New(env, symbol);
+}
+
+Napi::Value SyntaxTreeWrapper::TypeName(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Node type ID expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  const TSLanguage* language = ts_tree_language(tree_->raw());
+  uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+  if (id >= ts_language_symbol_count(language)) {
+    return env.Null();
+  }
+  return Napi::String::New(env, ts_language_symbol_name(language, static_cast<TSSymbol>(id)));
+}
+
+Napi::Object TreeCursorWrapper::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "TreeCursor", {
+    InstanceMethod("gotoFirstChild", &TreeCursorWrapper::GotoFirstChild),
+    InstanceMethod("gotoNextSibling", &TreeCursorWrapper::GotoNextSibling),
+    InstanceMethod("gotoParent", &TreeCursorWrapper::GotoParent),
+    InstanceMethod("reset", &TreeCursorWrapper::Reset),
+    InstanceMethod("depth", &TreeCursorWrapper::Depth),
+    InstanceMethod("nodeType", &TreeCursorWrapper::NodeType),
+    InstanceMethod("nodeTypeId", &TreeCursorWrapper::NodeTypeId),
+    InstanceMethod("isNamed", &TreeCursorWrapper::IsNamed),
+    InstanceMethod("fieldName", &TreeCursorWrapper::FieldName),
+    InstanceMethod("childCount", &TreeCursorWrapper::ChildCount),
+    InstanceMethod("startIndex", &TreeCursorWrapper::StartIndex),
+    InstanceMethod("endIndex", &TreeCursorWrapper::EndIndex),
+    InstanceMethod("startPosition", &TreeCursorWrapper::StartPosition),
+    InstanceMethod("endPosition", &TreeCursorWrapper::EndPosition),
+    InstanceMethod("text", &TreeCursorWrapper::Text),
+  });
+
+  exports.Set("TreeCursor", func);
+  return exports;
+}
+
+TreeCursorWrapper::TreeCursorWrapper(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<TreeCursorWrapper>(info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject() ||
+      !info[0].As<Napi::Object>().InstanceOf(SyntaxTreeWrapper::constructor.Value())) {
+    Napi::TypeError::New(env, "SyntaxTree expected").ThrowAsJavaScriptException();
+    return;
+  }
+  tree_ = SyntaxTreeWrapper::Unwrap(info[0].As<Napi::Object>())->tree();
+  cursor_ = ts_tree_cursor_new(tree_->root());
+  initialized_ = true;
+}
+
+TreeCursorWrapper::~TreeCursorWrapper() {
+  if (initialized_) ts_tree_cursor_delete(&cursor_);
+}
+
+Napi::Value TreeCursorWrapper::GotoFirstChild(const Napi::CallbackInfo& info) {
+  bool moved = ts_tree_cursor_goto_first_child(&cursor_);
+  if (moved) depth_++;
+  return Napi::Boolean::New(info.Env(), moved);
+}
+
+Napi::Value TreeCursorWrapper::GotoNextSibling(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_next_sibling(&cursor_));
+}
+
+Napi::Value TreeCursorWrapper::GotoParent(const Napi::CallbackInfo& info) {
+  bool moved = ts_tree_cursor_goto_parent(&cursor_);
+  if (moved) depth_--;
+  return Napi::Boolean::New(info.Env(), moved);
+}
+
+void TreeCursorWrapper::Reset(const Napi::CallbackInfo& info) {
+  ts_tree_cursor_reset(&cursor_, tree_->root());
+  depth_ = 0;
+}
+
+Napi::Value TreeCursorWrapper::Depth(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), depth_);
+}
+
+Napi::Value TreeCursorWrapper::NodeType(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), ts_node_type(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::NodeTypeId(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), ts_node_symbol(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::IsNamed(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), ts_node_is_named(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::FieldName(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* field = ts_tree_cursor_current_field_name(&cursor_);
+  if (!field) return env.Null();
+  return Napi::String::New(env, field);
+}
+
+Napi::Value TreeCursorWrapper::ChildCount(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), ts_node_child_count(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::StartIndex(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), ts_node_start_byte(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::EndIndex(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), ts_node_end_byte(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::StartPosition(const Napi::CallbackInfo& info) {
+  return PointToJs(info.Env(), ts_node_start_point(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::EndPosition(const Napi::CallbackInfo& info) {
+  return PointToJs(info.Env(), ts_node_end_point(ts_tree_cursor_current_node(&cursor_)));
+}
+
+Napi::Value TreeCursorWrapper::Text(const Napi::CallbackInfo& info) {
+  std::string_view text = tree_->text(ts_tree_cursor_current_node(&cursor_));
+  return Napi::String::New(info.Env(), text.data(), text.size());
+}
+
+static Napi::Value LanguageForPath(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::LanguageId language = prism::languageForPath(info[0].As<Napi::String>().Utf8Value());
+  if (language == prism::LanguageId::Unknown) return env.Null();
+  return Napi::String::New(env, prism::languageName(language));
+}
+
+static Napi::Value ReadSource(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "FilePath string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  prism::SourceBufferPtr source = prism::loadSource(info[0].As<Napi::String>().Utf8Value());
+  if (!source) return env.Null();
+  return SourceSliceToJs(env, source, source->view());
+}
+
+static Napi::Value SourceBufferStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::SourceBufferStats stats = prism::sourceBufferStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("files", Napi::Number::New(env, stats.files));
+  obj.Set("residentBytes", Napi::Number::New(env, stats.residentBytes));
+  obj.Set("loads", Napi::Number::New(env, stats.loads));
+  obj.Set("reuses", Napi::Number::New(env, stats.reuses));
+  return obj;
+}
+
+static Napi::Value TreeCacheStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  prism::TreeCacheStats stats = prism::parseCacheStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("entries", Napi::Number::New(env, stats.entries));
+  obj.Set("residentBytes", Napi::Number::New(env, stats.residentBytes));
+  obj.Set("budgetBytes", Napi::Number::New(env, stats.budgetBytes));
+  obj.Set("hits", Napi::Number::New(env, stats.hits));
+  obj.Set("misses", Napi::Number::New(env, stats.misses));
+  obj.Set("evictions", Napi::Number::New(env, stats.evictions));
+  return obj;
+}
+
+static void SetTreeCacheBudget(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Budget in bytes expected").ThrowAsJavaScriptException();
+    return;
+  }
+  double bytes = info[0].As<Napi::Number>().DoubleValue();
+  prism::setParseCacheBudget(bytes > 0 ? static_cast<size_t>(bytes) : 0);
+}
+
+Napi::Object InitSyntaxTree(Napi::Env env, Napi::Object exports) {
+  SyntaxTreeWrapper::Init(env, exports);
+  TreeCursorWrapper::Init(env, exports);
+  exports.Set("languageForPath", Napi::Function::New(env, LanguageForPath, "languageForPath"));
+  exports.Set("readSource", Napi::Function::New(env, ReadSource, "readSource"));
+  exports.Set("sourceBufferStats", Napi::Function::New(env, SourceBufferStats, "sourceBufferStats"));
+  exports.Set("treeCacheStats", Napi::Function::New(env, TreeCacheStats, "treeCacheStats"));
+  exports.Set("setTreeCacheBudget", Napi::Function::New(env, SetTreeCacheBudget, "setTreeCacheBudget"));
+  return exports;
+}
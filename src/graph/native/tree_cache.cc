@@ -0,0 +1,184 @@
+#include "tree_cache.h"
+#include <iterator>
+
+namespace prism {
+
+namespace {
+
+// Approximate heap bytes per node of a tree-sitter tree: most nodes are heap
+// subtrees, while many leaves are stored inline in their parent.
+constexpr size_t kBytesPerNode = 48;
+constexpr size_t kProtectedShare = 80;  // Percent of the budget
+constexpr size_t kDefaultParseCacheBytes = 256u << 20;
+
+TreeCache& parseCache() {
+  static TreeCache cache(kDefaultParseCacheBytes);
+  return cache;
+}
+
+}  // namespace
+
+size_t heapBytes(const std::string& text) {
+  return text.size() > 15 ? text.capacity() + 1 : 0;
+}
+
+size_t referenceBytes(const Reference& ref) {
+  return sizeof(Reference) + heapBytes(ref.id) + heapBytes(ref.fromSymbolId) +
+         heapBytes(ref.toSymbolId) + heapBytes(ref.filePath) + heapBytes(ref.name) +
+         heapBytes(ref.receiverClass);
+}
+
+size_t extractionResultBytes(const ExtractionResult& result) {
+  size_t bytes = sizeof(ExtractionResult);
+  for (const auto& symbol : result.symbols) {
+    bytes += sizeof(Symbol) + heapBytes(symbol.id) + heapBytes(symbol.name) +
+             heapBytes(symbol.filePath) + heapBytes(symbol.className);
+  }
+  for (const auto& entry : result.imports) {
+    bytes += sizeof(ImportEntry) + heapBytes(entry.source) + heapBytes(entry.resolvedPath);
+    for (const auto& name : entry.imported) bytes += sizeof(std::string) + heapBytes(name);
+  }
+  for (const auto& site : result.callSites) bytes += referenceBytes(site);
+  for (const auto& base : result.bases) {
+    bytes += sizeof(ClassBase) + heapBytes(base.classId) + heapBytes(base.name);
+  }
+  for (const auto& entry : result.exports) {
+    bytes += sizeof(ExportEntry) + heapBytes(entry.name) + heapBytes(entry.localName) +
+             heapBytes(entry.source);
+  }
+  return bytes;
+}
+
+size_t treeCacheEntryBytes(const TreeCacheEntry& entry) {
+  size_t bytes = sizeof(TreeCacheEntry);
+  if (entry.tree) {
+    bytes += sizeof(SyntaxTree) + entry.tree->source()->size() +
+             static_cast<size_t>(ts_node_descendant_count(entry.tree->root())) * kBytesPerNode;
+  }
+  if (entry.extraction) bytes += extractionResultBytes(*entry.extraction);
+  return bytes;
+}
+
+TreeCache::TreeCache(size_t budgetBytes) : budgetBytes_(budgetBytes) {}
+
+bool TreeCache::get(const std::string& key, TreeCacheEntry& out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    stats_.misses++;
+    return false;
+  }
+  stats_.hits++;
+  SlotList::iterator slot = it->second;
+  if (slot->isProtected) {
+    protected_.splice(protected_.begin(), protected_, slot);
+  } else {
+    // Second use: promote, demoting the coldest protected entries past their share.
+    slot->isProtected = true;
+    probationBytes_ -= slot->bytes;
+    protectedBytes_ += slot->bytes;
+    protected_.splice(protected_.begin(), probation_, slot);
+    size_t protectedBudget = budgetBytes_ / 100 * kProtectedShare;
+    while (protectedBytes_ > protectedBudget && protected_.size() > 1) {
+      SlotList::iterator coldest = std::prev(protected_.end());
+      coldest->isProtected = false;
+      protectedBytes_ -= coldest->bytes;
+      probationBytes_ += coldest->bytes;
+      probation_.splice(probation_.begin(), protected_, coldest);
+    }
+  }
+  out = slot->entry;
+  return true;
+}
+
+void TreeCache::put(const std::string& key, TreeCacheEntry entry) {
+  size_t bytes = treeCacheEntryBytes(entry);
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool wasProtected = false;
+  auto it = slots_.find(key);
+  if (it != slots_.end()) {
+    // A new version of a protected entry, such as a reparse, stays protected.
+    wasProtected = it->second->isProtected;
+    unlink(it->second);
+    slots_.erase(it);
+  }
+  if (bytes > budgetBytes_) {
+    stats_.evictions++;
+    return;
+  }
+  SlotList& to = wasProtected ? protected_ : probation_;
+  to.push_front({key, std::move(entry), bytes, wasProtected});
+  (wasProtected ? protectedBytes_ : probationBytes_) += bytes;
+  slots_.emplace(key, to.begin());
+  shrink();
+}
+
+void TreeCache::erase(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) return;
+  unlink(it->second);
+  slots_.erase(it);
+}
+
+void TreeCache::setBudget(size_t budgetBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budgetBytes_ = budgetBytes;
+  shrink();
+}
+
+TreeCacheStats TreeCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TreeCacheStats stats = stats_;
+  stats.entries = slots_.size();
+  stats.residentBytes = probationBytes_ + protectedBytes_;
+  stats.budgetBytes = budgetBytes_;
+  return stats;
+}
+
+void TreeCache::unlink(SlotList::iterator slot) {
+  if (slot->isProtected) {
+    protectedBytes_ -= slot->bytes;
+    protected_.erase(slot);
+  } else {
+    probationBytes_ -= slot->bytes;
+    probation_.erase(slot);
+  }
+}
+
+void TreeCache::shrink() {
+  while (probationBytes_ + protectedBytes_ > budgetBytes_) {
+    SlotList& from = probation_.empty() ? protected_ : probation_;
+    SlotList::iterator coldest = std::prev(from.end());
+    slots_.erase(coldest->key);
+    unlink(coldest);
+    stats_.evictions++;
+  }
+}
+
+SyntaxTreePtr parseCached(LanguageId language, SourceBufferPtr source) {
+  uint64_t hash = source->contentHash();
+  std::string key(1, static_cast<char>(language));
+  key.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+
+  TreeCache& cache = parseCache();
+  TreeCacheEntry entry;
+  // Equal hashes of different bytes are possible, if unlikely; compare.
+  if (cache.get(key, entry) && entry.tree->source()->view() == source->view()) return entry.tree;
+
+  entry.tree = SyntaxTree::parse(language, std::move(source));
+  if (!entry.tree) return nullptr;
+  SyntaxTreePtr tree = entry.tree;
+  cache.put(key, std::move(entry));
+  return tree;
+}
+
+void setParseCacheBudget(size_t budgetBytes) {
+  parseCache().setBudget(budgetBytes);
+}
+
+TreeCacheStats parseCacheStats() {
+  return parseCache().stats();
+}
+
+}  // namespace prism
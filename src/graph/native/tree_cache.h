@@ -0,0 +1,91 @@
+#ifndef TREE_CACHE_H
+#define TREE_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "extractor.h"
+#include "syntax_tree.h"
+
+namespace prism {
+
+struct TreeCacheEntry {
+  SyntaxTreePtr tree;
+  std::shared_ptr<const ExtractionResult> extraction;  // Optional
+};
+
+struct TreeCacheStats {
+  size_t entries = 0;
+  size_t residentBytes = 0;
+  size_t budgetBytes = 0;
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+};
+
+// Heap bytes of a string beyond the string itself; short strings live in its
+// small-string buffer and cost nothing extra.
+size_t heapBytes(const std::string& text);
+size_t referenceBytes(const Reference& ref);
+size_t extractionResultBytes(const ExtractionResult& result);
+
+// Approximate heap bytes held by entry: its source, its tree's nodes and the
+// extraction. Bytes shared with another entry are counted in both.
+size_t treeCacheEntryBytes(const TreeCacheEntry& entry);
+
+// Parse trees charged by measured bytes and evicted in O(1) once their total
+// passes the budget. Segmented LRU: new entries start on probation and move
+// to the protected segment (up to 80% of the budget) on their second use, so
+// a sweep over many files once, such as warm-up, cannot flush the trees that
+// are used repeatedly. Internally synchronized.
+class TreeCache {
+ public:
+  explicit TreeCache(size_t budgetBytes);
+
+  TreeCache(const TreeCache&) = delete;
+  TreeCache& operator=(const TreeCache&) = delete;
+
+  bool get(const std::string& key, TreeCacheEntry& out);
+  // Replaces any entry under key. An entry larger than the whole budget is
+  // not kept.
+  void put(const std::string& key, TreeCacheEntry entry);
+  void erase(const std::string& key);
+  void setBudget(size_t budgetBytes);
+  TreeCacheStats stats() const;
+
+ private:
+  struct Slot {
+    std::string key;
+    TreeCacheEntry entry;
+    size_t bytes;
+    bool isProtected;
+  };
+  using SlotList = std::list<Slot>;  // Most recently used at the front
+
+  mutable std::mutex mutex_;
+  size_t budgetBytes_;
+  size_t probationBytes_ = 0;
+  size_t protectedBytes_ = 0;
+  SlotList probation_;
+  SlotList protected_;
+  std::unordered_map<std::string, SlotList::iterator> slots_;
+  TreeCacheStats stats_;
+
+  // Caller holds mutex_.
+  void unlink(SlotList::iterator slot);
+  void shrink();
+};
+
+// Parses source, or returns the tree of an earlier parse of identical bytes
+// in the same language from a process-wide TreeCache. Tools that re-read an
+// unchanged file get its tree back without parsing.
+SyntaxTreePtr parseCached(LanguageId language, SourceBufferPtr source);
+void setParseCacheBudget(size_t budgetBytes);
+TreeCacheStats parseCacheStats();
+
+}  // namespace prism
+
+#endif  // TREE_CACHE_H
@@ -0,0 +1,159 @@
+#include "usage_scanner.h"
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+namespace prism {
+
+namespace {
+
+enum class ScanKind : uint8_t {
+  Other,
+  Import,
+  Definition,
+  Body,
+  FormalParameters,
+  Identifier,          // identifier, type_identifier
+  PropertyIdentifier,  // property_identifier, shorthand_property_identifier
+  VariableDeclarator,  // Also Python default parameters: only the name field declares
+  ParameterContainer,
+  JsxElement,
+  MemberExpression,
+};
+
+ScanKind kindForType(const char* type) {
+  if (strstr(type, "import")) return ScanKind::Import;
+  if (!strcmp(type, "function_declaration") || !strcmp(type, "function_definition") ||
+      !strcmp(type, "class_declaration") || !strcmp(type, "class_definition") ||
+      !strcmp(type, "method_definition")) {
+    return ScanKind::Definition;
+  }
+  if (!strcmp(type, "statement_block") || !strcmp(type, "block")) return ScanKind::Body;
+  if (!strcmp(type, "formal_parameters")) return ScanKind::FormalParameters;
+  if (!strcmp(type, "identifier") || !strcmp(type, "type_identifier")) return ScanKind::Identifier;
+  if (!strcmp(type, "property_identifier") || !strcmp(type, "shorthand_property_identifier")) {
+    return ScanKind::PropertyIdentifier;
+  }
+  if (!strcmp(type, "variable_declarator") || !strcmp(type, "default_parameter") ||
+      !strcmp(type, "typed_default_parameter")) {
+    return ScanKind::VariableDeclarator;
+  }
+  if (!strcmp(type, "required_parameter") || !strcmp(type, "optional_parameter") ||
+      !strcmp(type, "shorthand_property_identifier_pattern") || !strcmp(type, "object_pattern") ||
+      !strcmp(type, "array_pattern") || !strcmp(type, "typed_parameter") ||
+      !strcmp(type, "parameters")) {
+    return ScanKind::ParameterContainer;
+  }
+  if (!strcmp(type, "jsx_opening_element") || !strcmp(type, "jsx_self_closing_element")) {
+    return ScanKind::JsxElement;
+  }
+  if (!strcmp(type, "member_expression")) return ScanKind::MemberExpression;
+  return ScanKind::Other;
+}
+
+// Node kinds indexed by grammar symbol, so the walk never compares type strings.
+std::vector<ScanKind> kindTables[3];
+std::once_flag kindTableFlags[3];
+
+const std::vector<ScanKind>& kindTableFor(LanguageId language) {
+  auto index = static_cast<size_t>(language);
+  std::call_once(kindTableFlags[index], [language, index]() {
+    const TSLanguage* tsLanguage = tsLanguageFor(language);
+    uint32_t count = ts_language_symbol_count(tsLanguage);
+    std::vector<ScanKind>& table = kindTables[index];
+    table.resize(count, ScanKind::Other);
+    for (uint32_t symbol = 0; symbol < count; symbol++) {
+      const char* name = ts_language_symbol_name(tsLanguage, static_cast<TSSymbol>(symbol));
+      if (name) table[symbol] = kindForType(name);
+    }
+  });
+  return kindTables[index];
+}
+
+class UsageScanner {
+ public:
+  UsageScanner(const SyntaxTree& tree)
+      : tree_(tree), kinds_(kindTableFor(tree.language())) {
+    nameField_ = ts_language_field_id_for_name(tsLanguageFor(tree.language()), "name", 4);
+  }
+
+  std::vector<std::string_view> run() {
+    TSTreeCursor cursor = ts_tree_cursor_new(tree_.root());
+    visitChildren(&cursor, ScanKind::Other);
+    ts_tree_cursor_delete(&cursor);
+    return std::vector<std::string_view>(names_.begin(), names_.end());
+  }
+
+ private:
+  const SyntaxTree& tree_;
+  const std::vector<ScanKind>& kinds_;
+  TSFieldId nameField_ = 0;
+  std::unordered_set<std::string_view> names_;
+
+  ScanKind kindOf(TSNode node) const {
+    TSSymbol symbol = ts_node_symbol(node);
+    return symbol < kinds_.size() ? kinds_[symbol] : ScanKind::Other;
+  }
+
+  // Visits the named children of the cursor's current node.
+  void visitChildren(TSTreeCursor* cursor, ScanKind kind) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) return;
+    do {
+      TSNode child = ts_tree_cursor_current_node(cursor);
+      if (!ts_node_is_named(child)) continue;
+      ScanKind childKind = kindOf(child);
+      if (kind == ScanKind::Definition &&
+          (childKind == ScanKind::FormalParameters || childKind == ScanKind::Identifier)) {
+        continue;
+      }
+      visit(cursor, child, childKind, kind);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+  }
+
+  void visit(TSTreeCursor* cursor, TSNode node, ScanKind kind, ScanKind parentKind) {
+    switch (kind) {
+      case ScanKind::Import:
+        return;
+      case ScanKind::Identifier:
+      case ScanKind::PropertyIdentifier:
+        if (!isDeclaration(cursor, parentKind)) names_.insert(tree_.text(node));
+        break;
+      case ScanKind::JsxElement: {
+        TSNode nameNode = ts_node_named_child(node, 0);
+        if (!ts_node_is_null(nameNode)) {
+          ScanKind nameKind = kindOf(nameNode);
+          if (nameKind == ScanKind::Identifier || nameKind == ScanKind::MemberExpression) {
+            names_.insert(tree_.text(nameNode));
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    visitChildren(cursor, kind);
+  }
+
+  bool isDeclaration(const TSTreeCursor* cursor, ScanKind parentKind) const {
+    switch (parentKind) {
+      case ScanKind::VariableDeclarator:
+        return ts_tree_cursor_current_field_id(cursor) == nameField_;
+      case ScanKind::Definition:
+      case ScanKind::ParameterContainer:
+      case ScanKind::FormalParameters:
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+}  // namespace
+
+std::vector<std::string_view> scanIdentifierUsages(const SyntaxTree& tree) {
+  if (tree.language() == LanguageId::Unknown) return {};
+  return UsageScanner(tree).run();
+}
+
+}  // namespace prism
@@ -0,0 +1,17 @@
+#ifndef USAGE_SCANNER_H
+#define USAGE_SCANNER_H
+
+#include <string_view>
+#include <vector>
+#include "syntax_tree.h"
+
+namespace prism {
+
+// Distinct identifier names a file uses outside of declarations: binding names
+// of functions, classes, variable declarators and parameters are skipped, as
+// are import statements. Views point into the tree's source buffer.
+std::vector<std::string_view> scanIdentifierUsages(const SyntaxTree& tree);
+
+}  // namespace prism
+
+#endif  // USAGE_SCANNER_H
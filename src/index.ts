@@ -1,11 +1,12 @@
 import { MCPServer } from './server.js';
 import { initializeConfig } from './utils/config.js';
+import { initializeProjectIndex } from './graph/indexer.js';
 import { logger } from './utils/logger.js';
 import { isPrismError } from './utils/errors.js';
 
 async function main() {
   try {
-    initializeConfig();
+    const config = initializeConfig();
 
     const server = new MCPServer();
 
@@ -35,7 +36,8 @@ async function main() {
 
     server.registerTool({
       name: 'get_skeleton',
-      description: 'Extract skeleton structure from a source code file',
+      description:
+        'Extract skeleton structure from a source code file, or from every file in a directory',
       inputSchema: {
         type: 'object',
         properties: {
@@ -43,8 +45,11 @@ async function main() {
             type: 'string',
             description: 'Path to source file to extract skeleton from',
           },
+          directoryPath: {
+            type: 'string',
+            description: 'Path to a directory to extract the skeletons of all files in',
+          },
         },
-        required: ['filePath'],
       },
     });
 
@@ -491,6 +496,10 @@ async function main() {
     });
 
     await server.start();
+
+    if (config.get('graph').warmOnStartup) {
+      void initializeProjectIndex(process.cwd());
+    }
   } catch (error) {
     logger.error('Fatal error during startup', error as Error);
 
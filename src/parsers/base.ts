@@ -57,20 +57,34 @@ export abstract class BaseParser implements ParserInterface {
     return this.config.extensions.includes(fileExtension);
   }
 
-  protected convertTreeToAST(rootNode: any, parent: ASTNode | null = null): ASTNode {
-    const astNode: ASTNode = {
+  /**
+   * Mirrors the tree-sitter tree as ASTNodes. When the parsed source is passed in,
+   * `text` is a lazy slice of it rather than a copy per node, so memory stays
+   * linear in file size instead of growing with nesting depth.
+   */
+  protected convertTreeToAST(
+    rootNode: any,
+    parent: ASTNode | null = null,
+    source?: string
+  ): ASTNode {
+    const astNode = {
       type: rootNode.type,
-      text: rootNode.text,
       startPosition: rootNode.startPosition,
       endPosition: rootNode.endPosition,
       children: [],
       namedChildren: [],
       parent,
-    };
+    } as unknown as ASTNode;
+
+    if (source === undefined) {
+      astNode.text = rootNode.text;
+    } else {
+      defineLazyText(astNode, source, rootNode.startIndex, rootNode.endIndex);
+    }
 
     for (let i = 0; i < rootNode.childCount; i++) {
       const child = rootNode.child(i);
-      const astChild = this.convertTreeToAST(child, astNode);
+      const astChild = this.convertTreeToAST(child, astNode, source);
       astChild.field = rootNode.fieldNameForChild(i) || undefined;
       astNode.children.push(astChild);
       if (child.isNamed) {
@@ -81,3 +95,21 @@ export abstract class BaseParser implements ParserInterface {
     return astNode;
   }
 }
+
+// tree-sitter's startIndex/endIndex are string indices when parsing a JS string,
+// so slicing the source yields exactly node.text.
+function defineLazyText(node: ASTNode, source: string, start: number, end: number): void {
+  Object.defineProperty(node, 'text', {
+    get: () => source.slice(start, end),
+    set(value: string) {
+      Object.defineProperty(this, 'text', {
+        value,
+        writable: true,
+        enumerable: true,
+        configurable: true,
+      });
+    },
+    enumerable: true,
+    configurable: true,
+  });
+}
@@ -39,7 +39,7 @@ export class PythonParser extends BaseParser {
         endPosition: node.endPosition,
       }));
 
-      const rootAST = this.convertTreeToAST(tree.rootNode);
+      const rootAST = this.convertTreeToAST(tree.rootNode, null, source);
 
       const parseTime = performance.now() - startTime;
 
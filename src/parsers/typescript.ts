@@ -59,7 +59,7 @@ export class TypeScriptParser extends BaseParser {
         endPosition: node.endPosition,
       }));
 
-      const rootAST = this.convertTreeToAST(tree.rootNode);
+      const rootAST = this.convertTreeToAST(tree.rootNode, null, source);
 
       const parseTime = performance.now() - startTime;
 
@@ -2,8 +2,14 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { ParserError } from '../utils/errors.js';
 import { logger } from '../utils/logger.js';
-import { buildSymbolTable, findSymbolDefinition, findReferences } from './find_callers.js';
+import {
+  buildSymbolTable,
+  findSymbolDefinition,
+  findReferences,
+  findReferencesFromIndex,
+} from './find_callers.js';
 import { findSourceFiles } from './find_callers.js';
+import { filterCandidateFiles } from '../graph/indexer.js';
 import type {
   SymbolDefinition,
   SymbolReference,
@@ -289,9 +295,14 @@ async function findAllReferences(
   symbol: SymbolDefinition,
   files: string[]
 ): Promise<SymbolReference[]> {
+  const indexed = await findReferencesFromIndex(symbol, files);
+  if (indexed) {
+    return indexed;
+  }
+
   const allReferences: SymbolReference[] = [];
 
-  for (const file of files) {
+  for (const file of await filterCandidateFiles(files, [symbol.name])) {
     try {
       const parser = ParserFactory.getParserForFile(file);
       const result = await parser.parseFile(file);
@@ -2,9 +2,15 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { ParserError } from '../utils/errors.js';
 import { logger } from '../utils/logger.js';
-import { buildSymbolTable, findSymbolDefinition, findReferences } from './find_callers.js';
+import {
+  buildSymbolTable,
+  findSymbolDefinition,
+  findReferences,
+  findReferencesFromIndex,
+} from './find_callers.js';
 import type { SymbolDefinition, SymbolReference, RefactorImpact } from '../types/ast.js';
 import { findSourceFiles } from './find_callers.js';
+import { filterCandidateFiles } from '../graph/indexer.js';
 
 export async function analyzeRefactorImpact(args: Record<string, unknown>): Promise<ToolResponse> {
   const { filePath, elementName, elementType, proposedChanges } = args;
@@ -127,9 +133,14 @@ async function findAllReferences(
   symbol: SymbolDefinition,
   files: string[]
 ): Promise<SymbolReference[]> {
+  const indexed = await findReferencesFromIndex(symbol, files);
+  if (indexed) {
+    return indexed;
+  }
+
   const allReferences: SymbolReference[] = [];
 
-  for (const file of files) {
+  for (const file of await filterCandidateFiles(files, [symbol.name])) {
     try {
       const parser = ParserFactory.getParserForFile(file);
       const result = await parser.parseFile(file);
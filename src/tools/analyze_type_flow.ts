@@ -1,7 +1,10 @@
 import type { ToolResponse } from '../types/mcp.js';
+import { readFile } from 'fs/promises';
+import { resolve } from 'path';
 import { ParserFactory } from '../parsers/factory.js';
 import { ParserError } from '../utils/errors.js';
 import { logger } from '../utils/logger.js';
+import { getNativeGraph } from '../graph/indexer.js';
 import { buildSymbolTable } from './find_callers.js';
 import { findSourceFiles } from './find_callers.js';
 import type { TypeFlowAnalysis, TypeOrigin, TypeRelationship } from '../types/ast.js';
@@ -85,7 +88,16 @@ export async function analyzeTypeFlow(args: Record<string, unknown>): Promise<To
     }
 
     // Analyze type flow at the target position
-    const typeAnalysis = await analyzeTypeAtPosition(result.tree, targetPosition, filePath, files);
+    let typeAnalysis = await analyzeTypeAtPosition(result.tree, targetPosition, filePath, files);
+    if (typeof lineNumber === 'number') {
+      typeAnalysis = await refineWithDataflow(
+        typeAnalysis,
+        result.tree,
+        { row: lineNumber - 1, column: (columnNumber as number) || 0 },
+        filePath,
+        typeof variableName === 'string' ? variableName : undefined
+      );
+    }
 
     const analysis: TypeFlowAnalysis = {
       targetLocation: {
@@ -174,6 +186,118 @@ async function analyzeTypeAtPosition(
   }
 }
 
+type TypeAnalysisResult = Awaited<ReturnType<typeof analyzeTypeAtPosition>>;
+
+/**
+ * Refines a position query with the native dataflow engine: a type guard that
+ * holds on every path to the line wins, otherwise untyped variables take the
+ * types of the definitions that reach it.
+ */
+async function refineWithDataflow(
+  analysis: TypeAnalysisResult,
+  root: any,
+  position: { row: number; column: number },
+  filePath: string,
+  variableName?: string
+): Promise<TypeAnalysisResult> {
+  const native = await getNativeGraph();
+  if (!native) {
+    return analysis;
+  }
+
+  const node = findNodeAtPosition(root, position);
+  const name = variableName ?? (node?.type === 'identifier' ? node.text : undefined);
+  const functionName = node ? findEnclosingFunctionName(node) : null;
+  if (!name || !functionName) {
+    return analysis;
+  }
+
+  const absolutePath = resolve(filePath);
+  const point = native.dataflowAt(
+    native.readSource(absolutePath) ?? (await readFile(absolutePath)),
+    absolutePath,
+    functionName,
+    position.row + 1
+  );
+  if (!point) {
+    return analysis;
+  }
+
+  const isKnown = analysis.resolvedType !== 'any' && analysis.resolvedType !== 'unknown';
+  const narrowing = point.narrowings.filter((n) => n.variableName === name).pop();
+  if (narrowing) {
+    const narrowedType =
+      narrowing.narrowedType === 'NonNullable<T>' && isKnown
+        ? `NonNullable<${analysis.resolvedType}>`
+        : narrowing.narrowedType;
+    return {
+      ...analysis,
+      resolvedType: narrowedType,
+      typeOrigins: [
+        ...analysis.typeOrigins,
+        { type: narrowedType, source: 'type_narrowing', location: `${filePath}:${narrowing.line}` },
+      ],
+      inferenceChain: [...analysis.inferenceChain, `Narrowed by ${narrowing.condition}`],
+      confidence: 'high',
+    };
+  }
+
+  const reaching = point.reachingDefinitions.filter((d) => d.name === name);
+  if (reaching.length === 0) {
+    return analysis;
+  }
+
+  const inferenceChain = [
+    ...analysis.inferenceChain,
+    `Reaching definitions: ${reaching.map((d) => `line ${d.line}`).join(', ')}`,
+  ];
+  const types = [...new Set(reaching.map((d) => d.type))];
+  if (isKnown || types.some((t) => t === undefined)) {
+    return { ...analysis, inferenceChain };
+  }
+
+  return {
+    ...analysis,
+    resolvedType: types.join(' | '),
+    typeOrigins: [
+      ...analysis.typeOrigins,
+      ...reaching.map((d) => ({
+        type: d.type!,
+        source: 'reaching_definition' as const,
+        location: `${filePath}:${d.line}`,
+      })),
+    ],
+    inferenceChain,
+    confidence: reaching.length === 1 ? 'high' : 'medium',
+  };
+}
+
+function findEnclosingFunctionName(node: any): string | null {
+  const nameOf = (n: any): string | null =>
+    n.namedChildren?.find(
+      (c: any) => c.field === 'name' || c.type === 'identifier' || c.type === 'property_identifier'
+    )?.text ?? null;
+
+  for (let current = node; current; current = current.parent) {
+    if (
+      current.type === 'function_declaration' ||
+      current.type === 'generator_function_declaration' ||
+      current.type === 'method_definition'
+    ) {
+      return nameOf(current);
+    }
+    if (
+      (current.type === 'arrow_function' ||
+        current.type === 'function_expression' ||
+        current.type === 'function') &&
+      current.parent?.type === 'variable_declarator'
+    ) {
+      return nameOf(current.parent);
+    }
+  }
+  return null;
+}
+
 function findNodeAtPosition(node: any, position: { row: number; column: number }): any {
   // Check if this node contains the position
   if (node.startPosition && node.endPosition) {
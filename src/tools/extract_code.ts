@@ -3,6 +3,8 @@ import { ParserFactory } from '../parsers/factory.js';
 import { ParserError } from '../utils/errors.js';
 import { logger } from '../utils/logger.js';
 import { readFileSync } from 'fs';
+import { resolve } from 'path';
+import { getNativeGraph } from '../graph/indexer.js';
 import type { ASTNode } from '../types/ast.js';
 
 export async function extractCode(args: Record<string, unknown>): Promise<ToolResponse> {
@@ -26,6 +28,10 @@ export async function extractCode(args: Record<string, unknown>): Promise<ToolRe
     const parser = ParserFactory.getParserForFile(filePath);
     const result = await parser.parseFile(filePath);
     const language = parser.getLanguage();
+    // The addon's shared copy of the file, when available, so only the
+    // extracted lines are decoded
+    const native = await getNativeGraph();
+    const source = native?.readSource(resolve(filePath)) ?? readFileSync(filePath, 'utf-8');
 
     let code: string;
     let metadata: any = {
@@ -35,7 +41,7 @@ export async function extractCode(args: Record<string, unknown>): Promise<ToolRe
 
     if (typeof startLine === 'number' && typeof endLine === 'number') {
       // Extract by line numbers
-      code = extractByLineNumbers(filePath, startLine, endLine);
+      code = extractByLineNumbers(source, startLine, endLine);
       metadata.extractionMethod = 'line_numbers';
       metadata.startLine = startLine;
       metadata.endLine = endLine;
@@ -43,7 +49,7 @@ export async function extractCode(args: Record<string, unknown>): Promise<ToolRe
       // Extract by element name
       const extraction = extractByElementName(
         result.tree,
-        filePath,
+        source,
         elementName,
         elementType as string
       );
@@ -116,25 +122,49 @@ export async function extractCode(args: Record<string, unknown>): Promise<ToolRe
   }
 }
 
-function extractByLineNumbers(filePath: string, startLine: number, endLine: number): string {
-  const content = readFileSync(filePath, 'utf-8');
-  const lines = content.split('\n');
+/**
+ * 0-based lines startIndex..endIndex, inclusive. A Buffer is scanned for line
+ * breaks and only the selected bytes are decoded.
+ */
+function sliceLines(source: Buffer | string, startIndex: number, endIndex: number): string {
+  if (typeof source === 'string') {
+    return source
+      .split('\n')
+      .slice(startIndex, endIndex + 1)
+      .join('\n');
+  }
 
-  // Adjust for 0-based vs 1-based indexing
-  const startIndex = Math.max(0, startLine - 1);
-  const endIndex = Math.min(lines.length - 1, endLine - 1);
+  let start = 0;
+  for (let line = 0; line < startIndex; line++) {
+    const newline = source.indexOf(0x0a, start);
+    if (newline === -1) {
+      return '';
+    }
+    start = newline + 1;
+  }
+  let end = start;
+  for (let line = startIndex; line <= endIndex; line++) {
+    const newline = source.indexOf(0x0a, end);
+    if (newline === -1) {
+      end = source.length;
+      break;
+    }
+    end = line === endIndex ? newline : newline + 1;
+  }
+  return source.toString('utf8', start, end);
+}
 
-  return lines.slice(startIndex, endIndex + 1).join('\n');
+function extractByLineNumbers(source: Buffer | string, startLine: number, endLine: number): string {
+  // Adjust for 0-based vs 1-based indexing
+  return sliceLines(source, Math.max(0, startLine - 1), endLine - 1);
 }
 
 function extractByElementName(
   root: ASTNode,
-  filePath: string,
+  source: Buffer | string,
   elementName: string,
   elementType?: string
 ): { code: string; metadata: any } | null {
-  const fileContent = readFileSync(filePath, 'utf-8');
-  const lines = fileContent.split('\n');
 
   function findElement(
     node: ASTNode,
@@ -176,7 +206,7 @@ function extractByElementName(
       // Extract the source code for this element
       const startLine = node.startPosition.row;
       const endLine = node.endPosition.row;
-      const code = lines.slice(startLine, endLine + 1).join('\n');
+      const code = sliceLines(source, startLine, endLine);
 
       const metadata = {
         elementName,
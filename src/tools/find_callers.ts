@@ -9,8 +9,14 @@ import type {
   CallSite,
   FindCallersResult,
 } from '../types/ast.js';
+import type { IndexedReference } from '../graph/native/index.js';
+import {
+  getWarmProjectIndex,
+  getProjectIndexForFiles,
+  filterCandidateFiles,
+} from '../graph/indexer.js';
 import { readdirSync, statSync } from 'fs';
-import { join, extname } from 'path';
+import { join, relative, resolve, sep } from 'path';
 
 export default async function findCallers(args: Record<string, unknown>): Promise<ToolResponse> {
   const { filePath, functionName, methodName } = args;
@@ -50,6 +56,12 @@ export default async function findCallers(args: Record<string, unknown>): Promis
     const isMethod = typeof methodName === 'string';
 
     const projectDir = getProjectDirectory(validatedFilePath);
+
+    const indexed = await findCallersFromIndex(projectDir, validatedFilePath, symbolName, isMethod);
+    if (indexed) {
+      return indexed;
+    }
+
     const files = findSourceFiles(projectDir);
 
     const symbolTable = await buildSymbolTable(files);
@@ -120,6 +132,105 @@ export default async function findCallers(args: Record<string, unknown>): Promis
   }
 }
 
+/**
+ * Answers from the warm project index when it covers projectDir: the symbol and
+ * its resolved call sites are lookups, so no file is parsed. Returns null to
+ * fall back to the parsing path.
+ */
+async function findCallersFromIndex(
+  projectDir: string,
+  filePath: string,
+  symbolName: string,
+  isMethod: boolean
+): Promise<ToolResponse | null> {
+  const index = await getWarmProjectIndex(projectDir);
+  if (!index) {
+    return null;
+  }
+
+  const absoluteFile = resolve(filePath);
+  const candidates = index
+    .findSymbolsByFile(absoluteFile)
+    .filter((sym) => sym.name === symbolName && sym.type !== 'variable');
+  const symbol =
+    candidates.length === 1
+      ? candidates[0]
+      : candidates.find((sym) => sym.type === (isMethod ? 'method' : 'function'));
+
+  if (!symbol) {
+    return null;
+  }
+
+  // Same matches as findReferences: calls only reach functions and methods,
+  // `new` expressions and config references are not calls, and identifiers
+  // passed as arguments are callbacks. Paths take the form findSourceFiles
+  // gives them.
+  const absoluteDir = resolve(projectDir);
+  const toToolPath = (file: string) => join(projectDir, relative(absoluteDir, file));
+  const isCallable = symbol.type === 'function' || symbol.type === 'method';
+  const isCall = (type: string) => type === 'direct' || type === 'method';
+  const references = index
+    .findCallers(symbol.id, true)
+    .filter((ref) => ref.type === 'callback' || (isCallable && isCall(ref.type)))
+    .filter((ref) => ref.filePath === absoluteDir || ref.filePath.startsWith(absoluteDir + sep));
+  // Columns are reported in UTF-16 code units, as the parsers count them; a
+  // file changed since it was indexed has no line to convert against.
+  if (references.some((ref) => ref.lineColumn === undefined)) {
+    return null;
+  }
+  const callers = references
+    .sort((a, b) => a.filePath.localeCompare(b.filePath) || a.line - b.line || a.column - b.column)
+    .map((ref) =>
+      formatIndexedCallSite(
+        { ...ref, filePath: toToolPath(ref.filePath) },
+        symbolName,
+        index.getSymbol(ref.fromSymbolId)
+      )
+    );
+
+  const result: FindCallersResult = {
+    symbol: {
+      name: symbolName,
+      type: symbol.type,
+      filePath: toToolPath(absoluteFile),
+      line: symbol.line,
+    },
+    callers,
+    totalCount: callers.length,
+  };
+
+  logger.info('Found callers from project index', {
+    symbol: symbolName,
+    callerCount: callers.length,
+  });
+
+  return {
+    content: [
+      {
+        type: 'text',
+        text: JSON.stringify(result, null, 2),
+      },
+    ],
+  };
+}
+
+function formatIndexedCallSite(
+  reference: IndexedReference,
+  symbolName: string,
+  caller: { name: string; className?: string } | null
+): CallSite {
+  return {
+    filePath: reference.filePath,
+    lineNumber: reference.line,
+    columnNumber: reference.lineColumn ?? reference.column,
+    functionName: symbolName,
+    callerFunction: caller?.name,
+    callerClass: caller?.className,
+    callType:
+      reference.type === 'method' || reference.type === 'callback' ? reference.type : 'direct',
+  };
+}
+
 function getProjectDirectory(filePath: string): string {
   const stats = statSync(filePath);
   if (stats.isDirectory()) {
@@ -128,27 +239,43 @@ function getProjectDirectory(filePath: string): string {
   return filePath.split('/').slice(0, -1).join('/') || '.';
 }
 
-export function findSourceFiles(dir: string): string[] {
-  const files: string[] = [];
-  const extensions = ['.ts', '.tsx', '.js', '.jsx', '.py', '.pyw'];
-
-  const entries = readdirSync(dir, { withFileTypes: true });
+/**
+ * Directories no source walk enters: dependencies, VCS and other hidden
+ * directories, and build output. The native index skips the same ones
+ * (isSkippedDirectory in project_index.cc), so answers from a warm index and
+ * from parsing cover the same files.
+ */
+export function isSkippedDirectory(name: string): boolean {
+  return name === 'node_modules' || name === 'build' || name === 'dist' || name.startsWith('.');
+}
 
-  for (const entry of entries) {
-    const fullPath = join(dir, entry.name);
+/**
+ * Files under dir with a supported extension, the scope the native index
+ * warms. A source file given as dir is returned as is; a missing path has none.
+ */
+export function findSourceFiles(dir: string): string[] {
+  try {
+    if (!statSync(dir).isDirectory()) {
+      return ParserFactory.detectLanguage(dir) !== null ? [dir] : [];
+    }
+  } catch {
+    return [];
+  }
 
-    if (entry.isDirectory()) {
-      if (entry.name !== 'node_modules' && entry.name !== '.git' && !entry.name.startsWith('.')) {
-        files.push(...findSourceFiles(fullPath));
-      }
-    } else if (entry.isFile()) {
-      const ext = extname(fullPath);
-      if (extensions.includes(ext)) {
+  const files: string[] = [];
+  const walk = (current: string): void => {
+    for (const entry of readdirSync(current, { withFileTypes: true })) {
+      const fullPath = join(current, entry.name);
+      if (entry.isDirectory()) {
+        if (!isSkippedDirectory(entry.name)) {
+          walk(fullPath);
+        }
+      } else if (entry.isFile() && ParserFactory.detectLanguage(fullPath) !== null) {
         files.push(fullPath);
       }
     }
-  }
-
+  };
+  walk(dir);
   return files;
 }
 
@@ -425,7 +552,7 @@ async function findCallersForSymbol(
 ): Promise<SymbolReference[]> {
   const callers: SymbolReference[] = [];
 
-  for (const file of files) {
+  for (const file of await filterCandidateFiles(files, [symbol.name])) {
     try {
       const parser = ParserFactory.getParserForFile(file);
       const result = await parser.parseFile(file);
@@ -534,6 +661,50 @@ export function findReferences(
   return references;
 }
 
+/**
+ * findReferences over files, parsing only those whose identifier postings in
+ * the project index hold an occurrence findReferences could match. Reference
+ * spans and enclosing names are the parser's, so the result is the same as
+ * parsing every file. Returns null unless every file is indexed. Reference
+ * paths are reported in the same form as files.
+ */
+export async function findReferencesFromIndex(
+  targetSymbol: SymbolDefinition,
+  files: string[]
+): Promise<SymbolReference[] | null> {
+  const index = await getProjectIndexForFiles(files);
+  if (!index) {
+    return null;
+  }
+
+  const isCallable = targetSymbol.type === 'function' || targetSymbol.type === 'method';
+  const matched = new Set<string>();
+  for (const usage of index.findUsages(targetSymbol.name)) {
+    // Calls of functions and methods, and the object of a Python attribute
+    // call; a variable anywhere but as a key or method name; any argument
+    if (
+      (isCallable && usage.kind !== 'declaration') ||
+      (targetSymbol.type === 'variable' && (!usage.isProperty || usage.isMember)) ||
+      usage.isArgument
+    ) {
+      matched.add(usage.filePath);
+    }
+  }
+
+  const references: SymbolReference[] = [];
+  for (const file of files.filter((file) => matched.has(resolve(file)))) {
+    try {
+      const parser = ParserFactory.getParserForFile(file);
+      const result = await parser.parseFile(file);
+      references.push(...findReferences(result.tree, file, targetSymbol));
+    } catch (error) {
+      logger.warn(`Failed to find references in ${file}`, error as Record<string, unknown>);
+    }
+  }
+
+  return references;
+}
+
 function formatCallSite(reference: SymbolReference, symbolName: string): CallSite {
   return {
     filePath: reference.filePath,
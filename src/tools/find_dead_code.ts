@@ -2,8 +2,10 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { logger } from '../utils/logger.js';
 import type { ASTNode, SymbolDefinition } from '../types/ast.js';
-import { readdirSync, statSync, readFileSync, existsSync } from 'fs';
-import { join, extname, basename } from 'path';
+import { readFileSync, existsSync } from 'fs';
+import { extname, basename, resolve } from 'path';
+import { getProjectIndexForFiles, getNativeGraph, SymbolFlags } from '../graph/indexer.js';
+import { findSourceFiles } from './find_callers.js';
 
 const REACT_LIFECYCLE_METHODS = new Set([
   'constructor',
@@ -105,6 +107,38 @@ function isConfigurationFile(filePath: string): boolean {
   return false;
 }
 
+/**
+ * JS fallback for the native classifySymbols: the same SymbolFlags, matched
+ * pattern by pattern.
+ */
+function classifySymbol(symbol: SymbolDefinition): number {
+  let flags = 0;
+  if (symbol.type === 'class' && isMiddlewareClass(symbol.name, symbol.filePath)) {
+    flags |= SymbolFlags.MiddlewareClass;
+  }
+  if (symbol.className && isMiddlewareClass(symbol.className, symbol.filePath)) {
+    flags |= SymbolFlags.InMiddlewareClass;
+  }
+  if (isFrameworkMethod(symbol.name)) flags |= SymbolFlags.FrameworkMethod;
+  if (REACT_LIFECYCLE_METHODS.has(symbol.name)) flags |= SymbolFlags.ReactLifecycle;
+  if (symbol.name.startsWith('__') && symbol.name.endsWith('__')) flags |= SymbolFlags.PythonMagic;
+  if (isConfigurationFile(symbol.filePath)) flags |= SymbolFlags.InConfigFile;
+
+  const isMethod = symbol.type === 'method';
+  const isPython = ['.py', '.pyw'].includes(extname(symbol.filePath).toLowerCase());
+  if ((symbol.type === 'function' || isMethod) && flags & SymbolFlags.PythonMagic) {
+    flags |= SymbolFlags.DeadCodeRoot;
+  }
+  // Framework lifecycle methods in middleware/filter/handler classes are called by the framework
+  if (isMethod && flags & SymbolFlags.InMiddlewareClass && flags & SymbolFlags.FrameworkMethod) {
+    flags |= SymbolFlags.DeadCodeRoot;
+  }
+  if (isMethod && !isPython && flags & SymbolFlags.ReactLifecycle) {
+    flags |= SymbolFlags.DeadCodeRoot;
+  }
+  return flags;
+}
+
 function extractClassReferencesFromConfig(filePath: string): Set<string> {
   const references = new Set<string>();
 
@@ -321,9 +355,12 @@ export default async function findDeadCode(args: Record<string, unknown>): Promi
     const symbolTable = await buildSymbolTable(files);
     const allSymbols = Object.values(symbolTable);
 
-    const referenceMap = await buildReferenceMap(files, symbolTable);
+    const referenceMap =
+      (await buildReferenceMapFromIndex(files, symbolTable)) ??
+      (await buildReferenceMap(files, symbolTable));
 
-    const configReferences = await buildConfigReferenceMap(files);
+    const configReferences =
+      (await buildConfigReferenceMapFromIndex(files)) ?? (await buildConfigReferenceMap(files));
 
     const unusedSymbols: DeadCodeSymbol[] = [];
     const warnings: string[] = [];
@@ -413,48 +450,6 @@ export default async function findDeadCode(args: Record<string, unknown>): Promi
   }
 }
 
-function findSourceFiles(dir: string): string[] {
-  const files: string[] = [];
-  const extensions = ['.ts', '.tsx', '.js', '.jsx', '.py', '.pyw'];
-
-  try {
-    const stats = statSync(dir);
-    if (!stats.isDirectory()) {
-      if (extensions.includes(extname(dir))) {
-        return [dir];
-      }
-      return [];
-    }
-  } catch {
-    return [];
-  }
-
-  const entries = readdirSync(dir, { withFileTypes: true });
-
-  for (const entry of entries) {
-    const fullPath = join(dir, entry.name);
-
-    if (entry.isDirectory()) {
-      if (
-        entry.name !== 'node_modules' &&
-        entry.name !== '.git' &&
-        entry.name !== 'build' &&
-        entry.name !== 'dist' &&
-        !entry.name.startsWith('.')
-      ) {
-        files.push(...findSourceFiles(fullPath));
-      }
-    } else if (entry.isFile()) {
-      const ext = extname(fullPath);
-      if (extensions.includes(ext)) {
-        files.push(fullPath);
-      }
-    }
-  }
-
-  return files;
-}
-
 interface SymbolTable {
   [symbolId: string]: SymbolDefinition;
 }
@@ -478,9 +473,26 @@ async function buildSymbolTable(files: string[]): Promise<SymbolTable> {
     }
   }
 
+  await markFrameworkRoots(Object.values(symbolTable));
   return symbolTable;
 }
 
+/**
+ * Marks symbols that frameworks call by name (lifecycle hooks, middleware
+ * methods, magic methods) as externally used. Every symbol is classified in one
+ * native pass when the addon is available.
+ */
+async function markFrameworkRoots(symbols: SymbolDefinition[]): Promise<void> {
+  const native = await getNativeGraph();
+  const flags = native ? native.classifySymbols(symbols) : symbols.map(classifySymbol);
+
+  symbols.forEach((symbol, i) => {
+    if ((flags[i] ?? 0) & SymbolFlags.DeadCodeRoot) {
+      symbol.isExported = true;
+    }
+  });
+}
+
 async function buildConfigReferenceMap(files: string[]): Promise<Set<string>> {
   const references = new Set<string>();
 
@@ -496,6 +508,20 @@ async function buildConfigReferenceMap(files: string[]): Promise<Set<string>> {
   return references;
 }
 
+/**
+ * Same references as buildConfigReferenceMap, recorded natively as edges from
+ * the config root when each file was indexed. Returns null unless every file is
+ * indexed.
+ */
+async function buildConfigReferenceMapFromIndex(files: string[]): Promise<Set<string> | null> {
+  const index = await getProjectIndexForFiles(files);
+  if (!index) {
+    return null;
+  }
+
+  return new Set(index.getConfigReferences(files.map((file) => resolve(file))));
+}
+
 function collectExportedNames(root: ASTNode): Set<string> {
   const exportedNames = new Set<string>();
 
@@ -612,6 +638,32 @@ async function buildReferenceMap(
   return referenceMap;
 }
 
+/**
+ * Same counts as buildReferenceMap, taken from the project index's per-file
+ * usage table in one native join. Returns null unless every file is indexed.
+ */
+async function buildReferenceMapFromIndex(
+  files: string[],
+  symbolTable: SymbolTable
+): Promise<Map<string, number> | null> {
+  const index = await getProjectIndexForFiles(files);
+  if (!index) {
+    return null;
+  }
+
+  const indexedFiles = files.map((file) => resolve(file));
+  const symbols = Object.values(symbolTable);
+  const names = Array.from(new Set(symbols.map((symbol) => symbol.name)));
+  const counts = index.countUsages(names, indexedFiles);
+  const countByName = new Map(names.map((name, i) => [name, counts[i] ?? 0]));
+
+  const referenceMap = new Map<string, number>();
+  for (const symbol of symbols) {
+    referenceMap.set(symbol.id, countByName.get(symbol.name) ?? 0);
+  }
+  return referenceMap;
+}
+
 function collectUsedIdentifiers(node: ASTNode, usedNames: Set<string>, currentFile: string): void {
   if (node.type.includes('import')) {
     return;
@@ -731,12 +783,6 @@ function extractSymbols(
         const name = extractName(node);
         if (name) {
           const isMethod = parentClass !== undefined;
-          const isPythonMagic = name.startsWith('__') && name.endsWith('__');
-          const isFramework = isFrameworkMethod(name);
-          const parentIsMiddleware = parentClass ? isMiddlewareClass(parentClass, filePath) : false;
-          
-          // Framework lifecycle methods in middleware/filter/handler classes should be marked as used
-          const isMiddlewareLifecycleMethod = isMethod && parentIsMiddleware && isFramework;
 
           symbols.push({
             id: generateSymbolId({
@@ -751,7 +797,7 @@ function extractSymbols(
             filePath,
             startPosition: node.startPosition,
             endPosition: node.endPosition,
-            isExported: exportedNames.has(name) || isExported(node) || isPythonMagic || isMiddlewareLifecycleMethod,
+            isExported: exportedNames.has(name) || isExported(node),
           });
         }
         break;
@@ -760,16 +806,7 @@ function extractSymbols(
       case 'method_definition': {
         const name = extractName(node);
         if (name) {
-          const isReactLifecycle = REACT_LIFECYCLE_METHODS.has(name);
-          const isPythonMagic = name.startsWith('__') && name.endsWith('__');
-          const isFramework = isFrameworkMethod(name);
-          const parentIsMiddleware = parentClass ? isMiddlewareClass(parentClass, filePath) : false;
-          
-          // Framework lifecycle methods in middleware/filter/handler classes should be marked as used
-          const isMiddlewareLifecycleMethod = parentIsMiddleware && isFramework;
-
-          const isExported = isReactLifecycle || isPythonMagic || isMiddlewareLifecycleMethod;
-
+          // Lifecycle and middleware hooks are marked by markFrameworkRoots
           symbols.push({
             id: generateSymbolId({ name, className: parentClass, filePath, type: 'method' }),
             name,
@@ -778,7 +815,7 @@ function extractSymbols(
             filePath,
             startPosition: node.startPosition,
             endPosition: node.endPosition,
-            isExported,
+            isExported: false,
           });
         }
         break;
@@ -788,7 +825,6 @@ function extractSymbols(
       case 'class_definition': {
         const className = extractClassName(node);
         if (className) {
-          const isMiddleware = isMiddlewareClass(className, filePath);
           const parentIsExported = exportedNames.has(className) || isExported(node);
           
           // Don't automatically mark middleware classes as exported - let usage determine that
@@ -1,5 +1,9 @@
 import type { ToolResponse } from '../types/mcp.js';
+import { readFile } from 'fs/promises';
+import { resolve } from 'path';
 import { ParserFactory } from '../parsers/factory.js';
+import { getNativeGraph } from '../graph/indexer.js';
+import type { NativePatternMatch } from '../graph/native/index.js';
 import { logger } from '../utils/logger.js';
 
 interface PatternMatch {
@@ -17,6 +21,42 @@ interface PatternMatch {
   }>;
 }
 
+/**
+ * Converts native matches, with 0-based positions, to the tool's 1-based shape.
+ */
+function fromNativeMatches(matches: NativePatternMatch[]): PatternMatch[] {
+  return matches.map((match) => {
+    const captures: PatternMatch['captures'] = {};
+    let start = { row: Infinity, column: Infinity };
+    let end = { row: 0, column: 0 };
+    for (const capture of match.captures) {
+      captures[capture.name] = {
+        text: capture.text,
+        range: {
+          start: { line: capture.startPosition.row + 1, column: capture.startPosition.column + 1 },
+          end: { line: capture.endPosition.row + 1, column: capture.endPosition.column + 1 },
+        },
+        type: capture.type,
+      };
+      const s = capture.startPosition;
+      const e = capture.endPosition;
+      if (s.row < start.row || (s.row === start.row && s.column < start.column)) {
+        start = s;
+      }
+      if (e.row > end.row || (e.row === end.row && e.column > end.column)) {
+        end = e;
+      }
+    }
+    return {
+      range: {
+        start: { line: start.row + 1, column: start.column + 1 },
+        end: { line: end.row + 1, column: end.column + 1 },
+      },
+      captures,
+    };
+  });
+}
+
 export default async function findPatterns(args: Record<string, unknown>): Promise<ToolResponse> {
   const { filePath, query } = args;
 
@@ -35,6 +75,24 @@ export default async function findPatterns(args: Record<string, unknown>): Promi
   try {
     logger.info('Searching patterns', { filePath, query });
 
+    // Compiled queries are cached natively; parsers and cursors are reused per thread
+    const native = await getNativeGraph();
+    if (native) {
+      const absolutePath = resolve(filePath);
+      const source = native.readSource(absolutePath) ?? (await readFile(absolutePath));
+      const matches = native.findPatterns(source, absolutePath, query);
+      if (matches) {
+        return {
+          content: [
+            {
+              type: 'text',
+              text: JSON.stringify(fromNativeMatches(matches), null, 2),
+            },
+          ],
+        };
+      }
+    }
+
     const parser = ParserFactory.getParserForFile(filePath);
 
     // Access the underlying native parser instance
@@ -71,8 +129,7 @@ export default async function findPatterns(args: Record<string, unknown>): Promi
         throw new Error('Tree-sitter Query constructor not found on Parser class');
     }
     
-    const fs = await import('fs/promises');
-    const content = await fs.readFile(filePath, 'utf-8');
+    const content = await readFile(filePath, 'utf-8');
     const rawTree = parserInstance.parser.parse(content);
     
     const matches = treeSitterQuery.matches(rawTree.rootNode);
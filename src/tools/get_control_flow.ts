@@ -1,5 +1,8 @@
 import type { ToolResponse } from '../types/mcp.js';
+import { readFile } from 'fs/promises';
+import { resolve } from 'path';
 import { ParserFactory } from '../parsers/factory.js';
+import { getNativeGraph } from '../graph/indexer.js';
 import { logger } from '../utils/logger.js';
 import type { ASTNode } from '../types/ast.js';
 
@@ -8,6 +11,7 @@ interface CFGNode {
   type: 'entry' | 'exit' | 'normal' | 'condition' | 'loop' | 'exception';
   label: string;
   statements: string[];
+  unreachable?: boolean;
 }
 
 interface CFGEdge {
@@ -39,6 +43,24 @@ export default async function getControlFlow(args: Record<string, unknown>): Pro
   try {
     logger.info('Analyzing control flow', { filePath, functionName });
 
+    // Native graphs are cached by file, function and content hash
+    const native = await getNativeGraph();
+    if (native) {
+      const absolutePath = resolve(filePath);
+      const source = native.readSource(absolutePath) ?? (await readFile(absolutePath));
+      const cfg = native.buildControlFlow(source, absolutePath, functionName);
+      if (cfg) {
+        return {
+          content: [
+            {
+              type: 'text',
+              text: JSON.stringify(cfg, null, 2),
+            },
+          ],
+        };
+      }
+    }
+
     const parser = ParserFactory.getParserForFile(filePath);
     const result = await parser.parseFile(filePath);
 
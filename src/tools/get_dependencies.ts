@@ -4,6 +4,7 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { extractSkeleton } from './get_skeleton.js';
 import { logger } from '../utils/logger.js';
+import { getProjectIndex } from '../graph/indexer.js';
 import type { ImportStatement, ASTNode } from '../types/ast.js';
 
 export async function getDependencies(args: Record<string, unknown>): Promise<ToolResponse> {
@@ -18,7 +19,6 @@ export async function getDependencies(args: Record<string, unknown>): Promise<To
 
   try {
     const filesToProcess: string[] = [];
-    const rootPath = (directoryPath as string) || path.dirname(filePath as string);
 
     if (directoryPath) {
        // Recursively find all supported files
@@ -27,6 +27,8 @@ export async function getDependencies(args: Record<string, unknown>): Promise<To
        filesToProcess.push(filePath as string);
     }
 
+    // The native resolver reads only the filesystem, so it needs no warm index
+    const index = await getProjectIndex();
     const dependencyGraph: Record<string, string[]> = {};
     const allImports: Record<string, ImportStatement[]> = {};
     const unusedImports: Record<string, string[]> = {};
@@ -41,8 +43,10 @@ export async function getDependencies(args: Record<string, unknown>): Promise<To
       dependencyGraph[file] = [];
 
       for (const imp of skeleton.imports) {
-        const resolved = resolveImport(file, imp.source);
-        if (resolved && fs.existsSync(resolved)) {
+        const resolved = index
+          ? index.resolveImport(path.resolve(file), imp.source)
+          : resolveImport(file, imp.source);
+        if (resolved) {
            dependencyGraph[file].push(resolved);
         }
       }
@@ -51,6 +55,8 @@ export async function getDependencies(args: Record<string, unknown>): Promise<To
       const importedNames: string[] = [];
       for (const imp of skeleton.imports) {
           for (const item of imp.imported) {
+              // `from module import *` binds no name of its own
+              if (item.name === '*') continue;
               importedNames.push(item.alias || item.name);
           }
       }
@@ -2,12 +2,17 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { logger } from '../utils/logger.js';
 import type { ASTNode } from '../types/ast.js';
+import { getProjectIndexForFiles } from '../graph/indexer.js';
+import { resolve } from 'path';
 
 interface ImportItem {
   source: string;
   type: 'static' | 'dynamic' | 'require';
   specifiers?: string[];
   isTypeOnly?: boolean;
+  resolvedPath?: string;
+  /** Specifier -> file that really defines it, when re-exported through barrels. */
+  definedIn?: Record<string, string>;
 }
 
 export default async function getImports(args: Record<string, unknown>): Promise<ToolResponse> {
@@ -99,6 +104,7 @@ export default async function getImports(args: Record<string, unknown>): Promise
     }
     
     traverse(tree);
+    await resolveDefinitions(filePath, imports);
 
     return {
       content: [
@@ -122,6 +128,39 @@ export default async function getImports(args: Record<string, unknown>): Promise
   }
 }
 
+/**
+ * Adds each import's target file and, for names a barrel re-exports, the file
+ * that defines them, from the project index's export table. Leaves imports
+ * untouched without a warm index.
+ */
+async function resolveDefinitions(filePath: string, imports: ImportItem[]): Promise<void> {
+  if (imports.length === 0) {
+    return;
+  }
+
+  const absolutePath = resolve(filePath);
+  const index = await getProjectIndexForFiles([absolutePath], { recordAccess: true });
+  if (!index) {
+    return;
+  }
+
+  for (const item of imports) {
+    const target = index.resolveImport(absolutePath, item.source);
+    if (!target) {
+      continue;
+    }
+    item.resolvedPath = target;
+
+    for (const specifier of item.specifiers ?? []) {
+      const origin = index.resolveExport(target, specifier);
+      if (origin?.filePath && origin.filePath !== target) {
+        item.definedIn ??= {};
+        item.definedIn[specifier] = origin.filePath;
+      }
+    }
+  }
+}
+
 function processImportStatement(node: ASTNode): ImportItem[] {
     const items: ImportItem[] = [];
     const sourceNode = node.namedChildren.find(c => c.type === 'string');
@@ -2,6 +2,8 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { logger } from '../utils/logger.js';
 import type { ASTNode } from '../types/ast.js';
+import { getProjectIndexForFiles } from '../graph/indexer.js';
+import { resolve } from 'path';
 
 interface ExportItem {
   name: string;
@@ -10,6 +12,8 @@ interface ExportItem {
   members?: string[]; // For classes/interfaces
   source?: string; // For re-exports
   isDefault?: boolean;
+  definedIn?: string; // Re-exports: file that really defines it, through any barrels
+  originalName?: string; // Re-exports: name in definedIn when aliased
 }
 
 export default async function getPublicSurface(args: Record<string, unknown>): Promise<ToolResponse> {
@@ -30,29 +34,14 @@ export default async function getPublicSurface(args: Record<string, unknown>): P
   try {
     logger.info('Analyzing public surface', { filePath });
 
-    const parser = ParserFactory.getParserForFile(filePath);
-    const result = await parser.parseFile(filePath);
-    const tree = result.tree;
-
-    const exports: ExportItem[] = [];
-    
-    // Traverse top-level nodes for exports
-    for (const node of tree.namedChildren) {
-        if (node.type === 'export_statement') {
-            exports.push(...processExportStatement(node));
-        } else if (node.type === 'export_clause') {
-            // Note: export declaration usually wraps export clause in tree-sitter?
-            // "export { x }" is an export_statement containing an export_clause in some grammars
-            // Checking structure:
-            // export_statement -> export_clause
-        } 
-    }
+    const exports = (await getIndexedSurface(filePath)) ?? (await parseSurface(filePath));
+    const resolvedExports = await resolveReExports(filePath, exports);
 
     return {
       content: [
         {
           type: 'text',
-          text: JSON.stringify(exports, null, 2),
+          text: JSON.stringify(resolvedExports, null, 2),
         },
       ],
     };
@@ -70,6 +59,85 @@ export default async function getPublicSurface(args: Record<string, unknown>): P
   }
 }
 
+/**
+ * The surface the project index recorded when it last indexed filePath, so
+ * the file is not parsed again. Null without a warm index that has the file.
+ */
+async function getIndexedSurface(filePath: string): Promise<ExportItem[] | null> {
+  const absolutePath = resolve(filePath);
+  const index = await getProjectIndexForFiles([absolutePath]);
+  return index?.getPublicSurface(absolutePath) ?? null;
+}
+
+async function parseSurface(filePath: string): Promise<ExportItem[]> {
+  const parser = ParserFactory.getParserForFile(filePath);
+  const result = await parser.parseFile(filePath);
+  const exports: ExportItem[] = [];
+
+  // Traverse top-level nodes for exports
+  for (const node of result.tree.namedChildren) {
+    if (node.type === 'export_statement') {
+      exports.push(...processExportStatement(node));
+    }
+  }
+  return exports;
+}
+
+/**
+ * Follows re-exports through barrel files with the project index's export
+ * table: `export *` is expanded into the names it forwards and every
+ * re-export gets the file that defines it. Unchanged without a warm index.
+ */
+async function resolveReExports(filePath: string, exports: ExportItem[]): Promise<ExportItem[]> {
+  if (!exports.some((item) => item.type === 're-export')) {
+    return exports;
+  }
+
+  const absolutePath = resolve(filePath);
+  const index = await getProjectIndexForFiles([absolutePath]);
+  if (!index) {
+    return exports;
+  }
+
+  const origins = new Map(index.getExports(absolutePath).map((origin) => [origin.name, origin]));
+  const result: ExportItem[] = [];
+  const listed = new Set<string>();
+
+  for (const item of exports) {
+    // Expanded below, unless it forwards a package the index cannot see into
+    if (
+      item.type === 're-export' &&
+      item.name === '*' &&
+      index.resolveImport(absolutePath, item.source!)
+    ) {
+      continue;
+    }
+    const origin = item.type === 're-export' ? origins.get(item.name) : undefined;
+    if (origin?.filePath) {
+      item.definedIn = origin.filePath;
+      if (origin.localName !== item.name) item.originalName = origin.localName;
+    }
+    result.push(item);
+    listed.add(item.name);
+  }
+
+  // Names forwarded by `export * from`
+  for (const origin of origins.values()) {
+    if (listed.has(origin.name) || origin.depth === 0) {
+      continue;
+    }
+    result.push({
+      name: origin.name,
+      type: 're-export',
+      ...(origin.module ? { source: origin.module } : {}),
+      ...(origin.filePath ? { definedIn: origin.filePath } : {}),
+      ...(origin.localName !== origin.name ? { originalName: origin.localName } : {}),
+    });
+  }
+
+  return result;
+}
+
 function processExportStatement(node: ASTNode): ExportItem[] {
     const items: ExportItem[] = [];
     
@@ -223,7 +291,7 @@ function extractSignature(node: ASTNode): string {
     // Reconstruct signature from params and return type
     const params = node.namedChildren.find(c => c.type === 'formal_parameters');
     const returnType = node.namedChildren.find(c => c.type === 'type_annotation'); // TS
-    return `(${params?.text || ''})${returnType ? returnType.text : ''}`;
+    return `${params?.text || '()'}${returnType ? returnType.text : ''}`;
 }
 
 function extractClassMembers(node: ASTNode): string[] {
@@ -233,7 +301,13 @@ function extractClassMembers(node: ASTNode): string[] {
 
     for (const member of body.namedChildren) {
         // Filter private
-        if (member.type === 'method_definition' || member.type === 'public_field_definition') {
+        if (
+            member.type === 'method_definition' ||
+            member.type === 'public_field_definition' ||
+            member.type === 'field_definition' ||
+            member.type === 'property_signature' ||
+            member.type === 'method_signature'
+        ) {
              // Check modifiers
              const accessibility = member.children.find(c => c.type === 'accessibility_modifier');
              if (accessibility && accessibility.text !== 'public') continue;
@@ -2,27 +2,32 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { ParserError } from '../utils/errors.js';
 import { logger } from '../utils/logger.js';
+import { getProjectIndexForFiles, getWarmProjectIndex } from '../graph/indexer.js';
+import { findSourceFiles } from './find_callers.js';
+import { join, relative, resolve } from 'path';
 import type {
   FileSkeleton,
   ClassDefinition,
-  FunctionDefinition,
   Method,
   Parameter,
   Property,
   ASTNode,
   ImportStatement,
   VariableDeclaration,
+  InterfaceDefinition,
+  EnumDefinition,
+  TypeAlias,
 } from '../types/ast.js';
 
 export async function getSkeleton(args: Record<string, unknown>): Promise<ToolResponse> {
-  const { filePath } = args;
+  const { filePath, directoryPath } = args;
 
-  if (typeof filePath !== 'string') {
+  if (typeof filePath !== 'string' && typeof directoryPath !== 'string') {
     return {
       content: [
         {
           type: 'text',
-          text: 'Invalid arguments: filePath must be a string',
+          text: 'Invalid arguments: either filePath or directoryPath must be provided',
         },
       ],
       isError: true,
@@ -30,13 +35,23 @@ export async function getSkeleton(args: Record<string, unknown>): Promise<ToolRe
   }
 
   try {
-    logger.info('Extracting skeleton', { filePath });
+    if (typeof directoryPath === 'string') {
+      logger.info('Extracting skeletons', { directoryPath });
+      const skeletons = await getDirectorySkeletons(directoryPath);
+      return {
+        content: [
+          {
+            type: 'text',
+            text: JSON.stringify(skeletons, null, 2),
+          },
+        ],
+      };
+    }
 
-    const parser = ParserFactory.getParserForFile(filePath);
-    const result = await parser.parseFile(filePath);
-    const language = parser.getLanguage();
+    logger.info('Extracting skeleton', { filePath });
 
-    const skeleton = extractSkeleton(result.tree, filePath, language);
+    const skeleton =
+      (await getIndexedSkeleton(filePath as string)) ?? (await parseSkeleton(filePath as string));
 
     logger.info('Skeleton extracted successfully', {
       filePath,
@@ -53,7 +68,7 @@ export async function getSkeleton(args: Record<string, unknown>): Promise<ToolRe
       ],
     };
   } catch (error) {
-    logger.error('Failed to extract skeleton', error as Error, { filePath });
+    logger.error('Failed to extract skeleton', error as Error, { filePath, directoryPath });
 
     if (error instanceof ParserError) {
       return {
@@ -74,6 +89,62 @@ export async function getSkeleton(args: Record<string, unknown>): Promise<ToolRe
   }
 }
 
+async function parseSkeleton(filePath: string): Promise<FileSkeleton> {
+  const parser = ParserFactory.getParserForFile(filePath);
+  const result = await parser.parseFile(filePath);
+  return extractSkeleton(result.tree, filePath, parser.getLanguage());
+}
+
+/**
+ * The skeleton the project index computed when it last indexed filePath, so
+ * the file is not parsed again. Null without a warm index that has the file.
+ */
+async function getIndexedSkeleton(filePath: string): Promise<FileSkeleton | null> {
+  const absolutePath = resolve(filePath);
+  const index = await getProjectIndexForFiles([absolutePath]);
+  const skeleton = index?.getSkeleton(absolutePath);
+  if (!skeleton) {
+    return null;
+  }
+  return {
+    ...skeleton,
+    filePath,
+    language: ParserFactory.detectLanguage(filePath) ?? skeleton.language,
+  };
+}
+
+/** Skeletons of every source file under directoryPath, from the index when it covers it. */
+async function getDirectorySkeletons(directoryPath: string): Promise<FileSkeleton[]> {
+  const index = await getWarmProjectIndex(directoryPath);
+  if (index) {
+    // Paths in the caller's form and order, as the parsing walk gives them
+    const absoluteDir = resolve(directoryPath);
+    return index
+      .getSkeletons(absoluteDir)
+      .map((skeleton) => ({
+        ...skeleton,
+        filePath: join(directoryPath, relative(absoluteDir, skeleton.filePath)),
+        language: ParserFactory.detectLanguage(skeleton.filePath) ?? skeleton.language,
+      }))
+      .sort((a, b) => (a.filePath < b.filePath ? -1 : a.filePath > b.filePath ? 1 : 0));
+  }
+
+  const skeletons: FileSkeleton[] = [];
+  for (const file of findSourceFiles(directoryPath).sort()) {
+    try {
+      skeletons.push(await parseSkeleton(file));
+    } catch (error) {
+      logger.warn(`Failed to parse ${file}`, error as Record<string, unknown>);
+    }
+  }
+  return skeletons;
+}
+
+/**
+ * The outline of a parsed file. Follows the rules of the native index's
+ * skeleton (src/graph/native/skeleton.cc) field for field, so a tool returns
+ * the same skeleton whether or not the index is warm.
+ */
 export function extractSkeleton(root: ASTNode, filePath: string, language: string): FileSkeleton {
   const skeleton: FileSkeleton = {
     filePath,
@@ -90,92 +161,119 @@ export function extractSkeleton(root: ASTNode, filePath: string, language: strin
   };
 
   if (language === 'typescript' || language === 'javascript') {
-    extractTypeScriptSkeleton(root, skeleton);
+    for (const statement of root.namedChildren) {
+      extractTypeScriptStatement(statement, skeleton);
+    }
   } else if (language === 'python') {
-    extractPythonSkeleton(root, skeleton);
+    for (const statement of root.namedChildren) {
+      extractPythonStatement(statement, skeleton);
+    }
   }
 
   return skeleton;
 }
 
-function extractTypeScriptSkeleton(root: ASTNode, skeleton: FileSkeleton): void {
-  const statements = root.children;
-
-  for (const statement of statements) {
-    switch (statement.type) {
-      case 'import_statement':
-        skeleton.imports.push(extractTypeScriptImport(statement));
-        break;
-      case 'export_statement':
-        extractTypeScriptExport(statement, skeleton);
-        break;
-      case 'class_declaration':
-        skeleton.exports.classes.push(extractTypeScriptClass(statement));
-        break;
-      case 'function_declaration':
-      case 'function_definition':
-        const func = extractTypeScriptFunction(statement);
-        if (func.name !== 'constructor') {
-          skeleton.exports.functions.push(func);
-        }
-        break;
-      case 'variable_declaration':
-      case 'lexical_declaration': {
-        const variable = extractTypeScriptVariable(statement);
-        if (variable.isExported) {
-          skeleton.exports.variables.push(variable);
-        }
-        break;
-      }
+type Visibility = 'public' | 'private' | 'protected';
 
-      case 'type_alias_declaration':
-        skeleton.exports.typeAliases.push(extractTypeAlias(statement));
-        break;
-    }
+interface Modifiers {
+  visibility?: Visibility;
+  isStatic?: boolean;
+  isReadonly?: boolean;
+  isAsync?: boolean;
+  isGenerator?: boolean;
+  isAbstract?: boolean;
+}
+
+interface ExportFlags {
+  isExported?: boolean;
+  isDefault?: boolean;
+}
+
+/** The first child in the named field, as tree-sitter's childByFieldName. */
+function field(node: ASTNode | undefined, name: string): ASTNode | undefined {
+  return node?.children.find((child) => child.field === name);
+}
+
+function text(node: ASTNode | undefined): string {
+  return node?.text ?? '';
+}
+
+function hasChildOfType(node: ASTNode, type: string): boolean {
+  return node.children.some((child) => child.type === type);
+}
+
+function stripQuotes(value: string): string {
+  const quote = value[0];
+  if (value.length >= 2 && (quote === '"' || quote === "'" || quote === '`')) {
+    return value.endsWith(quote) ? value.slice(1, -1) : value;
+  }
+  return value;
+}
+
+// `Promise<User>` -> `Promise`, as the TypeScript tools report return types.
+function withoutTypeArguments(type: string): string {
+  const open = type.indexOf('<');
+  if (open <= 0 || !type.endsWith('>')) return type;
+  const base = type.slice(0, open);
+  return /^\w+$/.test(base) ? base : type;
+}
+
+/** The type inside a `: Type` annotation. */
+function annotatedType(annotation: ASTNode | undefined): string {
+  if (!annotation) return '';
+  if (annotation.type !== 'type_annotation') return annotation.text;
+  return text(annotation.namedChildren[0]);
+}
+
+function extractDecorator(node: ASTNode): string {
+  return text(node.namedChildren[0] ?? node);
+}
+
+function extractParameter(name: string, type: string, defaultValue: string): Parameter {
+  const parameter: Parameter = { name };
+  if (type) parameter.type = type;
+  if (defaultValue) parameter.defaultValue = defaultValue;
+  return parameter;
+}
+
+function extractTypeScriptStatement(node: ASTNode, skeleton: FileSkeleton): void {
+  if (node.type === 'import_statement') {
+    skeleton.imports.push(extractTypeScriptImport(node));
+  } else if (node.type === 'export_statement') {
+    extractTypeScriptExport(node, skeleton);
+  } else {
+    extractTypeScriptDeclaration(node, {}, skeleton);
   }
 }
 
 function extractTypeScriptImport(node: ASTNode): ImportStatement {
   const imp: ImportStatement = {
     type: 'import',
-    source: '',
+    source: stripQuotes(text(field(node, 'source'))),
     imported: [],
   };
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'string') {
-      imp.source = child.text.slice(1, -1);
-    } else if (child.type === 'import_clause') {
-      for (const clauseChild of child.namedChildren) {
-        if (clauseChild.type === 'identifier') {
-          imp.imported.push({ name: clauseChild.text });
-          imp.isDefault = true;
-        } else if (clauseChild.type === 'named_imports') {
-          for (const named of clauseChild.namedChildren.filter(
-            (n) => n.type === 'import_specifier'
-          )) {
-            const parts = named.namedChildren.filter(
-              (n) => n.type === 'identifier' || n.type === 'property_identifier'
-            );
-            if (parts.length === 1) {
-              imp.imported.push({ name: parts[0]?.text ?? '' });
-            } else if (parts.length === 2) {
-              imp.imported.push({ name: parts[0]?.text ?? '', alias: parts[1]?.text });
-            }
-          }
-        } else if (clauseChild.type === 'namespace_import') {
-          const identifier = clauseChild.namedChildren.find((n) => n.type === 'identifier');
-          if (identifier) {
-            imp.imported.push({ name: identifier.text });
-            imp.isNamespace = true;
-          }
+  for (const clause of node.namedChildren) {
+    if (clause.type !== 'import_clause') continue;
+    for (const child of clause.namedChildren) {
+      if (child.type === 'identifier') {
+        imp.imported.push({ name: child.text });
+        imp.isDefault = true;
+      } else if (child.type === 'namespace_import') {
+        for (const name of child.namedChildren) {
+          if (name.type === 'identifier') imp.imported.push({ name: name.text });
         }
-      }
-    } else if (child.type === 'namespace_import') {
-      const identifier = child.namedChildren.find((n) => n.type === 'identifier');
-      if (identifier) {
-        imp.imported.push({ name: identifier.text });
         imp.isNamespace = true;
+      } else if (child.type === 'named_imports') {
+        for (const specifier of child.namedChildren) {
+          if (specifier.type !== 'import_specifier') continue;
+          const alias = text(field(specifier, 'alias'));
+          imp.imported.push(
+            alias
+              ? { name: text(field(specifier, 'name')), alias }
+              : { name: text(field(specifier, 'name')) }
+          );
+        }
       }
     }
   }
@@ -183,439 +281,324 @@ function extractTypeScriptImport(node: ASTNode): ImportStatement {
   return imp;
 }
 
-function extractTypeScriptExport(node: ASTNode, skeleton: FileSkeleton): void {
-  function processNode(n: ASTNode): void {
-    switch (n.type) {
-      case 'class_declaration':
-        skeleton.exports.classes.push(extractTypeScriptClass(n));
-        break;
-      case 'function_declaration':
-      case 'function_definition':
-        skeleton.exports.functions.push(extractTypeScriptFunction(n, true));
-        break;
-      case 'variable_declaration':
-        skeleton.exports.variables.push(extractTypeScriptVariable(n, true));
-        break;
-      case 'interface_declaration':
-        skeleton.exports.interfaces.push(extractTypeScriptInterface(n));
-        break;
-      case 'enum_declaration':
-        skeleton.exports.enums.push(extractTypeEnum(n));
-        break;
-      case 'type_alias_declaration':
-        skeleton.exports.typeAliases.push(extractTypeAlias(n));
-        break;
-      case 'export_clause':
-        for (const specifier of n.namedChildren.filter(
-          (child) => child.type === 'export_specifier'
-        )) {
-          const identifiers = specifier.namedChildren.filter(
-            (child) => child.type === 'identifier' || child.type === 'property_identifier'
-          );
-          if (identifiers.length > 0) {
-            skeleton.exports.variables.push({
-              type: 'variable',
-              name: identifiers[0]?.text ?? '',
-              isExported: true,
-              alias: identifiers.length > 1 ? identifiers[1]?.text : undefined,
-            } as any);
-          }
-        }
-        break;
+/** Adds the declaration node to the skeleton, when it is one. */
+function extractTypeScriptDeclaration(
+  node: ASTNode,
+  flags: ExportFlags,
+  skeleton: FileSkeleton
+): void {
+  switch (node.type) {
+    case 'class_declaration':
+    case 'abstract_class_declaration':
+      skeleton.exports.classes.push(extractTypeScriptClass(node));
+      break;
+    case 'function_declaration':
+    case 'generator_function_declaration':
+      skeleton.exports.functions.push({
+        type: 'function',
+        ...extractTypeScriptFunction(node, flags),
+      });
+      break;
+    case 'lexical_declaration':
+    case 'variable_declaration': {
+      // Only exported variables belong to the outline.
+      if (!flags.isExported) return;
+      const isConst = hasChildOfType(node, 'const');
+      for (const declarator of node.namedChildren) {
+        if (declarator.type !== 'variable_declarator') continue;
+        const variable: VariableDeclaration = {
+          type: 'variable',
+          name: text(field(declarator, 'name')),
+        };
+        const varType = annotatedType(field(declarator, 'type'));
+        if (varType) variable.varType = varType;
+        variable.isExported = true;
+        if (isConst) variable.isConst = true;
+        skeleton.exports.variables.push(variable);
+      }
+      break;
     }
-
-    for (const child of n.children) {
-      processNode(child);
+    case 'interface_declaration':
+      skeleton.exports.interfaces.push(extractTypeScriptInterface(node));
+      break;
+    case 'enum_declaration':
+      skeleton.exports.enums.push(extractTypeScriptEnum(node));
+      break;
+    case 'type_alias_declaration': {
+      const alias: TypeAlias = { type: 'type_alias', name: text(field(node, 'name')) };
+      const definition = text(field(node, 'value'));
+      if (definition) alias.definition = definition;
+      skeleton.exports.typeAliases.push(alias);
+      break;
     }
   }
+}
 
-  for (const child of node.children) {
-    processNode(child);
+function extractTypeScriptExport(node: ASTNode, skeleton: FileSkeleton): void {
+  const flags: ExportFlags = { isExported: true };
+  if (hasChildOfType(node, 'default')) flags.isDefault = true;
+  const declaration = field(node, 'declaration');
+  if (declaration) extractTypeScriptDeclaration(declaration, flags, skeleton);
+
+  for (const clause of node.namedChildren) {
+    if (clause.type !== 'export_clause') continue;
+    for (const specifier of clause.namedChildren) {
+      if (specifier.type !== 'export_specifier') continue;
+      const variable: VariableDeclaration = {
+        type: 'variable',
+        name: text(field(specifier, 'name')),
+      };
+      const alias = text(field(specifier, 'alias'));
+      if (alias) variable.alias = alias;
+      variable.isExported = true;
+      skeleton.exports.variables.push(variable);
+    }
   }
 }
 
 function extractTypeScriptClass(node: ASTNode): ClassDefinition {
-  const classDef: ClassDefinition = {
-    type: 'class',
-    name: '',
-    properties: [],
-    methods: [],
-  };
-
-  for (const child of node.children) {
-    if (child.type === 'type_identifier' || child.type === 'identifier') {
-      classDef.name = child.text;
+  let extendsName = '';
+  const implementsNames: string[] = [];
+  const decorators: string[] = [];
+  for (const child of node.namedChildren) {
+    if (child.type === 'decorator') {
+      decorators.push(extractDecorator(child));
     } else if (child.type === 'class_heritage') {
-      for (const heritage of child.namedChildren) {
-        if (heritage.type.includes('extends')) {
-          const identifier = heritage.namedChildren.find(
-            (n) => n.type === 'type_identifier' || n.type === 'identifier'
-          );
-          if (identifier) classDef.extends = identifier.text;
-        } else if (heritage.type.includes('implements')) {
-          const identifiers = heritage.namedChildren.filter((n) => n.type === 'type_identifier');
-          classDef.implements = identifiers.map((n) => n.text);
-        }
-      }
-    } else if (child.type === 'decorator') {
-      if (!classDef.decorators) classDef.decorators = [];
-      classDef.decorators.push(extractDecorator(child));
-    } else if (child.type === 'class_body') {
-      for (const member of child.children) {
-        if (member.type === 'public_field_definition' || member.type === 'property_definition') {
-          classDef.properties.push(extractTypeScriptProperty(member));
-        } else if (member.type === 'method_definition') {
-          const method = extractTypeScriptMethod(member);
-          if (method.name !== 'constructor') {
-            classDef.methods.push(method);
-          }
-        } else if (member.type === 'constructor_definition') {
-          classDef.constructorDef = {
-            parameters: extractParameters(member),
-            visibility: extractVisibility(member),
-          };
+      for (const clause of child.namedChildren) {
+        if (clause.type === 'extends_clause') {
+          extendsName = text(field(clause, 'value') ?? clause.namedChildren[0]);
+        } else if (clause.type === 'implements_clause') {
+          implementsNames.push(...clause.namedChildren.map((type) => type.text));
         }
       }
     }
   }
 
-  return classDef;
-}
-
-function extractTypeScriptProperty(node: ASTNode): Property {
-  const prop: Property = { name: '' };
-
-  for (const child of node.children) {
-    if (child.type === 'property_identifier' || child.type === 'identifier') {
-      prop.name = child.text;
-    } else if (child.type === 'type_annotation') {
-      const typeNode = child.namedChildren.find(
-        (n) => n.type === 'type_identifier' || n.type.includes('type')
-      );
-      if (typeNode) prop.type = typeNode.text;
-    } else if (child.type === 'accessibility_modifier') {
-      prop.visibility = child.text as 'public' | 'private' | 'protected';
-    } else if (child.type === 'readonly_modifier' || child.type === 'readonly') {
-      prop.isReadonly = true;
-    } else if (child.type === 'static_modifier' || child.type === 'static') {
-      prop.isStatic = true;
+  const properties: Property[] = [];
+  const methods: Method[] = [];
+  let constructorDef: ClassDefinition['constructorDef'];
+  // Member decorators precede their member in the class body.
+  let memberDecorators: string[] = [];
+  for (const member of field(node, 'body')?.namedChildren ?? []) {
+    if (member.type === 'decorator') {
+      memberDecorators.push(extractDecorator(member));
+      continue;
+    }
+    const queued = memberDecorators;
+    memberDecorators = [];
+    if (member.type === 'method_definition' && text(field(member, 'name')) === 'constructor') {
+      const method = extractTypeScriptFunction(member, {});
+      constructorDef = { parameters: method.parameters };
+      if (method.visibility) constructorDef.visibility = method.visibility;
+      if (queued.length > 0) constructorDef.decorators = queued;
+    } else if (
+      member.type === 'method_definition' ||
+      member.type === 'method_signature' ||
+      member.type === 'abstract_method_signature'
+    ) {
+      const method: Method = extractTypeScriptFunction(member, {
+        isAbstract: member.type === 'abstract_method_signature',
+      });
+      if (queued.length > 0) method.decorators = queued;
+      methods.push(method);
+    } else if (member.type === 'public_field_definition' || member.type === 'field_definition') {
+      const prop = extractTypeScriptProperty(member);
+      if (queued.length > 0) prop.decorators = queued;
+      properties.push(prop);
     }
   }
 
-  return prop;
+  return {
+    type: 'class',
+    name: text(field(node, 'name')),
+    ...(extendsName ? { extends: extendsName } : {}),
+    ...(implementsNames.length > 0 ? { implements: implementsNames } : {}),
+    ...(constructorDef ? { constructorDef } : {}),
+    properties,
+    methods,
+    ...(decorators.length > 0 ? { decorators } : {}),
+  };
 }
 
-function extractTypeScriptMethod(node: ASTNode): Method {
-  const method: Method = { name: '', parameters: [] };
-
+function extractModifiers(node: ASTNode): Modifiers {
+  const modifiers: Modifiers = {};
   for (const child of node.children) {
-    if (child.type === 'property_identifier' || child.type === 'identifier') {
-      method.name = child.text;
-    } else if (child.type === 'formal_parameters') {
-      method.parameters = extractParameters(child);
-    } else if (child.type === 'type_annotation') {
-      const typeNode = child.namedChildren.find(
-        (n) => n.type === 'type_identifier' || n.type.includes('type')
-      );
-      if (typeNode) {
-        let returnType: string = typeNode.text;
-        const genericMatch = returnType.match(/^(\w+)<.*>$/);
-        if (genericMatch && genericMatch[1]) {
-          returnType = genericMatch[1];
-        }
-        method.returnType = returnType;
-      }
-    } else if (child.type === 'accessibility_modifier') {
-      method.visibility = child.text as 'public' | 'private' | 'protected';
-    } else if (child.type === 'static_modifier' || child.type === 'static') {
-      method.isStatic = true;
+    if (child.type === 'accessibility_modifier') {
+      modifiers.visibility = child.text as Visibility;
+    } else if (child.type === 'static') {
+      modifiers.isStatic = true;
+    } else if (child.type === 'readonly') {
+      modifiers.isReadonly = true;
     } else if (child.type === 'async') {
-      method.isAsync = true;
-    } else if (child.type === 'generator_modifier') {
-      method.isGenerator = true;
-    } else if (child.type === 'decorator') {
-      if (!method.decorators) method.decorators = [];
-      method.decorators.push(extractDecorator(child));
+      modifiers.isAsync = true;
+    } else if (child.type === '*') {
+      modifiers.isGenerator = true;
+    } else if (child.type === 'abstract') {
+      modifiers.isAbstract = true;
     }
   }
-
-  return method;
+  return modifiers;
 }
 
-function extractParameters(node: ASTNode): Parameter[] {
-  const parameters: Parameter[] = [];
+function extractTypeScriptProperty(node: ASTNode): Property {
+  const modifiers = extractModifiers(node);
+  const prop: Property = { name: text(field(node, 'name') ?? field(node, 'property')) };
+  const type = annotatedType(field(node, 'type'));
+  if (type) prop.type = type;
+  if (modifiers.visibility) prop.visibility = modifiers.visibility;
+  if (modifiers.isReadonly) prop.isReadonly = true;
+  if (modifiers.isStatic) prop.isStatic = true;
+  return prop;
+}
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'required_parameter' || child.type === 'optional_parameter') {
-      const param: Parameter = { name: '' };
-      for (const p of child.namedChildren) {
-        if (p.type === 'identifier' || p.type === 'property_identifier') {
-          param.name = p.text;
-        } else if (p.type === 'type_annotation') {
-          const typeNode = p.namedChildren.find(
-            (n) => n.type === 'type_identifier' || n.type.includes('type')
-          );
-          if (typeNode) param.type = typeNode.text;
-        } else if (p.type === 'default_value') {
-          param.defaultValue = p.text;
-        }
-      }
-      parameters.push(param);
-    }
+/** Functions, methods and signatures; export flags only apply to functions. */
+function extractTypeScriptFunction(
+  node: ASTNode,
+  flags: ExportFlags & Modifiers
+): Method & ExportFlags {
+  const modifiers = extractModifiers(node);
+  const func: Method & ExportFlags = {
+    name: text(field(node, 'name')),
+    parameters: extractTypeScriptParameters(field(node, 'parameters')),
+  };
+  const returnType = withoutTypeArguments(annotatedType(field(node, 'return_type')));
+  if (returnType) func.returnType = returnType;
+  if (modifiers.visibility) func.visibility = modifiers.visibility;
+  if (flags.isExported) func.isExported = true;
+  if (flags.isDefault) func.isDefault = true;
+  if (modifiers.isStatic) func.isStatic = true;
+  if (modifiers.isAsync) func.isAsync = true;
+  if (modifiers.isGenerator || node.type === 'generator_function_declaration') {
+    func.isGenerator = true;
   }
-
-  return parameters;
+  if (modifiers.isAbstract || flags.isAbstract) func.isAbstract = true;
+  return func;
 }
 
-function extractTypeScriptFunction(node: ASTNode, isExported = false): FunctionDefinition {
-  const func: FunctionDefinition = {
-    type: 'function',
-    name: '',
-    parameters: [],
-    isExported,
-  };
+function extractTypeScriptParameters(node: ASTNode | undefined): Parameter[] {
+  const parameters: Parameter[] = [];
 
-  for (const child of node.children) {
-    if (child.type === 'identifier' || child.type === 'property_identifier') {
-      func.name = child.text;
-    } else if (child.type === 'formal_parameters') {
-      func.parameters = extractParameters(child);
-    } else if (child.type === 'type_annotation') {
-      const typeNode = child.namedChildren.find(
-        (n) => n.type === 'type_identifier' || n.type.includes('type')
+  for (const child of node?.namedChildren ?? []) {
+    if (child.type === 'required_parameter' || child.type === 'optional_parameter') {
+      parameters.push(
+        extractParameter(
+          text(field(child, 'pattern')),
+          annotatedType(field(child, 'type')),
+          text(field(child, 'value'))
+        )
       );
-      if (typeNode) {
-        let returnType: string = typeNode.text;
-        const genericMatch = returnType.match(/^(\w+)<.*>$/);
-        if (genericMatch && genericMatch[1]) {
-          returnType = genericMatch[1];
-        }
-        func.returnType = returnType;
-      }
-    } else if (child.type === 'async') {
-      func.isAsync = true;
-    } else if (child.type === 'generator_modifier') {
-      func.isGenerator = true;
-    } else if (child.type === 'decorator') {
-      if (!func.decorators) func.decorators = [];
-      func.decorators.push(extractDecorator(child));
+    } else if (child.type === 'assignment_pattern') {
+      parameters.push(
+        extractParameter(text(field(child, 'left')), '', text(field(child, 'right')))
+      );
+    } else if (
+      child.type === 'identifier' ||
+      child.type === 'rest_pattern' ||
+      child.type === 'object_pattern' ||
+      child.type === 'array_pattern'
+    ) {
+      parameters.push({ name: child.text });
     }
   }
 
-  return func;
+  return parameters;
 }
 
-function extractTypeScriptVariable(node: ASTNode, isExported = false): VariableDeclaration {
-  const variable: VariableDeclaration = {
-    type: 'variable',
-    name: '',
-    isExported,
-  };
-
+function extractTypeScriptInterface(node: ASTNode): InterfaceDefinition {
+  const bases: string[] = [];
   for (const child of node.namedChildren) {
-    if (child.type === 'variable_declarator') {
-      for (const declarator of child.namedChildren) {
-        if (declarator.type === 'identifier' || declarator.type === 'property_identifier') {
-          variable.name = declarator.text;
-        } else if (declarator.type === 'type_annotation') {
-          const typeNode = declarator.namedChildren.find((n) => n.type === 'type_identifier');
-          if (typeNode) variable.varType = child.text.trim();
-        }
-      }
-    } else if (child.type === 'const' || child.type === 'let' || child.type === 'var') {
-      variable.isConst = child.type === 'const';
+    if (child.type === 'extends_type_clause' || child.type === 'extends_clause') {
+      bases.push(...child.namedChildren.map((type) => type.text));
     }
   }
 
-  return variable;
-}
-
-function extractTypeScriptInterface(node: ASTNode): any {
-  const iface: any = {
+  const iface: InterfaceDefinition = {
     type: 'interface',
-    name: '',
+    name: text(field(node, 'name')),
+    ...(bases.length > 0 ? { extends: bases } : {}),
     properties: [],
     methods: [],
   };
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'type_identifier') {
-      iface.name = child.text;
-    } else if (child.type === 'type_parameters') {
-      const identifiers = child.namedChildren.filter((n) => n.type === 'type_identifier');
-      iface.typeParameters = identifiers.map((n) => n.text);
-    } else if (child.type === 'extends_type_clause' || child.type === 'extends_clause') {
-      const identifiers = child.namedChildren.filter((n) => n.type === 'type_identifier');
-      iface.extends = identifiers.map((n) => n.text);
-    } else if (child.type === 'interface_body') {
-      for (const member of child.namedChildren) {
-        if (member.type === 'property_signature') {
-          iface.properties.push(extractTypeScriptPropertySignature(member));
-        } else if (member.type === 'method_signature') {
-          iface.methods.push(extractTypeScriptMethodSignature(member));
-        } else if (member.type === 'call_signature') {
-          iface.methods.push(extractTypeScriptMethodSignature(member));
-        }
-      }
+  for (const member of field(node, 'body')?.namedChildren ?? []) {
+    if (member.type === 'property_signature') {
+      const prop: Property = { name: text(field(member, 'name')) };
+      const type = annotatedType(field(member, 'type'));
+      if (type) prop.type = type;
+      iface.properties.push(prop);
+    } else if (member.type === 'method_signature' || member.type === 'call_signature') {
+      const method: Method = {
+        name: text(field(member, 'name')),
+        parameters: extractTypeScriptParameters(field(member, 'parameters')),
+      };
+      const returnType = annotatedType(field(member, 'return_type'));
+      if (returnType) method.returnType = returnType;
+      iface.methods.push(method);
     }
   }
 
   return iface;
 }
 
-function extractTypeScriptPropertySignature(node: ASTNode): any {
-  const prop: any = { name: '' };
-
-  for (const child of node.namedChildren) {
-    if (child.type === 'property_identifier') {
-      prop.name = child.text;
-    } else if (child.type === 'type_annotation') {
-      const typeNode = child.namedChildren.find(
-        (n) => n.type === 'type_identifier' || n.type.includes('type')
-      );
-      if (typeNode) prop.type = typeNode.text;
-    }
-  }
-
-  return prop;
-}
-
-function extractTypeScriptMethodSignature(node: ASTNode): Method {
-  const method: Method = { name: '', parameters: [] };
-
-  for (const child of node.namedChildren) {
-    if (child.type === 'property_identifier') {
-      method.name = child.text;
-    } else if (child.type === 'formal_parameters') {
-      method.parameters = extractParameters(child);
-    } else if (child.type === 'type_annotation') {
-      const typeNode = child.namedChildren.find(
-        (n) => n.type === 'type_identifier' || n.type.includes('type')
-      );
-      if (typeNode) method.returnType = typeNode.text;
-    }
-  }
-
-  return method;
-}
-
-function extractTypeEnum(node: ASTNode): any {
-  const enumDef: any = {
+function extractTypeScriptEnum(node: ASTNode): EnumDefinition {
+  const enumDef: EnumDefinition = {
     type: 'enum',
-    name: '',
+    name: text(field(node, 'name')),
     members: [],
   };
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'identifier' || child.type === 'type_identifier') {
-      enumDef.name = child.text;
-    } else if (child.type === 'enum_body') {
-      for (const member of child.namedChildren) {
-        if (member.type === 'property_identifier') {
-          enumDef.members.push({ name: member.text });
-        } else if (member.type === 'enum_assignment') {
-          const nameNode = member.namedChildren.find((n) => n.type === 'property_identifier');
-          const valueNode = member.namedChildren.find((n) => n.type === 'string');
-          enumDef.members.push({
-            name: nameNode?.text ?? '',
-            value: valueNode ? valueNode.text.slice(1, -1) : undefined,
-          });
-        }
-      }
+  for (const member of field(node, 'body')?.namedChildren ?? []) {
+    if (member.type === 'enum_assignment') {
+      const valueNode = field(member, 'value');
+      const value = valueNode?.type === 'string' ? stripQuotes(valueNode.text) : text(valueNode);
+      enumDef.members.push(
+        value ? { name: text(field(member, 'name')), value } : { name: text(field(member, 'name')) }
+      );
+    } else if (member.type === 'property_identifier' || member.type === 'string') {
+      enumDef.members.push({ name: stripQuotes(member.text) });
     }
   }
 
   return enumDef;
 }
 
-function extractTypeAlias(node: ASTNode): any {
-  const alias: any = {
-    type: 'type_alias',
-    name: '',
-  };
-
-  for (const child of node.namedChildren) {
-    if (child.type === 'type_identifier') {
-      alias.name = child.text;
-    } else if (child.type === 'type_annotation') {
-      alias.definition = child.text;
-    }
-  }
-
-  return alias;
-}
-
-function extractDecorator(node: ASTNode): string {
-  const identifier = node.namedChildren.find(
-    (n) => n.type === 'identifier' || n.type === 'decorator_identifier'
-  );
-  return identifier ? identifier.text : node.text;
-}
-
-function extractVisibility(node: ASTNode): 'public' | 'private' | 'protected' | undefined {
-  const modifier = node.namedChildren.find((n) => n.type === 'accessibility_modifier');
-  return modifier ? (modifier.text as 'public' | 'private' | 'protected') : undefined;
-}
-
 export default getSkeleton;
 
-function extractPythonSkeleton(root: ASTNode, skeleton: FileSkeleton): void {
-  let statements = root.children;
-  // Handle case where module has a block child containing statements
-  if (root.type === 'module' && statements.length === 1 && statements[0]?.type === 'block') {
-    statements = statements[0].children;
-  }
-
-  for (const statement of statements) {
-    // Handle wrapped statements
-    if (statement.type === 'statement') {
-      for (const child of statement.children) {
-        if (child.type === 'import_from_statement') {
-          skeleton.imports.push(extractPythonImport(child));
-        } else if (child.type === 'class_definition') {
-          skeleton.exports.classes.push(extractPythonClass(child));
-        } else if (child.type === 'function_definition') {
-          skeleton.exports.functions.push(extractPythonFunction(child));
-        } else if (child.type === 'expression_statement') {
-          const variable = extractPythonVariable(child);
-          if (variable) {
-            skeleton.exports.variables.push(variable);
-          }
-        } else if (child.type === 'import_from_statement') {
-          skeleton.imports.push(extractPythonImport(child));
-        }
-      }
-    } else {
-      switch (statement.type) {
-        case 'import_statement':
-          skeleton.imports.push(extractPythonImport(statement));
-          break;
-        case 'import_from_statement':
-          skeleton.imports.push(extractPythonImport(statement));
-          break;
-        case 'class_definition':
-          skeleton.exports.classes.push(extractPythonClass(statement));
-          break;
-        case 'decorated_definition':
-          for (const child of statement.namedChildren) {
-            if (child.type === 'class_definition') {
-              skeleton.exports.classes.push(extractPythonClass(child));
-            } else if (child.type === 'function_definition') {
-              skeleton.exports.functions.push(extractPythonFunction(child));
-            }
-          }
-          break;
-        case 'function_definition':
-          skeleton.exports.functions.push(extractPythonFunction(statement));
-          break;
-        case 'expression_statement': {
-          const variable = extractPythonVariable(statement);
-          if (variable) {
-            skeleton.exports.variables.push(variable);
-          }
-          break;
-        }
+function extractPythonStatement(node: ASTNode, skeleton: FileSkeleton): void {
+  switch (node.type) {
+    case 'import_statement':
+    case 'import_from_statement':
+      skeleton.imports.push(extractPythonImport(node));
+      break;
+    case 'class_definition':
+      skeleton.exports.classes.push(extractPythonClass(node, []));
+      break;
+    case 'function_definition':
+      skeleton.exports.functions.push({ type: 'function', ...extractPythonFunction(node, []) });
+      break;
+    case 'decorated_definition': {
+      const decorators = extractPythonDecorators(node);
+      const definition = field(node, 'definition');
+      if (definition?.type === 'class_definition') {
+        skeleton.exports.classes.push(extractPythonClass(definition, decorators));
+      } else if (definition?.type === 'function_definition') {
+        skeleton.exports.functions.push({
+          type: 'function',
+          ...extractPythonFunction(definition, decorators),
+        });
       }
+      break;
+    }
+    case 'expression_statement': {
+      const assignment = node.namedChildren[0];
+      if (assignment?.type !== 'assignment') return;
+      const left = field(assignment, 'left');
+      if (left?.type !== 'identifier' && left?.type !== 'attribute') return;
+      const variable: VariableDeclaration = { type: 'variable', name: text(left) };
+      const varType = text(field(assignment, 'type'));
+      if (varType) variable.varType = varType;
+      skeleton.exports.variables.push(variable);
+      break;
     }
   }
 }
@@ -627,215 +610,118 @@ function extractPythonImport(node: ASTNode): ImportStatement {
     imported: [],
   };
 
-  if (node.type === 'import_statement') {
-    // import os, import sys
-    const dottedName = node.namedChildren.find((n) => n.type === 'dotted_name');
-    if (dottedName) {
-      imp.source = dottedName.text;
-      imp.imported.push({ name: dottedName.text });
-    }
-  } else if (node.type === 'import_from_statement') {
-    // from module import items
-    const moduleName = node.namedChildren.find(
-      (n) => n.type === 'dotted_name' && n.field === 'module_name'
-    );
-    if (moduleName) {
-      imp.source = moduleName.text;
+  for (const name of node.children) {
+    if (name.field !== 'name') continue;
+    if (name.type === 'aliased_import') {
+      const alias = text(field(name, 'alias'));
+      imp.imported.push(
+        alias ? { name: text(field(name, 'name')), alias } : { name: text(field(name, 'name')) }
+      );
+    } else {
+      imp.imported.push({ name: name.text });
     }
+  }
 
-    // Collect all imported items (exclude module name)
-    const importItems = node.namedChildren.filter(
-      (n) => (n.type === 'dotted_name' || n.type === 'aliased_import') && n.field !== 'module_name'
-    );
-
-    for (const item of importItems) {
-      if (item.type === 'dotted_name') {
-        imp.imported.push({ name: item.text });
-      } else if (item.type === 'aliased_import') {
-        const nameNode = item.namedChildren.find(
-          (n) => n.type === 'dotted_name' || n.type === 'identifier'
-        );
-        const aliasNode = item.namedChildren.find(
-          (n) => n.type === 'identifier' && n.field === 'alias'
-        );
-        if (nameNode) {
-          imp.imported.push({
-            name: nameNode.text,
-            alias: aliasNode ? aliasNode.text : undefined,
-          });
-        }
-      }
-    }
+  if (node.type === 'import_statement') {
+    // import os.path as p
+    imp.source = imp.imported[0]?.name ?? '';
+  } else {
+    imp.source = text(field(node, 'module_name'));
+    if (hasChildOfType(node, 'wildcard_import')) imp.imported.push({ name: '*' });
   }
 
   return imp;
 }
 
-function extractPythonClass(node: ASTNode): ClassDefinition {
+function extractPythonDecorators(node: ASTNode): string[] {
+  return node.namedChildren
+    .filter((child) => child.type === 'decorator')
+    .map((child) => extractDecorator(child));
+}
+
+function extractPythonClass(node: ASTNode, decorators: string[]): ClassDefinition {
+  const bases = (field(node, 'superclasses')?.namedChildren ?? []).filter(
+    (base) => base.type === 'identifier' || base.type === 'attribute'
+  );
   const classDef: ClassDefinition = {
     type: 'class',
-    name: '',
+    name: text(field(node, 'name')),
+    ...(bases.length > 0 ? { extends: bases.map((base) => base.text).join(', ') } : {}),
     properties: [],
     methods: [],
   };
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'identifier') {
-      classDef.name = child.text;
-    } else if (child.type === 'argument_list') {
-      const identifiers = child.namedChildren.filter(
-        (n) => n.type === 'identifier' || n.type === 'dotted_name'
-      );
-      classDef.extends = identifiers.map((n) => n.text).join(', ');
-    } else if (child.type === 'decorator') {
-      if (!classDef.decorators) classDef.decorators = [];
-      classDef.decorators.push(extractPythonDecorator(child));
-    } else if (child.type === 'block') {
-      for (const member of child.children) {
-        if (member.type === 'function_definition') {
-          classDef.methods.push(extractPythonFunction(member, true));
-        } else if (member.type === 'decorated_definition') {
-          let decorators: string[] = [];
-          let funcDef: ASTNode | null = null;
-          for (const decoratedChild of member.namedChildren) {
-            if (decoratedChild.type === 'decorator') {
-              decorators.push(extractPythonDecorator(decoratedChild));
-            } else if (decoratedChild.type === 'function_definition') {
-              funcDef = decoratedChild;
-            }
-          }
-          if (funcDef) {
-            const method = extractPythonFunction(funcDef, true);
-            method.decorators = decorators;
-            for (const dec of decorators) {
-              if (dec === 'staticmethod') {
-                method.isStatic = true;
-              } else if (dec === 'classmethod') {
-                method.isStatic = true;
-              }
-            }
-            classDef.methods.push(method);
-          }
-        } else if (member.type === 'expression_statement') {
-          const assignment = member.namedChildren.find((n) => n.type === 'assignment');
-          if (assignment) {
-            const variable = extractPythonAssignment(assignment);
-            if (variable?.name.startsWith('self.')) {
-              classDef.properties.push({
-                name: variable.name.slice(5),
-                type: variable.varType,
-                isStatic: false,
-              });
-            }
-          }
+  const properties = new Set<string>();
+  for (let member of field(node, 'body')?.namedChildren ?? []) {
+    let memberDecorators: string[] = [];
+    if (member.type === 'decorated_definition') {
+      memberDecorators = extractPythonDecorators(member);
+      const definition = field(member, 'definition');
+      if (!definition) continue;
+      member = definition;
+    }
+    if (member.type !== 'function_definition') continue;
+    const method = extractPythonFunction(member, memberDecorators, true);
+    if (method.name === '__init__') {
+      // Attributes assigned to self in __init__ are the instance's properties.
+      for (const statement of field(member, 'body')?.namedChildren ?? []) {
+        const assignment = statement.namedChildren[0];
+        if (statement.type !== 'expression_statement' || assignment?.type !== 'assignment') {
+          continue;
         }
+        const left = field(assignment, 'left');
+        if (left?.type !== 'attribute' || text(field(left, 'object')) !== 'self') continue;
+        const name = text(field(left, 'attribute'));
+        if (properties.has(name)) continue;
+        properties.add(name);
+        const prop: Property = { name };
+        const type = text(field(assignment, 'type'));
+        if (type) prop.type = type;
+        classDef.properties.push(prop);
       }
     }
+    classDef.methods.push(method);
   }
 
+  if (decorators.length > 0) classDef.decorators = decorators;
   return classDef;
 }
 
-function extractPythonFunction(node: ASTNode, isMethod = false): FunctionDefinition {
-  const func: FunctionDefinition = {
-    type: 'function',
-    name: '',
+function extractPythonFunction(node: ASTNode, decorators: string[], isMethod = false): Method {
+  const func: Method = {
+    name: text(field(node, 'name')),
     parameters: [],
   };
 
-  for (const child of node.namedChildren) {
-    if (child.type === 'identifier') {
-      func.name = child.text;
-    } else if (child.type === 'parameters') {
-      func.parameters = extractPythonParameters(child, isMethod);
-    } else if (child.type === 'type') {
-      func.returnType = child.text;
-    } else if (child.type === 'decorator') {
-      if (!func.decorators) func.decorators = [];
-      func.decorators.push(extractPythonDecorator(child));
-
-      if (child.text.includes('staticmethod')) {
-        func.isStatic = true;
-      } else if (child.text.includes('classmethod')) {
-        func.isStatic = true;
-      }
-    }
-  }
-
-  return func;
-}
-
-function extractPythonParameters(node: ASTNode, isMethod = false): Parameter[] {
-  const parameters: Parameter[] = [];
-
-  for (const child of node.namedChildren) {
-    if (child.type === 'identifier') {
-      if (!isMethod || child.text !== 'self') {
-        parameters.push({ name: child.text });
-      }
+  for (const child of field(node, 'parameters')?.namedChildren ?? []) {
+    let parameter: Parameter;
+    if (
+      child.type === 'identifier' ||
+      child.type === 'list_splat_pattern' ||
+      child.type === 'dictionary_splat_pattern'
+    ) {
+      parameter = { name: child.text };
     } else if (child.type === 'typed_parameter') {
-      const param: Parameter = { name: '' };
-      for (const p of child.namedChildren) {
-        if (p.type === 'identifier') {
-          if (!isMethod || p.text !== 'self') {
-            param.name = p.text;
-          }
-        } else if (p.type === 'type') {
-          param.type = p.text;
-        }
-      }
-      if (param.name) {
-        parameters.push(param);
-      }
-    } else if (child.type === 'default_parameter') {
-      const param: Parameter = { name: '', defaultValue: '' };
-      for (const p of child.namedChildren) {
-        if (p.type === 'identifier') {
-          if (!isMethod || p.text !== 'self') {
-            param.name = p.text;
-          }
-        } else if (p.type === 'type') {
-          param.type = p.text;
-        } else if (p.type === 'default_value') {
-          param.defaultValue = p.text;
-        }
-      }
-      if (param.name) {
-        parameters.push(param);
-      }
+      parameter = extractParameter(text(child.namedChildren[0]), text(field(child, 'type')), '');
+    } else if (child.type === 'default_parameter' || child.type === 'typed_default_parameter') {
+      parameter = extractParameter(
+        text(field(child, 'name')),
+        text(field(child, 'type')),
+        text(field(child, 'value'))
+      );
+    } else {
+      continue;
     }
+    if (isMethod && parameter.name === 'self') continue;
+    func.parameters.push(parameter);
   }
 
-  return parameters;
-}
-
-function extractPythonVariable(node: ASTNode): VariableDeclaration | null {
-  const assignment = node.namedChildren.find((n) => n.type === 'assignment');
-  if (!assignment) return null;
-
-  return extractPythonAssignment(assignment);
-}
-
-function extractPythonAssignment(node: ASTNode): VariableDeclaration | null {
-  const variable: VariableDeclaration = {
-    type: 'variable',
-    name: '',
-  };
-
-  for (const child of node.namedChildren) {
-    if (child.type === 'identifier' || child.type === 'attribute') {
-      variable.name = child.text;
-    }
+  const returnType = text(field(node, 'return_type'));
+  if (returnType) func.returnType = returnType;
+  if (decorators.some((name) => name === 'staticmethod' || name === 'classmethod')) {
+    func.isStatic = true;
   }
-
-  if (!variable.name) return null;
-
-  return variable;
-}
-
-function extractPythonDecorator(node: ASTNode): string {
-  const identifier = node.namedChildren.find(
-    (n) => n.type === 'identifier' || n.type === 'attribute' || n.type === 'call'
-  );
-  return identifier ? identifier.text : node.text;
+  if (hasChildOfType(node, 'async')) func.isAsync = true;
+  if (decorators.length > 0) func.decorators = decorators;
+  return func;
 }
@@ -2,8 +2,9 @@ import type { ToolResponse } from '../types/mcp.js';
 import { ParserFactory } from '../parsers/factory.js';
 import { logger } from '../utils/logger.js';
 import type { ASTNode } from '../types/ast.js';
-import { readdirSync, statSync } from 'fs';
-import { join, extname } from 'path';
+import { getProjectIndexForFiles, filterCandidateFiles } from '../graph/indexer.js';
+import { resolve } from 'path';
+import { findSourceFiles } from './find_callers.js';
 
 interface VariableUsage {
   type: 'declaration' | 'assignment' | 'read';
@@ -13,9 +14,19 @@ interface VariableUsage {
   context: string;
 }
 
+interface ParameterFlowReport {
+  /** Symbol id of the function that declares the variable as a parameter. */
+  function: string;
+  returned: boolean;
+  passedTo: { function: string; parameter: string; depth: number }[];
+  globals: string[];
+}
+
 interface TrackVariableResult {
   variableName: string;
   usages: VariableUsage[];
+  /** Where the variable flows across calls when it is a parameter; needs the project index. */
+  parameterFlows?: ParameterFlowReport[];
   summary: {
     declarations: number;
     assignments: number;
@@ -66,17 +77,20 @@ export default async function trackVariable(args: Record<string, unknown>): Prom
       };
     }
 
-    const usages: VariableUsage[] = [];
-
-    for (const file of files) {
-      try {
-        const parser = ParserFactory.getParserForFile(file);
-        const result = await parser.parseFile(file);
-        
-        const fileUsages = findVariableUsages(result.tree, variableName, file);
-        usages.push(...fileUsages);
-      } catch (error) {
-        logger.warn(`Failed to parse ${file}`, error as Record<string, unknown>);
+    const indexedUsages = await findVariableUsagesFromIndex(variableName, files);
+    const usages: VariableUsage[] = indexedUsages ?? [];
+
+    if (!indexedUsages) {
+      for (const file of await filterCandidateFiles(files, [variableName])) {
+        try {
+          const parser = ParserFactory.getParserForFile(file);
+          const result = await parser.parseFile(file);
+
+          const fileUsages = findVariableUsages(result.tree, variableName, file);
+          usages.push(...fileUsages);
+        } catch (error) {
+          logger.warn(`Failed to parse ${file}`, error as Record<string, unknown>);
+        }
       }
     }
 
@@ -97,6 +111,11 @@ export default async function trackVariable(args: Record<string, unknown>): Prom
       },
     };
 
+    const parameterFlows = await findParameterFlowsFromIndex(variableName, files);
+    if (parameterFlows && parameterFlows.length > 0) {
+      result.parameterFlows = parameterFlows;
+    }
+
     logger.info('Variable tracking complete', {
       variableName,
       totalUsages: usages.length,
@@ -125,50 +144,78 @@ export default async function trackVariable(args: Record<string, unknown>): Prom
   }
 }
 
-function findSourceFiles(dir: string): string[] {
-  const files: string[] = [];
-  const extensions = ['.ts', '.tsx', '.js', '.jsx', '.py', '.pyw'];
+/**
+ * Reads the variable's postings from the project index's inverted identifier
+ * index. Property names (`obj.name`, keys, methods, class fields) are not the
+ * variable and are skipped, as findVariableUsages skips them; calls and import
+ * bindings count as reads. Lines and columns come from the bytes each file was
+ * indexed from, in the parser's units. Returns null unless every file is
+ * indexed and those bytes are still at hand.
+ */
+async function findVariableUsagesFromIndex(
+  variableName: string,
+  files: string[]
+): Promise<VariableUsage[] | null> {
+  const index = await getProjectIndexForFiles(files);
+  if (!index) {
+    return null;
+  }
 
-  try {
-    const stats = statSync(dir);
-    if (!stats.isDirectory()) {
-      if (extensions.includes(extname(dir))) {
-        return [dir];
-      }
-      return [];
+  const scope = new Map(files.map((file) => [resolve(file), file]));
+  const usages: VariableUsage[] = [];
+
+  for (const usage of index.findUsages(variableName, undefined, true)) {
+    const filePath = scope.get(usage.filePath);
+    if (filePath === undefined || usage.isProperty) {
+      continue;
+    }
+    if (usage.lineText === undefined || usage.lineColumn === undefined) {
+      return null;
     }
-  } catch {
-    return [];
-  }
 
-  const entries = readdirSync(dir, { withFileTypes: true });
+    usages.push({
+      type: usage.kind === 'call' || usage.isImport ? 'read' : usage.kind,
+      filePath,
+      line: usage.line,
+      column: usage.lineColumn,
+      context: lineContext(usage.lineText, variableName),
+    });
+  }
 
-  for (const entry of entries) {
-    const fullPath = join(dir, entry.name);
+  return usages;
+}
 
-    if (entry.isDirectory()) {
-      if (
-        entry.name !== 'node_modules' &&
-        entry.name !== '.git' &&
-        entry.name !== 'build' &&
-        entry.name !== 'dist' &&
-        !entry.name.startsWith('.')
-      ) {
-        files.push(...findSourceFiles(fullPath));
-      }
-    } else if (entry.isFile()) {
-      const ext = extname(fullPath);
-      if (extensions.includes(ext)) {
-        files.push(fullPath);
-      }
-    }
+/**
+ * For every indexed function in files that takes variableName as a parameter,
+ * composes the index's function summaries to follow the value through the
+ * calls it is passed to. Returns null unless every file is indexed.
+ */
+async function findParameterFlowsFromIndex(
+  variableName: string,
+  files: string[]
+): Promise<ParameterFlowReport[] | null> {
+  const index = await getProjectIndexForFiles(files);
+  if (!index) {
+    return null;
   }
 
-  return files;
+  const absolute = files.map((file) => resolve(file));
+  return index.traceParametersNamed(variableName, absolute).map((flow) => ({
+    function: flow.reaches[0]!.symbolId,
+    returned: flow.returned,
+    passedTo: flow.reaches.slice(1).map((step) => ({
+      function: step.symbolId,
+      parameter: step.parameter,
+      depth: step.depth,
+    })),
+    globals: flow.globals,
+  }));
 }
 
 function findVariableUsages(root: ASTNode, variableName: string, filePath: string): VariableUsage[] {
   const usages: VariableUsage[] = [];
+  // The root starts at its first token, so its text can begin mid-line.
+  const lines = root.text.split('\n');
 
   function traverse(node: ASTNode): void {
     // Check if node matches the variable name
@@ -184,7 +231,7 @@ function findVariableUsages(root: ASTNode, variableName: string, filePath: strin
         filePath,
         line: node.startPosition.row + 1,
         column: node.startPosition.column,
-        context: getLineContent(node),
+        context: lineContext(lines[node.startPosition.row - root.startPosition.row], variableName),
       });
     }
 
@@ -284,13 +331,13 @@ function getMethodNameNode(node: ASTNode): ASTNode | null {
     return node.namedChildren.find(c => c.type === 'identifier' || c.type === 'property_identifier') || null;
 }
 
-function getLineContent(node: ASTNode): string {
-    // This is a placeholder since ASTNode doesn't always have full source access
-    // Ideally we would read the file line, but here we can return the parent's text context
-    // or simply describe the parent type
-    let context = node.parent?.text || node.text;
+function lineContext(lineText: string | undefined, variableName: string): string {
+    return truncateContext(lineText?.trim() || variableName);
+}
+
+function truncateContext(context: string): string {
     if (context.length > 50) {
-        context = context.substring(0, 50) + '...';
+        return context.substring(0, 50) + '...';
     }
     return context;
 }
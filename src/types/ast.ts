@@ -50,6 +50,7 @@ export interface Property {
   visibility?: 'public' | 'private' | 'protected';
   isReadonly?: boolean;
   isStatic?: boolean;
+  decorators?: string[];
 }
 
 export interface ClassDefinition {
@@ -62,6 +63,7 @@ export interface ClassDefinition {
   constructorDef?: {
     parameters: Parameter[];
     visibility?: 'public' | 'private' | 'protected' | undefined;
+    decorators?: string[];
   };
   decorators?: string[];
 }
@@ -91,6 +93,7 @@ export interface VariableDeclaration {
   type: 'variable';
   name: string;
   varType?: string;
+  alias?: string;
   isExported?: boolean;
   isConst?: boolean;
   value?: string;
@@ -296,7 +299,9 @@ export interface TypeOrigin {
     | 'literal_inference'
     | 'function_definition'
     | 'interface_property'
-    | 'generic_inference';
+    | 'generic_inference'
+    | 'type_narrowing'
+    | 'reaching_definition';
   location: string;
 }
 
@@ -5,6 +5,7 @@ export interface Symbol {
   filePath: string;
   line: number;
   column: number;
+  endLine?: number;
   className?: string;
   isExported?: boolean;
   isStatic?: boolean;
@@ -18,6 +19,7 @@ export interface Reference {
   filePath: string;
   line: number;
   column: number;
+  name?: string;
 }
 
 export interface FileData {
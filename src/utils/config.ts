@@ -6,12 +6,30 @@ export interface CacheConfig {
   enabled: boolean;
   maxSize: number;
   ttl: number;
+  /** Budget of the native parse-tree cache, in bytes. */
+  maxBytes: number;
+  /** Tier budgets of the per-file analysis cache, in bytes. */
+  hotBytes: number;
+  warmBytes: number;
+  /** The cold tier: the on-disk cache under paths.cacheDir. */
+  coldBytes: number;
 }
 
 export interface GraphConfig {
   enableCpp: boolean;
   maxNodes: number;
   enableIncremental: boolean;
+  warmOnStartup: boolean;
+  /** Quiet time after a file changes before it is reindexed in the background. */
+  reindexDebounceMs: number;
+  /** Share of one core background reindexing may use, 0 to 1. */
+  reindexCpuBudget: number;
+  /** Most accessed files and symbols of past sessions to load after warm-up. */
+  prefetchFiles: number;
+  prefetchSymbols: number;
+  /** Bounds of that prefetch: wall time, and bytes of trees it may keep. */
+  prefetchTimeMs: number;
+  prefetchBytes: number;
 }
 
 export interface ParserConfig {
@@ -47,11 +65,22 @@ const DEFAULT_CONFIG: PrismConfig = {
     enabled: true,
     maxSize: 1000,
     ttl: 3600000,
+    maxBytes: 268435456,
+    hotBytes: 33554432,
+    warmBytes: 67108864,
+    coldBytes: 536870912,
   },
   graph: {
     enableCpp: true,
     maxNodes: 1000000,
     enableIncremental: true,
+    warmOnStartup: true,
+    reindexDebounceMs: 100,
+    reindexCpuBudget: 0.25,
+    prefetchFiles: 64,
+    prefetchSymbols: 256,
+    prefetchTimeMs: 2000,
+    prefetchBytes: 33554432,
   },
   parser: {
     maxFileSize: 10485760,
@@ -151,6 +180,16 @@ export class ConfigManager {
       errors.push('cache.ttl must be non-negative');
     }
 
+    if (this.config.cache.maxBytes < 0) {
+      errors.push('cache.maxBytes must be non-negative');
+    }
+
+    for (const tier of ['hotBytes', 'warmBytes', 'coldBytes'] as const) {
+      if (this.config.cache[tier] < 0) {
+        errors.push(`cache.${tier} must be non-negative`);
+      }
+    }
+
     if (this.config.parser.maxFileSize < 0) {
       errors.push('parser.maxFileSize must be non-negative');
     }
@@ -163,6 +202,26 @@ export class ConfigManager {
       errors.push('graph.maxNodes must be greater than 0');
     }
 
+    if (this.config.graph.reindexDebounceMs < 0) {
+      errors.push('graph.reindexDebounceMs must be non-negative');
+    }
+
+    if (this.config.graph.reindexCpuBudget < 0 || this.config.graph.reindexCpuBudget > 1) {
+      errors.push('graph.reindexCpuBudget must be between 0 and 1');
+    }
+
+    const prefetchBounds = [
+      'prefetchFiles',
+      'prefetchSymbols',
+      'prefetchTimeMs',
+      'prefetchBytes',
+    ] as const;
+    for (const bound of prefetchBounds) {
+      if (this.config.graph[bound] < 0) {
+        errors.push(`graph.${bound} must be non-negative`);
+      }
+    }
+
     const valid = errors.length === 0;
     if (!valid) {
       logger.error('Configuration validation failed', undefined, { errors });
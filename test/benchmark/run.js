@@ -0,0 +1,94 @@
+#!/usr/bin/env node
+// Cold-index benchmark: warms a fresh ProjectIndex over a synthetic tree with
+// each file-read backend and reports the median of several rounds.
+//
+//   npm run build:native && npm run benchmark -- [fileCount] [rounds]
+//
+// Runs after the first see a warm page cache unless caches are dropped between
+// rounds (as root: `sync; echo 3 > /proc/sys/vm/drop_caches`), so the numbers
+// mostly measure per-file syscall and scheduling overhead.
+
+import { createRequire } from 'module';
+import { mkdtempSync, mkdirSync, writeFileSync, rmSync } from 'fs';
+import { tmpdir } from 'os';
+import { join } from 'path';
+
+const require = createRequire(import.meta.url);
+const addon = require('../../build/Release/graph.node');
+
+const fileCount = Number(process.argv[2] ?? 20000);
+const rounds = Number(process.argv[3] ?? 5);
+const backends = ['sequential', 'threads', 'io_uring'];
+
+function createTree(root, count) {
+  const perDirectory = 100;
+  for (let i = 0; i < count; i++) {
+    const directory = join(root, `pkg${Math.floor(i / perDirectory)}`);
+    if (i % perDirectory === 0) {
+      mkdirSync(directory, { recursive: true });
+    }
+    const previous = i % perDirectory === 0 ? null : `./module${i - 1}`;
+    const lines = [];
+    if (previous) {
+      lines.push(`import { helper${i - 1} } from '${previous}';`);
+    }
+    lines.push(`export function helper${i}(value: number): number {`);
+    lines.push(previous ? `  return helper${i - 1}(value) + ${i};` : `  return value + ${i};`);
+    lines.push('}');
+    lines.push(`export class Service${i} {`);
+    lines.push(`  run(input: string[]): number {`);
+    lines.push(`    return input.filter((item) => item.length > ${i % 7}).length;`);
+    lines.push('  }');
+    lines.push('}');
+    writeFileSync(join(directory, `module${i}.ts`), lines.join('\n') + '\n');
+  }
+}
+
+function median(values) {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.floor(sorted.length / 2)];
+}
+
+async function main() {
+  const root = mkdtempSync(join(tmpdir(), 'prism-bench-'));
+  try {
+    console.log(`Creating ${fileCount} files under ${root}`);
+    createTree(root, fileCount);
+
+    const results = new Map(backends.map((backend) => [backend, []]));
+    const backendUsed = new Map();
+    for (let round = 0; round < rounds; round++) {
+      for (const backend of backends) {
+        const index = new addon.ProjectIndex();
+        const start = process.hrtime.bigint();
+        const indexed = await index.warm(root, backend);
+        const ms = Number(process.hrtime.bigint() - start) / 1e6;
+        if (indexed !== fileCount) {
+          throw new Error(`${backend}: indexed ${indexed} of ${fileCount} files`);
+        }
+        results.get(backend).push(ms);
+        backendUsed.set(backend, index.getStats().readBackend);
+      }
+    }
+
+    const baseline = median(results.get('sequential'));
+    console.log(`\n${fileCount} files, median of ${rounds} rounds`);
+    for (const backend of backends) {
+      const ms = median(results.get(backend));
+      const used = backendUsed.get(backend);
+      const label = used === backend ? backend : `${backend} (fell back to ${used})`;
+      console.log(
+        `${label.padEnd(32)} ${ms.toFixed(1).padStart(9)} ms` +
+          `  ${Math.round((fileCount / ms) * 1000).toString().padStart(8)} files/s` +
+          `  ${(baseline / ms).toFixed(2)}x`
+      );
+    }
+  } finally {
+    rmSync(root, { recursive: true, force: true });
+  }
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
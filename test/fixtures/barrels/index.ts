@@ -0,0 +1,5 @@
+import { version } from './version';
+
+export * from './lib';
+export { area as computeArea } from './lib/index';
+export { version };
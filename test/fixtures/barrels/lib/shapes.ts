@@ -0,0 +1,5 @@
+export function area() {
+  return 0;
+}
+
+export default class Circle {}
@@ -20,5 +20,10 @@ export class Calculator {
 
 export default function defaultFn() {}
 
+export interface Shape {
+  area(): number;
+  readonly name: string;
+}
+
 export { add as sum };
 export * from './other_module';
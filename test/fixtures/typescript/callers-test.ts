@@ -18,3 +18,7 @@ export function processData(): void {
   main();
   helper1();
 }
+
+export function schedule(): void {
+  [1, 2].forEach(helper2);
+}
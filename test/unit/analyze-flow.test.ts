@@ -2,6 +2,10 @@ import { describe, it, expect, beforeEach, afterEach } from 'vitest';
 import { ParserFactory } from '../../src/parsers/factory.js';
 import { Language } from '../../src/parsers/base.js';
 import { analyzeFlow } from '../../src/tools/analyze_flow.js';
+import { getProjectIndex, resetProjectIndex } from '../../src/graph/indexer.js';
+import { mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join } from 'path';
 
 describe('analyze_flow', () => {
   beforeEach(() => {
@@ -235,4 +239,46 @@ function helper() {
       }
     });
   });
+
+  describe('Project Index', () => {
+    it('should analyze the same flow with and without a warm index', async () => {
+      const dir = mkdtempSync(join(tmpdir(), 'prism-flow-'));
+      writeFileSync(
+        join(dir, 'app.ts'),
+        [
+          "export function main() { const s = 'ß👋'; run(s); return [s].map(helper); }",
+          'export function run(x: string) { return helper(x); }',
+          'export function helper(x: string) { return x; }',
+        ].join('\n')
+      );
+      writeFileSync(
+        join(dir, 'other.ts'),
+        [
+          "import { helper } from './app';",
+          'export const table = { helper: 1 };',
+          "export function other() { return helper('é') + table.helper; }",
+        ].join('\n')
+      );
+      resetProjectIndex();
+
+      try {
+        const analyze = async () => {
+          const result = await analyzeFlow({
+            directoryPath: dir,
+            entryPoint: 'helper',
+            maxDepth: 3,
+          });
+          return result.content[0].text;
+        };
+        const parsed = await analyze();
+        expect(JSON.parse(parsed).totalEdges).toBeGreaterThan(0);
+
+        await (await getProjectIndex())!.warm(dir);
+        expect(await analyze()).toBe(parsed);
+      } finally {
+        resetProjectIndex();
+        rmSync(dir, { recursive: true, force: true });
+      }
+    });
+  });
 });
@@ -2,6 +2,10 @@ import { describe, it, expect, beforeEach, afterEach } from 'vitest';
 import { ParserFactory } from '../../src/parsers/factory.js';
 import { Language } from '../../src/parsers/base.js';
 import { analyzeRefactorImpact } from '../../src/tools/analyze_refactor_impact.js';
+import { getProjectIndex, resetProjectIndex } from '../../src/graph/indexer.js';
+import { mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join } from 'path';
 
 describe('analyze_refactor_impact', () => {
   beforeEach(() => {
@@ -279,4 +283,52 @@ export function calculate(): void {
       }
     });
   });
+
+  describe('Project Index', () => {
+    it('should report the same impact with and without a warm index', async () => {
+      const dir = mkdtempSync(join(tmpdir(), 'prism-impact-'));
+      writeFileSync(
+        join(dir, 'app.ts'),
+        [
+          "export function main() { const s = 'ß👋'; run(s); return [s].map(helper); }",
+          'export function run(x: string) { return helper(x); }',
+          'export function helper(x: string) { return x; }',
+        ].join('\n')
+      );
+      writeFileSync(
+        join(dir, 'other.ts'),
+        [
+          "import { helper } from './app';",
+          'export const table = { helper: 1 };',
+          "export function other() { return helper('é') + table.helper; }",
+        ].join('\n')
+      );
+      resetProjectIndex();
+
+      try {
+        const queries = [
+          {
+            filePath: join(dir, 'app.ts'),
+            elementName: 'helper',
+            elementType: 'function',
+            proposedChanges: { returnTypeChange: { oldType: 'string', newType: 'number' } },
+          },
+          { filePath: join(dir, 'other.ts'), elementName: 'table', elementType: 'variable' },
+        ];
+        const analyze = async (query: Record<string, unknown>) =>
+          (await analyzeRefactorImpact(query)).content[0].text;
+        const parsed = [];
+        for (const query of queries) parsed.push(await analyze(query));
+        expect(JSON.parse(parsed[0]!).totalReferences).toBe(3);
+
+        await (await getProjectIndex())!.warm(dir);
+        for (let i = 0; i < queries.length; i++) {
+          expect(await analyze(queries[i]!)).toBe(parsed[i]);
+        }
+      } finally {
+        resetProjectIndex();
+        rmSync(dir, { recursive: true, force: true });
+      }
+    });
+  });
 });
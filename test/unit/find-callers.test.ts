@@ -2,11 +2,15 @@ import { describe, it, expect, beforeEach, afterEach } from 'vitest';
 import { ParserFactory } from '../../src/parsers/factory.js';
 import { Language } from '../../src/parsers/base.js';
 import type { ASTNode, SymbolDefinition } from '../../src/types/ast.js';
-import {
+import findCallers, {
   buildSymbolTable,
   findSymbolDefinition,
   findReferences,
 } from '../../src/tools/find_callers.js';
+import { getProjectIndex, resetProjectIndex } from '../../src/graph/indexer.js';
+import { mkdirSync, mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join, resolve } from 'path';
 
 describe('find_callers', () => {
   beforeEach(() => {
@@ -412,6 +416,112 @@ class C extends A {
       expect(bRefs.length).toBeGreaterThan(0);
     });
   });
+
+  describe('Project Index', () => {
+    const root = 'test/fixtures/typescript';
+
+    beforeEach(() => {
+      resetProjectIndex();
+    });
+
+    afterEach(() => {
+      resetProjectIndex();
+    });
+
+    async function callers(file: string, functionName: string) {
+      const response = await findCallers({ filePath: `${root}/${file}`, functionName });
+      expect(response.isError).toBeUndefined();
+      return JSON.parse(response.content[0]!.text);
+    }
+
+    it('should report the same call sites with and without a warm index', async () => {
+      const queries: Array<[string, string]> = [
+        ['callers-test.ts', 'helper1'],
+        ['callers-test.ts', 'helper2'],
+        ['calculator.ts', 'Calculator'],
+        ['calculator.ts', 'factorial'],
+      ];
+      const parsed = [];
+      for (const [file, name] of queries) parsed.push(await callers(file, name));
+
+      await (await getProjectIndex())!.warm(resolve(root));
+      for (let i = 0; i < queries.length; i++) {
+        const [file, name] = queries[i]!;
+        const indexed = await callers(file, name);
+        expect(indexed.symbol).toEqual(parsed[i].symbol);
+        expect(indexed.callers.map(site)).toEqual(parsed[i].callers.map(site));
+      }
+
+      const helper2 = await callers('callers-test.ts', 'helper2');
+      expect(helper2.callers.map((c: { callType: string }) => c.callType)).toEqual([
+        'direct',
+        'callback',
+      ]);
+      expect(helper2.callers[0].filePath).toBe(`${root}/callers-test.ts`);
+      // `new Calculator()` is not a call of the class
+      expect((await callers('calculator.ts', 'Calculator')).totalCount).toBe(0);
+    });
+
+    it('should report columns in UTF-16 code units from a warm index', async () => {
+      const dir = mkdtempSync(join(tmpdir(), 'prism-callers-'));
+      try {
+        const file = join(dir, 'greet.ts');
+        writeFileSync(
+          file,
+          [
+            'export function greet(name: string) {',
+            '  return name;',
+            '}',
+            "const wave = '👋 héllo'; greet(wave);",
+            "export function main() { const s = 'ß'; return [s].map(greet); }",
+          ].join('\n')
+        );
+        const query = { filePath: file, functionName: 'greet' };
+        const parsed = JSON.parse((await findCallers(query)).content[0]!.text);
+        const columns = (result: { callers: Array<{ columnNumber: number }> }) =>
+          result.callers.map((call) => call.columnNumber);
+        // Code units, not bytes: the emoji takes two, é and ß one each
+        expect(columns(parsed)).toEqual([25, 54]);
+
+        await (await getProjectIndex())!.warm(dir);
+        const indexed = JSON.parse((await findCallers(query)).content[0]!.text);
+        expect(indexed.callers.map(site)).toEqual(parsed.callers.map(site));
+        expect(columns(indexed)).toEqual([25, 54]);
+      } finally {
+        rmSync(dir, { recursive: true, force: true });
+      }
+    });
+
+    it('should search the files the index covers with and without it', async () => {
+      const dir = mkdtempSync(join(tmpdir(), 'prism-scope-'));
+      try {
+        const file = join(dir, 'greet.ts');
+        writeFileSync(file, 'export function greet() {}\n');
+        for (const sub of ['build', 'dist', 'lib']) {
+          mkdirSync(join(dir, sub));
+          writeFileSync(join(dir, sub, 'use.js'), 'greet();\n');
+        }
+        writeFileSync(join(dir, 'lib', 'use.mjs'), 'greet();\n');
+        const query = { filePath: file, functionName: 'greet' };
+        const files = (result: { callers: Array<{ filePath: string }> }) =>
+          result.callers.map((call) => call.filePath).sort();
+
+        const parsed = JSON.parse((await findCallers(query)).content[0]!.text);
+        expect(files(parsed)).toEqual([join(dir, 'lib', 'use.js'), join(dir, 'lib', 'use.mjs')]);
+
+        await (await getProjectIndex())!.warm(dir);
+        const indexed = JSON.parse((await findCallers(query)).content[0]!.text);
+        expect(files(indexed)).toEqual(files(parsed));
+      } finally {
+        rmSync(dir, { recursive: true, force: true });
+      }
+    });
+
+    function site(call: Record<string, unknown>) {
+      const { filePath, lineNumber, columnNumber, callType, callerFunction } = call;
+      return [filePath, lineNumber, columnNumber, callType, callerFunction];
+    }
+  });
 });
 
 // Helper function to extract symbols from a tree
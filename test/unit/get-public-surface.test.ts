@@ -29,6 +29,7 @@ describe('get_public_surface', () => {
     const add = exports.find((e: any) => e.name === 'add');
     expect(add).toBeTruthy();
     expect(add.type).toBe('function');
+    expect(add.signature).toBe('(a: number, b: number): number');
   });
 
   it('should extract class public members', async () => {
@@ -46,6 +47,16 @@ describe('get_public_surface', () => {
     // Should NOT have 'cache' or 'internalMethod'
     expect(calculator.members).not.toContain('cache');
     expect(calculator.members).not.toContain('internalMethod');
+    expect(calculator.members).toEqual(['result', 'constructor', 'add']);
+  });
+
+  it('should list interface members', async () => {
+    const result = await getPublicSurface({ filePath: fixturePath });
+    const exports = JSON.parse(result.content[0].text);
+
+    const shape = exports.find((e: any) => e.name === 'Shape');
+    expect(shape.type).toBe('interface');
+    expect(shape.members).toEqual(['area', 'name']);
   });
 
   it('should handle default exports', async () => {
@@ -55,6 +66,7 @@ describe('get_public_surface', () => {
     const def = exports.find((e: any) => e.isDefault);
     expect(def).toBeTruthy();
     expect(def.type).toBe('function');
+    expect(def.signature).toBe('()');
   });
   
   it('should handle re-exports and aliases', async () => {
@@ -1,7 +1,12 @@
 import { describe, it, expect, beforeEach, afterEach } from 'vitest';
+import { readdirSync } from 'fs';
+import { join, relative, resolve } from 'path';
+import { ProjectIndex } from '../../src/graph/native/index';
 import { ParserFactory } from '../../src/parsers/factory.js';
 import { Language } from '../../src/parsers/base.js';
-import { extractSkeleton } from '../../src/tools/get_skeleton.js';
+import getSkeleton, { extractSkeleton } from '../../src/tools/get_skeleton.js';
+import { getProjectIndex, resetProjectIndex } from '../../src/graph/indexer.js';
+import type { FileSkeleton } from '../../src/types/ast.js';
 
 describe('get_skeleton', () => {
   beforeEach(() => {
@@ -500,4 +505,139 @@ class Inner {
       expect(skeleton.exports.classes[0].name).toBe('Outer');
     });
   });
+
+  // get_skeleton answers from the index when it is warm and parses otherwise;
+  // both must give the same outline.
+  describe('Native index parity', () => {
+    const fixtures = join(process.cwd(), 'test/fixtures');
+    const files = ['', 'typescript', 'javascript', 'python'].flatMap((dir) =>
+      readdirSync(join(fixtures, dir))
+        .filter((name) => /\.(ts|js|py)$/.test(name))
+        .map((name) => relative(process.cwd(), join(fixtures, dir, name)))
+    );
+
+    function expectParity(filePath: string, native: FileSkeleton | null, parsed: FileSkeleton) {
+      expect(native).not.toBeNull();
+      const indexed = { ...native!, filePath, language: parsed.language };
+      expect(parsed).toStrictEqual(indexed);
+      expect(JSON.stringify(parsed, null, 2)).toBe(JSON.stringify(indexed, null, 2));
+    }
+
+    it.each(files)('should match the index skeleton of %s', async (file) => {
+      const filePath = join(process.cwd(), file);
+      const parser = ParserFactory.getParserForFile(filePath);
+      const result = await parser.parseFile(filePath);
+      const parsed = extractSkeleton(result.tree, filePath, parser.getLanguage());
+
+      const index = new ProjectIndex();
+      expect(index.indexFile(filePath)).toBe(true);
+      expectParity(filePath, index.getSkeleton(filePath), parsed);
+    });
+
+    it('should list a directory the same way with and without a warm index', async () => {
+      resetProjectIndex();
+      try {
+        const directoryPath = 'test/fixtures/typescript';
+        const list = async () => {
+          const response = await getSkeleton({ directoryPath });
+          expect(response.isError).toBeUndefined();
+          return response.content[0]!.text;
+        };
+        const parsed = await list();
+        const paths = JSON.parse(parsed).map((skeleton: FileSkeleton) => skeleton.filePath);
+        expect(paths).toEqual([
+          'test/fixtures/typescript/calculator.ts',
+          'test/fixtures/typescript/callers-test.ts',
+        ]);
+
+        await (await getProjectIndex())!.warm(resolve(directoryPath));
+        expect(await list()).toBe(parsed);
+      } finally {
+        resetProjectIndex();
+      }
+    });
+
+    it('should match the index on declarations outside the fixtures', () => {
+      const source = [
+        "import React, * as all from 'react';",
+        "import { a as b, c } from './c';",
+        'interface Internal extends Base<T>, Other {',
+        '  id: number;',
+        '  (x: string): void;',
+        '  load(id?: number): Promise<User>;',
+        '}',
+        "enum Mode { A, B = 2, C = 'c', 'quoted' }",
+        'type Pair = [number, number];',
+        'const hidden = 1;',
+        'export const shown: number = 1, other = 2;',
+        'export let counter = 0;',
+        'export function* ids({ start }, ...rest) {}',
+        'export abstract class Shape implements Drawable {',
+        '  @observable protected static readonly sides: number;',
+        '  #secret = 1;',
+        '  @inject constructor(private readonly name: string, size = 1) {',
+        '    super();',
+        '  }',
+        '  abstract area(): number;',
+        '  static async *walk<T>(items: T[]): AsyncGenerator<T> {}',
+        '}',
+        'export { hidden as visible, counter };',
+        'export * from "./all";',
+      ].join('\n');
+      const parser = ParserFactory.getParser(Language.TypeScript);
+      const parsed = extractSkeleton(parser.parse(source).tree, '/src/shapes.ts', 'typescript');
+      const index = new ProjectIndex();
+      index.indexSource('/src/shapes.ts', source);
+
+      expectParity('/src/shapes.ts', index.getSkeleton('/src/shapes.ts'), parsed);
+      expect(parsed.exports.interfaces.map((i) => i.name)).toEqual(['Internal']);
+      expect(parsed.exports.enums[0].members).toEqual([
+        { name: 'A' },
+        { name: 'B', value: '2' },
+        { name: 'C', value: 'c' },
+        { name: 'quoted' },
+      ]);
+      expect(parsed.exports.variables.map((v) => v.alias ?? v.name)).toEqual([
+        'shown',
+        'other',
+        'counter',
+        'visible',
+        'counter',
+      ]);
+      expect(parsed.exports.functions[0]).toMatchObject({ isExported: true, isGenerator: true });
+      expect(parsed.exports.classes[0].constructorDef!.parameters).toEqual([
+        { name: 'name', type: 'string' },
+        { name: 'size', defaultValue: '1' },
+      ]);
+    });
+
+    it('should match the index on Python declarations outside the fixtures', () => {
+      const source = [
+        'import os.path as p, sys',
+        'from .models import User as U, Group',
+        'from typing import *',
+        'LIMIT: int = 10',
+        '@dataclass',
+        'class Worker(Base, mixins.Loggable):',
+        '    def __init__(self, name: str, *args, retries: int = 3, **kwargs):',
+        '        self.name = name',
+        '        self.name = name.strip()',
+        '        self.count: int = 0',
+        '    @staticmethod',
+        '    async def run(job, timeout=5) -> bool:',
+        '        return True',
+        '',
+      ].join('\n');
+      const parser = ParserFactory.getParser(Language.Python);
+      const parsed = extractSkeleton(parser.parse(source).tree, '/src/worker.py', 'python');
+      const index = new ProjectIndex();
+      index.indexSource('/src/worker.py', source);
+
+      expectParity('/src/worker.py', index.getSkeleton('/src/worker.py'), parsed);
+      const worker = parsed.exports.classes[0];
+      expect(worker.extends).toBe('Base, mixins.Loggable');
+      expect(worker.properties).toEqual([{ name: 'name' }, { name: 'count', type: 'int' }]);
+      expect(worker.methods[1]).toMatchObject({ isStatic: true, isAsync: true });
+    });
+  });
 });
@@ -0,0 +1,116 @@
+import { describe, it, expect } from 'vitest';
+import {
+  buildControlFlow,
+  controlFlowCacheStats,
+  type NativeControlFlowGraph,
+} from '../../src/graph/native/index';
+
+function nodeWith(cfg: NativeControlFlowGraph, text: string) {
+  return cfg.nodes.find((n) => n.statements.some((s) => s.includes(text)))!;
+}
+
+function edgesFrom(cfg: NativeControlFlowGraph, id: string) {
+  return cfg.edges.filter((e) => e.from === id);
+}
+
+describe('Native control flow', () => {
+  it('should build branches, loops and exception edges for TypeScript', () => {
+    const source = [
+      'export function run(items: number[]) {',
+      '  let total = 0;',
+      '  for (let i = 0; i < items.length; i++) {',
+      '    if (items[i] < 0) continue;',
+      '    if (items[i] > 100) break;',
+      '    total += items[i];',
+      '  }',
+      '  try {',
+      '    check(total);',
+      '  } catch (e) {',
+      "    throw new Error('bad');",
+      '  } finally {',
+      '    done();',
+      '  }',
+      '  return total;',
+      '  cleanup();',
+      '}',
+    ].join('\n');
+
+    const cfg = buildControlFlow(source, '/src/run.ts', 'run')!;
+    expect(cfg).not.toBeNull();
+    expect(cfg.nodes[0]!.type).toBe('entry');
+    expect(cfg.nodes[1]!.type).toBe('exit');
+
+    const loop = cfg.nodes.find((n) => n.type === 'loop')!;
+    expect(loop.label).toBe('i < items.length');
+    expect(edgesFrom(cfg, loop.id).map((e) => e.label).sort()).toEqual(['false', 'true']);
+
+    const update = nodeWith(cfg, 'i++');
+    expect(edgesFrom(cfg, update.id)).toEqual([{ from: update.id, to: loop.id, label: 'back' }]);
+    expect(edgesFrom(cfg, nodeWith(cfg, 'continue').id)[0]!.to).toBe(update.id);
+
+    // Breaks leave the loop and join the code after it
+    const afterLoop = nodeWith(cfg, 'check(total)');
+    expect(cfg.edges).toContainEqual({ from: nodeWith(cfg, 'break').id, to: afterLoop.id });
+    expect(cfg.edges).toContainEqual({ from: loop.id, to: afterLoop.id, label: 'false' });
+
+    const handler = cfg.nodes.find((n) => n.label === 'catch (e)')!;
+    expect(cfg.edges).toContainEqual({ from: afterLoop.id, to: handler.id, label: 'exception' });
+
+    const thrown = cfg.nodes.find((n) => n.type === 'exception')!;
+    const finallyBlock = nodeWith(cfg, 'done()');
+    expect(edgesFrom(cfg, thrown.id)).toEqual([
+      { from: thrown.id, to: cfg.nodes[1]!.id, label: 'exception' },
+    ]);
+    expect(cfg.edges.some((e) => e.from === afterLoop.id && e.to === finallyBlock.id)).toBe(true);
+
+    expect(nodeWith(cfg, 'return total').unreachable).toBeUndefined();
+    expect(nodeWith(cfg, 'cleanup()').unreachable).toBe(true);
+  });
+
+  it('should handle Python elif chains and loop else clauses', () => {
+    const source = [
+      'class Worker:',
+      '    def step(self, items):',
+      '        for item in items:',
+      '            if item is None:',
+      '                break',
+      '        else:',
+      '            return 0',
+      '        if self.a:',
+      '            x = 1',
+      '        elif self.b:',
+      '            x = 2',
+      '        else:',
+      '            raise ValueError()',
+      '        return x',
+    ].join('\n');
+
+    const cfg = buildControlFlow(source, '/app/worker.py', 'step')!;
+    expect(cfg).not.toBeNull();
+
+    const loop = cfg.nodes.find((n) => n.type === 'loop')!;
+    expect(loop.label).toBe('for item in items');
+    const loopElse = nodeWith(cfg, 'return 0');
+    expect(cfg.edges).toContainEqual({ from: loop.id, to: loopElse.id, label: 'false' });
+
+    const conditions = cfg.nodes.filter((n) => n.type === 'condition').map((n) => n.label);
+    expect(conditions).toEqual(['item is None', 'self.a', 'self.b']);
+    expect(cfg.nodes.filter((n) => n.type === 'exception')).toHaveLength(1);
+  });
+
+  it('should serve repeated requests from the cache until the source changes', () => {
+    const source = 'const pick = (x: number) => x > 0 ? x : 0;';
+    const before = controlFlowCacheStats();
+
+    const first = buildControlFlow(source, '/src/cached.ts', 'pick')!;
+    expect(first.nodes.map((n) => n.label)).toEqual(['Start', 'End', 'Body']);
+    expect(buildControlFlow(source, '/src/cached.ts', 'pick')).toEqual(first);
+    expect(controlFlowCacheStats().hits).toBe(before.hits + 1);
+
+    buildControlFlow(source + '\n', '/src/cached.ts', 'pick');
+    expect(controlFlowCacheStats().misses).toBe(before.misses + 2);
+
+    expect(buildControlFlow(source, '/src/cached.ts', 'missing')).toBeNull();
+    expect(buildControlFlow('puts 1', '/src/a.rb', 'pick')).toBeNull();
+  });
+});
@@ -0,0 +1,98 @@
+import { describe, it, expect } from 'vitest';
+import { analyzeDataflow, dataflowAt } from '../../src/graph/native/index';
+
+describe('Native dataflow', () => {
+  it('should compute reaching definitions through branches and loops', () => {
+    const source = [
+      'function total(items: number[], scale = 1) {',
+      '  let sum = 0;',
+      '  for (const item of items) {',
+      '    if (item > 10) {',
+      '      sum = item * scale;',
+      '    }',
+      '    sum += item;',
+      '  }',
+      '  return sum;',
+      '}',
+    ].join('\n');
+
+    const dataflow = analyzeDataflow(source, '/src/total.ts', 'total')!;
+    expect(dataflow).not.toBeNull();
+    expect(dataflow.definitions.map((d) => `${d.name}:${d.kind}:${d.line}`)).toEqual([
+      'items:parameter:1',
+      'scale:parameter:1',
+      'sum:declaration:2',
+      'item:loop:3',
+      'sum:assignment:5',
+      'sum:assignment:7',
+    ]);
+    expect(dataflow.definitions[0]!.type).toBe('number[]');
+    expect(dataflow.definitions[1]!.type).toBe('number');
+
+    // The declaration and the in-loop update both reach the return
+    const atReturn = dataflowAt(source, '/src/total.ts', 'total', 9)!;
+    const sums = atReturn.reachingDefinitions.filter((d) => d.name === 'sum').map((d) => d.line);
+    expect(sums.sort()).toEqual([2, 7]);
+
+    // Inside the loop the previous iteration's update reaches the test
+    const atIf = dataflowAt(source, '/src/total.ts', 'total', 4)!;
+    expect(atIf.reachingDefinitions.filter((d) => d.name === 'sum').map((d) => d.line)).toEqual([
+      2, 7,
+    ]);
+
+    expect(dataflowAt(source, '/src/total.ts', 'total', 20)).toBeNull();
+  });
+
+  it('should narrow types along the branch where the guard holds', () => {
+    const source = [
+      'function show(value: string | number | null, err: unknown) {',
+      "  if (typeof value === 'string') {",
+      '    print(value);',
+      '  }',
+      '  if (value !== null) {',
+      '    print(value);',
+      '  }',
+      '  if (err instanceof Error && value) {',
+      '    print(err);',
+      '  }',
+      '  print(value);',
+      '}',
+    ].join('\n');
+
+    const narrowed = (line: number) =>
+      dataflowAt(source, '/src/show.ts', 'show', line)!.narrowings.map(
+        (n) => `${n.variableName}:${n.narrowedType}:${n.reason}`
+      );
+
+    expect(narrowed(3)).toEqual(['value:string:typeof']);
+    expect(narrowed(6)).toEqual(['value:NonNullable<T>:equality']);
+    expect(narrowed(9)).toEqual(['err:Error:instanceof', 'value:NonNullable<T>:control_flow']);
+    expect(narrowed(11)).toEqual([]);
+
+    const point = dataflowAt(source, '/src/show.ts', 'show', 3)!;
+    expect(point.narrowings[0]!.condition).toBe("typeof value === 'string'");
+  });
+
+  it('should handle Python isinstance checks and reuse cached results', () => {
+    const source = [
+      'def parse(raw):',
+      '    value = None',
+      '    if isinstance(raw, (int, float)):',
+      '        value = raw',
+      '    elif raw is not None:',
+      '        value = str(raw)',
+      '    return value',
+    ].join('\n');
+
+    const first = analyzeDataflow(source, '/app/parse.py', 'parse')!;
+    expect(first.narrowings.map((n) => `${n.variableName}:${n.narrowedType}`)).toContain(
+      'raw:int | float'
+    );
+    expect(analyzeDataflow(source, '/app/parse.py', 'parse')).toEqual(first);
+
+    const atReturn = dataflowAt(source, '/app/parse.py', 'parse', 7)!;
+    expect(atReturn.reachingDefinitions.map((d) => d.line).sort()).toEqual([1, 2, 4, 6]);
+
+    expect(analyzeDataflow(source, '/app/parse.py', 'missing')).toBeNull();
+  });
+});
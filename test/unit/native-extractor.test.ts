@@ -0,0 +1,185 @@
+import { describe, it, expect } from 'vitest';
+import {
+  extractFile,
+  scanIdentifierUsages,
+  scanConfigReferences,
+  classifySymbols,
+} from '../../src/graph/native/index';
+import { SymbolFlags } from '../../src/graph/indexer';
+
+describe('Native extractor', () => {
+  it('should extract TypeScript symbols, imports and call sites in one pass', () => {
+    const source = [
+      "import type { Config } from './config';",
+      "import fs, { readFileSync as read } from 'fs';",
+      '',
+      'export function load(path: string) {',
+      '  return parse(read(path));',
+      '}',
+      '',
+      'function parse(text: string) {',
+      '  return JSON.parse(text);',
+      '}',
+      '',
+      'export class Loader {',
+      '  static create() {',
+      '    return new Loader();',
+      '  }',
+      '  run() {',
+      '    load("x");',
+      '  }',
+      '}',
+      '',
+      'const helper = () => parse("{}");',
+      'export { helper };',
+    ].join('\n');
+
+    const result = extractFile(source, '/src/loader.ts')!;
+    expect(result).not.toBeNull();
+
+    const byId = new Map(result.symbols.map((s) => [s.id, s]));
+    expect(byId.get('function:load:/src/loader.ts')).toMatchObject({
+      line: 4,
+      endLine: 6,
+      isExported: true,
+    });
+    expect(byId.get('function:parse:/src/loader.ts')?.isExported).toBe(false);
+    expect(byId.get('class:Loader:/src/loader.ts')?.isExported).toBe(true);
+    expect(byId.get('method:create:Loader:/src/loader.ts')?.isStatic).toBe(true);
+    expect(byId.get('method:run:Loader:/src/loader.ts')).toMatchObject({ className: 'Loader' });
+    expect(byId.get('variable:helper:/src/loader.ts')?.isExported).toBe(true);
+
+    expect(result.imports).toEqual([
+      { source: './config', imported: ['Config'], isTypeOnly: true },
+      { source: 'fs', imported: ['fs', 'readFileSync'], isTypeOnly: false },
+    ]);
+
+    const calls = result.callSites.map((c) => [c.name, c.fromSymbolId, c.type]);
+    expect(calls).toContainEqual(['parse', 'function:load:/src/loader.ts', 'direct']);
+    expect(calls).toContainEqual(['read', 'function:load:/src/loader.ts', 'direct']);
+    expect(calls).toContainEqual(['parse', 'function:parse:/src/loader.ts', 'method']);
+    expect(calls).toContainEqual(['Loader', 'method:create:Loader:/src/loader.ts', 'new']);
+    expect(calls).toContainEqual(['path', 'function:load:/src/loader.ts', 'callback']);
+    expect(calls).toContainEqual(['load', 'method:run:Loader:/src/loader.ts', 'direct']);
+    expect(calls).toContainEqual(['parse', 'variable:helper:/src/loader.ts', 'direct']);
+  });
+
+  it('should extract Python classes, methods and module-level variables', () => {
+    const source = [
+      'import os.path',
+      'from .models import User, Group as G',
+      '',
+      'LIMIT = 10',
+      '',
+      'class Service:',
+      '    @staticmethod',
+      '    def build():',
+      '        return Service()',
+      '',
+      '    def run(self):',
+      '        def inner():',
+      '            pass',
+      '        self.build()',
+      '',
+      'def main():',
+      '    Service.build()',
+    ].join('\n');
+
+    const result = extractFile(source, '/app/service.py')!;
+    const ids = result.symbols.map((s) => s.id);
+
+    expect(ids).toContain('variable:LIMIT:/app/service.py');
+    expect(ids).toContain('class:Service:/app/service.py');
+    expect(ids).toContain('method:build:Service:/app/service.py');
+    expect(ids).toContain('method:run:Service:/app/service.py');
+    expect(ids).toContain('function:inner:/app/service.py');
+    expect(ids).toContain('function:main:/app/service.py');
+    expect(result.symbols.find((s) => s.name === 'build')?.isStatic).toBe(true);
+
+    expect(result.imports).toEqual([
+      { source: 'os.path', imported: ['os.path'], isTypeOnly: false },
+      { source: '.models', imported: ['User', 'Group'], isTypeOnly: false },
+    ]);
+
+    const calls = result.callSites.map((c) => [c.name, c.fromSymbolId]);
+    expect(calls).toContainEqual(['Service', 'method:build:Service:/app/service.py']);
+    expect(calls).toContainEqual(['build', 'method:run:Service:/app/service.py']);
+    expect(calls).toContainEqual(['build', 'function:main:/app/service.py']);
+  });
+
+  it('should collect identifier uses but not declarations or imports', () => {
+    const source = [
+      "import { unusedImport } from './lib';",
+      'const total = compute(base);',
+      'function compute(value: Amount, unit) {',
+      '  return value.amount;',
+      '}',
+      'const view = <Panel title={total} />;',
+    ].join('\n');
+
+    const names = scanIdentifierUsages(source, '/src/view.tsx')!;
+
+    expect(names).toEqual(
+      expect.arrayContaining(['compute', 'base', 'value', 'amount', 'Panel', 'total'])
+    );
+    expect(names).not.toContain('unusedImport');
+    expect(names).not.toContain('view');
+    expect(names).not.toContain('unit');
+    expect(new Set(names).size).toBe(names.length);
+  });
+
+  it('should treat Python parameters as declarations', () => {
+    const names = scanIdentifierUsages('def run(job, retries=LIMIT):\n    job.start()\n', '/a.py')!;
+
+    expect(names).toEqual(expect.arrayContaining(['job', 'LIMIT', 'start']));
+    expect(names).not.toContain('run');
+    expect(names).not.toContain('retries');
+  });
+
+  it('should scan config files for dotted class paths', () => {
+    const settings = [
+      'import app.auth.TokenFilter',
+      'MIDDLEWARE = [',
+      "    'app.middleware.AuthMiddleware',",
+      '    "vendor.security.TokenFilter",',
+      "    'vendor.unrelated.Widget',",
+      ']',
+    ].join('\n');
+
+    expect(scanConfigReferences(settings, '/app/settings.py')).toEqual([
+      { name: 'AuthMiddleware', line: 3, column: 4 },
+      { name: 'TokenFilter', line: 4, column: 4 },
+    ]);
+
+    const json = '{"handler": "pkg.log.JsonHandler", "pkg.Key": 1, "list": ["a.B", "plain"]}';
+    expect(scanConfigReferences(json, '/app/logging.config.json')!.map((r) => r.name)).toEqual([
+      'JsonHandler',
+      'B',
+    ]);
+    expect(scanConfigReferences(json, '/app/data.json')).toBeNull();
+  });
+
+  it('should classify framework hooks and middleware in one pass', () => {
+    const flags = classifySymbols([
+      { name: 'dispatch', type: 'method', className: 'AuthMiddleware', filePath: '/app/auth.py' },
+      { name: 'dispatch', type: 'method', className: 'Auth', filePath: '/app/auth.py' },
+      { name: 'render', type: 'method', className: 'App', filePath: '/src/App.tsx' },
+      { name: 'render', type: 'method', className: 'App', filePath: '/app/view.py' },
+      { name: '__str__', type: 'function', filePath: '/app/util.py' },
+      { name: 'RequestFILTER', type: 'class', filePath: '/app/settings.py' },
+      { name: 'Render', type: 'method', className: 'App', filePath: '/src/App.tsx' },
+    ]);
+
+    const roots = Array.from(flags, (f) => (f & SymbolFlags.DeadCodeRoot) !== 0);
+    expect(roots).toEqual([true, false, true, false, true, false, false]);
+    expect(flags[0]! & SymbolFlags.InMiddlewareClass).toBeTruthy();
+    expect(flags[5]! & SymbolFlags.MiddlewareClass).toBeTruthy();
+    expect(flags[5]! & SymbolFlags.InConfigFile).toBeTruthy();
+    expect(flags[6]! & SymbolFlags.ReactLifecycle).toBe(0);
+  });
+
+  it('should return null for unsupported files', () => {
+    expect(extractFile('puts 1', '/src/a.rb')).toBeNull();
+    expect(scanIdentifierUsages('puts 1', '/src/a.rb')).toBeNull();
+  });
+});
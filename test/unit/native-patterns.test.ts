@@ -0,0 +1,86 @@
+import { describe, it, expect } from 'vitest';
+import { findPatterns, patternCacheStats } from '../../src/graph/native/index';
+
+describe('Native pattern matching', () => {
+  const source = [
+    'function helper(a: number) {',
+    '  return a + 1;',
+    '}',
+    'function main() {',
+    '  helper(1);',
+    '  console.log(helper(2));',
+    '}',
+  ].join('\n');
+
+  it('should return captures with 0-based positions', () => {
+    const matches = findPatterns(
+      source,
+      '/src/main.ts',
+      '(function_declaration name: (identifier) @name)'
+    )!;
+    expect(matches.map((m) => m.captures[0]!.text)).toEqual(['helper', 'main']);
+    const capture = matches[1]!.captures[0]!;
+    expect(capture.name).toBe('name');
+    expect(capture.type).toBe('identifier');
+    expect(capture.startPosition).toEqual({ row: 3, column: 9 });
+    expect(capture.endPosition).toEqual({ row: 3, column: 13 });
+  });
+
+  it('should count columns in UTF-16 code units', () => {
+    const matches = findPatterns(
+      "const wave = '👋 héllo'; greet(wave);\n",
+      '/src/wave.ts',
+      '(call_expression function: (identifier) @fn)'
+    )!;
+    const capture = matches[0]!.captures[0]!;
+    expect(capture.text).toBe('greet');
+    expect(capture.startPosition).toEqual({ row: 0, column: 25 });
+    expect(capture.endPosition).toEqual({ row: 0, column: 30 });
+  });
+
+  it('should apply text predicates', () => {
+    const eq = findPatterns(
+      source,
+      '/src/main.ts',
+      '(call_expression function: (identifier) @fn (#eq? @fn "helper"))'
+    )!;
+    expect(eq).toHaveLength(2);
+
+    const match = findPatterns(
+      source,
+      '/src/main.ts',
+      '(call_expression function: (member_expression) @fn (#match? @fn "^console\\\\."))'
+    )!;
+    expect(match.map((m) => m.captures[0]!.text)).toEqual(['console.log']);
+
+    const notEq = findPatterns(
+      source,
+      '/src/main.ts',
+      '(call_expression function: (identifier) @fn (#not-eq? @fn "helper"))'
+    )!;
+    expect(notEq).toHaveLength(0);
+  });
+
+  it('should reuse compiled queries and parsers', () => {
+    const query = '(return_statement) @ret';
+    findPatterns(source, '/src/main.ts', query);
+    const before = patternCacheStats();
+
+    for (let i = 0; i < 5; i++) {
+      expect(findPatterns(source, '/src/main.ts', query)).toHaveLength(1);
+    }
+
+    const after = patternCacheStats();
+    expect(after.hits).toBe(before.hits + 5);
+    expect(after.misses).toBe(before.misses);
+    expect(after.parsers).toBe(before.parsers);
+    expect(after.parses).toBeGreaterThanOrEqual(before.parses + 5);
+  });
+
+  it('should throw on invalid queries and skip unsupported files', () => {
+    expect(() => findPatterns(source, '/src/main.ts', '(not_a_node_type)')).toThrow(
+      /Invalid query/
+    );
+    expect(findPatterns('# readme', '/docs/README.md', '(x)')).toBeNull();
+  });
+});
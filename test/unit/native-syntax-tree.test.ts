@@ -0,0 +1,125 @@
+import { describe, it, expect } from 'vitest';
+import { mkdtempSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join } from 'path';
+import {
+  NativeSyntaxTree,
+  readSource,
+  setTreeCacheBudget,
+  sourceBufferStats,
+  treeCacheStats,
+} from '../../src/graph/native/index';
+import { TypeScriptParser } from '../../src/parsers/typescript';
+
+describe('NativeSyntaxTree', () => {
+  const source = 'function add(a: number, b: number) {\n  return a + b;\n}\n';
+
+  it('should detect languages from file paths', () => {
+    expect(NativeSyntaxTree.languageForFile('/src/a.ts')).toBe('typescript');
+    expect(NativeSyntaxTree.languageForFile('/src/a.jsx')).toBe('tsx');
+    expect(NativeSyntaxTree.languageForFile('/src/a.py')).toBe('python');
+    expect(NativeSyntaxTree.languageForFile('/src/a.rb')).toBeNull();
+  });
+
+  it('should walk the tree with a cursor', () => {
+    const tree = new NativeSyntaxTree(source, 'typescript');
+    const cursor = tree.walk();
+
+    expect(cursor.nodeType()).toBe('program');
+    expect(cursor.gotoFirstChild()).toBe(true);
+    expect(cursor.nodeType()).toBe('function_declaration');
+    expect(cursor.depth()).toBe(1);
+    expect(cursor.startPosition()).toEqual({ row: 0, column: 0 });
+
+    expect(cursor.gotoFirstChild()).toBe(true);
+    expect(cursor.gotoNextSibling()).toBe(true);
+    expect(cursor.fieldName()).toBe('name');
+    expect(cursor.text()).toBe('add');
+
+    expect(cursor.gotoParent()).toBe(true);
+    expect(cursor.gotoParent()).toBe(true);
+    expect(cursor.gotoParent()).toBe(false);
+    expect(cursor.depth()).toBe(0);
+  });
+
+  it('should expose node type IDs and byte-range text', () => {
+    const tree = new NativeSyntaxTree(Buffer.from(source), 'typescript');
+    const identifierId = tree.typeId('identifier');
+    expect(tree.typeName(identifierId)).toBe('identifier');
+
+    const identifiers: string[] = [];
+    tree.forEachNode((cursor) => {
+      if (cursor.nodeTypeId() === identifierId) {
+        identifiers.push(tree.text(cursor.startIndex(), cursor.endIndex()));
+      }
+    });
+
+    expect(identifiers).toEqual(['add', 'a', 'b', 'a', 'b']);
+    expect(tree.byteLength()).toBe(Buffer.byteLength(source));
+    expect(tree.hasError()).toBe(false);
+  });
+
+  it('should share one loaded copy of a file between views and trees', () => {
+    const dir = mkdtempSync(join(tmpdir(), 'prism-source-'));
+    const small = join(dir, 'small.ts');
+    const large = join(dir, 'large.ts');
+    writeFileSync(small, source);
+    writeFileSync(large, 'export const value = 1;\n'.repeat(8192));
+
+    const first = readSource(large)!;
+    const before = sourceBufferStats();
+    const second = readSource(large)!;
+    expect(sourceBufferStats().reuses).toBe(before.reuses + 1);
+    expect(sourceBufferStats().loads).toBe(before.loads);
+    expect(second.equals(first)).toBe(true);
+
+    // Parsing a view reuses its bytes, and text views slice the same buffer
+    const tree = new NativeSyntaxTree(readSource(small)!, 'typescript');
+    expect(tree.textView(9, 12).toString()).toBe('add');
+    expect(tree.text(0, 12)).toBe('function add');
+
+    // A rewritten file is loaded again
+    writeFileSync(small, source + '// changed\n');
+    const loads = sourceBufferStats().loads;
+    expect(readSource(small)!.toString()).toBe(source + '// changed\n');
+    expect(sourceBufferStats().loads).toBe(loads + 1);
+    expect(readSource(join(dir, 'missing.ts'))).toBeNull();
+
+    // Loaded bytes are a copy: truncating and rewriting in place leaves them be
+    const original = first.toString();
+    writeFileSync(large, 'export const value = 2;\n');
+    expect(first.toString()).toBe(original);
+  });
+
+  it('should reuse cached trees for identical source within a byte budget', () => {
+    const unique = `${source}// tree cache ${Date.now()}\n`;
+    const before = treeCacheStats();
+    new NativeSyntaxTree(unique, 'typescript');
+    const afterFirst = treeCacheStats();
+    expect(afterFirst.misses).toBe(before.misses + 1);
+    expect(afterFirst.residentBytes).toBeGreaterThan(before.residentBytes);
+
+    const again = new NativeSyntaxTree(Buffer.from(unique), 'typescript');
+    expect(treeCacheStats().hits).toBe(afterFirst.hits + 1);
+    expect(again.text(9, 12)).toBe('add');
+
+    // Shrinking the budget evicts down to it; live trees stay usable
+    const budget = afterFirst.budgetBytes;
+    setTreeCacheBudget(0);
+    expect(treeCacheStats()).toMatchObject({ entries: 0, residentBytes: 0 });
+    expect(treeCacheStats().evictions).toBeGreaterThan(afterFirst.evictions);
+    expect(again.text(9, 12)).toBe('add');
+    setTreeCacheBudget(budget);
+  });
+
+  it('should keep ASTNode text identical to tree-sitter text', () => {
+    const parser = new TypeScriptParser();
+    const { tree } = parser.parse(source);
+    const fn = tree.namedChildren[0]!;
+
+    expect(tree.text.startsWith('function add')).toBe(true);
+    expect(fn.type).toBe('function_declaration');
+    expect(fn.namedChildren[0]!.text).toBe('add');
+    expect(JSON.parse(JSON.stringify({ text: fn.text }))).toEqual({ text: fn.text });
+  });
+});
@@ -0,0 +1,786 @@
+import { describe, it, expect, beforeEach } from 'vitest';
+import { spawn } from 'child_process';
+import { appendFileSync, mkdtempSync, readFileSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join, resolve } from 'path';
+import { ProjectIndex } from '../../src/graph/native/index';
+
+describe('ProjectIndex (Native)', () => {
+  let index: ProjectIndex;
+
+  beforeEach(() => {
+    index = new ProjectIndex();
+  });
+
+  it('should link call sites across files regardless of indexing order', () => {
+    index.indexSource('/src/app.ts', "import { util } from './util';\nfunction run() {\n  util();\n}\n");
+    index.indexSource('/src/util.ts', 'export function util() {}\n');
+
+    const callers = index.findCallers('function:util:/src/util.ts');
+    expect(callers).toHaveLength(1);
+    expect(callers[0]).toMatchObject({
+      fromSymbolId: 'function:run:/src/app.ts',
+      filePath: '/src/app.ts',
+      line: 3,
+      type: 'direct',
+    });
+  });
+
+  it('should drop call sites when the calling file changes or is removed', () => {
+    index.indexSource('/src/util.ts', 'export function util() {}\n');
+    index.indexSource('/src/app.ts', 'function run() {\n  util();\n  util();\n}\n');
+    expect(index.findCallers('function:util:/src/util.ts')).toHaveLength(2);
+
+    index.indexSource('/src/app.ts', 'function run() {\n  util();\n}\n');
+    expect(index.findCallers('function:util:/src/util.ts')).toHaveLength(1);
+
+    index.removeFile('/src/app.ts');
+    expect(index.findCallers('function:util:/src/util.ts')).toHaveLength(0);
+  });
+
+  it('should relink callers when the target file is re-indexed', () => {
+    index.indexSource('/src/app.ts', 'function run() {\n  util();\n}\n');
+    index.indexSource('/src/util.ts', 'export function util() {}\n');
+    index.indexSource('/src/util.ts', '\nexport function util() {}\n');
+
+    expect(index.findCallers('function:util:/src/util.ts')).toHaveLength(1);
+    expect(index.getSymbol('function:util:/src/util.ts')?.line).toBe(2);
+  });
+
+  it('should count name usages across files with one join', () => {
+    index.indexSource('/src/util.ts', 'export function util() {}\nexport const unused = 1;\n');
+    index.indexSource('/src/a.ts', 'util();\n');
+    index.indexSource('/src/b.ts', 'util(); util();\n');
+
+    expect(index.getFileUsages('/src/b.ts')).toEqual(['util']);
+    expect(index.countUsages(['util', 'unused', 'missing'])).toEqual([2, 0, 0]);
+    expect(index.countUsages(['util'], ['/src/a.ts', '/src/util.ts'])).toEqual([1]);
+
+    index.removeFile('/src/a.ts');
+    expect(index.countUsages(['util'])).toEqual([1]);
+  });
+
+  it('should record identifier postings with usage kinds', () => {
+    index.indexSource(
+      '/src/counter.ts',
+      [
+        'let count = 0;',
+        'function bump(step) {',
+        '  count += step;',
+        '  count++;',
+        '  log(count);',
+        '  return state.count;',
+        '}',
+        'bump(1);',
+      ].join('\n')
+    );
+    index.indexSource('/lib/other.ts', 'count = 1;\n');
+
+    const usages = index.findUsages('count', '/src');
+    expect(usages.map((u) => [u.line, u.column, u.kind])).toEqual([
+      [1, 4, 'declaration'],
+      [3, 2, 'assignment'],
+      [4, 2, 'assignment'],
+      [5, 6, 'read'],
+      [6, 15, 'read'],
+    ]);
+    expect(usages[3]).toMatchObject({ isArgument: true, isMember: false });
+    expect(usages[4]).toMatchObject({ isArgument: false, isMember: true, isProperty: true });
+
+    expect(index.findUsages('bump').map((u) => [u.line, u.kind])).toEqual([
+      [2, 'declaration'],
+      [8, 'call'],
+    ]);
+    expect(index.findUsages('count')).toHaveLength(6);
+
+    index.indexSource('/src/counter.ts', 'export {};\n');
+    expect(index.findUsages('count')).toEqual([
+      {
+        filePath: '/lib/other.ts',
+        line: 1,
+        column: 0,
+        kind: 'assignment',
+        isMember: false,
+        isArgument: false,
+        isProperty: false,
+        isImport: false,
+      },
+    ]);
+  });
+
+  it('should narrow candidate files with per-file identifier filters', () => {
+    index.indexSource('/src/orders.ts', 'export function placeOrderWithRetry() {}\n');
+    index.indexSource('/src/checkout.ts', 'placeOrderWithRetry();\n');
+    index.indexSource('/src/theme.ts', 'export const paletteBackgroundShade = 3;\n');
+
+    const candidates = index.findCandidateFiles(['placeOrderWithRetry']);
+    expect(candidates.sort()).toEqual(['/src/checkout.ts', '/src/orders.ts']);
+
+    expect(
+      index.findCandidateFiles(['paletteBackgroundShade'], ['/src/theme.ts', '/src/unindexed.ts'])
+    ).toEqual(['/src/theme.ts', '/src/unindexed.ts']);
+  });
+
+  it('should keep candidate files that changed on disk since they were indexed', () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-candidates-'));
+    try {
+      const edited = join(root, 'edited.ts');
+      const untouched = join(root, 'untouched.ts');
+      writeFileSync(edited, 'export const first = 1;\n');
+      writeFileSync(untouched, 'export const other = 1;\n');
+      expect(index.indexFile(edited)).toBe(true);
+      expect(index.indexFile(untouched)).toBe(true);
+      expect(index.findCandidateFiles(['secondValue'], [edited, untouched])).toEqual([]);
+
+      // Not marked dirty, as when the watcher has yet to report the write
+      writeFileSync(edited, 'export const first = 1;\nexport const secondValue = 2;\n');
+      expect(index.findCandidateFiles(['secondValue'], [edited, untouched])).toEqual([edited]);
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it('should link config references from the config root', () => {
+    index.indexSource('/app/middleware.py', 'class AuthMiddleware:\n    pass\n');
+    index.indexSource('/app/settings.py', "MIDDLEWARE = ['app.middleware.AuthMiddleware']\n");
+
+    const callers = index.findCallers('class:AuthMiddleware:/app/middleware.py');
+    expect(callers).toHaveLength(1);
+    expect(callers[0]).toMatchObject({ fromSymbolId: 'config', filePath: '/app/settings.py', line: 1 });
+    expect(index.getConfigReferences(['/app/settings.py', '/app/middleware.py'])).toEqual([
+      'AuthMiddleware',
+    ]);
+
+    index.indexSource('/app/settings.py', 'MIDDLEWARE = []\n');
+    expect(index.findCallers('class:AuthMiddleware:/app/middleware.py')).toHaveLength(0);
+  });
+
+  it('should resolve relative, extensionless and Python imports', async () => {
+    const tsDir = resolve('test/fixtures/dependencies/typescript');
+    const pyDir = resolve('test/fixtures/dependencies/python');
+
+    expect(index.resolveImport(`${tsDir}/a.ts`, './b')).toBe(`${tsDir}/b.ts`);
+    expect(index.resolveImport(`${tsDir}/a.ts`, './b.js')).toBe(`${tsDir}/b.ts`);
+    expect(index.resolveImport(`${tsDir}/a.ts`, 'lodash')).toBeNull();
+    expect(index.resolveImport(`${pyDir}/py_a.py`, 'py_b')).toBe(`${pyDir}/py_b.py`);
+    expect(index.resolveImport(`${pyDir}/py_a.py`, 'os.path')).toBeNull();
+
+    // Results are cached only under a watched root, where changes invalidate them
+    expect(index.getStats().cachedImportResolutions).toBe(0);
+    await index.warm(tsDir);
+    index.resolveImport(`${tsDir}/a.ts`, './b');
+    const cached = index.getStats().cachedImportResolutions;
+    index.resolveImport(`${tsDir}/a.ts`, './b');
+    index.resolveImport(`${pyDir}/py_a.py`, 'py_b');
+    index.resolveImport(`${pyDir}/py_a.py`, 'py_b');
+    expect(index.getStats().cachedImportResolutions).toBe(cached + 1);
+  });
+
+  it('should resolve method calls through the class hierarchy', () => {
+    index.indexSource(
+      '/src/shapes.ts',
+      [
+        'export class Shape {',
+        '  area() { return 0; }',
+        '  describe() { return this.area(); }',
+        '}',
+        'export class Square extends Shape implements Drawable {',
+        '  area() { return super.area() + 1; }',
+        '}',
+        'class Report {',
+        '  area() { return 0; }',
+        '}',
+      ].join('\n')
+    );
+    index.indexSource('/src/app.ts', 'function main() {\n  new Square().describe();\n}\n');
+
+    const shapeArea = 'method:area:Shape:/src/shapes.ts';
+    const squareArea = 'method:area:Square:/src/shapes.ts';
+    const reportArea = 'method:area:Report:/src/shapes.ts';
+
+    // this.area() in Shape may run Shape's or Square's override, never Report's
+    const describeCallees = index
+      .findCallees('method:describe:Shape:/src/shapes.ts')
+      .map((r) => r.toSymbolId);
+    expect(describeCallees.sort()).toEqual([shapeArea, squareArea]);
+    expect(index.findCallers(reportArea)).toHaveLength(0);
+
+    // super.area() runs the base implementation only
+    const superCalls = index.findCallees(squareArea);
+    expect(superCalls.map((r) => r.toSymbolId)).toEqual([shapeArea]);
+    expect(superCalls[0]).toMatchObject({ receiverClass: 'Shape', superCall: true });
+
+    // Inherited: Square has no describe of its own
+    expect(index.resolveMethod('Square', 'describe')).toEqual([
+      'method:describe:Shape:/src/shapes.ts',
+    ]);
+    expect(index.findCallers('method:describe:Shape:/src/shapes.ts')).toHaveLength(1);
+
+    expect(index.getBaseClasses('class:Square:/src/shapes.ts')).toEqual([
+      { classId: 'class:Square:/src/shapes.ts', name: 'Shape', isImplements: false },
+      { classId: 'class:Square:/src/shapes.ts', name: 'Drawable', isImplements: true },
+    ]);
+    expect(index.getSubclasses('class:Shape:/src/shapes.ts')).toEqual([
+      'class:Square:/src/shapes.ts',
+    ]);
+
+    index.removeFile('/src/shapes.ts');
+    expect(index.getSubclasses('class:Shape:/src/shapes.ts')).toEqual([]);
+  });
+
+  it('should follow re-export chains through barrels and update them incrementally', () => {
+    const dir = resolve('test/fixtures/barrels');
+    const files = ['lib/shapes.ts', 'lib/index.ts', 'version.ts', 'index.ts'];
+    for (const file of files) {
+      index.indexSource(`${dir}/${file}`, readFileSync(`${dir}/${file}`, 'utf-8'));
+    }
+
+    const surface = index.getExports(`${dir}/index.ts`);
+    expect(surface.map((e) => `${e.name}:${e.localName}:${e.depth}`).sort()).toEqual([
+      'Circle:Circle:2',
+      'area:area:2',
+      'computeArea:area:2',
+      'version:version:1',
+    ]);
+    expect(index.resolveExport(`${dir}/index.ts`, 'Circle')).toMatchObject({
+      filePath: `${dir}/lib/shapes.ts`,
+      localName: 'Circle',
+    });
+    expect(index.resolveExport(`${dir}/index.ts`, 'version')!.filePath).toBe(`${dir}/version.ts`);
+    // `export *` never forwards default
+    expect(index.resolveExport(`${dir}/lib/index.ts`, 'default')).toBeNull();
+
+    // Changing the leaf recomputes it and the two barrels above it, not version.ts
+    const before = index.getStats().exportSurfaceComputations;
+    index.indexSource(
+      `${dir}/lib/shapes.ts`,
+      'export function area() {}\nexport function perimeter() {}\n'
+    );
+    expect(index.resolveExport(`${dir}/index.ts`, 'perimeter')).toMatchObject({
+      filePath: `${dir}/lib/shapes.ts`,
+      depth: 2,
+    });
+    expect(index.resolveExport(`${dir}/index.ts`, 'Circle')).toMatchObject({
+      filePath: `${dir}/lib/shapes.ts`,
+      localName: 'default',
+    });
+    expect(index.getStats().exportSurfaceComputations - before).toBe(3);
+  });
+
+  it('should reparse edits incrementally and re-extract only the statements they touch', () => {
+    const source = [
+      "import { log } from './log';",
+      '',
+      'function first() {',
+      '  log(1);',
+      '}',
+      '',
+      'function second() {',
+      '  first();',
+      '}',
+      '',
+    ].join('\n');
+    index.indexSource('/src/edit.ts', source);
+
+    // A line inserted into first() moves everything in second() down by one
+    const at = source.indexOf('  log(1);');
+    expect(index.applyEdit('/src/edit.ts', at, at, '  log(0);\n')).toBe(true);
+    expect(index.getStats()).toMatchObject({ incrementalParses: 1, partialExtractions: 1 });
+
+    const lines = index.findSymbolsByFile('/src/edit.ts').map((s) => `${s.name}:${s.line}`);
+    expect(lines.sort()).toEqual(['first:3', 'second:8']);
+    const callers = index.findCallers('function:first:/src/edit.ts');
+    expect(callers).toHaveLength(1);
+    expect(callers[0]).toMatchObject({ fromSymbolId: 'function:second:/src/edit.ts', line: 9 });
+    expect(index.findUsages('log').filter((u) => u.kind === 'call')).toHaveLength(2);
+
+    // Diffed against the retained source; touching an import re-extracts everything
+    index.indexSource('/src/edit.ts', source.replace("'./log'", "'./logger'"));
+    expect(index.getStats()).toMatchObject({ incrementalParses: 2, partialExtractions: 1 });
+    expect(index.findCallers('function:first:/src/edit.ts')[0]!.line).toBe(8);
+
+    expect(index.applyEdit('/src/missing.ts', 0, 0, 'x')).toBe(false);
+  });
+
+  it('should compose function summaries across files and recompute only what changed', () => {
+    index.indexSource(
+      '/src/app.ts',
+      [
+        "import { store } from './store';",
+        'export function handle(request, options) {',
+        '  const body = request.body;',
+        '  return store(body, options.mode);',
+        '}',
+        'function ping(a) { return ping(a); }',
+      ].join('\n')
+    );
+    index.indexSource(
+      '/src/store.ts',
+      ['let last;', 'export function store(value, mode) {', '  last = value;', '  return value;', '}'].join(
+        '\n'
+      )
+    );
+
+    const summary = index.getFunctionSummary('function:handle:/src/app.ts')!;
+    expect(summary.parameters).toEqual(['request', 'options']);
+    expect(summary.returnedParameters).toEqual(['request']);
+    expect(summary.globalFlows).toEqual([{ parameter: 'request', global: 'last' }]);
+    expect(summary.calleeFlows).toContainEqual({
+      parameter: 'options',
+      callee: 'store',
+      argument: 1,
+      line: 4,
+    });
+    expect(index.getFunctionSummary('function:ping:/src/app.ts')!.sccSize).toBe(1);
+
+    const flow = index.traceParameterFlow('function:handle:/src/app.ts', 0)!;
+    expect(flow.returned).toBe(true);
+    expect(flow.globals).toEqual(['last']);
+    expect(flow.reaches).toEqual([
+      { symbolId: 'function:handle:/src/app.ts', parameter: 'request', depth: 0 },
+      { symbolId: 'function:store:/src/store.ts', parameter: 'value', depth: 1 },
+    ]);
+
+    // A body edit that keeps the summary does not touch the callers
+    const before = index.getStats().summaryComputations;
+    index.indexSource(
+      '/src/store.ts',
+      ['let last;', 'export function store(value, mode) {', '  last = value;', '  return (value);', '}'].join(
+        '\n'
+      )
+    );
+    index.getFunctionSummary('function:handle:/src/app.ts');
+    expect(index.getStats().summaryComputations).toBe(before + 1);
+
+    index.indexSource('/src/store.ts', 'export function store(value, mode) {\n  return mode;\n}');
+    const updated = index.getFunctionSummary('function:handle:/src/app.ts')!;
+    expect(updated.returnedParameters).toEqual(['options']);
+    expect(updated.globalFlows).toEqual([]);
+    expect(index.getStats().summaryComputations).toBe(before + 3);
+
+    index.removeFile('/src/app.ts');
+    expect(index.getFunctionSummary('function:handle:/src/app.ts')).toBeNull();
+  });
+
+  it('should trace parameters by name without recording access', () => {
+    index.indexSource(
+      '/src/app.ts',
+      [
+        "import { store } from './store';",
+        'export function handle(value, options) {',
+        '  return store(value, options.mode);',
+        '}',
+        'export const label = (prefix: string) => prefix;',
+      ].join('\n')
+    );
+    index.indexSource('/src/store.ts', 'export function store(value, mode) {\n  return mode;\n}');
+
+    const accessRecords = index.getStats().accessRecords;
+    const files = ['/src/app.ts', '/src/store.ts', '/src/none.ts'];
+    const flows = index.traceParametersNamed('value', files);
+    expect(flows.map((flow) => [flow.reaches[0]!.symbolId, flow.returned])).toEqual([
+      ['function:handle:/src/app.ts', false],
+      ['function:store:/src/store.ts', false],
+    ]);
+    expect(flows[0]!.reaches[1]).toEqual({
+      symbolId: 'function:store:/src/store.ts',
+      parameter: 'value',
+      depth: 1,
+    });
+    expect(index.traceParametersNamed('mode', ['/src/app.ts'])).toEqual([]);
+    expect(index.traceParametersNamed('prefix', ['/src/app.ts'])[0]!.returned).toBe(true);
+    expect(index.getStats().accessRecords).toBe(accessRecords);
+  });
+
+  it('should warm from a directory and cover files beneath it', async () => {
+    const root = resolve('test/fixtures/typescript');
+    const fileCount = await index.warm(root);
+
+    expect(fileCount).toBeGreaterThan(0);
+    expect(index.isWarm()).toBe(true);
+    expect(index.covers(`${root}/callers-test.ts`)).toBe(true);
+    expect(index.covers(resolve('test/fixtures/python'))).toBe(false);
+
+    const callers = index.findCallers(`function:helper1:${root}/callers-test.ts`);
+    expect(callers.map((c) => c.fromSymbolId).sort()).toEqual([
+      `function:main:${root}/callers-test.ts`,
+      `function:main:${root}/callers-test.ts`,
+      `function:processData:${root}/callers-test.ts`,
+    ]);
+    expect(index.getStats().indexedFiles).toBe(fileCount);
+    expect(['io_uring', 'threads']).toContain(index.getStats().readBackend);
+  });
+
+  it('should keep the newest read of a file indexed while warm-up runs', async () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-generations-'));
+    const file = join(root, 'edited.ts');
+    try {
+      for (let i = 0; i < 50; i++) {
+        writeFileSync(join(root, `file${i}.ts`), `export function f${i}() {}\n`);
+      }
+      for (let round = 0; round < 5; round++) {
+        writeFileSync(file, 'export function before() {}\n');
+        const fresh = new ProjectIndex();
+        const warming = fresh.warm(root);
+        // Warm-up may already have read the old bytes; its parse must not win.
+        writeFileSync(file, 'export function after() {}\n');
+        fresh.indexFile(file);
+        await warming;
+        expect(fresh.findSymbolsByFile(file).map((s) => s.name)).toEqual(['after']);
+      }
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it('should index the same files with every read backend', async () => {
+    const root = resolve('test/fixtures/typescript');
+    const counts: number[] = [];
+    for (const backend of ['sequential', 'threads', 'io_uring'] as const) {
+      const fresh = new ProjectIndex();
+      counts.push(await fresh.warm(root, backend));
+      expect(fresh.getStats().lastReadBytes).toBeGreaterThan(0);
+      expect(fresh.findSymbolsByFile(`${root}/callers-test.ts`).length).toBeGreaterThan(0);
+    }
+    expect(new Set(counts).size).toBe(1);
+  });
+
+  it('should reindex a large file truncated and rewritten in place under its retained tree', () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-rewrite-'));
+    const file = join(root, 'large.ts');
+    const body = (name: string, count: number) => {
+      const lines = Array.from({ length: count }, (_, i) => `export function ${name}${i}() {}`);
+      return `${lines.join('\n')}\n`;
+    };
+    try {
+      writeFileSync(file, body('before', 4000));
+      expect(index.indexFile(file)).toBe(true);
+      expect(index.getStats().retainedTrees).toBeGreaterThan(0);
+
+      // What formatters and Node's writeFile do: O_TRUNC, then write
+      writeFileSync(file, body('after', 3));
+      expect(index.indexFile(file)).toBe(true);
+      expect(index.findSymbolsByFile(file).map((s) => s.name)).toEqual([
+        'after0',
+        'after1',
+        'after2',
+      ]);
+      expect(index.findUsages('after2', undefined, true)[0]).toMatchObject({
+        line: 3,
+        lineText: 'export function after2() {}',
+      });
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it('should index whole prefixes of files that grow while being read', async () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-grow-'));
+    const files = Array.from({ length: 100 }, (_, i) => join(root, `grow${i}.ts`));
+    const line = (n: number) => `export function f${n}() {}\n`;
+    try {
+      for (const file of files) {
+        writeFileSync(file, line(0));
+      }
+      const sizes = files.map(() => 1);
+      const fresh = new ProjectIndex();
+      const warming = fresh.warm(root, 'io_uring');
+      // Appends land between the statx and the read of some files
+      for (const deadline = Date.now() + 50; Date.now() < deadline; ) {
+        for (let i = 0; i < files.length; i++) {
+          appendFileSync(files[i]!, line(sizes[i]!++));
+        }
+      }
+      await warming;
+
+      for (let i = 0; i < files.length; i++) {
+        const names = fresh.findSymbolsByFile(files[i]!).map((s) => s.name);
+        // The last append may have been read partway through its name
+        const last = names.pop()!;
+        expect(names).toEqual(names.map((_, n) => `f${n}`));
+        expect(`f${names.length}`.startsWith(last)).toBe(true);
+        fresh.indexFile(files[i]!);
+        expect(fresh.findSymbolsByFile(files[i]!)).toHaveLength(sizes[i]!);
+      }
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it.skipIf(process.platform !== 'linux')(
+    'should coalesce watcher bursts into one dirty batch',
+    async () => {
+      const root = mkdtempSync(join(tmpdir(), 'prism-watch-'));
+      try {
+        // Leave dirty files to the explicit refresh below
+        index.setReindexOptions({ cpuBudget: 0 });
+        writeFileSync(join(root, 'a.ts'), 'export function a() {}\n');
+        await index.warm(root);
+
+        const batches: string[][] = [];
+        const delivered = new Promise<void>((done) => {
+          expect(
+            index.watch(root, (filePaths) => {
+              batches.push(filePaths);
+              done();
+            })
+          ).toBe(true);
+        });
+
+        // A formatter-style burst: many writes to a few files
+        for (let i = 0; i < 50; i++) {
+          writeFileSync(join(root, 'a.ts'), `export function a${i}() {}\n`);
+          writeFileSync(join(root, 'b.ts'), `export function b${i}() {}\n`);
+          writeFileSync(join(root, 'notes.md'), `${i}\n`);
+        }
+        await delivered;
+
+        expect(batches).toEqual([[join(root, 'a.ts'), join(root, 'b.ts')]]);
+        expect(index.getStats().dirtyFiles).toBe(2);
+        expect(index.getStats().watchBatches).toBe(1);
+
+        index.refreshDirtyFiles();
+        expect(index.findSymbolsByName('a49')).toHaveLength(1);
+        expect(index.findSymbolsByName('b49')).toHaveLength(1);
+      } finally {
+        index.unwatch();
+        rmSync(root, { recursive: true, force: true });
+      }
+    }
+  );
+
+  it('should refresh queried files first and leave the rest queued', async () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-reindex-'));
+    try {
+      index.setReindexOptions({ cpuBudget: 0 });
+      writeFileSync(join(root, 'app.ts'), "import { util } from './util';\nutil();\n");
+      writeFileSync(join(root, 'util.ts'), 'export function util() {}\n');
+      writeFileSync(join(root, 'other.ts'), 'export function other() {}\n');
+      await index.warm(root);
+
+      writeFileSync(join(root, 'app.ts'), "import { util } from './util';\nexport function app() {}\n");
+      writeFileSync(join(root, 'util.ts'), 'export function util2() {}\n');
+      writeFileSync(join(root, 'other.ts'), 'export function other2() {}\n');
+      index.markFileDirty(join(root, 'other.ts'));
+      index.markFileDirty(join(root, 'util.ts'));
+      index.markFileDirty(join(root, 'app.ts'));
+      index.markFileDirty(join(root, 'app.ts'));
+
+      expect(index.refreshFiles([join(root, 'app.ts')])).toBe(1);
+      expect(index.findSymbolsByName('app')).toHaveLength(1);
+      expect(index.findSymbolsByName('util2')).toHaveLength(0);
+      const stats = index.getStats();
+      expect(stats.reindexQueueDepth).toBe(2);
+      // app.ts imports util.ts, so it moves ahead of other.ts
+      expect(stats.reindexPrioritized).toBe(1);
+      expect(stats.coalescedChanges).toBe(1);
+      expect(stats.reindexLagMs).toBeGreaterThanOrEqual(0);
+
+      index.setReindexOptions({ debounceMs: 0, cpuBudget: 1 });
+      for (let i = 0; i < 100 && index.getStats().reindexQueueDepth > 0; i++) {
+        await new Promise((done) => setTimeout(done, 10));
+      }
+      expect(index.getStats().reindexQueueDepth).toBe(0);
+      expect(index.getStats().backgroundReindexed).toBe(2);
+      expect(index.findSymbolsByName('util2')).toHaveLength(1);
+      expect(index.findSymbolsByName('other2')).toHaveLength(1);
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it('should restore analyses from a shared disk cache by content', () => {
+    const cacheDir = mkdtempSync(join(tmpdir(), 'prism-parse-cache-'));
+    const app = "import { util } from './util';\nfunction run() {\n  util();\n}\n";
+    const util = 'export function util() {}\n';
+    try {
+      expect(index.setCacheDir(cacheDir)).toBe(true);
+      index.indexSource('/src/app.ts', app);
+      index.indexSource('/src/util.ts', util);
+      expect(index.getStats().diskCacheWrites).toBe(2);
+
+      // A second server process over the same directory parses nothing
+      const restarted = new ProjectIndex();
+      expect(restarted.setCacheDir(cacheDir)).toBe(true);
+      restarted.indexSource('/src/app.ts', app);
+      restarted.indexSource('/src/util.ts', util);
+      const stats = restarted.getStats();
+      expect(stats.diskCacheHits).toBe(2);
+      expect(stats.diskCacheWrites).toBe(0);
+      expect(restarted.findCallers('function:util:/src/util.ts')).toEqual(
+        index.findCallers('function:util:/src/util.ts')
+      );
+      expect(restarted.countUsages(['util'])).toEqual(index.countUsages(['util']));
+
+      // Records are keyed by content, not path
+      restarted.indexSource('/lib/copy.ts', util);
+      expect(restarted.getStats().diskCacheHits).toBe(3);
+      expect(restarted.findSymbolsByFile('/lib/copy.ts').map((s) => s.id)).toEqual([
+        'function:util:/lib/copy.ts',
+      ]);
+    } finally {
+      rmSync(cacheDir, { recursive: true, force: true });
+    }
+  });
+
+  it('should move analyses between cache tiers by use', () => {
+    const cacheDir = mkdtempSync(join(tmpdir(), 'prism-tiers-'));
+    const app = "import { util } from './util';\nfunction run() {\n  util();\n}\n";
+    try {
+      index.setCacheDir(cacheDir);
+      index.indexSource('/src/util.ts', 'export function util() {}\n');
+      index.indexSource('/src/app.ts', app);
+      expect(index.getStats().hotEntries).toBe(2);
+
+      // Restored from disk without a tree, so each re-index is a lookup
+      const restarted = new ProjectIndex();
+      restarted.setCacheDir(cacheDir);
+      restarted.indexSource('/src/util.ts', 'export function util() {}\n');
+      for (let i = 0; i < 3; i++) restarted.indexSource('/src/app.ts', app);
+      let stats = restarted.getStats();
+      expect([stats.coldHits, stats.warmHits, stats.hotHits]).toEqual([2, 1, 1]);
+      expect(stats.cachePromotions).toBe(1);
+      expect(stats.hotHitRate).toBeCloseTo(1 / 4);
+      expect(restarted.findCallers('function:util:/src/util.ts')).toHaveLength(1);
+
+      restarted.setCacheBudgets({ hotBytes: 0 });
+      stats = restarted.getStats();
+      expect(stats.hotEntries).toBe(0);
+      expect(stats.warmEntries).toBe(2);
+      expect(stats.cacheDemotions).toBe(1);
+      expect(stats.warmRawBytes).toBeGreaterThan(0);
+      restarted.indexSource('/src/app.ts', app);
+      expect(restarted.getStats().warmHits).toBe(2);
+      expect(restarted.findCallers('function:util:/src/util.ts')).toHaveLength(1);
+    } finally {
+      rmSync(cacheDir, { recursive: true, force: true });
+    }
+  });
+
+  it('should back off collecting the disk cache while another process holds the lock', async () => {
+    const cacheDir = mkdtempSync(join(tmpdir(), 'prism-parse-cache-'));
+    // -o: the lock is flock's own and goes with it, not with the command
+    const lockPath = join(cacheDir, 'gc.lock');
+    const holder = spawn('flock', ['-o', lockPath, 'sh', '-c', 'echo locked; exec sleep 30']);
+    try {
+      await new Promise((ready) => holder.stdout.once('data', ready));
+      index.setCacheDir(cacheDir, 20_000);
+      const write = (i: number) =>
+        index.indexSource(`/src/file${i}.ts`, `export function f${i}(a: number) { return a; }\n`);
+      for (let i = 0; i < 30; i++) {
+        write(i);
+      }
+      let stats = index.getStats();
+      expect(stats.diskCacheWrites).toBe(30);
+      expect(stats.diskCacheCollections).toBe(0);
+      expect(stats.diskCacheDeferredCollections).toBeGreaterThan(0);
+      // Retried once per tenth of the budget written, not on every write
+      expect(stats.diskCacheDeferredCollections).toBeLessThanOrEqual(
+        1 + stats.diskCacheBytes / 2_000
+      );
+      expect(stats.diskCacheDeferredCollections).toBeLessThan(30);
+
+      holder.kill();
+      await new Promise((exited) => holder.once('exit', exited));
+      for (let i = 30; i < 300 && index.getStats().diskCacheCollections === 0; i++) {
+        write(i);
+      }
+      stats = index.getStats();
+      expect(stats.diskCacheCollections).toBe(1);
+      expect(stats.diskCacheBytes).toBeLessThanOrEqual(20_000);
+    } finally {
+      holder.kill();
+      rmSync(cacheDir, { recursive: true, force: true });
+    }
+  });
+
+  it('should persist access counts with the cache and prefetch the working set', async () => {
+    const root = mkdtempSync(join(tmpdir(), 'prism-prefetch-'));
+    const cacheDir = join(root, '.cache');
+    const hotFile = join(root, 'hot.ts');
+    try {
+      writeFileSync(hotFile, 'export function hot(a: number) {\n  return a;\n}\n');
+      writeFileSync(join(root, 'cold.ts'), 'export function cold() {}\n');
+      index.setCacheDir(cacheDir);
+      await index.warm(root);
+      for (let i = 0; i < 4; i++) {
+        index.findSymbolsByFile(hotFile);
+        index.getFunctionSummary(`function:hot:${hotFile}`);
+      }
+      expect(index.getStats().accessRecords).toBe(8);
+      expect(index.flushAccessLog()).toBe(true);
+
+      const restarted = new ProjectIndex();
+      restarted.setCacheDir(cacheDir);
+      expect(restarted.getStats()).toMatchObject({ accessedFiles: 1, accessedSymbols: 1 });
+      await restarted.warm(root);
+      const retainedBefore = restarted.getStats().retainedTrees;
+      const result = await restarted.prefetch();
+      expect(result).toMatchObject({ files: 1, symbols: 1, timedOut: false, outOfMemory: false });
+      expect(restarted.getStats().retainedTrees).toBe(retainedBefore + 1);
+      expect(restarted.getStats().lastPrefetch.files).toBe(1);
+
+      const constrained = new ProjectIndex();
+      constrained.setCacheDir(cacheDir);
+      await constrained.warm(root);
+      expect(await constrained.prefetch({ memoryBytes: 0 })).toMatchObject({
+        files: 0,
+        outOfMemory: true,
+      });
+    } finally {
+      rmSync(root, { recursive: true, force: true });
+    }
+  });
+
+  it('should serve skeletons and public surfaces from the index', () => {
+    index.indexSource(
+      '/src/shapes.ts',
+      [
+        "import { Base } from './base';",
+        'export class Square extends Base {',
+        '  private side: number;',
+        '  constructor(side: number) {',
+        '    super();',
+        '    this.side = side;',
+        '  }',
+        '  area(): number {',
+        '    return this.side * this.side;',
+        '  }',
+        '}',
+        'export function unit(scale = 1): Square {',
+        '  return new Square(scale);',
+        '}',
+        "export * from './base';",
+      ].join('\n')
+    );
+    index.indexSource('/src/base.ts', 'export class Base {}\n');
+    index.indexSource('/lib/other.ts', 'export const other = 1;\n');
+
+    const skeleton = index.getSkeleton('/src/shapes.ts')!;
+    expect(skeleton.language).toBe('typescript');
+    expect(skeleton.imports[0].source).toBe('./base');
+    const square = skeleton.exports.classes[0];
+    expect(square).toMatchObject({ name: 'Square', extends: 'Base' });
+    expect(square.constructorDef!.parameters.map((p) => p.name)).toEqual(['side']);
+    expect(square.methods[0]).toMatchObject({ name: 'area', returnType: 'number' });
+    expect(square.properties[0]).toMatchObject({ name: 'side', visibility: 'private' });
+    expect(skeleton.exports.functions[0].parameters[0].defaultValue).toBe('1');
+
+    const surface = index.getPublicSurface('/src/shapes.ts')!;
+    expect(surface.map((item) => item.name)).toEqual(['Square', 'unit', '*']);
+    expect(surface[0].members).toEqual(['constructor', 'area']);
+    expect(surface[1].signature).toBe('(scale = 1): Square');
+    expect(surface[2]).toMatchObject({ type: 're-export', source: './base' });
+
+    expect(index.getSkeletons('/src').map((s) => s.filePath)).toEqual([
+      '/src/base.ts',
+      '/src/shapes.ts',
+    ]);
+
+    // Kept current as files change
+    index.indexSource('/src/base.ts', 'export function base() {}\n');
+    expect(index.getSkeleton('/src/base.ts')!.exports.classes).toHaveLength(0);
+    expect(index.getSkeleton('/src/base.ts')!.exports.functions[0].name).toBe('base');
+    expect(index.getSkeleton('/src/missing.ts')).toBeNull();
+  });
+});
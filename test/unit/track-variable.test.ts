@@ -1,6 +1,10 @@
 import { describe, it, expect, beforeEach, afterEach } from 'vitest';
 import trackVariable from '../../src/tools/track_variable.js';
 import { ParserFactory } from '../../src/parsers/factory.js';
+import { getProjectIndex, resetProjectIndex } from '../../src/graph/indexer.js';
+import { mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import { join } from 'path';
 
 describe('track_variable', () => {
   beforeEach(() => {
@@ -119,4 +123,57 @@ function process(data) { // Declaration
       fs.unlinkSync(testFile);
     }
   });
+
+  it('should report the same usages with and without a warm index', async () => {
+    const dir = mkdtempSync(join(tmpdir(), 'prism-track-'));
+    const code = [
+      "const greeting = 'héllo wörld 👋';",
+      "export const label = { title: 'Ünïcode' }; const total = greeting.length + 1;",
+      '',
+      'export function shout(): string {',
+      "  return '¡' + greeting.toUpperCase() + '!'; // 🎉 greeting",
+      '}',
+    ].join('\n');
+    writeFileSync(join(dir, 'greeting.ts'), code);
+    // Keys, shorthand properties, class fields and method names are not the
+    // variable; the import binding is read as the parser reads it
+    writeFileSync(
+      join(dir, 'uses.ts'),
+      [
+        "import { greeting } from './greeting';",
+        'export const card = { greeting: 1, greeting };',
+        'export class Card { greeting = 2; greeting() { return greeting; } }',
+      ].join('\n')
+    );
+    resetProjectIndex();
+
+    try {
+      const track = async () =>
+        JSON.parse(
+          (await trackVariable({ variableName: 'greeting', directoryPath: dir })).content[0].text
+        );
+      const parsed = await track();
+      const index = (await getProjectIndex())!;
+      await index.warm(dir);
+      const indexed = await track();
+
+      expect(indexed.usages).toEqual(parsed.usages);
+      // A directory-wide query is not a read of every file for prefetch
+      expect(index.getStats().accessRecords).toBe(0);
+      // Columns count UTF-16 code units, as the parser does
+      expect(parsed.usages.map((u: any) => [u.line, u.column, u.type])).toEqual([
+        [1, 6, 'declaration'],
+        [2, 57, 'read'],
+        [5, 15, 'read'],
+        [1, 9, 'read'],
+        [3, 54, 'read'],
+      ]);
+      expect(parsed.usages[2].context).toBe(
+        "return '¡' + greeting.toUpperCase() + '!'; // 🎉 g..."
+      );
+    } finally {
+      resetProjectIndex();
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
 });